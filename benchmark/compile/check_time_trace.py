@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Check clang -ftime-trace output against per-TU thresholds.
+
+Reads the *.json traces clang drops next to the benchmark objects,
+reports total frontend time and the costliest template instantiations
+per TU, and exits non-zero when a TU exceeds its budget in
+thresholds.json. Run via the `benchmark-compile` CMake target.
+"""
+
+import argparse
+import json
+import pathlib
+import sys
+
+
+def load_trace(path):
+    with open(path) as f:
+        return json.load(f).get("traceEvents", [])
+
+
+def frontend_ms(events):
+    total = sum(e.get("dur", 0) for e in events
+                if e.get("name") == "Total Frontend")
+    if total == 0:
+        total = sum(e.get("dur", 0) for e in events
+                    if e.get("name") == "Frontend")
+    return total / 1000.0
+
+
+def instantiations(events):
+    by_detail = {}
+    for e in events:
+        if e.get("name") in ("InstantiateClass", "InstantiateFunction"):
+            detail = e.get("args", {}).get("detail", "<unknown>")
+            by_detail[detail] = by_detail.get(detail, 0) + e.get("dur", 0)
+    return sorted(by_detail.items(), key=lambda kv: -kv[1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--trace-dir", required=True, type=pathlib.Path)
+    parser.add_argument("--thresholds", required=True, type=pathlib.Path)
+    parser.add_argument("--top", type=int, default=10,
+                        help="instantiations to list per TU")
+    args = parser.parse_args()
+
+    with open(args.thresholds) as f:
+        thresholds = json.load(f)
+
+    traces = {p.name.split(".")[0]: p
+              for p in sorted(args.trace_dir.rglob("*.json"))}
+    failures = []
+    for tu, budget_ms in sorted(thresholds.items()):
+        trace = traces.get(tu)
+        if trace is None:
+            failures.append(f"{tu}: no trace found under {args.trace_dir}")
+            continue
+        events = load_trace(trace)
+        total = frontend_ms(events)
+        verdict = "ok" if total <= budget_ms else "OVER BUDGET"
+        print(f"{tu}: frontend {total:.1f} ms (budget {budget_ms} ms) "
+              f"[{verdict}]")
+        for detail, dur in instantiations(events)[:args.top]:
+            print(f"    {dur / 1000.0:8.1f} ms  {detail}")
+        if total > budget_ms:
+            failures.append(
+                f"{tu}: frontend {total:.1f} ms exceeds budget {budget_ms} ms")
+
+    if failures:
+        print("\ncompile-time regression:", file=sys.stderr)
+        for failure in failures:
+            print(f"  {failure}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
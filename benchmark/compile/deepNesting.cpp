@@ -0,0 +1,35 @@
+// Deep nesting: variants of tuples of variants, matched four levels
+// down. Stresses recursive PatternTraits instantiation (As inside Ds
+// inside As) and the depth-indexed id bookkeeping.
+#include "matchit.h"
+#include <tuple>
+#include <variant>
+
+using Leaf = std::variant<int32_t, double>;
+using Pair = std::tuple<Leaf, Leaf>;
+using Node = std::variant<Leaf, Pair>;
+using Tree = std::tuple<Node, Node>;
+
+double collapse(Tree const &tree)
+{
+  using namespace matchit;
+  Id<int32_t> i, j;
+  Id<double> x, y;
+  return match(tree)(
+      // clang-format off
+      pattern | ds(as<Leaf>(as<int32_t>(i)), as<Leaf>(as<int32_t>(j))) =
+          i + j,
+      pattern | ds(as<Pair>(ds(as<int32_t>(i), as<double>(x))),
+                   as<Pair>(ds(as<double>(y), as<int32_t>(j)))) =
+          i + x + y + j,
+      pattern | ds(as<Pair>(ds(as<double>(x), _)), _) = x + 0.0,
+      pattern | ds(_, as<Leaf>(as<double>(y)))        = y + 0.0,
+      pattern | _                                     = expr(0.0)
+      // clang-format on
+  );
+}
+
+int32_t main()
+{
+  return collapse(Tree{Leaf{2}, Leaf{3}}) == 5.0 ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+// Many flat arms: 64 literal patterns plus a catch-all. Stresses the
+// per-arm PatternPair machinery, the flat-dispatch classification and
+// RetTypeSelect over a long arm list.
+#include "matchit.h"
+#include <string_view>
+
+std::string_view opcodeName(int32_t opcode)
+{
+  using namespace matchit;
+  return match(opcode)(
+      // clang-format off
+      pattern | 0  = expr("nop"),     pattern | 1  = expr("push"),
+      pattern | 2  = expr("pop"),     pattern | 3  = expr("dup"),
+      pattern | 4  = expr("swap"),    pattern | 5  = expr("add"),
+      pattern | 6  = expr("sub"),     pattern | 7  = expr("mul"),
+      pattern | 8  = expr("div"),     pattern | 9  = expr("mod"),
+      pattern | 10 = expr("neg"),     pattern | 11 = expr("not"),
+      pattern | 12 = expr("and"),     pattern | 13 = expr("or"),
+      pattern | 14 = expr("xor"),     pattern | 15 = expr("shl"),
+      pattern | 16 = expr("shr"),     pattern | 17 = expr("eq"),
+      pattern | 18 = expr("ne"),      pattern | 19 = expr("lt"),
+      pattern | 20 = expr("le"),      pattern | 21 = expr("gt"),
+      pattern | 22 = expr("ge"),      pattern | 23 = expr("jmp"),
+      pattern | 24 = expr("jz"),      pattern | 25 = expr("jnz"),
+      pattern | 26 = expr("call"),    pattern | 27 = expr("ret"),
+      pattern | 28 = expr("load"),    pattern | 29 = expr("store"),
+      pattern | 30 = expr("alloc"),   pattern | 31 = expr("free"),
+      pattern | 32 = expr("ldc"),     pattern | 33 = expr("ldl"),
+      pattern | 34 = expr("stl"),     pattern | 35 = expr("lda"),
+      pattern | 36 = expr("sta"),     pattern | 37 = expr("ldg"),
+      pattern | 38 = expr("stg"),     pattern | 39 = expr("inc"),
+      pattern | 40 = expr("dec"),     pattern | 41 = expr("tst"),
+      pattern | 42 = expr("cmp"),     pattern | 43 = expr("brk"),
+      pattern | 44 = expr("sys"),     pattern | 45 = expr("in"),
+      pattern | 46 = expr("out"),     pattern | 47 = expr("wait"),
+      pattern | 48 = expr("yield"),   pattern | 49 = expr("fork"),
+      pattern | 50 = expr("join"),    pattern | 51 = expr("lock"),
+      pattern | 52 = expr("unlock"),  pattern | 53 = expr("fence"),
+      pattern | 54 = expr("cas"),     pattern | 55 = expr("xchg"),
+      pattern | 56 = expr("trap"),    pattern | 57 = expr("iret"),
+      pattern | 58 = expr("hlt"),     pattern | 59 = expr("dbg"),
+      pattern | 60 = expr("ext0"),    pattern | 61 = expr("ext1"),
+      pattern | 62 = expr("ext2"),    pattern | 63 = expr("ext3"),
+      pattern | _  = expr("invalid")
+      // clang-format on
+  );
+}
+
+int32_t main()
+{
+  return opcodeName(5) == std::string_view{"add"} ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+// Sample-shaped mix: the idioms the sample/ directory leans on most —
+// string arms, app projections, guards, some/none over optionals and a
+// range pattern — in one TU, as a proxy for what typical users compile.
+#include "matchit.h"
+#include <optional>
+#include <string>
+
+int32_t classifyCommand(std::string const &command)
+{
+  using namespace matchit;
+  return match(command)(
+      // clang-format off
+      pattern | "start" = expr(1),
+      pattern | "stop"  = expr(2),
+      pattern | "pause" = expr(3),
+      pattern | _       = expr(0)
+      // clang-format on
+  );
+}
+
+char const *classifyMagnitude(int32_t value)
+{
+  using namespace matchit;
+  constexpr auto square = [](int32_t v) { return v * v; };
+  Id<int32_t> s;
+  return match(value)(
+      // clang-format off
+      pattern | app(square, s) | when(s > 10000) = expr("large"),
+      pattern | (within(1, 100))                 = expr("small"),
+      pattern | meet([](auto v) { return v < 0; }) = expr("negative"),
+      pattern | _                                = expr("medium")
+      // clang-format on
+  );
+}
+
+int32_t unwrapOrZero(std::optional<int32_t> const &value)
+{
+  using namespace matchit;
+  Id<int32_t> v;
+  return match(value)(
+      // clang-format off
+      pattern | some(v) = v + 0,
+      pattern | none    = expr(0)
+      // clang-format on
+  );
+}
+
+int32_t main()
+{
+  return classifyCommand("stop") == 2 &&
+                 classifyMagnitude(7) == std::string{"small"} &&
+                 unwrapOrZero(std::nullopt) == 0
+             ? 0
+             : 1;
+}
@@ -0,0 +1,31 @@
+// Wide destructuring: a 24-field record matched with per-field ids.
+// Stresses SubTypes/IndexedTypes and the Unique id-type collection,
+// which historically went quadratic in the tuple width.
+#include "matchit.h"
+#include <tuple>
+
+int32_t sumWideRecord(
+    std::tuple<int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t,
+               int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t,
+               int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t,
+               int32_t, int32_t, int32_t> const &record)
+{
+  using namespace matchit;
+  Id<int32_t> a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p, q, r, s, t, u,
+      v, w, x;
+  return match(record)(
+      pattern | ds(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                   0, 0, 0, 0) = expr(0),
+      pattern | ds(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p, q, r, s, t,
+                   u, v, w, x) =
+          [&]
+      {
+        return *a + *b + *c + *d + *e + *f + *g + *h + *i + *j + *k + *l + *m +
+               *n + *o + *p + *q + *r + *s + *t + *u + *v + *w + *x;
+      });
+}
+
+int32_t main()
+{
+  return sumWideRecord({}) == 0 ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""Check Google Benchmark JSON results against per-benchmark thresholds.
+
+Reads the --benchmark_out JSON produced by macro-benchmarks, prints each
+benchmark's time next to its budget, and exits non-zero when a budgeted
+benchmark is missing or over its threshold in thresholds.json. Budgets
+are wall-clock upper bounds, set a few times above the numbers a routine
+development machine reports, so only genuine regressions trip them. Run
+via the `benchmark-macro` CMake target.
+"""
+
+import argparse
+import json
+import pathlib
+import sys
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--results", required=True, type=pathlib.Path)
+    parser.add_argument("--thresholds", required=True, type=pathlib.Path)
+    args = parser.parse_args()
+
+    with open(args.results) as f:
+        results = {b["name"]: b for b in json.load(f).get("benchmarks", [])}
+    with open(args.thresholds) as f:
+        thresholds = json.load(f)
+
+    failures = []
+    for name, budget_ns in sorted(thresholds.items()):
+        result = results.get(name)
+        if result is None:
+            failures.append(f"{name}: missing from {args.results}")
+            continue
+        time_ns = result["real_time"]
+        unit = result.get("time_unit", "ns")
+        if unit != "ns":
+            failures.append(f"{name}: unexpected time unit {unit}")
+            continue
+        verdict = "ok" if time_ns <= budget_ns else "OVER BUDGET"
+        print(f"{name}: {time_ns:.0f} ns (budget {budget_ns} ns) [{verdict}]")
+        if time_ns > budget_ns:
+            failures.append(
+                f"{name}: {time_ns:.0f} ns exceeds budget {budget_ns} ns")
+
+    if failures:
+        print("\nmacro-benchmark regression:", file=sys.stderr)
+        for failure in failures:
+            print(f"  {failure}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
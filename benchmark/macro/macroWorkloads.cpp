@@ -0,0 +1,255 @@
+#include "matchit.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+using namespace matchit;
+
+// Macro benchmarks lifted from the heavyweight samples, parameterized so
+// a run sweeps realistic sizes: expression-tree evaluation by tree
+// depth, red-black rebalancing by insertion count, and the recursive
+// graph match by transition-stream length. These recursive workloads
+// exercise the cache and inlining interactions the microbenchmarks
+// cannot see.
+
+// --- Evaluating-Expression-Trees.cpp, parameterized by depth ---------
+struct Expr;
+struct Neg
+{
+  std::shared_ptr<Expr> expr;
+};
+struct Add
+{
+  std::shared_ptr<Expr> lhs, rhs;
+};
+struct Mul
+{
+  std::shared_ptr<Expr> lhs, rhs;
+};
+struct Expr : std::variant<int, Neg, Add, Mul>
+{
+  using variant::variant;
+};
+
+namespace std
+{
+  template <>
+  struct variant_size<Expr> : variant_size<Expr::variant>
+  {
+  };
+  template <std::size_t I>
+  struct variant_alternative<I, Expr> : variant_alternative<I, Expr::variant>
+  {
+  };
+} // namespace std
+
+bool operator==(Expr const &l, Expr const &r)
+{
+  return static_cast<std::variant<int, Neg, Add, Mul> const &>(l) ==
+         static_cast<std::variant<int, Neg, Add, Mul> const &>(r);
+}
+
+namespace
+{
+  const auto asNegDs = asDsVia<Neg>(&Neg::expr);
+  const auto asAddDs = asDsVia<Add>(&Add::lhs, &Add::rhs);
+  const auto asMulDs = asDsVia<Mul>(&Mul::lhs, &Mul::rhs);
+
+  int eval(const Expr &ex)
+  {
+    Id<int> i;
+    Id<Expr> e, l, r;
+    return match(ex)(
+        // clang-format off
+        pattern | as<int>(i)                   = i,
+        pattern | asNegDs(some(e))             = [&]{ return -eval(*e); },
+        pattern | asAddDs(some(l), some(r))    = [&]{ return eval(*l) + eval(*r); },
+        pattern | asMulDs(some(as<int>(0)), _) = 0,
+        pattern | asMulDs(_, some(as<int>(0))) = 0,
+        pattern | asMulDs(some(l), some(r))    = [&]{ return eval(*l) * eval(*r); },
+        pattern | _                            = -1
+        // clang-format on
+    );
+  }
+
+  std::shared_ptr<Expr> makeTree(int64_t depth, int32_t &counter)
+  {
+    if (depth == 0)
+    {
+      return std::make_shared<Expr>(counter++ % 7);
+    }
+    auto const l = makeTree(depth - 1, counter);
+    auto const r = makeTree(depth - 1, counter);
+    switch (counter++ % 3)
+    {
+    case 0:
+      return std::make_shared<Expr>(Add{l, r});
+    case 1:
+      return std::make_shared<Expr>(Mul{l, r});
+    default:
+      return std::make_shared<Expr>(Neg{l});
+    }
+  }
+
+  void exprTreeEval(benchmark::State &state)
+  {
+    auto counter = int32_t{0};
+    auto const tree = makeTree(state.range(0), counter);
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(eval(*tree));
+    }
+  }
+} // namespace
+
+// --- Red-black-Tree-Rebalancing.cpp, parameterized by insertions -----
+namespace
+{
+  enum Color
+  {
+    Red,
+    Black
+  };
+  template <typename T>
+  struct RbNode
+  {
+    RbNode() = default;
+    RbNode(Color color_, std::shared_ptr<RbNode> const &lhs_, T value_,
+           std::shared_ptr<RbNode> const &rhs_)
+        : color{color_}, lhs{lhs_}, value{value_}, rhs{rhs_} {}
+    void balance();
+    Color color;
+    std::shared_ptr<RbNode> lhs;
+    T value;
+    std::shared_ptr<RbNode> rhs;
+  };
+
+  template <typename T>
+  bool operator==(RbNode<T> const &lhs, RbNode<T> const &rhs)
+  {
+    return lhs.color == rhs.color && lhs.lhs == rhs.lhs &&
+           lhs.value == rhs.value && lhs.rhs == rhs.rhs;
+  }
+
+  template <typename T>
+  void RbNode<T>::balance()
+  {
+    constexpr auto dsN = [](auto &&color, auto &&lhs, auto &&value, auto &&rhs)
+    {
+      return and_(app(&RbNode<T>::color, color), app(&RbNode<T>::lhs, lhs),
+                  app(&RbNode<T>::value, value), app(&RbNode<T>::rhs, rhs));
+    };
+    constexpr auto blackN = [dsN](auto &&lhs, auto &&value, auto &&rhs)
+    { return dsN(Black, lhs, value, rhs); };
+    constexpr auto redN = [dsN](auto &&lhs, auto &&value, auto &&rhs)
+    { return dsN(Red, lhs, value, rhs); };
+
+    Id<std::shared_ptr<RbNode<T>>> a, b, c, d;
+    Id<T> x, y, z;
+    Id<RbNode> self;
+    *this = match(*this)(
+        // clang-format off
+        pattern | blackN(some(redN(some(redN(a, x, b)), y, c)), z, d)
+        = [&]{ return RbNode{Red, std::make_shared<RbNode>(Black, *a, *x, *b), *y,
+                             std::make_shared<RbNode>(Black, *c, *z, *d)}; },
+        pattern | blackN(some(redN(a, x, some(redN(b, y, c)))), z, d)
+        = [&]{ return RbNode{Red, std::make_shared<RbNode>(Black, *a, *x, *b), *y,
+                             std::make_shared<RbNode>(Black, *c, *z, *d)}; },
+        pattern | blackN(a, x, some(redN(some(redN(b, y, c)), z, d)))
+        = [&]{ return RbNode{Red, std::make_shared<RbNode>(Black, *a, *x, *b), *y,
+                             std::make_shared<RbNode>(Black, *c, *z, *d)}; },
+        pattern | blackN(a, x, some(redN(b, y, some(redN(c, z, d)))))
+        = [&]{ return RbNode{Red, std::make_shared<RbNode>(Black, *a, *x, *b), *y,
+                             std::make_shared<RbNode>(Black, *c, *z, *d)}; },
+        pattern | self = self
+        // clang-format on
+    );
+  }
+
+  using IntNode = RbNode<int32_t>;
+
+  IntNode makeViolation(int32_t kind, int32_t v)
+  {
+    auto const leaf = std::shared_ptr<IntNode>{};
+    auto const red = [&](std::shared_ptr<IntNode> const &l, int32_t value,
+                         std::shared_ptr<IntNode> const &r)
+    { return std::make_shared<IntNode>(Red, l, value, r); };
+    switch (kind)
+    {
+    case 0: // left-left
+      return IntNode{Black, red(red(leaf, v, leaf), v + 1, leaf), v + 2, leaf};
+    case 1: // left-right
+      return IntNode{Black, red(leaf, v, red(leaf, v + 1, leaf)), v + 2, leaf};
+    case 2: // right-left
+      return IntNode{Black, leaf, v, red(red(leaf, v + 1, leaf), v + 2, leaf)};
+    default: // right-right
+      return IntNode{Black, leaf, v, red(leaf, v + 1, red(leaf, v + 2, leaf))};
+    }
+  }
+
+  void rbTreeBalance(benchmark::State &state)
+  {
+    auto const insertions = state.range(0);
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      for (int64_t i = 0; i < insertions; ++i)
+      {
+        auto node = makeViolation(static_cast<int32_t>(i) & 3,
+                                  static_cast<int32_t>(i));
+        node.balance();
+        benchmark::DoNotOptimize(node);
+      }
+    }
+  }
+} // namespace
+
+// --- graph.cpp, parameterized by transition-stream length ------------
+namespace
+{
+  template <typename T>
+  struct GraphNode
+  {
+    T value;
+    std::vector<GraphNode *> parents;
+  };
+
+  using StrNode = GraphNode<std::string>;
+
+  bool matchDiamond(StrNode const &top)
+  {
+    constexpr auto dsN = dsVia(&StrNode::value, &StrNode::parents);
+    auto const someDsN = [dsN](auto... pats) { return some(dsN(pats...)); };
+    Id<StrNode *> b;
+    return match(top)(
+        pattern | dsN("D", ds(b.at(someDsN("B", ds(someDsN("A", ds())))),
+                              someDsN("C", ds(b)))) = true,
+        pattern | _ = false);
+  }
+
+  void graphTransitions(benchmark::State &state)
+  {
+    auto A = std::make_unique<StrNode>(StrNode{"A", {}});
+    auto B = std::make_unique<StrNode>(StrNode{"B", {A.get()}});
+    auto C = std::make_unique<StrNode>(StrNode{"C", {B.get()}});
+    auto D = std::make_unique<StrNode>(StrNode{"D", {B.get(), C.get()}});
+    auto const length = state.range(0);
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      for (int64_t i = 0; i < length; ++i)
+      {
+        benchmark::DoNotOptimize(matchDiamond(*D));
+      }
+    }
+  }
+} // namespace
+
+BENCHMARK(exprTreeEval)->Arg(6)->Arg(10)->Arg(14);
+BENCHMARK(rbTreeBalance)->Arg(64)->Arg(512)->Arg(4096);
+BENCHMARK(graphTransitions)->Arg(64)->Arg(512)->Arg(4096);
+
+BENCHMARK_MAIN();
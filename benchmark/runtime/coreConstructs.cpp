@@ -0,0 +1,288 @@
+#include "matchit.h"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <variant>
+
+// Each core construct is paired with the hand-written code it competes
+// against — switch, std::visit, manual destructuring — so a run reports
+// the abstraction cost directly instead of an absolute number nobody can
+// interpret.
+
+namespace
+{
+  using namespace matchit;
+
+  int32_t classifyMatch(int32_t v)
+  {
+    return match(v)(pattern | 1 = 10, pattern | 2 = 20, pattern | 3 = 30,
+                    pattern | 4 = 40, pattern | _ = -1);
+  }
+
+  int32_t classifySwitch(int32_t v)
+  {
+    switch (v)
+    {
+    case 1:
+      return 10;
+    case 2:
+      return 20;
+    case 3:
+      return 30;
+    case 4:
+      return 40;
+    default:
+      return -1;
+    }
+  }
+
+  bool isVowelMatch(int32_t c)
+  {
+    return match(c)(pattern | or_('a', 'e', 'i', 'o', 'u') = true,
+                    pattern | _ = false);
+  }
+
+  bool isVowelSwitch(int32_t c)
+  {
+    switch (c)
+    {
+    case 'a':
+    case 'e':
+    case 'i':
+    case 'o':
+    case 'u':
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  int32_t dsPairMatch(std::pair<int32_t, int32_t> const &p)
+  {
+    Id<int32_t> x;
+    Id<int32_t> y;
+    return match(p)(pattern | ds(x, y) = x + y);
+  }
+
+  int32_t dsPairManual(std::pair<int32_t, int32_t> const &p)
+  {
+    auto const &[x, y] = p;
+    return x + y;
+  }
+
+  struct Circle
+  {
+    double radius;
+    // Id rebinding compares for agreement, so bound types need ==.
+    friend bool operator==(Circle const &l, Circle const &r)
+    {
+      return l.radius == r.radius;
+    }
+  };
+  struct Square
+  {
+    double side;
+    friend bool operator==(Square const &l, Square const &r)
+    {
+      return l.side == r.side;
+    }
+  };
+  using Shape = std::variant<Circle, Square>;
+
+  double areaMatch(Shape const &s)
+  {
+    Id<Circle> c;
+    Id<Square> sq;
+    return match(s)(
+        pattern | as<Circle>(c) = [&]
+        { return 3.141592653589793 * (*c).radius * (*c).radius; },
+        pattern | as<Square>(sq) = [&] { return (*sq).side * (*sq).side; });
+  }
+
+  template <typename... Ts>
+  struct Overloaded : Ts...
+  {
+    using Ts::operator()...;
+  };
+  template <typename... Ts>
+  Overloaded(Ts...) -> Overloaded<Ts...>;
+
+  double areaVisit(Shape const &s)
+  {
+    return std::visit(
+        Overloaded{[](Circle const &c)
+                   { return 3.141592653589793 * c.radius * c.radius; },
+                   [](Square const &sq) { return sq.side * sq.side; }},
+        s);
+  }
+
+  int32_t idBindMatch(int32_t v)
+  {
+    Id<int32_t> x;
+    return match(v)(pattern | x = x);
+  }
+
+  int32_t idBindManual(int32_t v) { return v; }
+
+  int32_t oooEndsMatch(std::array<int32_t, 8> const &a)
+  {
+    Id<int32_t> first;
+    Id<int32_t> last;
+    return match(a)(pattern | ds(first, ooo, last) = first + last,
+                    pattern | _ = 0);
+  }
+
+  int32_t oooEndsManual(std::array<int32_t, 8> const &a)
+  {
+    return a.front() + a.back();
+  }
+
+  void literalArmsMatch(benchmark::State &state)
+  {
+    int32_t v = 0;
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(classifyMatch(v & 7));
+      ++v;
+    }
+  }
+
+  void literalArmsSwitch(benchmark::State &state)
+  {
+    int32_t v = 0;
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(classifySwitch(v & 7));
+      ++v;
+    }
+  }
+
+  void orMembershipMatch(benchmark::State &state)
+  {
+    int32_t c = 0;
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(isVowelMatch('a' + (c & 15)));
+      ++c;
+    }
+  }
+
+  void orMembershipSwitch(benchmark::State &state)
+  {
+    int32_t c = 0;
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(isVowelSwitch('a' + (c & 15)));
+      ++c;
+    }
+  }
+
+  void dsDestructureMatch(benchmark::State &state)
+  {
+    auto const p = std::make_pair(int32_t{3}, int32_t{4});
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(dsPairMatch(p));
+    }
+  }
+
+  void dsDestructureManual(benchmark::State &state)
+  {
+    auto const p = std::make_pair(int32_t{3}, int32_t{4});
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(dsPairManual(p));
+    }
+  }
+
+  void variantAsMatch(benchmark::State &state)
+  {
+    auto const shapes =
+        std::array<Shape, 2>{Circle{1.5}, Square{2.5}};
+    std::size_t i = 0;
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(areaMatch(shapes[i & 1]));
+      ++i;
+    }
+  }
+
+  void variantVisit(benchmark::State &state)
+  {
+    auto const shapes =
+        std::array<Shape, 2>{Circle{1.5}, Square{2.5}};
+    std::size_t i = 0;
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(areaVisit(shapes[i & 1]));
+      ++i;
+    }
+  }
+
+  void idBindingMatch(benchmark::State &state)
+  {
+    int32_t v = 0;
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(idBindMatch(v));
+      ++v;
+    }
+  }
+
+  void idBindingManual(benchmark::State &state)
+  {
+    int32_t v = 0;
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(idBindManual(v));
+      ++v;
+    }
+  }
+
+  void oooSubrangeMatch(benchmark::State &state)
+  {
+    auto const a = std::array<int32_t, 8>{1, 2, 3, 4, 5, 6, 7, 8};
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(oooEndsMatch(a));
+    }
+  }
+
+  void oooSubrangeManual(benchmark::State &state)
+  {
+    auto const a = std::array<int32_t, 8>{1, 2, 3, 4, 5, 6, 7, 8};
+    for (auto s : state)
+    {
+      static_cast<void>(s);
+      benchmark::DoNotOptimize(oooEndsManual(a));
+    }
+  }
+
+} // namespace
+
+BENCHMARK(literalArmsMatch);
+BENCHMARK(literalArmsSwitch);
+BENCHMARK(orMembershipMatch);
+BENCHMARK(orMembershipSwitch);
+BENCHMARK(dsDestructureMatch);
+BENCHMARK(dsDestructureManual);
+BENCHMARK(variantAsMatch);
+BENCHMARK(variantVisit);
+BENCHMARK(idBindingMatch);
+BENCHMARK(idBindingManual);
+BENCHMARK(oooSubrangeMatch);
+BENCHMARK(oooSubrangeManual);
+
+BENCHMARK_MAIN();
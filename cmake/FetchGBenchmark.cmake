@@ -0,0 +1,18 @@
+include(FetchContent)
+
+set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+
+FetchContent_Declare(
+    googlebenchmark
+    GIT_REPOSITORY https://github.com/google/benchmark.git
+    GIT_TAG 344117638c8ff7e239044fd0fa7085839fc03021) # v1.8.3
+
+FetchContent_GetProperties(googlebenchmark)
+if(NOT googlebenchmark_POPULATED)
+    FetchContent_Populate(googlebenchmark)
+    add_subdirectory(${googlebenchmark_SOURCE_DIR} ${googlebenchmark_BINARY_DIR}
+                    EXCLUDE_FROM_ALL)
+endif()
+
+message(STATUS "Google Benchmark binaries are present at ${googlebenchmark_BINARY_DIR}")
@@ -2,8 +2,33 @@
 #define MATCHIT_CORE_H
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <new>
 #include <tuple>
+#include <type_traits>
+
+// MATCHIT_FORCE_INLINE collapses the hot matching chain (matchPattern ->
+// PatternTraits::matchPatternImpl -> evaluate_ plus the id walks) into
+// its callers even in -O0/-Og builds, where every hop is otherwise a
+// real call and match-heavy debug binaries crawl. Off by default:
+// optimized builds inline the chain anyway and forced inlining only
+// slows compilation there.
+#if !defined(MATCHIT_FORCE_INLINE)
+#define MATCHIT_FORCE_INLINE 0
+#endif // !defined(MATCHIT_FORCE_INLINE)
+
+#if MATCHIT_FORCE_INLINE
+#if defined(__GNUC__) || defined(__clang__)
+#define MATCHIT_HOT __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define MATCHIT_HOT __forceinline
+#else
+#define MATCHIT_HOT
+#endif
+#else
+#define MATCHIT_HOT
+#endif // MATCHIT_FORCE_INLINE
 
 namespace matchit
 {
@@ -23,10 +48,65 @@ namespace matchit
             using ValueT = Value &&;
         };
 
+        // sentinel for "deduce the result type from the arms".
+        class Deduce;
+
+        template <bool exhaustive, typename RetOverride, typename Value,
+                  typename... Patterns>
+        constexpr decltype(auto) matchPatterns(Value &&value,
+                                               Patterns const &...patterns);
+
+        // Caller-owned bump allocator for binding contexts. Contexts that
+        // materialize large intermediates (ooo subranges over big tuples)
+        // land here instead of on the stack of every call, so a loop reuses
+        // one buffer and deep recursion does not grow its frames by the
+        // context size. Allocation is a pointer bump; each arm releases back
+        // to its mark on completion, so nested matches inside handlers stack
+        // naturally within the same arena.
+        class Arena
+        {
+            unsigned char *mBuffer;
+            std::size_t mCapacity;
+            std::size_t mOffset = 0;
+
+        public:
+            template <std::size_t N>
+            explicit Arena(unsigned char (&buffer)[N]) : mBuffer{buffer}, mCapacity{N}
+            {
+            }
+            Arena(unsigned char *buffer, std::size_t capacity)
+                : mBuffer{buffer}, mCapacity{capacity}
+            {
+            }
+
+            void *allocate(std::size_t size, std::size_t align)
+            {
+                auto const aligned = (mOffset + align - 1) & ~(align - 1);
+                if (aligned + size > mCapacity)
+                {
+                    throw std::bad_alloc{};
+                }
+                mOffset = aligned + size;
+                return mBuffer + aligned;
+            }
+            std::size_t mark() const { return mOffset; }
+            void release(std::size_t marked) { mOffset = marked; }
+        };
+
         template <typename Value, typename... Patterns>
-        constexpr auto matchPatterns(Value &&value, Patterns const &...patterns);
+        decltype(auto) matchPatternsArena(Arena &arena, Value &&value,
+                                          Patterns const &...patterns);
 
-        template <typename Value, bool byRef>
+        template <typename RetOverride, typename Value, typename... Patterns>
+        constexpr auto tryMatchPatterns(Value &&value,
+                                        Patterns const &...patterns);
+
+        // defined alongside the dispatch-selection traits in patterns.h.
+        template <typename RetOverride, typename Value, typename... Patterns>
+        constexpr void reportDispatch();
+
+        template <typename Value, bool byRef, bool exhaustive = false,
+                  typename RetT = Deduce, bool reporting = false>
         class MatchHelper
         {
         private:
@@ -38,30 +118,214 @@ namespace matchit
             template <typename V>
             constexpr explicit MatchHelper(V &&value) : mValue{std::forward<V>(value)} {}
             template <typename... PatternPair>
-            constexpr auto operator()(PatternPair const &...patterns)
+            MATCHIT_HOT constexpr decltype(auto)
+            operator()(PatternPair const &...patterns)
             {
-                return matchPatterns(std::forward<ValueRefT>(mValue), patterns...);
+                if constexpr (reporting)
+                {
+                    reportDispatch<RetT, ValueT, PatternPair...>();
+                }
+                return matchPatterns<exhaustive, RetT>(
+                    std::forward<ValueRefT>(mValue), patterns...);
+            }
+            // dispatch audit: match(v).report()(arms...) matches as usual
+            // but also emits the compile-time DispatchReport warning naming
+            // the strategy this site is given and why the flat paths were
+            // not taken. See reportDispatch in patterns.h.
+            constexpr auto report() &&
+            {
+                return MatchHelper<Value, byRef, exhaustive, RetT, true>{
+                    std::forward<ValueRefT>(mValue)};
             }
         };
 
-        template <typename Value>
+        template <typename Value, bool byRef>
+        class ArenaMatchHelper
+        {
+        private:
+            using ValueT = typename ValueType<Value, byRef>::ValueT;
+            Arena &mArena;
+            ValueT mValue;
+            using ValueRefT = ValueT &&;
+
+        public:
+            template <typename V>
+            explicit ArenaMatchHelper(Arena &arena, V &&value)
+                : mArena{arena}, mValue{std::forward<V>(value)}
+            {
+            }
+            template <typename... PatternPair>
+            decltype(auto) operator()(PatternPair const &...patterns)
+            {
+                return matchPatternsArena(mArena, std::forward<ValueRefT>(mValue),
+                                          patterns...);
+            }
+        };
+
+        // match<Ret>(value) pins the result type: each arm's expression
+        // constructs Ret directly instead of being converted through
+        // std::common_type_t of all the arms.
+        template <typename RetT = Deduce, typename Value>
         constexpr auto match(Value &&value)
         {
-            return MatchHelper<Value, true>{std::forward<Value>(value)};
+            return MatchHelper<Value, true, false, RetT>{
+                std::forward<Value>(value)};
+        }
+
+        template <typename Value>
+        auto match(Arena &arena, Value &&value)
+        {
+            return ArenaMatchHelper<Value, true>{arena, std::forward<Value>(value)};
         }
 
         template <typename First, typename... Values>
+        auto match(Arena &arena, First &&first, Values &&...values)
+        {
+            auto result = std::forward_as_tuple(std::forward<First>(first),
+                                                std::forward<Values>(values)...);
+            return ArenaMatchHelper<decltype(result), false>{
+                arena, std::forward<decltype(result)>(result)};
+        }
+
+        template <typename RetT = Deduce, typename First, typename... Values,
+                  typename std::enable_if<!std::is_same<std::decay_t<First>,
+                                                        Arena>::value>::type * =
+                      nullptr>
         constexpr auto match(First &&first, Values &&...values)
         {
             auto result = std::forward_as_tuple(std::forward<First>(first),
                                                 std::forward<Values>(values)...);
-            return MatchHelper<decltype(result), false>{
+            return MatchHelper<decltype(result), false, false, RetT>{
+                std::forward<decltype(result)>(result)};
+        }
+
+        template <typename Value, bool byRef, typename RetT = Deduce>
+        class TryMatchHelper
+        {
+        private:
+            using ValueT = typename ValueType<Value, byRef>::ValueT;
+            ValueT mValue;
+            using ValueRefT = ValueT &&;
+
+        public:
+            template <typename V>
+            constexpr explicit TryMatchHelper(V &&value)
+                : mValue{std::forward<V>(value)}
+            {
+            }
+            template <typename... PatternPair>
+            constexpr auto operator()(PatternPair const &...patterns)
+            {
+                return tryMatchPatterns<RetT>(std::forward<ValueRefT>(mValue),
+                                              patterns...);
+            }
+        };
+
+        // match that reports a miss as an empty std::optional instead of
+        // throwing, for callers that probe several pattern sets in
+        // sequence. The sentinel-wildcard workaround this replaces both
+        // widens the arms' common type and keeps a live branch the
+        // optimizer cannot discard; here the miss is simply an empty
+        // optional and no exceptional path is emitted at all.
+        template <typename RetT = Deduce, typename Value>
+        constexpr auto tryMatch(Value &&value)
+        {
+            return TryMatchHelper<Value, true, RetT>{std::forward<Value>(value)};
+        }
+
+        template <typename RetT = Deduce, typename First, typename... Values,
+                  typename std::enable_if<!std::is_same<std::decay_t<First>,
+                                                        Arena>::value>::type * =
+                      nullptr>
+        constexpr auto tryMatch(First &&first, Values &&...values)
+        {
+            auto result = std::forward_as_tuple(std::forward<First>(first),
+                                                std::forward<Values>(values)...);
+            return TryMatchHelper<decltype(result), false, RetT>{
+                std::forward<decltype(result)>(result)};
+        }
+
+        // match whose arms are declared to cover every possible value. The
+        // no-arm-matched path becomes unreachable instead of a throw (or a
+        // silent no-op in statement form), so the optimizer can drop the cold
+        // tail and codegen the arms like an exhaustive switch. Coverage is
+        // checked statically for std::variant scrutinees; for everything else
+        // the declaration is trusted and a miss is undefined behavior.
+        template <typename Value>
+        constexpr auto matchExhaustive(Value &&value)
+        {
+            return MatchHelper<Value, true, true>{std::forward<Value>(value)};
+        }
+
+        template <typename First, typename... Values>
+        constexpr auto matchExhaustive(First &&first, Values &&...values)
+        {
+            auto result = std::forward_as_tuple(std::forward<First>(first),
+                                                std::forward<Values>(values)...);
+            return MatchHelper<decltype(result), false, true>{
+                std::forward<decltype(result)>(result)};
+        }
+
+#if defined(__cpp_consteval)
+        // match that must fold at compile time. Applying the arms is an
+        // immediate (consteval) call, so a use whose scrutinee or arms
+        // are not constant expressions is a compile error at the call
+        // site instead of silently emitted runtime code, and the result
+        // is a constant expression callers can static_assert on. The
+        // builder stays constexpr: only the full match expression needs
+        // to fold, and a consteval builder would forbid the helper from
+        // carrying its reference to the scrutinee.
+        template <typename Value, bool byRef, typename RetT = Deduce>
+        class ConstevalMatchHelper
+        {
+        private:
+            using ValueT = typename ValueType<Value, byRef>::ValueT;
+            ValueT mValue;
+            using ValueRefT = ValueT &&;
+
+        public:
+            template <typename V>
+            constexpr explicit ConstevalMatchHelper(V &&value)
+                : mValue{std::forward<V>(value)}
+            {
+            }
+            template <typename... PatternPair>
+            consteval decltype(auto) operator()(PatternPair const &...patterns)
+            {
+                return matchPatterns<false, RetT>(
+                    std::forward<ValueRefT>(mValue), patterns...);
+            }
+        };
+
+        template <typename RetT = Deduce, typename Value>
+        constexpr auto matchConsteval(Value &&value)
+        {
+            return ConstevalMatchHelper<Value, true, RetT>{
+                std::forward<Value>(value)};
+        }
+
+        template <typename RetT = Deduce, typename First, typename... Values,
+                  typename std::enable_if<!std::is_same<std::decay_t<First>,
+                                                        Arena>::value>::type * =
+                      nullptr>
+        constexpr auto matchConsteval(First &&first, Values &&...values)
+        {
+            auto result = std::forward_as_tuple(std::forward<First>(first),
+                                                std::forward<Values>(values)...);
+            return ConstevalMatchHelper<decltype(result), false, RetT>{
                 std::forward<decltype(result)>(result)};
         }
+#endif // defined(__cpp_consteval)
     } // namespace impl
 
     // export symbols
+    using impl::Arena;
     using impl::match;
+#if defined(__cpp_consteval)
+    using impl::matchConsteval;
+#endif // defined(__cpp_consteval)
+    using impl::matchExhaustive;
+    using impl::tryMatch;
 
 } // namespace matchit
 #endif // MATCHIT_CORE_H
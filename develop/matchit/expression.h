@@ -2,6 +2,7 @@
 #define MATCHIT_EXPRESSION_H
 
 #include <type_traits>
+#include <utility>
 
 namespace matchit
 {
@@ -23,17 +24,37 @@ namespace matchit
         template <typename T>
         class Id;
         template <typename T>
+        class SharedId;
+        // Expression nodes capture their operands by value so the resulting
+        // callables own their state and can outlive the statement that built
+        // them (stored in a reusable Matcher, for instance). An Id copy
+        // shares the original's binding block, so evaluation still reads the
+        // current binding.
+        template <typename T>
         constexpr auto expr(Id<T> &id)
         {
-            return nullary([&]
-                           { return *id; });
+            return nullary([id]
+                           { return *const_cast<Id<T> &>(id); });
+        }
+
+        // SharedId copies share the slot, so the same holds for them.
+        template <typename T>
+        constexpr auto expr(SharedId<T> &id)
+        {
+            return nullary([id]
+                           { return *const_cast<SharedId<T> &>(id); });
         }
 
         template <typename T>
         constexpr auto expr(T const &v)
         {
-            return nullary([&]
-                           { return v; });
+            // decay so array operands (string literals) are held as the
+            // pointer they would have evaluated to, not a copied array.
+            std::decay_t<T const &> const value = v;
+            return nullary(
+                [value]() noexcept(
+                    std::is_nothrow_copy_constructible_v<std::decay_t<T const &>>)
+                { return value; });
         }
 
         template <typename T>
@@ -79,6 +100,16 @@ namespace matchit
             }
         };
 
+        template <typename T>
+        class EvalTraits<SharedId<T>>
+        {
+        public:
+            constexpr static decltype(auto) evalImpl(SharedId<T> const &id)
+            {
+                return *const_cast<SharedId<T> &>(id);
+            }
+        };
+
         template <typename Pred>
         class Meet;
 
@@ -110,11 +141,130 @@ namespace matchit
         };
 
         template <typename T, typename... Args>
-        constexpr decltype(auto) evaluate_(T const &t, Args const &...args)
+        MATCHIT_HOT constexpr decltype(auto) evaluate_(T const &t,
+                                                       Args const &...args)
         {
             return EvalTraits<T>::evalImpl(t, args...);
         }
 
+        // Flat expression nodes. Each operator application is one struct —
+        // an operator tag plus operands stored by value — instead of
+        // another capturing-lambda layer, so a chain like x * scale + bias
+        // is a small tree of plain members: evaluation is a single
+        // constexpr recursion the compiler flattens even in lightly
+        // optimized builds, and the nodes own their operands outright, so
+        // a guard expression can safely outlive the statement that built
+        // it. Id operands are copies sharing the original's binding block,
+        // exactly as expr() documents.
+#define MATCHIT_OP_TAG(name, op)                                \
+    struct name                                                 \
+    {                                                           \
+        template <typename L, typename R>                       \
+        constexpr decltype(auto) operator()(L &&l, R &&r) const \
+        {                                                       \
+            return std::forward<L>(l) op std::forward<R>(r);    \
+        }                                                       \
+    };
+
+#define MATCHIT_UN_OP_TAG(name, op)                  \
+    struct name                                      \
+    {                                                \
+        template <typename T>                        \
+        constexpr decltype(auto) operator()(T &&t) const \
+        {                                            \
+            return op std::forward<T>(t);            \
+        }                                            \
+    };
+
+        MATCHIT_UN_OP_TAG(LogicalNot, !)
+        MATCHIT_UN_OP_TAG(Negate, -)
+        MATCHIT_OP_TAG(Plus, +)
+        MATCHIT_OP_TAG(Minus, -)
+        MATCHIT_OP_TAG(Mul, *)
+        MATCHIT_OP_TAG(Div, /)
+        MATCHIT_OP_TAG(Mod, %)
+        MATCHIT_OP_TAG(Less, <)
+        MATCHIT_OP_TAG(LessEqual, <=)
+        MATCHIT_OP_TAG(Equal, ==)
+        MATCHIT_OP_TAG(NotEqual, !=)
+        MATCHIT_OP_TAG(GreaterEqual, >=)
+        MATCHIT_OP_TAG(Greater, >)
+        MATCHIT_OP_TAG(BitXor, ^)
+        class LogicalOr;
+        class LogicalAnd;
+
+#undef MATCHIT_OP_TAG
+#undef MATCHIT_UN_OP_TAG
+
+        template <typename Op, typename T>
+        class UnaryExpr
+        {
+        public:
+            constexpr explicit UnaryExpr(T const &operand) : mOperand{operand} {}
+            template <typename... Args>
+            constexpr decltype(auto) operator()(Args const &...args) const
+            {
+                return Op{}(evaluate_(mOperand, args...));
+            }
+
+        private:
+            T const mOperand;
+        };
+
+        template <typename Op, typename L, typename R>
+        class BinaryExpr
+        {
+        public:
+            constexpr BinaryExpr(L const &lhs, R const &rhs)
+                : mLhs{lhs}, mRhs{rhs} {}
+            template <typename... Args>
+            constexpr decltype(auto) operator()(Args const &...args) const
+            {
+                return Op{}(evaluate_(mLhs, args...), evaluate_(mRhs, args...));
+            }
+
+        private:
+            L const mLhs;
+            R const mRhs;
+        };
+
+        // || and && keep their short-circuit: the right operand is only
+        // evaluated when the left does not decide, so they cannot go
+        // through an operator tag that takes both results.
+        template <typename L, typename R>
+        class BinaryExpr<LogicalOr, L, R>
+        {
+        public:
+            constexpr BinaryExpr(L const &lhs, R const &rhs)
+                : mLhs{lhs}, mRhs{rhs} {}
+            template <typename... Args>
+            constexpr decltype(auto) operator()(Args const &...args) const
+            {
+                return evaluate_(mLhs, args...) || evaluate_(mRhs, args...);
+            }
+
+        private:
+            L const mLhs;
+            R const mRhs;
+        };
+
+        template <typename L, typename R>
+        class BinaryExpr<LogicalAnd, L, R>
+        {
+        public:
+            constexpr BinaryExpr(L const &lhs, R const &rhs)
+                : mLhs{lhs}, mRhs{rhs} {}
+            template <typename... Args>
+            constexpr decltype(auto) operator()(Args const &...args) const
+            {
+                return evaluate_(mLhs, args...) && evaluate_(mRhs, args...);
+            }
+
+        private:
+            L const mLhs;
+            R const mRhs;
+        };
+
         template <typename T>
         class IsNullaryOrId : public std::false_type
         {
@@ -125,6 +275,11 @@ namespace matchit
         {
         };
 
+        template <typename T>
+        class IsNullaryOrId<SharedId<T>> : public std::true_type
+        {
+        };
+
         template <typename T>
         class IsNullaryOrId<Nullary<T>> : public std::true_type
         {
@@ -133,42 +288,68 @@ namespace matchit
         template <typename T>
         constexpr auto isNullaryOrIdV = IsNullaryOrId<std::decay_t<T>>::value;
 
-#define UN_OP_FOR_NULLARY(op)                                               \
+// Under C++20 the expression operators are constrained with concepts
+// instead of enable_if: candidates are discarded before any template
+// instantiation, and a misuse diagnostic names the unsatisfied concept
+// rather than unrolling the SFINAE machinery.
+#if defined(__cpp_concepts)
+        template <typename T>
+        concept NullaryOrIdExpr = isNullaryOrIdV<T>;
+
+#define UN_OP_FOR_NULLARY(op, tag)                 \
+    template <NullaryOrIdExpr T>                   \
+    constexpr auto operator op(T const &t)         \
+    {                                              \
+        return nullary(UnaryExpr<tag, T>{t});      \
+    }
+
+#define BIN_OP_FOR_NULLARY(op, tag)                                           \
+    template <typename T, typename U>                                         \
+        requires(NullaryOrIdExpr<T> || NullaryOrIdExpr<U>)                    \
+    constexpr auto operator op(T const &t, U const &u)                        \
+    {                                                                         \
+        return nullary(                                                       \
+            BinaryExpr<tag, std::decay_t<T>, std::decay_t<U>>{t, u});         \
+    }
+#else
+#define UN_OP_FOR_NULLARY(op, tag)                                          \
     template <typename T, std::enable_if_t<isNullaryOrIdV<T>, bool> = true> \
     constexpr auto operator op(T const &t)                                  \
     {                                                                       \
-        return nullary([&] { return op evaluate_(t); });                         \
+        return nullary(UnaryExpr<tag, T>{t});                               \
     }
 
-#define BIN_OP_FOR_NULLARY(op)                                                 \
+#define BIN_OP_FOR_NULLARY(op, tag)                                            \
     template <typename T, typename U,                                          \
               std::enable_if_t<isNullaryOrIdV<T> || isNullaryOrIdV<U>, bool> = \
                   true>                                                        \
     constexpr auto operator op(T const &t, U const &u)                         \
     {                                                                          \
-        return nullary([&] { return evaluate_(t) op evaluate_(u); });                    \
+        return nullary(                                                        \
+            BinaryExpr<tag, std::decay_t<T>, std::decay_t<U>>{t, u});          \
     }
+#endif // defined(__cpp_concepts)
 
         // ADL will find these operators.
-        UN_OP_FOR_NULLARY(!)
-        UN_OP_FOR_NULLARY(-)
+        UN_OP_FOR_NULLARY(!, LogicalNot)
+        UN_OP_FOR_NULLARY(-, Negate)
 
 #undef UN_OP_FOR_NULLARY
 
-        BIN_OP_FOR_NULLARY(+)
-        BIN_OP_FOR_NULLARY(-)
-        BIN_OP_FOR_NULLARY(*)
-        BIN_OP_FOR_NULLARY(/)
-        BIN_OP_FOR_NULLARY(%)
-        BIN_OP_FOR_NULLARY(<)
-        BIN_OP_FOR_NULLARY(<=)
-        BIN_OP_FOR_NULLARY(==)
-        BIN_OP_FOR_NULLARY(!=)
-        BIN_OP_FOR_NULLARY(>=)
-        BIN_OP_FOR_NULLARY(>)
-        BIN_OP_FOR_NULLARY(||)
-        BIN_OP_FOR_NULLARY(&&)
-        BIN_OP_FOR_NULLARY(^)
+        BIN_OP_FOR_NULLARY(+, Plus)
+        BIN_OP_FOR_NULLARY(-, Minus)
+        BIN_OP_FOR_NULLARY(*, Mul)
+        BIN_OP_FOR_NULLARY(/, Div)
+        BIN_OP_FOR_NULLARY(%, Mod)
+        BIN_OP_FOR_NULLARY(<, Less)
+        BIN_OP_FOR_NULLARY(<=, LessEqual)
+        BIN_OP_FOR_NULLARY(==, Equal)
+        BIN_OP_FOR_NULLARY(!=, NotEqual)
+        BIN_OP_FOR_NULLARY(>=, GreaterEqual)
+        BIN_OP_FOR_NULLARY(>, Greater)
+        BIN_OP_FOR_NULLARY(||, LogicalOr)
+        BIN_OP_FOR_NULLARY(&&, LogicalAnd)
+        BIN_OP_FOR_NULLARY(^, BitXor)
 
 #undef BIN_OP_FOR_NULLARY
 
@@ -198,43 +379,63 @@ namespace matchit
             return meet(std::forward<T>(t));
         }
 
-#define UN_OP_FOR_UNARY(op)                                                     \
+#if defined(__cpp_concepts)
+        template <typename T>
+        concept UnaryOrWildcardExpr = isUnaryOrWildcardV<T>;
+
+#define UN_OP_FOR_UNARY(op, tag)                   \
+    template <UnaryOrWildcardExpr T>               \
+    constexpr auto operator op(T const &t)         \
+    {                                              \
+        return unary(UnaryExpr<tag, T>{t});        \
+    }
+
+#define BIN_OP_FOR_UNARY(op, tag)                                          \
+    template <typename T, typename U>                                      \
+        requires(UnaryOrWildcardExpr<T> || UnaryOrWildcardExpr<U>)         \
+    constexpr auto operator op(T const &t, U const &u)                     \
+    {                                                                      \
+        return unary(                                                      \
+            BinaryExpr<tag, std::decay_t<T>, std::decay_t<U>>{t, u});      \
+    }
+#else
+#define UN_OP_FOR_UNARY(op, tag)                                                \
     template <typename T, std::enable_if_t<isUnaryOrWildcardV<T>, bool> = true> \
     constexpr auto operator op(T const &t)                                      \
     {                                                                           \
-        return unary([&](auto &&arg) constexpr { return op evaluate_(t, arg); });    \
+        return unary(UnaryExpr<tag, T>{t});                                     \
     }
 
-#define BIN_OP_FOR_UNARY(op)                                                   \
+#define BIN_OP_FOR_UNARY(op, tag)                                              \
     template <typename T, typename U,                                          \
               std::enable_if_t<isUnaryOrWildcardV<T> || isUnaryOrWildcardV<U>, \
                                bool> = true>                                   \
     constexpr auto operator op(T const &t, U const &u)                         \
     {                                                                          \
-        return unary([&](auto &&arg) constexpr {                               \
-            return evaluate_(t, arg) op evaluate_(u, arg);                               \
-        });                                                                    \
+        return unary(                                                          \
+            BinaryExpr<tag, std::decay_t<T>, std::decay_t<U>>{t, u});          \
     }
+#endif // defined(__cpp_concepts)
 
-        UN_OP_FOR_UNARY(!)
-        UN_OP_FOR_UNARY(-)
+        UN_OP_FOR_UNARY(!, LogicalNot)
+        UN_OP_FOR_UNARY(-, Negate)
 
 #undef UN_OP_FOR_UNARY
 
-        BIN_OP_FOR_UNARY(+)
-        BIN_OP_FOR_UNARY(-)
-        BIN_OP_FOR_UNARY(*)
-        BIN_OP_FOR_UNARY(/)
-        BIN_OP_FOR_UNARY(%)
-        BIN_OP_FOR_UNARY(<)
-        BIN_OP_FOR_UNARY(<=)
-        BIN_OP_FOR_UNARY(==)
-        BIN_OP_FOR_UNARY(!=)
-        BIN_OP_FOR_UNARY(>=)
-        BIN_OP_FOR_UNARY(>)
-        BIN_OP_FOR_UNARY(||)
-        BIN_OP_FOR_UNARY(&&)
-        BIN_OP_FOR_UNARY(^)
+        BIN_OP_FOR_UNARY(+, Plus)
+        BIN_OP_FOR_UNARY(-, Minus)
+        BIN_OP_FOR_UNARY(*, Mul)
+        BIN_OP_FOR_UNARY(/, Div)
+        BIN_OP_FOR_UNARY(%, Mod)
+        BIN_OP_FOR_UNARY(<, Less)
+        BIN_OP_FOR_UNARY(<=, LessEqual)
+        BIN_OP_FOR_UNARY(==, Equal)
+        BIN_OP_FOR_UNARY(!=, NotEqual)
+        BIN_OP_FOR_UNARY(>=, GreaterEqual)
+        BIN_OP_FOR_UNARY(>, Greater)
+        BIN_OP_FOR_UNARY(||, LogicalOr)
+        BIN_OP_FOR_UNARY(&&, LogicalAnd)
+        BIN_OP_FOR_UNARY(^, BitXor)
 
 #undef BIN_OP_FOR_UNARY
 
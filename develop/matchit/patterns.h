@@ -1,29 +1,369 @@
 #ifndef MATCHIT_PATTERNS_H
 #define MATCHIT_PATTERNS_H
 
+#include <any>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <variant>
+#include <vector>
 
 #if !defined(NO_SCALAR_REFERENCES_USED_IN_PATTERNS)
 #define NO_SCALAR_REFERENCES_USED_IN_PATTERNS 0
 #endif // !defined(NO_SCALAR_REFERENCES_USED_IN_PATTERNS)
 
+#if defined(__has_include)
+#if __has_include(<span>) && __cplusplus > 201703L
+#include <span>
+#define MATCHIT_HAS_SPAN 1
+#endif
+#endif
+#if !defined(MATCHIT_HAS_SPAN)
+#define MATCHIT_HAS_SPAN 0
+#endif // !defined(MATCHIT_HAS_SPAN)
+
+// branch-weight hint for likely()/unlikely() arm annotations; expands to
+// a plain test where the builtin is unavailable.
+#if defined(__GNUC__) || defined(__clang__)
+#define MATCHIT_EXPECT(cond, expected) __builtin_expect(!!(cond), (expected))
+#else
+#define MATCHIT_EXPECT(cond, expected) (!!(cond))
+#endif
+
+// MATCHIT_COMPACT trades peak match speed for code size: each call site
+// drives its arms through a shared type-erased loop instead of an
+// inlined per-arm fold, skipping the flat-dispatch fast paths. For
+// flash-constrained targets where the inlined expansion of a wide match
+// costs kilobytes per call site.
+#if !defined(MATCHIT_COMPACT)
+#define MATCHIT_COMPACT 0
+#endif // !defined(MATCHIT_COMPACT)
+
+// MATCHIT_PROFILE maintains per-call-site counters — invocations,
+// per-arm tries and hits, fall-through misses — in a global registry
+// with a snapshot/dump API (profileSnapshot()/dumpProfile()), telling
+// you which match sites are hot and which arms are tried-and-rejected
+// without attaching a profiler. Counters are relaxed atomics; with the
+// default of 0 everything is compiled out. Sites are keyed by their arm
+// type signature, so two sites with byte-identical arm types share one
+// entry.
+#if !defined(MATCHIT_PROFILE)
+#define MATCHIT_PROFILE 0
+#endif // !defined(MATCHIT_PROFILE)
+
+// MATCHIT_TRACE embeds static tracepoints for live diagnosis: every
+// match fires an event on entry (call-site id, arm count) and another
+// when an arm is selected (call-site id, arm index). Where <sys/sdt.h>
+// is present the events are USDT probes (provider "matchit", probes
+// "match_enter"/"arm_selected") visible to perf and bpftrace without
+// recompiling; a process-wide hook installed via setTraceHooks() fires
+// as well, covering targets without SDT. With the default of 0
+// everything is compiled out.
+#if !defined(MATCHIT_TRACE)
+#define MATCHIT_TRACE 0
+#endif // !defined(MATCHIT_TRACE)
+
+#if MATCHIT_TRACE
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define MATCHIT_HAS_SDT 1
+#endif
+#endif
+#if !defined(MATCHIT_HAS_SDT)
+#define MATCHIT_HAS_SDT 0
+#endif // !defined(MATCHIT_HAS_SDT)
+#endif // MATCHIT_TRACE
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MATCHIT_COLD __attribute__((cold, noinline))
+#else
+#define MATCHIT_COLD
+#endif
+
 namespace matchit
 {
     namespace impl
     {
+        // single cold stub for the no-arm-matched error: every call site
+        // shares one outlined throw (and its terminate tail) instead of
+        // emitting its own.
+        [[noreturn]] MATCHIT_COLD inline void throwNoMatch()
+        {
+            throw std::logic_error{"Error: no patterns got matched!"};
+        }
+
+#if MATCHIT_PROFILE
+        // Profile-mode counters for one match call site. The counter
+        // storage lives in function-local statics of siteStatsFor, so a
+        // site registers itself on first execution: registration is a CAS
+        // push onto an intrusive lock-free list — sites have static
+        // storage and are never unregistered, so no lock and no ownership
+        // bookkeeping are needed. All counting is relaxed: the numbers are
+        // diagnostics, not synchronization.
+        class SiteStats
+        {
+        public:
+            SiteStats(char const *site, std::size_t armCount,
+                      std::atomic<std::uint64_t> *tries,
+                      std::atomic<std::uint64_t> *hits)
+                : mSite{site}, mArmCount{armCount}, mTries{tries}, mHits{hits}
+            {
+                auto &head = registryHead();
+                mNext = head.load(std::memory_order_relaxed);
+                while (!head.compare_exchange_weak(mNext, this,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed))
+                {
+                }
+            }
+
+            void recordInvocation()
+            {
+                mInvocations.fetch_add(1, std::memory_order_relaxed);
+            }
+            void recordTry(std::size_t arm, bool hit)
+            {
+                mTries[arm].fetch_add(1, std::memory_order_relaxed);
+                if (hit)
+                {
+                    mHits[arm].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            void recordMiss()
+            {
+                mMisses.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            char const *site() const { return mSite; }
+            std::size_t armCount() const { return mArmCount; }
+            std::uint64_t invocations() const
+            {
+                return mInvocations.load(std::memory_order_relaxed);
+            }
+            std::uint64_t misses() const
+            {
+                return mMisses.load(std::memory_order_relaxed);
+            }
+            std::uint64_t tries(std::size_t arm) const
+            {
+                return mTries[arm].load(std::memory_order_relaxed);
+            }
+            std::uint64_t hits(std::size_t arm) const
+            {
+                return mHits[arm].load(std::memory_order_relaxed);
+            }
+            SiteStats const *next() const { return mNext; }
+
+            static std::atomic<SiteStats *> &registryHead()
+            {
+                static std::atomic<SiteStats *> head{nullptr};
+                return head;
+            }
+
+        private:
+            char const *mSite;
+            std::size_t mArmCount;
+            std::atomic<std::uint64_t> *mTries;
+            std::atomic<std::uint64_t> *mHits;
+            std::atomic<std::uint64_t> mInvocations{};
+            std::atomic<std::uint64_t> mMisses{};
+            SiteStats *mNext{};
+        };
+
+        template <typename... PatternPairs>
+        inline SiteStats &siteStatsFor()
+        {
+            static std::array<std::atomic<std::uint64_t>,
+                              sizeof...(PatternPairs)>
+                tries{};
+            static std::array<std::atomic<std::uint64_t>,
+                              sizeof...(PatternPairs)>
+                hits{};
+#if defined(__GNUC__) || defined(__clang__)
+            static SiteStats stats{__PRETTY_FUNCTION__,
+                                   sizeof...(PatternPairs), tries.data(),
+                                   hits.data()};
+#elif defined(_MSC_VER)
+            static SiteStats stats{__FUNCSIG__, sizeof...(PatternPairs),
+                                   tries.data(), hits.data()};
+#else
+            static SiteStats stats{"match site", sizeof...(PatternPairs),
+                                   tries.data(), hits.data()};
+#endif
+            return stats;
+        }
+
+        // constexpr-safe wrappers: during constant evaluation stats is
+        // null and no counter is touched.
+        template <typename Try>
+        constexpr bool profiledArmTry(SiteStats *stats, std::size_t &arm,
+                                      Try const &tryArm)
+        {
+            auto const index = arm++;
+            bool const hit = tryArm();
+            if (stats != nullptr)
+            {
+                stats->recordTry(index, hit);
+            }
+            return hit;
+        }
+
+        constexpr void profiledMiss(SiteStats *stats)
+        {
+            if (stats != nullptr)
+            {
+                stats->recordMiss();
+            }
+        }
+
+        struct SiteProfileSnapshot
+        {
+            char const *site;
+            std::uint64_t invocations;
+            std::uint64_t misses;
+            std::vector<std::uint64_t> tries;
+            std::vector<std::uint64_t> hits;
+        };
+
+        inline std::vector<SiteProfileSnapshot> profileSnapshot()
+        {
+            auto result = std::vector<SiteProfileSnapshot>{};
+            for (auto const *s = SiteStats::registryHead().load(
+                     std::memory_order_acquire);
+                 s != nullptr; s = s->next())
+            {
+                auto snapshot = SiteProfileSnapshot{
+                    s->site(), s->invocations(), s->misses(), {}, {}};
+                for (std::size_t arm = 0; arm < s->armCount(); ++arm)
+                {
+                    snapshot.tries.push_back(s->tries(arm));
+                    snapshot.hits.push_back(s->hits(arm));
+                }
+                result.push_back(std::move(snapshot));
+            }
+            return result;
+        }
+
+        template <typename Stream>
+        void dumpProfile(Stream &os)
+        {
+            for (auto const &site : profileSnapshot())
+            {
+                os << site.site << "\n  invocations " << site.invocations
+                   << ", misses " << site.misses << "\n";
+                for (std::size_t arm = 0; arm < site.tries.size(); ++arm)
+                {
+                    os << "  arm " << arm << ": tries " << site.tries[arm]
+                       << ", hits " << site.hits[arm] << "\n";
+                }
+            }
+        }
+#endif // MATCHIT_PROFILE
+
+#if MATCHIT_TRACE
+        // Trace-mode hooks: process-wide function pointers fired on match
+        // entry and on the selected arm, alongside the USDT probes when
+        // <sys/sdt.h> is present. Stored as relaxed atomics so installing
+        // from one thread is safe against concurrent matches; null hooks
+        // cost one load and a predictable branch per event.
+        using TraceHook = void (*)(char const *site, std::size_t);
+
+        inline std::atomic<TraceHook> &matchEnterHook()
+        {
+            static std::atomic<TraceHook> hook{nullptr};
+            return hook;
+        }
+
+        inline std::atomic<TraceHook> &armSelectedHook()
+        {
+            static std::atomic<TraceHook> hook{nullptr};
+            return hook;
+        }
+
+        // Install the hooks; either may be nullptr. matchEnter receives
+        // the call-site id and the arm count, armSelected the call-site id
+        // and the zero-based index of the arm that matched.
+        inline void setTraceHooks(TraceHook matchEnter, TraceHook armSelected)
+        {
+            matchEnterHook().store(matchEnter, std::memory_order_relaxed);
+            armSelectedHook().store(armSelected, std::memory_order_relaxed);
+        }
+
+        // Call-site id for trace events: the instantiated signature names
+        // the site by its arm types, the same keying as the profile
+        // registry, so trace and profile output correlate directly.
+        template <typename... PatternPairs>
+        inline char const *traceSiteName()
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __PRETTY_FUNCTION__;
+#elif defined(_MSC_VER)
+            return __FUNCSIG__;
+#else
+            return "match site";
+#endif
+        }
+
+        inline void traceMatchEnter(char const *site, std::size_t armCount)
+        {
+#if MATCHIT_HAS_SDT
+            DTRACE_PROBE2(matchit, match_enter, site, armCount);
+#endif
+            if (auto const hook =
+                    matchEnterHook().load(std::memory_order_relaxed))
+            {
+                hook(site, armCount);
+            }
+        }
+
+        inline void traceArmSelected(char const *site, std::size_t armIndex)
+        {
+#if MATCHIT_HAS_SDT
+            DTRACE_PROBE2(matchit, arm_selected, site, armIndex);
+#endif
+            if (auto const hook =
+                    armSelectedHook().load(std::memory_order_relaxed))
+            {
+                hook(site, armIndex);
+            }
+        }
+
+        // constexpr-safe wrapper: during constant evaluation site is null
+        // and no event fires.
+        template <typename Try>
+        constexpr bool tracedArmTry(char const *site, std::size_t &arm,
+                                    Try const &tryArm)
+        {
+            auto const index = arm++;
+            bool const hit = tryArm();
+            if (hit && site != nullptr)
+            {
+                traceArmSelected(site, index);
+            }
+            return hit;
+        }
+#endif // MATCHIT_TRACE
+
         template <typename I, typename S = I>
         class Subrange
         {
-            I mBegin;
-            S mEnd;
+            I mBegin{};
+            S mEnd{};
 
         public:
+            constexpr Subrange() = default;
+
             constexpr Subrange(I const begin, S const end) : mBegin{begin}, mEnd{end} {}
 
             constexpr Subrange(Subrange const &other)
@@ -42,6 +382,30 @@ namespace matchit
             }
             auto begin() const { return mBegin; }
             auto end() const { return mEnd; }
+
+            // contiguous slices (pointer iterators) additionally model a
+            // span: direct element access and a raw pointer for bulk
+            // operations on the underlying buffer.
+            template <typename P = I,
+                      typename = std::enable_if_t<std::is_pointer_v<P>>>
+            constexpr auto data() const
+            {
+                return mBegin;
+            }
+            template <typename P = I,
+                      typename = std::enable_if_t<std::is_pointer_v<P>>>
+            constexpr decltype(auto) operator[](size_t const index) const
+            {
+                return mBegin[index];
+            }
+#if MATCHIT_HAS_SPAN
+            template <typename P = I,
+                      typename = std::enable_if_t<std::is_pointer_v<P>>>
+            constexpr operator std::span<std::remove_pointer_t<P>>() const
+            {
+                return {mBegin, size()};
+            }
+#endif
         };
 
         template <typename I, typename S>
@@ -50,6 +414,57 @@ namespace matchit
             return Subrange<I, S>{begin, end};
         }
 
+        // Single-pass adapter: wraps an input iterator/sentinel pair so ds
+        // patterns can destructure a stream (socket reader, decompressor,
+        // istream_iterator, ...) without materializing it first. Matching
+        // consumes the stream as it proceeds, so only one ds arm can inspect
+        // a given stream; follow it with a wildcard arm for the miss case.
+        template <typename I, typename S = I>
+        class Streamed
+        {
+            I mBegin;
+            S mEnd;
+
+        public:
+            using value_type =
+                std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<I &>())>>;
+
+            Streamed(I begin, S end) : mBegin{std::move(begin)}, mEnd{std::move(end)} {}
+
+            bool done() const { return !(mBegin != mEnd); }
+            value_type next()
+            {
+                value_type v = *mBegin;
+                ++mBegin;
+                return v;
+            }
+        };
+
+        template <typename I, typename S>
+        auto streamed(I begin, S end)
+        {
+            return Streamed<I, S>{std::move(begin), std::move(end)};
+        }
+
+        template <typename Range>
+        auto streamed(Range &&range)
+        {
+            return streamed(std::begin(range), std::end(range));
+        }
+
+        template <typename T>
+        struct IsStreamed : std::false_type
+        {
+        };
+
+        template <typename I, typename S>
+        struct IsStreamed<Streamed<I, S>> : std::true_type
+        {
+        };
+
+        template <typename T>
+        constexpr auto isStreamedV = IsStreamed<std::decay_t<T>>::value;
+
         template <typename RangeType>
         class IterUnderlyingType
         {
@@ -82,12 +497,69 @@ namespace matchit
         using SubrangeT = Subrange<typename IterUnderlyingType<RangeType>::beginT,
                                    typename IterUnderlyingType<RangeType>::endT>;
 
+        // element types whose value equality is representation equality, so
+        // comparing slices of them can be a single memcmp. Floating point is
+        // excluded (NaN, signed zero); padded types are excluded by the
+        // unique-object-representations check.
+        template <typename T>
+        constexpr auto bitwiseEqualityV =
+            (std::is_integral_v<T> || std::is_enum_v<T>)&&std::
+                has_unique_object_representations_v<T>;
+
         template <typename I, typename S>
         bool operator==(Subrange<I, S> const &lhs, Subrange<I, S> const &rhs)
         {
             using std::operator==;
-            return lhs.size() == rhs.size() &&
-                   std::equal(lhs.begin(), lhs.end(), rhs.begin());
+            if constexpr (std::is_pointer_v<I> &&
+                          bitwiseEqualityV<std::remove_cv_t<
+                              std::remove_pointer_t<I>>>)
+            {
+                using Elem = std::remove_pointer_t<I>;
+                return lhs.size() == rhs.size() &&
+                       std::memcmp(lhs.data(), rhs.data(),
+                                   lhs.size() * sizeof(Elem)) == 0;
+            }
+            else
+            {
+                return lhs.size() == rhs.size() &&
+                       std::equal(lhs.begin(), lhs.end(), rhs.begin());
+            }
+        }
+
+        template <typename T>
+        struct IsSubrange : std::false_type
+        {
+        };
+
+        template <typename I, typename S>
+        struct IsSubrange<Subrange<I, S>> : std::true_type
+        {
+        };
+
+        // equality against any other contiguous range of the same
+        // byte-comparable element type (vector, array, span, ...), again as
+        // one bulk compare.
+        template <typename I, typename S, typename Range,
+                  typename = std::enable_if_t<
+                      std::is_pointer_v<I> && !IsSubrange<Range>::value &&
+                      std::is_same_v<std::remove_cv_t<std::remove_pointer_t<
+                                         decltype(std::declval<Range const &>()
+                                                      .data())>>,
+                                     std::remove_cv_t<std::remove_pointer_t<I>>>>>
+        bool operator==(Subrange<I, S> const &lhs, Range const &rhs)
+        {
+            using Elem = std::remove_cv_t<std::remove_pointer_t<I>>;
+            if constexpr (bitwiseEqualityV<Elem>)
+            {
+                return lhs.size() == rhs.size() &&
+                       std::memcmp(lhs.data(), rhs.data(),
+                                   lhs.size() * sizeof(Elem)) == 0;
+            }
+            else
+            {
+                return lhs.size() == rhs.size() &&
+                       std::equal(lhs.begin(), lhs.end(), rhs.begin());
+            }
         }
 
         template <typename K1, typename V1, typename K2, typename V2>
@@ -96,48 +568,65 @@ namespace matchit
             return t.first == u.first && t.second == u.second;
         }
 
+        // Deduplication keeps the last occurrence of each type, computed
+        // without the old per-element recursion (which instantiated a fresh
+        // class per suffix and went quadratic on wide ds patterns): one row
+        // of is_same comparisons per element feeds a constexpr mask, and a
+        // single tuple_cat assembles the survivors.
         template <typename T, typename... Ts>
-        class WithinTypes
+        constexpr std::array<bool, sizeof...(Ts)> sameTypeRow()
         {
-        public:
-            constexpr static auto value = (std::is_same_v<T, Ts> || ...);
-        };
+            return {{std::is_same_v<T, Ts>...}};
+        }
+
+        template <typename... Ts>
+        constexpr auto lastOccurrenceMask()
+        {
+            constexpr auto size = sizeof...(Ts);
+            std::array<std::array<bool, size>, size> const same{
+                {sameTypeRow<Ts, Ts...>()...}};
+            std::array<bool, size> keep{};
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                keep[i] = true;
+                for (std::size_t j = i + 1; j < size; ++j)
+                {
+                    if (same[i][j])
+                    {
+                        keep[i] = false;
+                    }
+                }
+            }
+            return keep;
+        }
 
-        template <typename T, typename Tuple>
-        class PrependUnique;
+        template <typename Tuple, typename Indices>
+        class UniqueImpl;
 
-        template <typename T, typename... Ts>
-        class PrependUnique<T, std::tuple<Ts...>>
+        template <typename... Ts, std::size_t... I>
+        class UniqueImpl<std::tuple<Ts...>, std::index_sequence<I...>>
         {
-            constexpr static auto unique = !WithinTypes<T, Ts...>::value;
+            constexpr static auto kept = lastOccurrenceMask<Ts...>();
 
         public:
-            using type =
-                std::conditional_t<unique, std::tuple<T, Ts...>, std::tuple<Ts...>>;
+            using type = decltype(std::tuple_cat(
+                std::declval<
+                    std::conditional_t<kept[I], std::tuple<Ts>, std::tuple<>>>()...));
         };
 
-        template <typename T, typename Tuple>
-        using PrependUniqueT = typename PrependUnique<T, Tuple>::type;
-
         template <typename Tuple>
         class Unique;
 
         template <typename... Ts>
-        using UniqueT = typename Unique<std::tuple<Ts...>>::type;
-
-        template <>
-        class Unique<std::tuple<>>
+        class Unique<std::tuple<Ts...>>
         {
         public:
-            using type = std::tuple<>;
+            using type = typename UniqueImpl<std::tuple<Ts...>,
+                                             std::index_sequence_for<Ts...>>::type;
         };
 
-        template <typename T, typename... Ts>
-        class Unique<std::tuple<T, Ts...>>
-        {
-        public:
-            using type = PrependUniqueT<T, UniqueT<Ts...>>;
-        };
+        template <typename... Ts>
+        using UniqueT = typename Unique<std::tuple<Ts...>>::type;
 
         static_assert(
             std::is_same_v<std::tuple<int32_t>, UniqueT<int32_t, int32_t>>);
@@ -191,7 +680,7 @@ namespace matchit
 
         // as constexpr
         template <class F, class... Args>
-        constexpr std::invoke_result_t<F, Args...>
+        MATCHIT_HOT constexpr std::invoke_result_t<F, Args...>
         invoke_(F &&f,
                 Args &&...args) noexcept(std::is_nothrow_invocable_v<F, Args...>)
         {
@@ -237,11 +726,48 @@ namespace matchit
         template <typename Pattern>
         class PatternTraits;
 
+        // When every arm returns an lvalue reference to the same type the
+        // match preserves the reference instead of copying the referee out;
+        // mixing T& and T const& arms yields T const&. Everything else keeps
+        // the decaying common-type result.
+        template <typename T, typename... Ts>
+        class RefRetType
+        {
+        public:
+            constexpr static bool applicable =
+                std::is_lvalue_reference_v<T> &&
+                ((std::is_lvalue_reference_v<Ts> &&
+                  std::is_same_v<std::decay_t<T>, std::decay_t<Ts>>)&&...);
+            constexpr static bool anyConst =
+                std::is_const_v<std::remove_reference_t<T>> ||
+                (std::is_const_v<std::remove_reference_t<Ts>> || ... || false);
+        };
+
         template <typename... PatternPairs>
         class PatternPairsRetType
         {
+            using RefInfo = RefRetType<typename PatternPairs::RetType...>;
+            // two-step select so the reference type is only formed when the
+            // arms actually all return references (RetType may be void).
+            template <bool preserveRef, typename = void>
+            struct Select
+            {
+                using type =
+                    std::common_type_t<typename PatternPairs::RetType...>;
+            };
+            template <typename Dummy>
+            struct Select<true, Dummy>
+            {
+                using First = std::tuple_element_t<
+                    0, std::tuple<typename PatternPairs::RetType...>>;
+                using type =
+                    std::conditional_t<RefInfo::anyConst,
+                                       std::decay_t<First> const &,
+                                       std::decay_t<First> &>;
+            };
+
         public:
-            using RetType = std::common_type_t<typename PatternPairs::RetType...>;
+            using RetType = typename Select<RefInfo::applicable>::type;
         };
 
         enum class IdProcess : int32_t
@@ -250,11 +776,28 @@ namespace matchit
             kCONFIRM
         };
 
+        // Confirm/cancel walks only exist to update Id bindings, so subtrees
+        // whose static Id count is zero are pruned here instead of being
+        // walked to run no-op processIdImpl leaves. An arm without any Id
+        // does no cancel work at all on failure.
         template <typename Pattern>
-        constexpr void processId(Pattern const &pattern, int32_t depth,
-                                 IdProcess idProcess)
+        MATCHIT_HOT constexpr void processId(Pattern const &pattern,
+                                             int32_t depth,
+                                             IdProcess idProcess)
+            noexcept(PatternTraits<Pattern>::nbIdV == 0 ||
+                     noexcept(PatternTraits<Pattern>::processIdImpl(
+                         pattern, depth, idProcess)))
         {
-            PatternTraits<Pattern>::processIdImpl(pattern, depth, idProcess);
+            if constexpr (PatternTraits<Pattern>::nbIdV != 0)
+            {
+                PatternTraits<Pattern>::processIdImpl(pattern, depth, idProcess);
+            }
+            else
+            {
+                static_cast<void>(pattern);
+                static_cast<void>(depth);
+                static_cast<void>(idProcess);
+            }
         }
 
         template <typename Tuple>
@@ -285,12 +828,52 @@ namespace matchit
                 mMemHolder[mSize] = std::forward<T>(t);
                 ++mSize;
             }
-            constexpr auto back() -> ElementT & { return mMemHolder[mSize - 1]; }
+            template <typename T>
+            constexpr auto backAs() -> T &
+            {
+                return std::get<T>(mMemHolder[mSize - 1]);
+            }
+            // rewind protocol for paths that retry matching within one
+            // pass (the subsequence sliding window): the slots are sized
+            // for a single pass, so a failed try releases back to its
+            // mark and the next try reuses them.
+            constexpr auto mark() const { return mSize; }
+            constexpr void release(size_t marked) { mSize = marked; }
         };
 
         template <>
         class Context<>
         {
+        public:
+            constexpr std::size_t mark() const { return 0; }
+            constexpr void release(std::size_t) {}
+        };
+
+        // Context for matches whose materialized intermediates all share one
+        // type (a single ooo subrange type, or repeated applications of the
+        // same unary): a plain array of that type, with no variant
+        // discriminant written on every store and none checked on access.
+        template <typename T, std::size_t N>
+        class MonoContext
+        {
+            std::array<T, N> mMemHolder{};
+            size_t mSize = 0;
+
+        public:
+            template <typename U>
+            constexpr void emplace_back(U &&u)
+            {
+                mMemHolder[mSize] = std::forward<U>(u);
+                ++mSize;
+            }
+            template <typename U>
+            constexpr auto backAs() -> T &
+            {
+                static_assert(std::is_same_v<U, T>);
+                return mMemHolder[mSize - 1];
+            }
+            constexpr auto mark() const { return mSize; }
+            constexpr void release(size_t marked) { mSize = marked; }
         };
 
         template <typename T>
@@ -298,14 +881,42 @@ namespace matchit
 
         template <typename... Ts>
         class ContextTrait<std::tuple<Ts...>>
+        {
+            template <typename Uniq>
+            struct Select
+            {
+                using type = Context<Ts...>;
+            };
+            template <typename T>
+            struct Select<std::tuple<T>>
+            {
+                using type =
+                    std::conditional_t<std::is_default_constructible_v<T> &&
+                                           std::is_move_assignable_v<T>,
+                                       MonoContext<T, sizeof...(Ts)>,
+                                       Context<Ts...>>;
+            };
+
+        public:
+            using ContextT = typename Select<UniqueT<Ts...>>::type;
+        };
+
+        template <>
+        class ContextTrait<std::tuple<>>
         {
         public:
-            using ContextT = Context<Ts...>;
+            using ContextT = Context<>;
         };
 
         template <typename Value, typename Pattern, typename ConctextT>
-        constexpr auto matchPattern(Value &&value, Pattern const &pattern,
-                                    int32_t depth, ConctextT &context)
+        MATCHIT_HOT constexpr auto matchPattern(Value &&value,
+                                                Pattern const &pattern,
+                                                int32_t depth,
+                                                ConctextT &context)
+            noexcept(noexcept(PatternTraits<Pattern>::matchPatternImpl(
+                         std::forward<Value>(value), pattern, depth,
+                         context)) &&
+                     noexcept(processId(pattern, depth, IdProcess::kCONFIRM)))
         {
             auto const result = PatternTraits<Pattern>::matchPatternImpl(
                 std::forward<Value>(value), pattern, depth, context);
@@ -314,6 +925,14 @@ namespace matchit
             return result;
         }
 
+        // true when matching Pattern against Value — including the id
+        // bookkeeping walk — is declared nothrow, so composite traits can
+        // fold the property over their subpatterns.
+        template <typename Pattern, typename Value, typename ContextT>
+        constexpr auto isNothrowMatchV = noexcept(
+            matchPattern(std::declval<Value>(), std::declval<Pattern const &>(),
+                         0, std::declval<ContextT &>()));
+
         template <typename Pattern, typename Func>
         class PatternPair
         {
@@ -324,12 +943,28 @@ namespace matchit
             constexpr PatternPair(Pattern const &pattern, Func const &func)
                 : mPattern{pattern}, mHandler{func} {}
             template <typename Value, typename ContextT>
-            constexpr bool matchValue(Value &&value, ContextT &context) const
+            MATCHIT_HOT constexpr bool matchValue(Value &&value,
+                                                  ContextT &context) const
+                noexcept(noexcept(matchPattern(std::forward<Value>(value),
+                                               mPattern, 0, context)))
             {
                 return matchPattern(std::forward<Value>(value), mPattern, /*depth*/ 0,
                                     context);
             }
-            constexpr auto execute() const { return mHandler(); }
+            MATCHIT_HOT constexpr decltype(auto) execute() const
+                noexcept(noexcept(mHandler()))
+            {
+                return mHandler();
+            }
+            constexpr auto const &pattern() const { return mPattern; }
+            // rebuild this arm around a different pattern, keeping the
+            // handler; used when a projection shared by every arm is hoisted
+            // out of the arms.
+            template <typename NewPattern>
+            constexpr auto withPattern(NewPattern const &newPattern) const
+            {
+                return PatternPair<NewPattern, Func>{newPattern, mHandler};
+            }
 
         private:
             Pattern const mPattern;
@@ -352,24 +987,71 @@ namespace matchit
             auto p = toNullary(pred);
             return When<decltype(p)>{p};
         }
-        
-        template <typename Pattern>
-        class PatternHelper
+
+        // Branch-weight annotation: pattern | p | likely() tells the
+        // compiler the arm's test is expected to succeed (unlikely() the
+        // opposite), so the hot handler is laid out on the fall-through
+        // path. Purely a codegen hint — match semantics are untouched.
+        template <typename Pattern, bool expected>
+        class Expected
         {
         public:
-            constexpr explicit PatternHelper(Pattern const &pattern)
+            constexpr explicit Expected(Pattern const &pattern)
                 : mPattern{pattern} {}
-            template <typename Func>
-            constexpr auto operator=(Func &&func)
-            {
-                auto f = toNullary(func);
-                return PatternPair<Pattern, decltype(f)>{mPattern, f};
-            }
-            template <typename Pred>
-            constexpr auto operator|(When<Pred> const &w)
-            {
-                return PatternHelper<PostCheck<Pattern, Pred>>(
-                    PostCheck(mPattern, w.mPred));
+            constexpr auto const &pattern() const { return mPattern; }
+
+        private:
+            Pattern const mPattern;
+        };
+
+        class LikelyTag
+        {
+        };
+        class UnlikelyTag
+        {
+        };
+
+        constexpr auto likely() { return LikelyTag{}; }
+        constexpr auto unlikely() { return UnlikelyTag{}; }
+
+        // Structural canonicalization applied once per arm, when
+        // `pattern | p = handler` assembles the PatternPair. Defined after
+        // the composite patterns below; declared here so arm assembly can
+        // name it.
+        template <typename Pattern, typename = void>
+        class CanonicalTraits;
+
+        template <typename Pattern>
+        constexpr decltype(auto) canonicalize(Pattern const &pattern);
+
+        template <typename Pattern>
+        class PatternHelper
+        {
+        public:
+            constexpr explicit PatternHelper(Pattern const &pattern)
+                : mPattern{pattern} {}
+            template <typename Func>
+            constexpr auto operator=(Func &&func)
+            {
+                auto f = toNullary(func);
+                auto const p = canonicalize(mPattern);
+                return PatternPair<std::decay_t<decltype(p)>, decltype(f)>{p, f};
+            }
+            template <typename Pred>
+            constexpr auto operator|(When<Pred> const &w)
+            {
+                return PatternHelper<PostCheck<Pattern, Pred>>(
+                    PostCheck(mPattern, w.mPred));
+            }
+            constexpr auto operator|(LikelyTag)
+            {
+                return PatternHelper<Expected<Pattern, true>>(
+                    Expected<Pattern, true>(mPattern));
+            }
+            constexpr auto operator|(UnlikelyTag)
+            {
+                return PatternHelper<Expected<Pattern, false>>(
+                    Expected<Pattern, false>(mPattern));
             }
 
         private:
@@ -419,14 +1101,15 @@ namespace matchit
             constexpr static auto nbIdV = 0;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value, Pattern const &pattern,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value, Pattern const &pattern,
                                                    int32_t /* depth */,
                                                    ContextT & /*context*/)
+                noexcept(noexcept(pattern == std::forward<Value>(value)))
             {
                 return pattern == std::forward<Value>(value);
             }
-            constexpr static void processIdImpl(Pattern const &, int32_t /*depth*/,
-                                                IdProcess) {}
+            MATCHIT_HOT constexpr static void processIdImpl(Pattern const &, int32_t /*depth*/,
+                                                IdProcess) noexcept {}
         };
 
         class Wildcard
@@ -447,13 +1130,13 @@ namespace matchit
             constexpr static auto nbIdV = 0;
 
             template <typename Value, typename ContextT>
-            constexpr static bool matchPatternImpl(Value &&, Pattern const &, int32_t,
-                                                   ContextT &)
+            MATCHIT_HOT constexpr static bool matchPatternImpl(Value &&, Pattern const &, int32_t,
+                                                   ContextT &) noexcept
             {
                 return true;
             }
-            constexpr static void processIdImpl(Pattern const &, int32_t /*depth*/,
-                                                IdProcess) {}
+            MATCHIT_HOT constexpr static void processIdImpl(Pattern const &, int32_t /*depth*/,
+                                                IdProcess) noexcept {}
         };
 
         template <typename... Patterns>
@@ -484,22 +1167,50 @@ namespace matchit
             constexpr static auto nbIdV = (PatternTraits<Patterns>::nbIdV + ... + 0);
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    Or<Patterns...> const &orPat,
                                                    int32_t depth, ContextT &context)
+                noexcept((isNothrowMatchV<InternalPatternT<Patterns>, Value,
+                                          ContextT> &&
+                          ...))
             {
-                constexpr auto patSize = sizeof...(Patterns);
-                return std::apply(
-                           [&value, depth, &context](auto const &...patterns)
-                           {
-                               return (matchPattern(value, patterns, depth + 1, context) ||
-                                       ...);
-                           },
-                           take<patSize - 1>(orPat.patterns())) ||
-                       matchPattern(std::forward<Value>(value),
-                                    get<patSize - 1>(orPat.patterns()), depth + 1, context);
-            }
-            constexpr static void processIdImpl(Or<Patterns...> const &orPat,
+                // Rollback across alternatives is already delta-scoped by the
+                // depth protocol: alternatives run at depth + 1, so a failing
+                // alternative only resets blocks bound at that depth or
+                // deeper, and bindings made before the or_ (outer at()/ds
+                // bindings the alternatives agree with) are compared against,
+                // not re-bound. No separate undo log is needed.
+                // or_ over plain literals is a membership test: compare
+                // against the stored alternatives directly instead of going
+                // through matchPattern/processId per alternative (both no-ops
+                // for literals). The flat fold over the contiguous tuple is
+                // what compilers turn into bit tests or vectorized compares;
+                // a sorted array buys nothing at these alternative counts.
+                if constexpr (((std::is_arithmetic_v<Patterns> ||
+                                std::is_enum_v<Patterns>)&&...))
+                {
+                    static_cast<void>(depth);
+                    static_cast<void>(context);
+                    return std::apply(
+                        [&value](auto const &...patterns)
+                        { return ((patterns == value) || ...); },
+                        orPat.patterns());
+                }
+                else
+                {
+                    constexpr auto patSize = sizeof...(Patterns);
+                    return std::apply(
+                               [&value, depth, &context](auto const &...patterns)
+                               {
+                                   return (matchPattern(value, patterns, depth + 1, context) ||
+                                           ...);
+                               },
+                               take<patSize - 1>(orPat.patterns())) ||
+                           matchPattern(std::forward<Value>(value),
+                                        get<patSize - 1>(orPat.patterns()), depth + 1, context);
+                }
+            }
+            MATCHIT_HOT constexpr static void processIdImpl(Or<Patterns...> const &orPat,
                                                 int32_t depth, IdProcess idProcess)
             {
                 return std::apply(
@@ -524,6 +1235,37 @@ namespace matchit
             return Meet<Pred>{pred};
         }
 
+        // Interval pattern, both bounds included. Bounds are stored by value
+        // (the Matcher-within sample captures by reference and must outlive
+        // the pattern; this one has no such constraint). When the bounds and
+        // the scrutinee share an integral type the test compiles to the
+        // single-branch unsigned-subtraction form
+        //     (U)(v - first) <= (U)(last - first)
+        // instead of a pair of comparisons.
+        template <typename First, typename Last>
+        constexpr auto within(First const &first, Last const &last)
+        {
+            return meet(
+                [first, last](auto &&v)
+                {
+                    using V = std::decay_t<decltype(v)>;
+                    if constexpr (std::is_integral_v<V> &&
+                                  std::is_same_v<First, V> &&
+                                  std::is_same_v<Last, V>)
+                    {
+                        using U = std::make_unsigned_t<V>;
+                        return static_cast<U>(static_cast<U>(v) -
+                                              static_cast<U>(first)) <=
+                               static_cast<U>(static_cast<U>(last) -
+                                              static_cast<U>(first));
+                    }
+                    else
+                    {
+                        return first <= v && v <= last;
+                    }
+                });
+        }
+
         template <typename Pred>
         class PatternTraits<Meet<Pred>>
         {
@@ -534,16 +1276,24 @@ namespace matchit
             constexpr static auto nbIdV = 0;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    Meet<Pred> const &meetPat,
                                                    int32_t /* depth */, ContextT &)
+                noexcept(noexcept(meetPat(std::forward<Value>(value))))
             {
                 return meetPat(std::forward<Value>(value));
             }
-            constexpr static void processIdImpl(Meet<Pred> const &, int32_t /*depth*/,
-                                                IdProcess) {}
+            MATCHIT_HOT constexpr static void processIdImpl(Meet<Pred> const &, int32_t /*depth*/,
+                                                IdProcess) noexcept {}
         };
 
+        // nothrow propagation spot-checks: trivial comparisons and their
+        // id-free walks carry noexcept end to end.
+        static_assert(isNothrowMatchV<int32_t, int32_t &&, Context<>>);
+        static_assert(isNothrowMatchV<Wildcard, int32_t &&, Context<>>);
+        static_assert(
+            isNothrowMatchV<Or<int32_t, int32_t>, int32_t &&, Context<>>);
+
         template <typename Unary, typename Pattern>
         class App
         {
@@ -568,6 +1318,46 @@ namespace matchit
         static_assert(std::holds_alternative<int32_t const *>(
             std::variant<std::monostate, const int32_t *>{&y}));
 
+        // a freshly built tuple of lvalue references (an aggregate torn into
+        // its fields, a tie over existing objects) needs no context slot: the
+        // referenced objects outlive the match and the tuple itself is
+        // re-derivable at will.
+        template <typename T>
+        struct AllLvalueRefTuple : std::false_type
+        {
+        };
+
+        template <typename... Ts>
+        struct AllLvalueRefTuple<std::tuple<Ts...>>
+            : std::conjunction<std::is_lvalue_reference<Ts>...>
+        {
+        };
+
+        template <typename T>
+        constexpr auto allLvalueRefTupleV =
+            AllLvalueRefTuple<std::remove_reference_t<T>>::value;
+
+        template <typename Type>
+        class Id;
+
+        template <typename Type>
+        class SharedId;
+
+        // a prvalue projection result also needs no context slot when nothing
+        // below the projection can keep a reference into it: a pure test (no
+        // ids under the pattern) only inspects the result while it is alive as
+        // the call's temporary, and a lone Id over the whole result moves it
+        // straight into its own block, since rvalue bindings are always owned
+        // and never by-pointer. Any other shape may hand lvalue references to
+        // sub-patterns (at(), ds over the result), so those still materialize
+        // into the context, where ids pointing into the result stay valid for
+        // the handler.
+        template <typename Pattern, typename AppResult>
+        constexpr auto consumesPrvalueDirectlyV =
+            PatternTraits<Pattern>::nbIdV == 0 ||
+            std::is_same_v<Pattern, Id<std::decay_t<AppResult>>> ||
+            std::is_same_v<Pattern, SharedId<std::decay_t<AppResult>>>;
+
         template <typename Unary, typename Pattern>
         class PatternTraits<App<Unary, Pattern>>
         {
@@ -578,11 +1368,13 @@ namespace matchit
             // support constexpr.
             template <typename Value>
             using AppResultCurTuple =
-                std::conditional_t<std::is_lvalue_reference_v<AppResult<Value>>
+                std::conditional_t<std::is_lvalue_reference_v<AppResult<Value>> ||
+                                       allLvalueRefTupleV<AppResult<Value>>
 #if NO_SCALAR_REFERENCES_USED_IN_PATTERNS
                                     || std::is_scalar_v<AppResult<Value>>
 #endif // NO_SCALAR_REFERENCES_USED_IN_PATTERNS
-                                    ,
+                                    || consumesPrvalueDirectlyV<
+                                           Pattern, AppResult<Value>>,
                                    std::tuple<>,
                                    std::tuple<std::decay_t<AppResult<Value>>>>;
 
@@ -595,7 +1387,7 @@ namespace matchit
             constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    App<Unary, Pattern> const &appPat,
                                                    int32_t depth, ContextT &context)
             {
@@ -609,18 +1401,308 @@ namespace matchit
                 {
                     context.emplace_back(invoke_(appPat.unary(), value));
                     decltype(auto) result =
-                        get<std::decay_t<AppResult<Value>>>(context.back());
+                        context.template backAs<std::decay_t<AppResult<Value>>>();
                     return matchPattern(std::forward<AppResult<Value>>(result),
                                         appPat.pattern(), depth + 1, context);
                 }
             }
-            constexpr static void processIdImpl(App<Unary, Pattern> const &appPat,
+            MATCHIT_HOT constexpr static void processIdImpl(App<Unary, Pattern> const &appPat,
                                                 int32_t depth, IdProcess idProcess)
             {
                 return processId(appPat.pattern(), depth, idProcess);
             }
         };
 
+        // Fused optional/pointer patterns. some(p) used to compose
+        // and_(app(cast<bool>, true), app(deref, p)) — two App traversals
+        // with their context and processId bookkeeping for what is one
+        // emptiness test plus a dereference. Some runs that directly: a
+        // single static_cast<bool> check, then p is matched (and any ids
+        // bound) through the reference the dereference yields. None is the
+        // emptiness test alone. Works for anything contextually
+        // bool-convertible and dereferenceable: std::optional, raw
+        // pointers, smart pointers.
+        template <typename Pattern>
+        class Some
+        {
+        public:
+            constexpr explicit Some(Pattern const &pattern)
+                : mPattern{pattern}
+            {
+            }
+            constexpr auto const &pattern() const { return mPattern; }
+
+        private:
+            InternalPatternT<Pattern> mPattern;
+        };
+
+        template <typename Pattern>
+        class PatternTraits<Some<Pattern>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = typename PatternTraits<Pattern>::
+                template AppResultTuple<decltype(*std::declval<Value>())>;
+
+            constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
+
+            template <typename Value, typename ContextT>
+            MATCHIT_HOT constexpr static auto matchPatternImpl(
+                Value &&value, Some<Pattern> const &somePat, int32_t depth,
+                ContextT &context)
+            {
+                return static_cast<bool>(value) &&
+                       matchPattern(*std::forward<Value>(value),
+                                    somePat.pattern(), depth + 1, context);
+            }
+            MATCHIT_HOT constexpr static void processIdImpl(
+                Some<Pattern> const &somePat, int32_t depth,
+                IdProcess idProcess)
+            {
+                return processId(somePat.pattern(), depth, idProcess);
+            }
+        };
+
+        class None
+        {
+        };
+
+        template <>
+        class PatternTraits<None>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = std::tuple<>;
+
+            constexpr static auto nbIdV = 0;
+
+            template <typename Value, typename ContextT>
+            constexpr static auto matchPatternImpl(Value &&value, None const &,
+                                                   int32_t /* depth */,
+                                                   ContextT &)
+            {
+                return !static_cast<bool>(value);
+            }
+            constexpr static void processIdImpl(None const &, int32_t,
+                                                IdProcess)
+            {
+            }
+        };
+
+        // Compiled string-shape pattern. Prefix, suffix and segment tests
+        // against strings are routinely written as meet lambdas stacking
+        // substr and find calls — several passes over the value and a
+        // lambda per shape. glob("GET /api/*/status") compiles the spec
+        // once at construction (constexpr when the pattern is) into a
+        // table of star-free literal segments and matches in a single
+        // forward walk with no allocation: the first segment anchors as a
+        // prefix, the last as a suffix, and the segments between are
+        // located greedily left to right. '*' matches any run of
+        // characters (consecutive stars collapse), '?' matches exactly
+        // one. Each star's run can be captured by passing one sub-pattern
+        // per star — glob("*.cpp", stem) — matched against a
+        // std::string_view of the run, so Id<std::string_view> binds it
+        // without copying the characters (see Id below for the aliasing
+        // rules).
+        template <std::size_t N, typename... Patterns>
+        class Glob
+        {
+        public:
+            constexpr explicit Glob(char const (&spec)[N],
+                                    Patterns const &...patterns)
+                : mSpec{}, mBegin{}, mEnd{}, mSegCount{1}, mPatterns{patterns...}
+            {
+                constexpr auto len = N - 1;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    mSpec[i] = spec[i];
+                }
+                std::size_t seg = 0;
+                std::size_t i = 0;
+                while (i < len)
+                {
+                    if (mSpec[i] == '*')
+                    {
+                        mEnd[seg] = i;
+                        while (i < len && mSpec[i] == '*')
+                        {
+                            ++i;
+                        }
+                        ++seg;
+                        mBegin[seg] = i;
+                    }
+                    else
+                    {
+                        ++i;
+                    }
+                }
+                mEnd[seg] = len;
+                mSegCount = seg + 1;
+                // one capture sub-pattern per star, or none for a pure test.
+                assert(sizeof...(Patterns) == 0 || sizeof...(Patterns) == seg);
+            }
+
+            constexpr auto const &patterns() const { return mPatterns; }
+
+            template <typename ContextT>
+            constexpr bool matchView(std::string_view value, int32_t depth,
+                                     ContextT &context) const
+            {
+                auto const stars = mSegCount - 1;
+                if (stars == 0)
+                {
+                    return value.size() == segLen(0) &&
+                           segMatchesAt(0, value, 0);
+                }
+                if (value.size() < segLen(0) + segLen(stars) ||
+                    !segMatchesAt(0, value, 0))
+                {
+                    return false;
+                }
+                auto const suffixStart = value.size() - segLen(stars);
+                if (suffixStart < segLen(0) ||
+                    !segMatchesAt(stars, value, suffixStart))
+                {
+                    return false;
+                }
+                if constexpr (sizeof...(Patterns) == 0)
+                {
+                    static_cast<void>(depth);
+                    static_cast<void>(context);
+                    auto pos = segLen(0);
+                    for (std::size_t seg = 1; seg != stars; ++seg)
+                    {
+                        pos = findSeg(seg, value, pos, suffixStart);
+                        if (pos == std::string_view::npos)
+                        {
+                            return false;
+                        }
+                        pos += segLen(seg);
+                    }
+                    return true;
+                }
+                else
+                {
+                    return matchCaptures(
+                        value, segLen(0), suffixStart, depth, context,
+                        std::make_index_sequence<sizeof...(Patterns)>{});
+                }
+            }
+
+        private:
+            constexpr std::size_t segLen(std::size_t seg) const
+            {
+                return mEnd[seg] - mBegin[seg];
+            }
+            constexpr bool segMatchesAt(std::size_t seg, std::string_view value,
+                                        std::size_t pos) const
+            {
+                for (auto k = mBegin[seg]; k != mEnd[seg]; ++k, ++pos)
+                {
+                    if (mSpec[k] != '?' && mSpec[k] != value[pos])
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            // first start in [from, limit - segLen] where seg matches, or
+            // npos.
+            constexpr std::size_t findSeg(std::size_t seg,
+                                          std::string_view value,
+                                          std::size_t from,
+                                          std::size_t limit) const
+            {
+                for (auto pos = from; pos + segLen(seg) <= limit; ++pos)
+                {
+                    if (segMatchesAt(seg, value, pos))
+                    {
+                        return pos;
+                    }
+                }
+                return std::string_view::npos;
+            }
+            template <typename ContextT, std::size_t... I>
+            constexpr bool matchCaptures(std::string_view value,
+                                         std::size_t pos,
+                                         std::size_t suffixStart, int32_t depth,
+                                         ContextT &context,
+                                         std::index_sequence<I...>) const
+            {
+                auto result = true;
+                auto const step = [&](auto idxC, auto const &pat)
+                {
+                    constexpr auto idx = decltype(idxC)::value;
+                    if (!result)
+                    {
+                        return;
+                    }
+                    auto capEnd = suffixStart;
+                    if constexpr (idx + 1 < sizeof...(Patterns))
+                    {
+                        capEnd = findSeg(idx + 1, value, pos, suffixStart);
+                        if (capEnd == std::string_view::npos)
+                        {
+                            result = false;
+                            return;
+                        }
+                    }
+                    result = matchPattern(value.substr(pos, capEnd - pos), pat,
+                                          depth + 1, context);
+                    pos = capEnd + segLen(idx + 1);
+                };
+                (step(std::integral_constant<std::size_t, I>{},
+                      std::get<I>(mPatterns)),
+                 ...);
+                return result;
+            }
+
+            char mSpec[N];
+            // star-free [begin, end) ranges into mSpec; mSegCount - 1 stars.
+            std::size_t mBegin[N];
+            std::size_t mEnd[N];
+            std::size_t mSegCount;
+            std::tuple<InternalPatternT<Patterns>...> mPatterns;
+        };
+
+        template <std::size_t N, typename... Patterns>
+        constexpr auto glob(char const (&spec)[N], Patterns const &...patterns)
+        {
+            return Glob<N, Patterns...>{spec, patterns...};
+        }
+
+        template <std::size_t N, typename... Patterns>
+        class PatternTraits<Glob<N, Patterns...>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = decltype(std::tuple_cat(
+                std::declval<typename PatternTraits<Patterns>::
+                                 template AppResultTuple<std::string_view>>()...));
+
+            constexpr static auto nbIdV =
+                (PatternTraits<Patterns>::nbIdV + ... + 0);
+
+            template <typename Value, typename ContextT>
+            MATCHIT_HOT constexpr static auto matchPatternImpl(
+                Value &&value, Glob<N, Patterns...> const &globPat,
+                int32_t depth, ContextT &context)
+            {
+                return globPat.matchView(
+                    std::string_view{std::forward<Value>(value)}, depth,
+                    context);
+            }
+            MATCHIT_HOT constexpr static void processIdImpl(
+                Glob<N, Patterns...> const &globPat, int32_t depth,
+                IdProcess idProcess)
+            {
+                std::apply(
+                    [depth, idProcess](auto const &...pats)
+                    { (processId(pats, depth, idProcess), ...); },
+                    globPat.patterns());
+            }
+        };
+
         template <typename... Patterns>
         class And
         {
@@ -662,9 +1744,12 @@ namespace matchit
             constexpr static auto nbIdV = (PatternTraits<Patterns>::nbIdV + ... + 0);
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    And<Patterns...> const &andPat,
                                                    int32_t depth, ContextT &context)
+                noexcept((isNothrowMatchV<InternalPatternT<Patterns>, Value &,
+                                          ContextT> &&
+                          ...))
             {
                 constexpr auto patSize = sizeof...(Patterns);
                 auto const exceptLast = std::apply(
@@ -689,7 +1774,7 @@ namespace matchit
                                         context);
                 }
             }
-            constexpr static void processIdImpl(And<Patterns...> const &andPat,
+            MATCHIT_HOT constexpr static void processIdImpl(And<Patterns...> const &andPat,
                                                 int32_t depth, IdProcess idProcess)
             {
                 return std::apply(
@@ -705,8 +1790,8 @@ namespace matchit
         class Not
         {
         public:
-            explicit Not(Pattern const &pattern) : mPattern{pattern} {}
-            auto const &pattern() const { return mPattern; }
+            constexpr explicit Not(Pattern const &pattern) : mPattern{pattern} {}
+            constexpr auto const &pattern() const { return mPattern; }
 
         private:
             InternalPatternT<Pattern> mPattern;
@@ -729,64 +1814,295 @@ namespace matchit
             constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    Not<Pattern> const &notPat,
                                                    int32_t depth, ContextT &context)
+                noexcept(isNothrowMatchV<InternalPatternT<Pattern>, Value,
+                                         ContextT>)
             {
                 return !matchPattern(std::forward<Value>(value), notPat.pattern(),
                                      depth + 1, context);
             }
-            constexpr static void processIdImpl(Not<Pattern> const &notPat, int32_t depth,
+            MATCHIT_HOT constexpr static void processIdImpl(Not<Pattern> const &notPat, int32_t depth,
                                                 IdProcess idProcess)
             {
                 processId(notPat.pattern(), depth, idProcess);
             }
         };
 
-        template <typename Ptr, typename Value, typename = std::void_t<>>
-        struct StorePointer : std::false_type
+        // Canonicalization rewrites pattern trees into cheaper equivalent
+        // shapes before any value is matched: double negation is dropped,
+        // not_(or_(...)) is De-Morganed into and_ of negations (each
+        // alternative is tested at most once instead of the whole
+        // disjunction running to completion under the negation), nested
+        // and_ is flattened into one conjunction, and stateless duplicate
+        // subpatterns (the same meet reused, repeated wildcards — the
+        // shapes rule engines produce when composing fragments
+        // programmatically) collapse to their first occurrence. Only
+        // id-free subtrees are rewritten: composites run their children
+        // one depth deeper, so moving a pattern across a composite
+        // boundary would change the depth its ids confirm and cancel at.
+        // Duplicate literals inside or_ are left alone — they are equal
+        // values of one type, not redundant types, and the fold-based
+        // membership test already handles them for the price of a
+        // compare.
+        template <typename Pattern, typename>
+        class CanonicalTraits
         {
+        public:
+            constexpr static Pattern const &canonical(Pattern const &pattern)
+            {
+                return pattern;
+            }
         };
 
-        template <typename Type>
-        using ValueVariant =
-                std::conditional_t<std::is_lvalue_reference_v<Type>,
-                            UniqVariant<std::remove_reference_t<Type>*>,
-                            std::conditional_t<std::is_rvalue_reference_v<Type>,
-                                        UniqVariant<std::remove_reference_t<Type>, std::remove_reference_t<Type> *>,
-                                        std::conditional_t<std::is_abstract_v<std::remove_reference_t<Type>>,
-                                                UniqVariant<std::remove_reference_t<Type>*, std::remove_reference_t<Type> const *>,
-                                                UniqVariant<std::remove_reference_t<Type>, std::remove_reference_t<Type>*, std::remove_reference_t<Type> const *>
-                                                >
-                                            >>;
-
-        template <typename Type, typename Value>
-        struct StorePointer<Type, Value,
-                            std::void_t<decltype(std::declval<ValueVariant<Type> &>() =
-                                                     &std::declval<Value>())>>
-            : std::is_reference<Value> // need to double check this condition. to loosen it.
+        template <typename Pattern>
+        constexpr decltype(auto) canonicalize(Pattern const &pattern)
         {
-        };
-
-        static_assert(!StorePointer<char, char>::value);
-        // static_assert(StorePointer<std::tuple<char, int>, std::tuple<char, int>>::value);
-        static_assert(StorePointer<char, char &>::value);
-        static_assert(StorePointer<const char, const char &>::value);
-        static_assert(StorePointer<const char, char &>::value);
-        static_assert(StorePointer<std::tuple<int32_t &, int32_t &> const,
-                                   std::tuple<int32_t &, int32_t &> const &>::value);
+            return CanonicalTraits<Pattern>::canonical(pattern);
+        }
 
-        template <typename... Ts>
-        class Overload : public Ts...
+        // Keep-first mask over the subpattern types: a stateless (empty)
+        // subpattern that already occurred earlier carries no information
+        // the first occurrence does not, for conjunction and disjunction
+        // alike.
+        template <typename... Patterns>
+        constexpr std::array<bool, sizeof...(Patterns)> keepFirstStatelessMask()
         {
-        public:
-            using Ts::operator()...;
-        };
+            constexpr auto size = sizeof...(Patterns);
+            std::array<std::array<bool, size>, size> const same = {
+                {sameTypeRow<Patterns, Patterns...>()...}};
+            std::array<bool, size> const stateless = {
+                {std::is_empty_v<Patterns>...}};
+            std::array<bool, size> kept{};
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                kept[i] = true;
+                if (stateless[i])
+                {
+                    for (std::size_t j = 0; j < i; ++j)
+                    {
+                        if (same[i][j])
+                        {
+                            kept[i] = false;
+                        }
+                    }
+                }
+            }
+            return kept;
+        }
 
-        template <typename... Ts>
-        constexpr auto overload(Ts &&...ts)
+        template <std::size_t N>
+        constexpr std::size_t countKept(std::array<bool, N> const &kept)
         {
-            return Overload<Ts...>{ts...};
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                count += kept[i] ? std::size_t{1} : std::size_t{0};
+            }
+            return count;
+        }
+
+        template <std::size_t Count, std::size_t N>
+        constexpr std::array<std::size_t, Count>
+        keptIndices(std::array<bool, N> const &kept)
+        {
+            std::array<std::size_t, Count> indices{};
+            std::size_t out = 0;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (kept[i])
+                {
+                    indices[out++] = i;
+                }
+            }
+            return indices;
+        }
+
+        template <typename Rebuild, std::size_t... I, typename... Patterns>
+        constexpr auto selectKept(Rebuild rebuild, std::index_sequence<I...>,
+                                  std::tuple<Patterns...> const &children)
+        {
+            constexpr auto indices =
+                keptIndices<sizeof...(I)>(keepFirstStatelessMask<Patterns...>());
+            return rebuild(std::get<indices[I]>(children)...);
+        }
+
+        template <typename Rebuild, typename... Patterns>
+        constexpr auto dedupStateless(Rebuild rebuild,
+                                      std::tuple<Patterns...> const &children)
+        {
+            return selectKept(
+                rebuild,
+                std::make_index_sequence<countKept(
+                    keepFirstStatelessMask<Patterns...>())>{},
+                children);
+        }
+
+        template <typename Pattern>
+        class IsAnd : public std::false_type
+        {
+        };
+
+        template <typename... Patterns>
+        class IsAnd<And<Patterns...>> : public std::true_type
+        {
+        };
+
+        // Splice an already-canonical subpattern into an enclosing
+        // conjunction: canonical And children are themselves flat, so this
+        // recurses at most one level.
+        template <typename Pattern>
+        constexpr auto flattenAnd(Pattern const &pattern)
+        {
+            if constexpr (IsAnd<Pattern>::value)
+            {
+                return std::apply(
+                    [](auto const &...patterns)
+                    { return std::tuple_cat(flattenAnd(patterns)...); },
+                    pattern.patterns());
+            }
+            else
+            {
+                return std::make_tuple(pattern);
+            }
+        }
+
+        // not_(not_(p)) -> p.
+        template <typename Pattern>
+        class CanonicalTraits<
+            Not<Not<Pattern>>,
+            std::enable_if_t<PatternTraits<Not<Not<Pattern>>>::nbIdV == 0>>
+        {
+        public:
+            constexpr static decltype(auto) canonical(Not<Not<Pattern>> const &p)
+            {
+                return canonicalize(p.pattern().pattern());
+            }
+        };
+
+        // De Morgan: not_(or_(p...)) -> and_(not_(p)...). Re-canonicalizing
+        // the rebuilt conjunction flattens it and resolves negations the
+        // rewrite itself introduced (a negated alternative that was an or_
+        // De-Morgans in turn; a negated negation drops).
+        template <typename... Patterns>
+        class CanonicalTraits<
+            Not<Or<Patterns...>>,
+            std::enable_if_t<PatternTraits<Not<Or<Patterns...>>>::nbIdV == 0>>
+        {
+        public:
+            constexpr static auto canonical(Not<Or<Patterns...>> const &p)
+            {
+                return std::apply(
+                    [](auto const &...patterns)
+                    { return canonicalize(and_(not_(canonicalize(patterns))...)); },
+                    p.pattern().patterns());
+            }
+        };
+
+        template <typename... Patterns>
+        class CanonicalTraits<
+            And<Patterns...>,
+            std::enable_if_t<PatternTraits<And<Patterns...>>::nbIdV == 0>>
+        {
+        public:
+            constexpr static auto canonical(And<Patterns...> const &p)
+            {
+                auto const flat = std::apply(
+                    [](auto const &...patterns)
+                    { return std::tuple_cat(flattenAnd(canonicalize(patterns))...); },
+                    p.patterns());
+                return dedupStateless(
+                    [](auto const &...patterns) { return and_(patterns...); },
+                    flat);
+            }
+        };
+
+        template <typename... Patterns>
+        class CanonicalTraits<
+            Or<Patterns...>,
+            std::enable_if_t<PatternTraits<Or<Patterns...>>::nbIdV == 0>>
+        {
+        public:
+            constexpr static auto canonical(Or<Patterns...> const &p)
+            {
+                auto const children = std::apply(
+                    [](auto const &...patterns)
+                    { return std::make_tuple(canonicalize(patterns)...); },
+                    p.patterns());
+                return dedupStateless(
+                    [](auto const &...patterns) { return or_(patterns...); },
+                    children);
+            }
+        };
+
+        static_assert(
+            std::is_same_v<std::decay_t<decltype(canonicalize(
+                               not_(not_(std::declval<int32_t &>()))))>,
+                           int32_t>);
+        static_assert(
+            std::is_same_v<std::decay_t<decltype(canonicalize(not_(or_(1, 2))))>,
+                           And<Not<int32_t>, Not<int32_t>>>);
+        static_assert(std::is_same_v<
+                      std::decay_t<decltype(canonicalize(
+                          and_(and_(std::declval<Wildcard &>(), 1), 2)))>,
+                      And<Wildcard, int32_t, int32_t>>);
+        static_assert(std::is_same_v<std::decay_t<decltype(canonicalize(or_(
+                          std::declval<Wildcard &>(), 1,
+                          std::declval<Wildcard &>())))>,
+                      Or<Wildcard, int32_t>>);
+
+        template <typename Ptr, typename Value, typename = std::void_t<>>
+        struct StorePointer : std::false_type
+        {
+        };
+
+        template <typename Type>
+        using ValueVariant =
+                std::conditional_t<std::is_lvalue_reference_v<Type>,
+                            UniqVariant<std::remove_reference_t<Type>*>,
+                            std::conditional_t<std::is_rvalue_reference_v<Type>,
+                                        UniqVariant<std::remove_reference_t<Type>, std::remove_reference_t<Type> *>,
+                                        std::conditional_t<std::is_abstract_v<std::remove_reference_t<Type>>,
+                                                UniqVariant<std::remove_reference_t<Type>*, std::remove_reference_t<Type> const *>,
+                                                UniqVariant<std::remove_reference_t<Type>, std::remove_reference_t<Type>*, std::remove_reference_t<Type> const *>
+                                                >
+                                            >>;
+
+        // Binding policy: lvalue scrutinees whose address fits one of the
+        // block's pointer alternatives are bound by pointer — no copy, no
+        // allocation, whatever the size of the type. Rvalues are moved into
+        // the block (they may not outlive the match), which also serves as
+        // the per-use opt-out: pass std::move(x) or a copy to force an owned
+        // binding. Small trivially copyable types bypass this entirely and
+        // copy through TrivialIdBlock below.
+        template <typename Type, typename Value>
+        struct StorePointer<Type, Value,
+                            std::void_t<decltype(std::declval<ValueVariant<Type> &>() =
+                                                     &std::declval<Value>())>>
+            : std::is_reference<Value>
+        {
+        };
+
+        static_assert(!StorePointer<char, char>::value);
+        // static_assert(StorePointer<std::tuple<char, int>, std::tuple<char, int>>::value);
+        static_assert(StorePointer<char, char &>::value);
+        static_assert(StorePointer<const char, const char &>::value);
+        static_assert(StorePointer<const char, char &>::value);
+        static_assert(StorePointer<std::tuple<int32_t &, int32_t &> const,
+                                   std::tuple<int32_t &, int32_t &> const &>::value);
+
+        template <typename... Ts>
+        class Overload : public Ts...
+        {
+        public:
+            using Ts::operator()...;
+        };
+
+        template <typename... Ts>
+        constexpr auto overload(Ts &&...ts)
+        {
+            return Overload<Ts...>{ts...};
         }
 
         template <typename Pattern>
@@ -794,6 +2110,15 @@ namespace matchit
 
         class Ooo;
 
+        // Equality for a repeated Id occurrence: when the same Id appears
+        // more than once in a pattern (ds(x, x), x reused across or_
+        // branches), occurrences after the first are checked against the
+        // bound value through this trait. Specialize it for types whose
+        // operator== is a deep walk to make the re-check cheap — compare a
+        // precomputed hash or a length field first and fall back to full
+        // equality only on agreement. An occurrence that sees the very
+        // same object as a by-pointer binding short-circuits on address
+        // identity before this trait is consulted.
         template <typename Type>
         class IdTraits
         {
@@ -828,7 +2153,14 @@ namespace matchit
             {
                 if (mDepth - depth >= 0)
                 {
-                    mVariant = {};
+                    // cancel walks mostly hit never-bound blocks (failed or_
+                    // alternatives that did not reach this Id); skip the
+                    // assignment, and its destroy for non-trivial types, when
+                    // the block is already empty.
+                    if (!std::holds_alternative<std::monostate>(mVariant))
+                    {
+                        mVariant = {};
+                    }
                     mDepth = depth;
                 }
             }
@@ -871,6 +2203,28 @@ namespace matchit
                                 }),
                     IdBlockBase<Type>::mVariant);
             }
+            // move-out access: only legal when the match bound an owned
+            // value; by-pointer bindings alias the scrutinee and must not be
+            // stolen from.
+            constexpr decltype(auto) move()
+            {
+                return std::visit(
+                    overload([](Type &v) -> Type && { return std::move(v); },
+                                [](Type const *) -> Type && {
+                                    throw std::logic_error(
+                                        "Cannot move out of a by-reference "
+                                        "binding!");
+                                },
+                                [](Type *) -> Type && {
+                                    throw std::logic_error(
+                                        "Cannot move out of a by-reference "
+                                        "binding!");
+                                },
+                                [](std::monostate &) -> Type && {
+                                    throw std::logic_error("invalid state!");
+                                }),
+                    IdBlockBase<Type>::mVariant);
+            }
         };
 
         template <typename Type>
@@ -951,6 +2305,75 @@ namespace matchit
             }
         };
 
+        // Storage fast path for trivially copyable bound types (ints, enums,
+        // small PODs — the common case). Binding is a store plus a flag set
+        // and reading is a flag-guarded load; there is no discriminant to tag
+        // and no pointer alternative, since copying such a value costs no
+        // more than storing its address.
+        template <typename Type>
+        class TrivialIdBlock
+        {
+            int32_t mDepth{};
+            Type mValue{};
+            bool mHasValue{};
+
+        public:
+            constexpr void reset(int32_t depth)
+            {
+                if (mDepth - depth >= 0)
+                {
+                    mHasValue = false;
+                    mDepth = depth;
+                }
+            }
+            constexpr void confirm(int32_t depth)
+            {
+                if (mDepth > depth || mDepth == 0)
+                {
+                    assert(depth == mDepth - 1 || depth == mDepth || mDepth == 0);
+                    mDepth = depth;
+                }
+            }
+            constexpr auto hasValue() const { return mHasValue; }
+            constexpr Type const &get() const
+            {
+                if (!mHasValue)
+                {
+                    throw std::logic_error("invalid state!");
+                }
+                return mValue;
+            }
+            template <typename Value>
+            constexpr void bind(Value &&value)
+            {
+                mValue = std::forward<Value>(value);
+                mHasValue = true;
+            }
+            constexpr Type &&move()
+            {
+                if (!mHasValue)
+                {
+                    throw std::logic_error("invalid state!");
+                }
+                return std::move(mValue);
+            }
+        };
+
+        // The plain block copies on bind, so it is reserved for types where
+        // the copy is no dearer than storing a pointer. Larger trivially
+        // copyable types (multi-kilobyte PODs matched by lvalue) keep the
+        // variant block, whose StorePointer path binds them by pointer
+        // without any copy.
+        template <typename Type>
+        constexpr auto useTrivialIdBlockV =
+            !std::is_reference_v<Type> && std::is_trivially_copyable_v<Type> &&
+            std::is_default_constructible_v<Type> &&
+            sizeof(Type) <= 2 * sizeof(void *);
+
+        template <typename Type>
+        using IdBlockT = std::conditional_t<useTrivialIdBlockV<Type>,
+                                            TrivialIdBlock<Type>, IdBlock<Type>>;
+
         template <typename Type>
         class IdUtil
         {
@@ -968,13 +2391,37 @@ namespace matchit
             {
                 v = ValueVariant<Type>{&value};
             }
+            // address of a by-pointer binding, or nullptr for owned and
+            // empty blocks; lets a repeated occurrence over the very same
+            // object settle equality by identity.
+            constexpr static void const *boundAddress(ValueVariant<Type> const &v)
+            {
+                using P = std::remove_const_t<std::remove_reference_t<Type>>;
+                return std::visit(
+                    overload([](P const *p) -> void const * { return p; },
+                             [](P *p) -> void const * { return p; },
+                             [](auto const &) -> void const *
+                             { return nullptr; }),
+                    v);
+            }
         };
 
+        // Binding string data without allocating: Id<std::string_view> is
+        // the supported way to capture a piece of a string scrutinee.
+        // string_view rides the trivial block, so binding copies the
+        // 16-byte view — never the characters — whether it comes from the
+        // scrutinee itself, a substr/tokenize projection, or a
+        // std::string lvalue (bound as a view of its buffer). The view
+        // aliases the scrutinee (or the arm's context for materialized
+        // projections), both of which outlive the handler, so reading it
+        // inside the handler is always safe; like any binding it must not
+        // escape the match expression. A repeated occurrence compares
+        // content, as string_view equality does.
         template <typename Type>
         class Id
         {
         private:
-            using BlockT = IdBlock<Type>;
+            using BlockT = IdBlockT<Type>;
             using BlockVT = std::variant<BlockT, BlockT *>;
             BlockVT mBlock = BlockT{};
 
@@ -1005,15 +2452,37 @@ namespace matchit
             }
 
             template <typename Value>
-            constexpr auto
+            MATCHIT_HOT constexpr auto
                 matchValue(Value &&v) const
             {
                 if (hasValue())
                 {
+                    // repeated occurrence: a prior by-pointer binding of
+                    // this very object is equal by identity — skip the
+                    // deep compare.
+                    if constexpr (!useTrivialIdBlockV<Type> &&
+                                  std::is_lvalue_reference_v<Value> &&
+                                  std::is_same_v<std::decay_t<Value>,
+                                                 std::decay_t<Type>>)
+                    {
+                        if (IdUtil<Type>::boundAddress(block().variant()) ==
+                            static_cast<void const *>(std::addressof(v)))
+                        {
+                            return true;
+                        }
+                    }
                     return IdTraits<std::decay_t<Type>>::equal(internalValue(), v);
                 }
-                IdUtil<Type>::bindValue(block().variant(), std::forward<Value>(v),
-                                   StorePointer<Type, Value>{});
+                if constexpr (useTrivialIdBlockV<Type>)
+                {
+                    block().bind(std::forward<Value>(v));
+                }
+                else
+                {
+                    IdUtil<Type>::bindValue(block().variant(),
+                                            std::forward<Value>(v),
+                                            StorePointer<Type, Value>{});
+                }
                 return true;
             }
             constexpr void reset(int32_t depth) const { return block().reset(depth); }
@@ -1023,6 +2492,11 @@ namespace matchit
             constexpr decltype(auto) get() { return block().get(); }
             // non-const to inform users not to mark Id as const.
             constexpr decltype(auto) operator*() { return get(); }
+            // steal the bound value out of the block instead of copying it.
+            // Only legal when the match bound an owned value (an rvalue
+            // scrutinee or a materialized intermediate); by-pointer bindings
+            // throw. Non-const to inform users not to mark Id as const.
+            constexpr decltype(auto) move() { return block().move(); }
         };
 
         template <typename Type>
@@ -1035,12 +2509,12 @@ namespace matchit
             constexpr static auto nbIdV = true;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value, Id<Type> const &idPat,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value, Id<Type> const &idPat,
                                                    int32_t /* depth */, ContextT &)
             {
                 return idPat.matchValue(std::forward<Value>(value));
             }
-            constexpr static void processIdImpl(Id<Type> const &idPat, int32_t depth,
+            MATCHIT_HOT constexpr static void processIdImpl(Id<Type> const &idPat, int32_t depth,
                                                 IdProcess idProcess)
             {
                 switch (idProcess)
@@ -1056,6 +2530,120 @@ namespace matchit
             }
         };
 
+        // Thread-shareable Id. A plain Id carries its binding inside the
+        // pattern object, so an arm set that binds Ids cannot be shared
+        // across threads and ends up rebuilt per call. A SharedId stores
+        // only an immutable slot index; the binding block lives in
+        // thread-local storage, one block per (slot, thread). A static
+        // pattern expression (or static matcher()) containing SharedIds can
+        // therefore serve any number of threads concurrently, each seeing
+        // its own bindings. Every access costs one thread-local vector
+        // lookup, so prefer plain Id when the pattern is built per call
+        // anyway. ooo binding is not supported; use Id for subranges.
+        template <typename Type>
+        class SharedId
+        {
+            using BlockT = IdBlockT<Type>;
+            std::size_t mSlot;
+
+            static std::size_t allocateSlot()
+            {
+                static std::atomic<std::size_t> counter{0};
+                return counter.fetch_add(1, std::memory_order_relaxed);
+            }
+            BlockT &block() const
+            {
+                static thread_local std::vector<BlockT> blocks;
+                if (blocks.size() <= mSlot)
+                {
+                    blocks.resize(mSlot + 1);
+                }
+                return blocks[mSlot];
+            }
+
+        public:
+            SharedId() : mSlot{allocateSlot()} {}
+            // copies share the slot, as Id copies share the block.
+            SharedId(SharedId const &) = default;
+
+            // non-const to inform users not to mark SharedId as const.
+            template <typename Pattern>
+            auto at(Pattern &&pattern)
+            {
+                return and_(pattern, *this);
+            }
+
+            template <typename Value>
+            auto matchValue(Value &&v) const
+            {
+                auto &b = block();
+                if (b.hasValue())
+                {
+                    if constexpr (!useTrivialIdBlockV<Type> &&
+                                  std::is_lvalue_reference_v<Value> &&
+                                  std::is_same_v<std::decay_t<Value>,
+                                                 std::decay_t<Type>>)
+                    {
+                        if (IdUtil<Type>::boundAddress(b.variant()) ==
+                            static_cast<void const *>(std::addressof(v)))
+                        {
+                            return true;
+                        }
+                    }
+                    return IdTraits<std::decay_t<Type>>::equal(b.get(), v);
+                }
+                if constexpr (useTrivialIdBlockV<Type>)
+                {
+                    b.bind(std::forward<Value>(v));
+                }
+                else
+                {
+                    IdUtil<Type>::bindValue(b.variant(), std::forward<Value>(v),
+                                            StorePointer<Type, Value>{});
+                }
+                return true;
+            }
+            void reset(int32_t depth) const { block().reset(depth); }
+            void confirm(int32_t depth) const { block().confirm(depth); }
+            bool hasValue() const { return block().hasValue(); }
+            // non-const to inform users not to mark SharedId as const.
+            decltype(auto) get() { return block().get(); }
+            decltype(auto) operator*() { return get(); }
+            decltype(auto) move() { return block().move(); }
+        };
+
+        template <typename Type>
+        class PatternTraits<SharedId<Type>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = std::tuple<>;
+
+            constexpr static auto nbIdV = true;
+
+            template <typename Value, typename ContextT>
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
+                                                   SharedId<Type> const &idPat,
+                                                   int32_t /* depth */, ContextT &)
+            {
+                return idPat.matchValue(std::forward<Value>(value));
+            }
+            MATCHIT_HOT constexpr static void processIdImpl(SharedId<Type> const &idPat,
+                                                int32_t depth, IdProcess idProcess)
+            {
+                switch (idProcess)
+                {
+                case IdProcess::kCANCEL:
+                    idPat.reset(depth);
+                    break;
+
+                case IdProcess::kCONFIRM:
+                    idPat.confirm(depth);
+                    break;
+                }
+            }
+        };
+
         template <typename... Patterns>
         class Ds
         {
@@ -1107,12 +2695,12 @@ namespace matchit
             constexpr static auto nbIdV = false;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&, Ooo, int32_t /*depth*/,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&, Ooo, int32_t /*depth*/,
                                                    ContextT &)
             {
                 return true;
             }
-            constexpr static void processIdImpl(Ooo, int32_t /*depth*/, IdProcess) {}
+            MATCHIT_HOT constexpr static void processIdImpl(Ooo, int32_t /*depth*/, IdProcess) {}
         };
 
         template <typename Pattern>
@@ -1123,17 +2711,20 @@ namespace matchit
             using AppResultTuple =
                 typename PatternTraits<Pattern>::template AppResultTuple<Value>;
 
-            constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
+            // the binder's template argument is the bound type, not a
+            // sub-pattern; what the confirm/cancel walk reaches is the one
+            // Id the binder wraps.
+            constexpr static auto nbIdV = PatternTraits<Id<Pattern>>::nbIdV;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    OooBinder<Pattern> const &oooBinderPat,
                                                    int32_t depth, ContextT &context)
             {
                 return matchPattern(std::forward<Value>(value), oooBinderPat.binder(),
                                     depth + 1, context);
             }
-            constexpr static void processIdImpl(OooBinder<Pattern> const &oooBinderPat,
+            MATCHIT_HOT constexpr static void processIdImpl(OooBinder<Pattern> const &oooBinderPat,
                                                 int32_t depth, IdProcess idProcess)
             {
                 processId(oooBinderPat.binder(), depth, idProcess);
@@ -1240,10 +2831,33 @@ namespace matchit
                                     depth + 1, context);
             };
             static_cast<void>(func);
-            // Fix Me, avoid call next from begin every time.
-            return (func(*std::next(rangeBegin, static_cast<long>(I)),
-                         std::get<I + patternStartIdx>(patternTuple)) &&
-                    ...);
+            using Iter = std::decay_t<RangeBegin>;
+            if constexpr (std::is_convertible_v<
+                              typename std::iterator_traits<Iter>::iterator_category,
+                              std::random_access_iterator_tag>)
+            {
+                return (func(rangeBegin[static_cast<std::ptrdiff_t>(I)],
+                             std::get<I + patternStartIdx>(patternTuple)) &&
+                        ...);
+            }
+            else
+            {
+                // forward iterators: advance one shared iterator through the
+                // fold instead of std::next from begin per position, which
+                // would walk the range quadratically.
+                auto iter = rangeBegin;
+                static_cast<void>(iter);
+                auto const step = [&](auto &&pattern)
+                {
+                    auto &&value = *iter;
+                    auto const matched =
+                        func(std::forward<decltype(value)>(value), pattern);
+                    ++iter;
+                    return matched;
+                };
+                static_cast<void>(step);
+                return (step(std::get<I + patternStartIdx>(patternTuple)) && ...);
+            }
         }
 
         template <std::size_t patternStartIdx, std::size_t size,
@@ -1257,17 +2871,85 @@ namespace matchit
                 std::make_index_sequence<size>{});
         }
 
-        template <std::size_t start, typename Indices, typename Tuple>
-        class IndexedTypes;
+        template <std::size_t patternStartIdx, typename Stream,
+                  typename PatternTuple, typename ContextT, std::size_t... I>
+        bool matchStreamPrefixImpl(Stream &stream, PatternTuple const &patternTuple,
+                                   int32_t depth, ContextT &context,
+                                   std::index_sequence<I...>)
+        {
+            using Elem = typename Stream::value_type;
+            // consumed elements land in the binding context so that ids bound
+            // inside the element patterns outlive this call.
+            auto const step = [&](auto const &pattern)
+            {
+                if (stream.done())
+                {
+                    return false;
+                }
+                context.emplace_back(stream.next());
+                return matchPattern(context.template backAs<Elem>(), pattern,
+                                    depth + 1, context);
+            };
+            static_cast<void>(step);
+            return (step(std::get<I + patternStartIdx>(patternTuple)) && ...);
+        }
 
-        template <typename Tuple, std::size_t start, std::size_t... I>
-        class IndexedTypes<start, std::index_sequence<I...>, Tuple>
+        template <std::size_t patternStartIdx, std::size_t size, typename Stream,
+                  typename PatternTuple, typename ContextT>
+        bool matchStreamPrefix(Stream &stream, PatternTuple const &patternTuple,
+                               int32_t depth, ContextT &context)
+        {
+            return matchStreamPrefixImpl<patternStartIdx>(
+                stream, patternTuple, depth, context,
+                std::make_index_sequence<size>{});
+        }
+
+        // O(1) type-at-index lookup: one multiply-inherited indexer per
+        // pack, and overload resolution against its bases picks out the
+        // element. Each std::get/tuple_element query walks the tuple
+        // recursively, which summed over every element of a wide ds
+        // pattern went quadratic.
+        template <std::size_t I, typename T>
+        class IndexedType
         {
         public:
-            using type = std::tuple<
+            using type = T;
+        };
+
+        template <typename Indices, typename... Ts>
+        class TypeIndexer;
+
+        template <std::size_t... I, typename... Ts>
+        class TypeIndexer<std::index_sequence<I...>, Ts...>
+            : public IndexedType<I, Ts>...
+        {
+        };
+
+        template <std::size_t I, typename T>
+        constexpr IndexedType<I, T> selectIndexed(IndexedType<I, T> const &);
+
+        template <std::size_t I, typename... Ts>
+        using TypeAtT = typename decltype(selectIndexed<I>(
+            std::declval<TypeIndexer<std::index_sequence_for<Ts...>, Ts...>>()))::type;
+
+        template <std::size_t start, typename Indices, typename Tuple>
+        class IndexedTypes;
+
+        template <typename Tuple, std::size_t start, std::size_t... I>
+        class IndexedTypes<start, std::index_sequence<I...>, Tuple>
+        {
+        public:
+            using type = std::tuple<
                 std::decay_t<decltype(std::get<start + I>(std::declval<Tuple>()))>...>;
         };
 
+        template <typename... Ts, std::size_t start, std::size_t... I>
+        class IndexedTypes<start, std::index_sequence<I...>, std::tuple<Ts...>>
+        {
+        public:
+            using type = std::tuple<std::decay_t<TypeAtT<start + I, Ts...>>...>;
+        };
+
         template <std::size_t start, std::size_t end, class Tuple>
         class SubTypes
         {
@@ -1285,6 +2967,23 @@ namespace matchit
         template <std::size_t start, std::size_t end, class Tuple>
         using SubTypesT = typename SubTypes<start, end, Tuple>::type;
 
+        template <typename Elem, typename Seq>
+        class RepeatTuple;
+
+        template <typename Elem, std::size_t... I>
+        class RepeatTuple<Elem, std::index_sequence<I...>>
+        {
+            template <std::size_t>
+            using E = Elem;
+
+        public:
+            using type = std::tuple<E<I>...>;
+        };
+
+        template <typename Elem, std::size_t n>
+        using RepeatTupleT =
+            typename RepeatTuple<Elem, std::make_index_sequence<n>>::type;
+
         static_assert(
             std::is_same_v<
                 std::tuple<std::nullptr_t>,
@@ -1350,11 +3049,63 @@ namespace matchit
         static_assert(!isRangeV<std::pair<int32_t, char>>);
         static_assert(isRangeV<const std::array<int32_t, 5>>);
 
+        // contiguous storage reachable through std::data: memchr/memcmp can
+        // scan it directly instead of walking iterators.
+        template <typename Range, typename = std::void_t<>>
+        struct HasContiguousData : std::false_type
+        {
+        };
+
+        template <typename Range>
+        struct HasContiguousData<
+            Range, std::void_t<decltype(std::data(std::declval<Range const &>()))>>
+            : std::is_pointer<decltype(std::data(std::declval<Range const &>()))>
+        {
+        };
+
+        template <typename Range>
+        constexpr auto hasContiguousDataV =
+            HasContiguousData<std::decay_t<Range>>::value;
+
+        template <typename Tuple>
+        struct AllIntegralElems : std::false_type
+        {
+        };
+
+        template <typename... Ts>
+        struct AllIntegralElems<std::tuple<Ts...>>
+            : std::bool_constant<(std::is_integral_v<std::decay_t<Ts>> && ...)>
+        {
+        };
+
         template <typename... Patterns>
         class PatternTraits<Ds<Patterns...>>
         {
             constexpr static auto nbOooOrBinder = nbOooOrBinderV<Patterns...>;
-            static_assert(nbOooOrBinder == 0 || nbOooOrBinder == 1);
+
+            // ds(ooo, needle..., ooo) is a subsequence search: the needle may
+            // sit at any offset of the scrutinee. Only this double-ooo shape
+            // is accepted beyond the usual single ooo, and the outer ooos
+            // must be plain (binders would be ambiguous: which side owns the
+            // unmatched elements around the first hit?).
+            constexpr static bool computeSubseqShape()
+            {
+                if constexpr (sizeof...(Patterns) >= 3 &&
+                              nbOooOrBinderV<Patterns...> == 2)
+                {
+                    using Pats = std::tuple<Patterns...>;
+                    return IsOoo<std::decay_t<
+                               std::tuple_element_t<0, Pats>>>::value &&
+                           IsOoo<std::decay_t<std::tuple_element_t<
+                               sizeof...(Patterns) - 1, Pats>>>::value;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            constexpr static auto isSubseqShape = computeSubseqShape();
+            static_assert(nbOooOrBinder <= 1 || isSubseqShape);
 
         public:
             template <typename PsTuple, typename VsTuple>
@@ -1413,6 +3164,20 @@ namespace matchit
                                                      std::declval<SecondHalfTuple>()));
             };
 
+            template <typename... Values>
+            class AppResultForTupleHelper<2, std::tuple<Values...>>
+            {
+                // subsequence shape (arrays only): the needle patterns see
+                // elements one at a time and the plain ooos bind nothing.
+                using ElemT = std::tuple_element_t<
+                    0, std::tuple<std::remove_reference_t<Values>..., int32_t>>;
+
+            public:
+                using type = decltype(std::tuple_cat(
+                    std::declval<typename PatternTraits<Patterns>::
+                                     template AppResultTuple<ElemT &>>()...));
+            };
+
             template <typename Tuple>
             using AppResultForTuple = typename AppResultForTupleHelper<
                 nbOooOrBinder, decltype(drop<0>(std::declval<Tuple>()))>::type;
@@ -1446,13 +3211,29 @@ namespace matchit
                 using type = AppResultForRangeType<RangeType>;
             };
 
+            // streams buffer every element a non-ooo pattern inspects in the
+            // binding context: one value slot per such pattern, plus whatever
+            // the element patterns themselves materialize.
+            template <typename Stream>
+            class AppResultHelper<Stream, std::enable_if_t<isStreamedV<Stream>>>
+            {
+                using Elem = typename std::decay_t<Stream>::value_type;
+
+            public:
+                using type = decltype(std::tuple_cat(
+                    std::declval<
+                        RepeatTupleT<Elem, sizeof...(Patterns) - nbOooOrBinder>>(),
+                    std::declval<typename PatternTraits<Patterns>::
+                                     template AppResultTuple<Elem &>>()...));
+            };
+
             template <typename Value>
             using AppResultTuple = typename AppResultHelper<Value>::type;
 
             constexpr static auto nbIdV = (PatternTraits<Patterns>::nbIdV + ... + 0);
 
             template <typename ValueTuple, typename ContextT>
-            constexpr static auto matchPatternImpl(ValueTuple &&valueTuple,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(ValueTuple &&valueTuple,
                                                    Ds<Patterns...> const &dsPat,
                                                    int32_t depth, ContextT &context)
                 -> std::enable_if_t<isTupleLikeV<ValueTuple>, bool>
@@ -1489,12 +3270,16 @@ namespace matchit
                     {
                         if constexpr (isBinder)
                         {
-                            auto const rangeSize = static_cast<long>(valLen - (patLen - 1));
+                            // extent and arity are both compile-time here, so
+                            // the ooo span length is too: the whole split
+                            // unrolls with constant offsets.
+                            constexpr auto rangeSize =
+                                static_cast<long>(valLen - (patLen - 1));
                             context.emplace_back(makeSubrange(&valueTuple[idxOoo],
                                                               &valueTuple[idxOoo] + rangeSize));
                             using type = decltype(makeSubrange(&valueTuple[idxOoo],
                                                                &valueTuple[idxOoo] + rangeSize));
-                            result = result && matchPattern(std::get<type>(context.back()),
+                            result = result && matchPattern(context.template backAs<type>(),
                                                             std::get<idxOoo>(dsPat.patterns()),
                                                             depth, context);
                         }
@@ -1508,16 +3293,38 @@ namespace matchit
                                          std::forward<ValueTuple>(valueTuple),
                                          dsPat.patterns(), depth, context);
                 }
+                else
+                {
+                    static_assert(isArrayV<ValueTuple>,
+                                  "the ds(ooo, needle..., ooo) subsequence "
+                                  "shape needs elements of one type: a range "
+                                  "or an array scrutinee.");
+                    constexpr auto valLen =
+                        std::tuple_size_v<std::decay_t<ValueTuple>>;
+                    constexpr auto runLen = sizeof...(Patterns) - 2;
+                    if constexpr (valLen < runLen)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        // delegate to the range implementation over the
+                        // array's contiguous storage.
+                        return matchPatternImpl(
+                            makeSubrange(&valueTuple[0], &valueTuple[0] + valLen),
+                            dsPat, depth, context);
+                    }
+                }
             }
 
             template <typename ValueRange, typename ContextT>
-            constexpr static auto matchPatternImpl(ValueRange &&valueRange,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(ValueRange &&valueRange,
                                                    Ds<Patterns...> const &dsPat,
                                                    int32_t depth, ContextT &context)
                 -> std::enable_if_t<!isTupleLikeV<ValueRange> && isRangeV<ValueRange>,
                                     bool>
             {
-                static_assert(nbOooOrBinder == 0 || nbOooOrBinder == 1);
+                static_assert(nbOooOrBinder <= 1 || isSubseqShape);
                 constexpr auto nbPat = sizeof...(Patterns);
 
                 if constexpr (nbOooOrBinder == 0)
@@ -1550,7 +3357,7 @@ namespace matchit
                         auto const end = std::next(beginOoo, rangeSize);
                         context.emplace_back(makeSubrange(beginOoo, end));
                         using type = decltype(makeSubrange(beginOoo, end));
-                        result = result && matchPattern(std::get<type>(context.back()),
+                        result = result && matchPattern(context.template backAs<type>(),
                                                         std::get<idxOoo>(dsPat.patterns()),
                                                         depth, context);
                     }
@@ -1559,9 +3366,177 @@ namespace matchit
                     return result && matchPatternRange<idxOoo + 1, patLen - idxOoo - 1>(
                                          beginAfterOoo, dsPat.patterns(), depth, context);
                 }
+                else
+                {
+                    // subsequence search: the first window matching the
+                    // needle wins. Contiguous byte ranges with an all-literal
+                    // needle scan in bulk — memchr skips to each candidate
+                    // first byte and memcmp verifies the run — instead of
+                    // advancing the pattern machinery per element.
+                    constexpr auto runLen = nbPat - 2;
+                    auto const valLen = valueRange.size();
+                    if (valLen < runLen)
+                    {
+                        return false;
+                    }
+                    using Elem = std::decay_t<decltype(*std::begin(valueRange))>;
+                    using NeedlePats =
+                        SubTypesT<1, nbPat - 1, std::tuple<Patterns...>>;
+                    if constexpr (hasContiguousDataV<ValueRange> &&
+                                  sizeof(Elem) == 1 && bitwiseEqualityV<Elem> &&
+                                  AllIntegralElems<NeedlePats>::value)
+                    {
+                        std::array<Elem, runLen> needle{};
+                        auto const representable = std::apply(
+                            [&needle](auto const &...lits)
+                            {
+                                std::size_t i = 0;
+                                static_cast<void>(i);
+                                // a literal outside Elem's range can equal no
+                                // element: the arm cannot match.
+                                return (((needle[i++] = static_cast<Elem>(lits)),
+                                         static_cast<Elem>(lits) == lits) &&
+                                        ...);
+                            },
+                            subtuple<1, nbPat - 1>(dsPat.patterns()));
+                        if (!representable)
+                        {
+                            return false;
+                        }
+                        auto const *cursor = std::data(valueRange);
+                        auto const *lastStart = cursor + (valLen - runLen);
+                        while (cursor <= lastStart)
+                        {
+                            auto const *hit =
+                                static_cast<Elem const *>(std::memchr(
+                                    cursor,
+                                    static_cast<int32_t>(
+                                        static_cast<unsigned char>(needle[0])),
+                                    static_cast<std::size_t>(lastStart - cursor) +
+                                        1));
+                            if (hit == nullptr)
+                            {
+                                return false;
+                            }
+                            if (runLen == 1 ||
+                                std::memcmp(hit, needle.data(), runLen) == 0)
+                            {
+                                return true;
+                            }
+                            cursor = hit + 1;
+                        }
+                        return false;
+                    }
+                    else
+                    {
+                        auto iter = std::begin(valueRange);
+                        for (std::size_t start = 0; start + runLen <= valLen;
+                             ++start, ++iter)
+                        {
+                            auto const marked = context.mark();
+                            if (matchPatternRange<1, runLen>(
+                                    iter, dsPat.patterns(), depth, context))
+                            {
+                                return true;
+                            }
+                            // a partially matched window may have confirmed
+                            // needle ids and materialized intermediates;
+                            // drop both before sliding — the context is
+                            // sized for a single pass over the needle.
+                            std::apply(
+                                [depth](auto const &...ps)
+                                {
+                                    (processId(ps, depth + 1,
+                                               IdProcess::kCANCEL),
+                                     ...);
+                                },
+                                dsPat.patterns());
+                            context.release(marked);
+                        }
+                        return false;
+                    }
+                }
+            }
+
+            template <typename Stream, typename ContextT>
+            MATCHIT_HOT static auto matchPatternImpl(Stream &&stream,
+                                         Ds<Patterns...> const &dsPat,
+                                         int32_t depth, ContextT &context)
+                -> std::enable_if_t<isStreamedV<Stream>, bool>
+            {
+                static_assert(nbOooOrBinder == 0 || nbOooOrBinder == 1);
+                constexpr auto patLen = sizeof...(Patterns);
+                using Elem = typename std::decay_t<Stream>::value_type;
+
+                if constexpr (nbOooOrBinder == 0)
+                {
+                    // exact arity: k elements must match and the stream must
+                    // then be exhausted, mirroring the sized-range check.
+                    return matchStreamPrefix<0, patLen>(stream, dsPat.patterns(),
+                                                        depth, context) &&
+                           stream.done();
+                }
+                else
+                {
+                    constexpr auto idxOoo =
+                        findOooIdx<typename Ds<Patterns...>::Type>();
+                    static_assert(
+                        !isOooBinderV<
+                            std::tuple_element_t<idxOoo, std::tuple<Patterns...>>>,
+                        "an ooo binder needs a multi-pass range: a stream "
+                        "cannot be re-read into a subrange.");
+                    if (!matchStreamPrefix<0, idxOoo>(stream, dsPat.patterns(),
+                                                      depth, context))
+                    {
+                        return false;
+                    }
+                    // drain the rest through a ring of the last m elements:
+                    // the patterns after ooo only ever need that many, so the
+                    // skipped middle is never buffered.
+                    constexpr auto m = patLen - idxOoo - 1;
+                    std::array<std::optional<Elem>, m == 0 ? 1 : m> ring{};
+                    std::size_t count = 0;
+                    while (!stream.done())
+                    {
+                        if constexpr (m > 0)
+                        {
+                            ring[count % m] = stream.next();
+                        }
+                        else
+                        {
+                            static_cast<void>(stream.next());
+                        }
+                        ++count;
+                    }
+                    if (count < m)
+                    {
+                        return false;
+                    }
+                    if constexpr (m > 0)
+                    {
+                        auto const step = [&](auto const &pattern,
+                                              std::size_t const i)
+                        {
+                            context.emplace_back(std::move(*ring[(count + i) % m]));
+                            return matchPattern(context.template backAs<Elem>(),
+                                                pattern, depth + 1, context);
+                        };
+                        return std::apply(
+                            [&](auto const &...patterns)
+                            {
+                                std::size_t i = 0;
+                                return (step(patterns, i++) && ...);
+                            },
+                            subtuple<idxOoo + 1, patLen>(dsPat.patterns()));
+                    }
+                    else
+                    {
+                        return true;
+                    }
+                }
             }
 
-            constexpr static void processIdImpl(Ds<Patterns...> const &dsPat,
+            MATCHIT_HOT constexpr static void processIdImpl(Ds<Patterns...> const &dsPat,
                                                 int32_t depth, IdProcess idProcess)
             {
                 return std::apply(
@@ -1616,22 +3591,70 @@ namespace matchit
             using AppResultTuple =
                 typename PatternTraits<Pattern>::template AppResultTuple<Value>;
 
+            constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
+
             template <typename Value, typename ContextT>
-            constexpr static auto
+            MATCHIT_HOT constexpr static auto
             matchPatternImpl(Value &&value, PostCheck<Pattern, Pred> const &postCheck,
                              int32_t depth, ContextT &context)
             {
-                return matchPattern(std::forward<Value>(value), postCheck.pattern(),
-                                    depth + 1, context) &&
+                // The guard runs on tentative bindings: ids bound by the
+                // structural impl are readable before any confirm walk, so
+                // the inner pattern is matched without its own
+                // confirm/cancel pass and the enclosing matchPattern issues
+                // the one walk for the whole arm afterwards. A failing
+                // guard — the common case for filtering guards — thus costs
+                // a single cancel walk instead of a confirm pass over the
+                // freshly bound ids followed by the cancel.
+                return PatternTraits<Pattern>::matchPatternImpl(
+                           std::forward<Value>(value), postCheck.pattern(),
+                           depth + 1, context) &&
                        postCheck.check();
             }
-            constexpr static void processIdImpl(PostCheck<Pattern, Pred> const &postCheck,
+            MATCHIT_HOT constexpr static void processIdImpl(PostCheck<Pattern, Pred> const &postCheck,
                                                 int32_t depth, IdProcess idProcess)
             {
+                // matchPatternImpl skipped the inner level's own confirm, so
+                // replay it here on success to keep the stepwise depth
+                // protocol the id blocks assert; a cancel resets every
+                // deeper level in one walk and needs no replay.
+                if (idProcess == IdProcess::kCONFIRM)
+                {
+                    processId(postCheck.pattern(), depth + 1, idProcess);
+                }
                 processId(postCheck.pattern(), depth, idProcess);
             }
         };
 
+        template <typename Pattern, bool expected>
+        class PatternTraits<Expected<Pattern, expected>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple =
+                typename PatternTraits<Pattern>::template AppResultTuple<Value>;
+
+            constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
+
+            template <typename Value, typename ContextT>
+            constexpr static bool
+            matchPatternImpl(Value &&value, Expected<Pattern, expected> const &e,
+                             int32_t depth, ContextT &context)
+            {
+                // same depth: the annotation is invisible to id bookkeeping.
+                return MATCHIT_EXPECT(
+                    matchPattern(std::forward<Value>(value), e.pattern(), depth,
+                                 context),
+                    expected);
+            }
+            constexpr static void
+            processIdImpl(Expected<Pattern, expected> const &e, int32_t depth,
+                          IdProcess idProcess)
+            {
+                processId(e.pattern(), depth, idProcess);
+            }
+        };
+
         static_assert(
             std::is_same_v<PatternTraits<Wildcard>::template AppResultTuple<int32_t>,
                            std::tuple<>>);
@@ -1643,10 +3666,24 @@ namespace matchit
         // static_assert(std::is_same_v<PatternTraits<App<decltype(x), Wildcard>>::
         //                                  template AppResultTuple<int32_t>,
         //                              std::tuple<>>);
+        // pure tests and a lone Id consume the projection result without a
+        // context slot; a composite that can reference into the result keeps
+        // one.
         static_assert(
             std::is_same_v<PatternTraits<App<decltype(x), Wildcard>>::
                                template AppResultTuple<std::array<int32_t, 3>>,
-                           std::tuple<std::array<int32_t, 3>>>);
+                           std::tuple<>>);
+        static_assert(
+            std::is_same_v<PatternTraits<App<decltype(x),
+                                             Id<std::array<int32_t, 3>>>>::
+                               template AppResultTuple<std::array<int32_t, 3>>,
+                           std::tuple<>>);
+        static_assert(
+            std::is_same_v<
+                PatternTraits<App<decltype(x),
+                                  And<Id<std::array<int32_t, 3>>, Wildcard>>>::
+                    template AppResultTuple<std::array<int32_t, 3>>,
+                std::tuple<std::array<int32_t, 3>>>);
         // static_assert(std::is_same_v<PatternTraits<And<App<decltype(x), Wildcard>>>::
         //                                  template AppResultTuple<int32_t>,
         //                              std::tuple<>>);
@@ -1657,45 +3694,1229 @@ namespace matchit
         static_assert(PatternTraits<Or<Id<int32_t>, Id<float>>>::nbIdV == 2);
         static_assert(PatternTraits<Or<Wildcard, float>>::nbIdV == 0);
 
+        // Fast dispatch for arm sets made of plain integral literals (plus the
+        // wildcard). Such arms bind no Ids and capture nothing into the
+        // context, so the whole match lowers to a flat run of comparisons
+        // without per-arm context construction or processId bookkeeping.
+        // Arm values live in the pattern objects at runtime, so the jump
+        // table itself is emitted by the optimizer, the same way it lowers a
+        // hand-written switch over the same comparisons.
+        template <typename T>
+        struct IsMeet : std::false_type
+        {
+        };
+
+        template <typename Pred>
+        struct IsMeet<Meet<Pred>> : std::true_type
+        {
+        };
+
+        template <typename Value, typename Pattern>
+        constexpr auto isEqDispatchArmV =
+            (std::is_same_v<std::decay_t<Value>, Pattern> &&
+             (std::is_integral_v<Pattern> || std::is_enum_v<Pattern>)) ||
+            (IsMeet<Pattern>::value &&
+             std::is_invocable_r_v<bool, Pattern const &, Value const &>) ||
+            std::is_same_v<Pattern, Wildcard>;
+
+        // likely()/unlikely() is transparent to the flat dispatch: an
+        // annotated literal arm keeps the fast path and carries its hint
+        // into the flattened comparison.
+        template <typename Value, typename Pattern, bool expected>
+        constexpr auto isEqDispatchArmV<Value, Expected<Pattern, expected>> =
+            isEqDispatchArmV<Value, Pattern>;
+
         template <typename Value, typename... PatternPairs>
-        constexpr auto matchPatterns(Value &&value, PatternPairs const &...patterns)
+        constexpr auto useEqDispatchV =
+            (isEqDispatchArmV<Value, typename PatternPairs::PatternT> && ...);
+
+        template <typename Value, typename Pattern>
+        constexpr bool eqDispatchPattern(Value const &value, Pattern const &p)
         {
-            using RetType = typename PatternPairsRetType<PatternPairs...>::RetType;
-            using TypeTuple = decltype(std::tuple_cat(
-                std::declval<typename PatternTraits<typename PatternPairs::PatternT>::
-                                 template AppResultTuple<Value>>()...));
+            if constexpr (std::is_same_v<Pattern, Wildcard>)
+            {
+                static_cast<void>(value);
+                static_cast<void>(p);
+                return true;
+            }
+            else if constexpr (IsMeet<Pattern>::value)
+            {
+                return static_cast<bool>(p(value));
+            }
+            else
+            {
+                return p == value;
+            }
+        }
 
-            // expression, has return value.
-            if constexpr (!std::is_same_v<RetType, void>)
+        template <typename Value, typename Pattern, bool expected>
+        constexpr bool eqDispatchPattern(Value const &value,
+                                         Expected<Pattern, expected> const &p)
+        {
+            return MATCHIT_EXPECT(eqDispatchPattern(value, p.pattern()),
+                                  expected);
+        }
+
+        template <typename Value, typename PatternPair>
+        constexpr bool eqDispatchMatch(Value const &value, PatternPair const &arm)
+        {
+            return eqDispatchPattern(value, arm.pattern());
+        }
+
+        // Fast dispatch for arm sets made of string literals — char const *
+        // and std::string_view arms, in any mix. The scrutinee is converted
+        // to a string_view once (a single strlen for raw char pointers),
+        // then every arm compares length-first before touching the
+        // characters, so arms of the wrong length cost one integer compare
+        // instead of a character-wise strcmp. No arm allocates: string_view
+        // arms and the converted scrutinee are views all the way through.
+        template <typename Value, typename Pattern>
+        constexpr auto isStrEqDispatchArmV =
+            ((std::is_same_v<Pattern, char const *> ||
+              std::is_same_v<Pattern, std::string_view>) &&
+             std::is_convertible_v<Value, std::string_view>) ||
+            std::is_same_v<Pattern, Wildcard>;
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto useStrEqDispatchV =
+            (isStrEqDispatchArmV<Value, typename PatternPairs::PatternT> && ...);
+
+        template <typename PatternPair>
+        constexpr bool strEqDispatchMatch(std::string_view const value,
+                                          PatternPair const &arm)
+        {
+            if constexpr (std::is_same_v<typename PatternPair::PatternT, Wildcard>)
             {
-                constexpr auto const func =
-                    [](auto const &pattern, auto &&value, RetType &result) constexpr->bool
+                static_cast<void>(value);
+                return true;
+            }
+            else
+            {
+                return std::string_view{arm.pattern()} == value;
+            }
+        }
+
+        // Literal destructuring arms: a ds(...) whose elements are all
+        // integral literals or wildcards over a tuple-like scrutinee needs no
+        // binding machinery either, so such arm sets join the flat dispatch
+        // and compile to fused element-wise compares. This is the
+        // decision-tree shape a pattern-matrix compiler would emit for
+        // literal rows; the sharing of column tests between arms is left to
+        // the optimizer, which sees them as plain comparisons of the same
+        // loads.
+        template <typename V, typename P>
+        constexpr bool eqDispatchElem(V const &v, P const &p)
+        {
+            if constexpr (std::is_same_v<P, Wildcard>)
+            {
+                static_cast<void>(v);
+                return true;
+            }
+            else
+            {
+                return p == v;
+            }
+        }
+
+        template <typename Value, typename Pattern, typename = std::void_t<>>
+        struct IsFlatDsArm : std::false_type
+        {
+        };
+
+        template <typename Value, typename... Ps>
+        struct IsFlatDsArm<
+            Value, Ds<Ps...>,
+            std::enable_if_t<std::tuple_size_v<std::decay_t<Value>> ==
+                                 sizeof...(Ps),
+                             std::void_t<>>>
+        {
+            // element types come from get<I> rather than std::tuple_element:
+            // tuple-like protocols in this library only require tuple_size
+            // plus an ADL get.
+            template <std::size_t... I>
+            constexpr static bool compute(std::index_sequence<I...>)
+            {
+                using std::get;
+                return (isEqDispatchArmV<
+                            std::decay_t<decltype(get<I>(
+                                std::declval<std::decay_t<Value> const &>()))>,
+                            std::tuple_element_t<I, std::tuple<Ps...>>> &&
+                        ...);
+            }
+            constexpr static bool value =
+                compute(std::make_index_sequence<sizeof...(Ps)>{});
+        };
+
+        template <typename Value, typename Pattern>
+        constexpr auto isDsEqDispatchArmV =
+            IsFlatDsArm<Value, Pattern>::value ||
+            std::is_same_v<Pattern, Wildcard>;
+
+        // Value-independent arm shape check. It runs first so that the
+        // tuple-like probe below is only ever instantiated for arm sets that
+        // can actually take this path; scrutinee types unrelated to literal
+        // destructuring never have their tuple-likeness inspected here.
+        template <typename Pattern>
+        struct IsLiteralDs : std::false_type
+        {
+        };
+
+        template <typename... Ps>
+        struct IsLiteralDs<Ds<Ps...>>
+        {
+            constexpr static bool value =
+                ((std::is_integral_v<Ps> || std::is_same_v<Ps, Wildcard>)&&...);
+        };
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto computeUseDsEqDispatch()
+        {
+            if constexpr (((IsLiteralDs<typename PatternPairs::PatternT>::value ||
+                            std::is_same_v<typename PatternPairs::PatternT,
+                                           Wildcard>)&&...) &&
+                          (IsLiteralDs<typename PatternPairs::PatternT>::value ||
+                           ...))
+            {
+                if constexpr (isTupleLikeV<Value>)
                 {
-                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
-                    if (pattern.matchValue(std::forward<Value>(value), context))
-                    {
-                        result = pattern.execute();
-                        processId(pattern, 0, IdProcess::kCANCEL);
-                        return true;
-                    }
-                    return false;
-                };
-                RetType result{};
-                bool const matched = (func(patterns, value, result) || ...);
-                if (!matched)
+                    return (isDsEqDispatchArmV<
+                                Value, typename PatternPairs::PatternT> &&
+                            ...);
+                }
+                else
                 {
-                    throw std::logic_error{"Error: no patterns got matched!"};
+                    return false;
                 }
-                static_cast<void>(matched);
-                return result;
             }
             else
-            // statement, no return value, mismatching all patterns is not an error.
             {
-                auto const func = [](auto const &pattern, auto &&value) -> bool
-                {
-                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
-                    if (pattern.matchValue(std::forward<Value>(value), context))
+                return false;
+            }
+        }
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto useDsEqDispatchV =
+            computeUseDsEqDispatch<Value, PatternPairs...>();
+
+        // Cost-ordered column testing for the flat ds path. Literal values
+        // are runtime data, but how discriminating a column *can* be is
+        // visible in the types: a column where many arms hold a Wildcard
+        // rejects nothing in those arms. Columns are therefore tested in
+        // ascending order of wildcard count across the arm set (stable, so
+        // equal columns keep source order) — in a (state, event) dispatch
+        // where most arms wildcard the state, the event column is compared
+        // first and rejects most arms on the first compare.
+        template <typename Value, typename... PatternPairs>
+        struct DsColumnOrder
+        {
+            constexpr static auto patLen =
+                std::tuple_size_v<std::decay_t<Value>>;
+
+            template <typename... Ps>
+            constexpr static void countDs(std::array<std::size_t, patLen> &wildcards,
+                                          Ds<Ps...> const *)
+            {
+                if constexpr (sizeof...(Ps) > 0)
+                {
+                    constexpr bool isWild[] = {std::is_same_v<Ps, Wildcard>...};
+                    for (std::size_t i = 0; i < patLen; ++i)
+                    {
+                        wildcards[i] += isWild[i] ? 1U : 0U;
+                    }
+                }
+                else
+                {
+                    static_cast<void>(wildcards);
+                }
+            }
+
+            template <typename PatternPair>
+            constexpr static void countArm(std::array<std::size_t, patLen> &wildcards)
+            {
+                using Pattern = typename PatternPair::PatternT;
+                if constexpr (!std::is_same_v<Pattern, Wildcard>)
+                {
+                    countDs(wildcards, static_cast<Pattern const *>(nullptr));
+                }
+            }
+
+            constexpr static std::array<std::size_t, patLen> compute()
+            {
+                std::array<std::size_t, patLen> wildcards{};
+                (countArm<PatternPairs>(wildcards), ...);
+                std::array<std::size_t, patLen> order{};
+                for (std::size_t i = 0; i < patLen; ++i)
+                {
+                    order[i] = i;
+                }
+                // stable insertion sort by ascending wildcard count.
+                for (std::size_t i = 1; i < patLen; ++i)
+                {
+                    auto const col = order[i];
+                    std::size_t j = i;
+                    while (j > 0 && wildcards[order[j - 1]] > wildcards[col])
+                    {
+                        order[j] = order[j - 1];
+                        --j;
+                    }
+                    order[j] = col;
+                }
+                return order;
+            }
+
+            constexpr static auto value = compute();
+
+            template <std::size_t... I>
+            constexpr static auto toSeq(std::index_sequence<I...>)
+                -> std::index_sequence<value[I]...>;
+
+            using seq =
+                decltype(toSeq(std::make_index_sequence<patLen>{}));
+        };
+
+        template <typename Value, typename DsPat, std::size_t... I>
+        constexpr bool dsEqDispatchMatchImpl(Value const &value,
+                                             DsPat const &dsPat,
+                                             std::index_sequence<I...>)
+        {
+            using std::get;
+            return (eqDispatchElem(get<I>(value), get<I>(dsPat.patterns())) &&
+                    ...);
+        }
+
+        template <typename Value, typename PatternPair, typename ColumnSeq>
+        constexpr bool dsEqDispatchMatch(Value const &value,
+                                         PatternPair const &arm, ColumnSeq)
+        {
+            using Pattern = typename PatternPair::PatternT;
+            if constexpr (std::is_same_v<Pattern, Wildcard>)
+            {
+                static_cast<void>(value);
+                return true;
+            }
+            else
+            {
+                return dsEqDispatchMatchImpl(value, arm.pattern(), ColumnSeq{});
+            }
+        }
+
+        template <typename T>
+        class AsPointer;
+
+        // Index-based pre-dispatch for as<T> arms over a std::variant. Every
+        // such arm knows the alternative index it can possibly match at
+        // compile time, so a mismatching arm is rejected with one integer
+        // compare against variant::index() instead of running the whole
+        // get_if-based pattern machinery. Arms whose index matches still go
+        // through the full match to run inner patterns and bindings.
+        template <typename Pattern>
+        struct AsDispatchTarget
+        {
+            using type = void;
+        };
+
+        template <typename T, typename P>
+        struct AsDispatchTarget<App<AsPointer<T>, P>>
+        {
+            using type = T;
+        };
+
+        template <typename T, typename P>
+        struct AsDispatchTarget<App<AsPointer<T> const &, P>>
+        {
+            using type = T;
+        };
+
+        template <typename P, typename Pred>
+        struct AsDispatchTarget<PostCheck<P, Pred>> : AsDispatchTarget<P>
+        {
+        };
+
+        template <typename P, bool expected>
+        struct AsDispatchTarget<Expected<P, expected>> : AsDispatchTarget<P>
+        {
+        };
+
+        template <typename Pattern>
+        using AsDispatchTargetT = typename AsDispatchTarget<Pattern>::type;
+
+        template <typename T>
+        struct IsVariant : std::false_type
+        {
+        };
+
+        template <typename... Alts>
+        struct IsVariant<std::variant<Alts...>> : std::true_type
+        {
+        };
+
+        template <typename T, typename Variant>
+        struct VariantAltIndex;
+
+        template <typename T, typename... Alts>
+        struct VariantAltIndex<T, std::variant<Alts...>>
+        {
+            constexpr static std::size_t compute()
+            {
+                constexpr bool found[] = {std::is_same_v<T, Alts>...};
+                std::size_t index = sizeof...(Alts);
+                for (std::size_t i = 0; i < sizeof...(Alts); ++i)
+                {
+                    if (found[i])
+                    {
+                        index = i;
+                        break;
+                    }
+                }
+                return index;
+            }
+            constexpr static auto value = compute();
+        };
+        static_assert(VariantAltIndex<bool, std::variant<int32_t, bool>>::value ==
+                      1);
+
+        // Fixed-arity ds arms over a sized range can only match one length,
+        // so comparing size() against the arity rejects wrong-length arms
+        // before any element is visited. Several ds arms of different
+        // arities thus degrade to a run of integer compares — effectively a
+        // length dispatch over the arm list.
+        template <typename Pattern>
+        struct DsArity
+        {
+            constexpr static bool fixed = false;
+            constexpr static std::size_t value = 0;
+        };
+
+        template <typename... Ps>
+        struct DsArity<Ds<Ps...>>
+        {
+            constexpr static bool fixed = nbOooOrBinderV<Ps...> == 0;
+            constexpr static std::size_t value = sizeof...(Ps);
+        };
+
+        template <typename P, typename Pred>
+        struct DsArity<PostCheck<P, Pred>> : DsArity<P>
+        {
+        };
+
+        template <typename P, bool expected>
+        struct DsArity<Expected<P, expected>> : DsArity<P>
+        {
+        };
+
+        template <typename Value, typename PatternPair>
+        MATCHIT_HOT constexpr bool armPossiblyMatches(Value const &value,
+                                                      PatternPair const &)
+        {
+            using Target = AsDispatchTargetT<typename PatternPair::PatternT>;
+            // as<T> arms over std::any: compare the stored type_info against
+            // typeid(T) directly. This is the same test any_cast performs,
+            // but done once up front it spares mismatching arms the whole
+            // any_cast call and the binding context that surrounds it.
+            if constexpr (!std::is_void_v<Target> &&
+                          std::is_same_v<std::decay_t<Value>, std::any>)
+            {
+                return value.type() == typeid(Target);
+            }
+            else if constexpr (!std::is_void_v<Target> &&
+                          IsVariant<std::decay_t<Value>>::value)
+            {
+                constexpr auto altIndex =
+                    VariantAltIndex<Target, std::decay_t<Value>>::value;
+                if constexpr (altIndex !=
+                              std::variant_size_v<std::decay_t<Value>>)
+                {
+                    return value.index() == altIndex;
+                }
+                else
+                {
+                    return true;
+                }
+            }
+            // the tuple-like/range probe is nested so it is only
+            // instantiated for fixed-arity ds arms: naming isTupleLikeV
+            // here for every arm would cache IsTupleLike<Value> for
+            // scrutinees whose std::tuple_size specialization appears
+            // later in the translation unit and make their ds matches
+            // ill-formed.
+            else if constexpr (DsArity<typename PatternPair::PatternT>::fixed)
+            {
+                if constexpr (!isTupleLikeV<Value> && isRangeV<Value>)
+                {
+                    return value.size() ==
+                           DsArity<typename PatternPair::PatternT>::value;
+                }
+                else
+                {
+                    static_cast<void>(value);
+                    return true;
+                }
+            }
+            else
+            {
+                static_cast<void>(value);
+                return true;
+            }
+        }
+
+        // Miss path for matchExhaustive: the caller declared the arms cover
+        // every value, so tell the optimizer the tail cannot run.
+        [[noreturn]] inline void unreachableMiss()
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            __assume(false);
+#else
+            __builtin_unreachable();
+#endif
+        }
+
+        template <typename T>
+        struct IsId : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct IsId<Id<T>> : std::true_type
+        {
+        };
+
+        template <typename Pattern>
+        constexpr auto isCatchAllPatternV =
+            std::is_same_v<Pattern, Wildcard> || IsId<Pattern>::value;
+
+        // Static coverage check backing matchExhaustive. Only variant
+        // scrutinees can be checked structurally: every alternative must be
+        // targeted by an as<Alt> arm, unless a wildcard/Id arm catches the
+        // rest. Guards cannot be seen through, so arms carrying `when` still
+        // count as covering their alternative — the declaration remains the
+        // caller's responsibility there.
+        template <typename Value, typename... PatternPairs>
+        struct CoversAllAlternatives : std::true_type
+        {
+        };
+
+        template <typename... Alts, typename... PatternPairs>
+        struct CoversAllAlternatives<std::variant<Alts...>, PatternPairs...>
+        {
+            constexpr static bool hasCatchAll =
+                (isCatchAllPatternV<typename PatternPairs::PatternT> || ...);
+            template <typename Alt>
+            constexpr static bool altCovered =
+                (std::is_same_v<Alt, AsDispatchTargetT<
+                                         typename PatternPairs::PatternT>> ||
+                 ...);
+            constexpr static bool value = hasCatchAll || (altCovered<Alts> && ...);
+        };
+
+// Profile-mode arm wrappers: MATCHIT_PROFILED_TRY counts a try (and a
+// hit on success) for the next arm index, MATCHIT_PROFILED_MISS a
+// fall-through. With profiling off both expand to the bare expression.
+// Used by runFlatArms and matchPatterns below; undefined after them.
+#if MATCHIT_PROFILE
+#define MATCHIT_PROFILED_TRY(expr) \
+    profiledArmTry(profileStats, profileArm, [&] { return (expr); })
+#define MATCHIT_PROFILED_MISS() profiledMiss(profileStats)
+#else
+#define MATCHIT_PROFILED_TRY(expr) (expr)
+#define MATCHIT_PROFILED_MISS() static_cast<void>(0)
+#endif // MATCHIT_PROFILE
+
+// Trace-mode arm wrapper: MATCHIT_TRACED_TRY fires the arm-selected
+// event when its arm matches. Nested inside MATCHIT_PROFILED_TRY so
+// both modes see the same arm indices.
+#if MATCHIT_TRACE
+#define MATCHIT_TRACED_TRY(expr) \
+    tracedArmTry(traceSite, traceArm, [&] { return (expr); })
+#else
+#define MATCHIT_TRACED_TRY(expr) (expr)
+#endif // MATCHIT_TRACE
+
+        // Run a flattened arm sequence where matching an arm needs no binding
+        // context and no processId bookkeeping.
+        template <typename RetType, bool exhaustive, typename ArmMatch,
+                  typename... PatternPairs>
+        constexpr decltype(auto) runFlatArms(ArmMatch const &armMatch,
+                                             PatternPairs const &...patterns)
+        {
+#if MATCHIT_PROFILE
+            // tries/hits/misses for flat-dispatch sites; the invocation
+            // itself is counted by matchPatterns before dispatching here.
+            SiteStats *profileStats = nullptr;
+            std::size_t profileArm = 0;
+#if defined(__GNUC__) || defined(__clang__)
+            if (!__builtin_is_constant_evaluated())
+#endif
+            {
+                profileStats = &siteStatsFor<PatternPairs...>();
+            }
+#endif // MATCHIT_PROFILE
+#if MATCHIT_TRACE
+            // arm-selected events for flat-dispatch sites; match entry is
+            // traced by matchPatterns before dispatching here.
+            char const *traceSite = nullptr;
+            std::size_t traceArm = 0;
+#if defined(__GNUC__) || defined(__clang__)
+            if (!__builtin_is_constant_evaluated())
+#endif
+            {
+                traceSite = traceSiteName<PatternPairs...>();
+            }
+#endif // MATCHIT_TRACE
+            if constexpr (std::is_lvalue_reference_v<RetType>)
+            {
+                std::remove_reference_t<RetType> *result = nullptr;
+                bool const matched =
+                    ((MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(armMatch(patterns)))
+                          ? (result = std::addressof(patterns.execute()), true)
+                          : false) ||
+                     ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                    else
+                    {
+                        throwNoMatch();
+                    }
+                }
+                return static_cast<RetType>(*result);
+            }
+            else if constexpr (!std::is_same_v<RetType, void>)
+            {
+                RetType result{};
+                bool const matched =
+                    ((MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(armMatch(patterns)))
+                          ? (result = patterns.execute(), true)
+                          : false) ||
+                     ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                    else
+                    {
+                        throwNoMatch();
+                    }
+                }
+                return result;
+            }
+            else
+            {
+                bool const matched =
+                    ((MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(armMatch(patterns)))
+                          ? (patterns.execute(), true)
+                          : false) ||
+                     ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                }
+                static_cast<void>(matched);
+            }
+        }
+
+        // Cross-arm hoisting of a shared App projection. Arms routinely
+        // apply the same unary — every some(p) arm casts and dereferences,
+        // hand-written arms repeat app(&T::size, p) — and each arm re-invokes
+        // it on the same scrutinee. When every arm is app(u, ...) with one
+        // unary (a trailing wildcard fallback is allowed), the projection is
+        // computed once and the inner patterns are matched against that.
+        template <typename Pattern>
+        struct AppUnaryType
+        {
+            using type = void;
+        };
+
+        template <typename Unary, typename Pattern>
+        struct AppUnaryType<App<Unary, Pattern>>
+        {
+            using type = Unary;
+        };
+
+        template <typename T, typename = std::void_t<>>
+        struct IsEqComparable : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct IsEqComparable<T, std::void_t<decltype(std::declval<T const &>() ==
+                                                      std::declval<T const &>())>>
+            : std::true_type
+        {
+        };
+
+        template <typename... PatternPairs>
+        constexpr bool computeUseAppHoist()
+        {
+            if constexpr (sizeof...(PatternPairs) < 2)
+            {
+                return false;
+            }
+            else
+            {
+                using First = std::tuple_element_t<
+                    0, std::tuple<typename PatternPairs::PatternT...>>;
+                using U = typename AppUnaryType<First>::type;
+                if constexpr (std::is_same_v<U, void>)
+                {
+                    return false;
+                }
+                // an empty unary is structurally identical across arms by
+                // type alone; stateful ones (member / function pointers) need
+                // an equality check of the instances at match time.
+                else if constexpr (!std::is_empty_v<U> &&
+                                   !IsEqComparable<U>::value)
+                {
+                    return false;
+                }
+                else
+                {
+                    constexpr bool allFit =
+                        ((std::is_same_v<typename PatternPairs::PatternT,
+                                         Wildcard> ||
+                          std::is_same_v<typename AppUnaryType<
+                                             typename PatternPairs::PatternT>::type,
+                                         U>) &&
+                         ...);
+                    constexpr auto nbApps =
+                        ((std::is_same_v<typename AppUnaryType<
+                                             typename PatternPairs::PatternT>::type,
+                                         U>
+                              ? 1
+                              : 0) +
+                         ...);
+                    return allFit && nbApps >= 2;
+                }
+            }
+        }
+
+        template <typename... PatternPairs>
+        constexpr auto useAppHoistV = computeUseAppHoist<PatternPairs...>();
+
+        template <typename First, typename... Rest>
+        constexpr auto const &firstAppUnary(First const &first, Rest const &...)
+        {
+            return first.pattern().unary();
+        }
+
+        template <typename Unary, typename... PatternPairs>
+        constexpr bool hoistUnariesAgree(Unary const &first,
+                                         PatternPairs const &...patterns)
+        {
+            if constexpr (std::is_empty_v<Unary>)
+            {
+                static_cast<void>(first);
+                return true;
+            }
+            else
+            {
+                auto const agree = [&first](auto const &arm)
+                {
+                    using Pattern =
+                        typename std::decay_t<decltype(arm)>::PatternT;
+                    if constexpr (std::is_same_v<
+                                      typename AppUnaryType<Pattern>::type,
+                                      Unary>)
+                    {
+                        return arm.pattern().unary() == first;
+                    }
+                    else
+                    {
+                        return true;
+                    }
+                };
+                return (agree(patterns) && ...);
+            }
+        }
+
+        template <typename PatternPair>
+        constexpr decltype(auto) hoistAppArm(PatternPair const &arm)
+        {
+            if constexpr (std::is_same_v<typename AppUnaryType<
+                                             typename PatternPair::PatternT>::type,
+                                         void>)
+            {
+                return (arm);
+            }
+            else
+            {
+                return arm.withPattern(arm.pattern().pattern());
+            }
+        }
+
+        // Lazily pick the match result type so the common-type computation
+        // is never instantiated when the caller pinned the type with
+        // match<Ret> (the arms may have no common type at all).
+        template <typename RetOverride, typename... PatternPairs>
+        class RetTypeSelect
+        {
+        public:
+            using type = RetOverride;
+        };
+
+        template <typename... PatternPairs>
+        class RetTypeSelect<Deduce, PatternPairs...>
+        {
+        public:
+            using type = typename PatternPairsRetType<PatternPairs...>::RetType;
+        };
+
+        // MATCHIT_COMPACT machinery: the non-template loop below is the
+        // only code shared match call sites expand to — everything
+        // arm-specific lives behind a type-erased thunk pointer.
+        using CompactArmThunk = bool (*)(void const *arm, void *value,
+                                         void *result);
+
+        inline bool compactArmLoop(CompactArmThunk const *thunks,
+                                   void const *const *arms, std::size_t count,
+                                   void *value, void *result)
+        {
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                if (thunks[i](arms[i], value, result))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Compact body of matchPatterns: each arm becomes a thunk over
+        // erased pointers and a call site shrinks to two constant arrays
+        // plus one compactArmLoop call. Every arm costs an indirect call
+        // and the flat-dispatch fast paths are skipped — peak speed is
+        // the price of the footprint.
+        template <typename RetType, bool exhaustive, typename TypeTuple,
+                  typename Value, typename... PatternPairs>
+        RetType runCompactMatch(Value &&value, PatternPairs const &...patterns)
+        {
+            // one result slot shape per match form: presence flag for
+            // statements, pointer for preserved references, optional
+            // otherwise.
+            using Slot = std::conditional_t<
+                std::is_void_v<RetType>, bool,
+                std::conditional_t<
+                    std::is_lvalue_reference_v<RetType>,
+                    std::remove_reference_t<RetType> *,
+                    std::optional<std::remove_const_t<RetType>>>>;
+            constexpr std::array<CompactArmThunk, sizeof...(PatternPairs)>
+                thunks{{+[](void const *arm, void *v, void *r) -> bool
+                        {
+                            auto const &pattern =
+                                *static_cast<PatternPairs const *>(arm);
+                            auto &valueRef =
+                                *static_cast<std::remove_reference_t<Value> *>(
+                                    v);
+                            if (!armPossiblyMatches(valueRef, pattern))
+                            {
+                                return false;
+                            }
+                            auto context =
+                                typename ContextTrait<TypeTuple>::ContextT{};
+                            if (!pattern.matchValue(
+                                    std::forward<Value>(valueRef), context))
+                            {
+                                return false;
+                            }
+                            auto &slot = *static_cast<Slot *>(r);
+                            if constexpr (std::is_void_v<RetType>)
+                            {
+                                pattern.execute();
+                                slot = true;
+                            }
+                            else if constexpr (
+                                std::is_lvalue_reference_v<RetType>)
+                            {
+                                slot = std::addressof(pattern.execute());
+                            }
+                            else
+                            {
+                                slot.emplace(pattern.execute());
+                            }
+                            processId(pattern, 0, IdProcess::kCANCEL);
+                            return true;
+                        }...}};
+            std::array<void const *, sizeof...(PatternPairs)> const arms{
+                {static_cast<void const *>(std::addressof(patterns))...}};
+            Slot slot{};
+            // the thunk restores the exact (possibly const) value type, so
+            // no write ever goes through the shed qualifier.
+            auto *const valuePtr = const_cast<void *>(
+                static_cast<void const *>(std::addressof(value)));
+            bool const matched =
+                compactArmLoop(thunks.data(), arms.data(),
+                               sizeof...(PatternPairs), valuePtr, &slot);
+            if (!matched)
+            {
+                if constexpr (exhaustive)
+                {
+                    unreachableMiss();
+                }
+                else if constexpr (!std::is_void_v<RetType>)
+                {
+                    throwNoMatch();
+                }
+            }
+            if constexpr (std::is_lvalue_reference_v<RetType>)
+            {
+                return static_cast<RetType>(*slot);
+            }
+            else if constexpr (!std::is_void_v<RetType>)
+            {
+                return static_cast<RetType>(std::move(*slot));
+            }
+        }
+
+        // Compile-time dispatch audit, triggered per site with
+        // match(v).report()(arms...). The call behaves exactly like
+        // match(v)(arms...) but additionally instantiates a [[deprecated]]
+        // stub whose -Wdeprecated-declarations warning spells out, in the
+        // instantiated template arguments, the strategy matchPatterns gives
+        // the site, its arm count, and — when the strategy is the
+        // sequential trial — which properties kept it off the flat fast
+        // paths. Auditing a code base is grepping one build log for
+        // DispatchReport; nothing reaches the binary and the match result
+        // is unchanged. AppHoist is reported as the static selection; the
+        // projection-agreement check it performs at runtime is not visible
+        // here.
+        namespace dispatchreport
+        {
+            struct FlatEqCompare;      // flattened literal/meet comparisons
+            struct FlatStrEqCompare;   // flattened length-first string compares
+            struct FlatDsEqCompare;    // fused element-wise literal ds compares
+            struct AppHoistThenNested; // shared projection hoisted, inner match
+            struct SequentialTrial;    // per-arm context + full pattern walk
+            struct CompactErasedLoop;  // MATCHIT_COMPACT shared type-erased loop
+        } // namespace dispatchreport
+
+        template <typename Strategy, std::size_t armCount,
+                  bool resultTypePinned, bool armsBindIds, bool armsHaveGuards,
+                  bool armShapesNotFlatLiterals>
+        struct DispatchReport
+        {
+            [[deprecated(
+                "matchit dispatch report - strategy, arm count and fallback "
+                "reasons are the template arguments of the DispatchReport "
+                "instantiation above")]] constexpr static void
+            emit()
+            {
+            }
+        };
+
+        template <typename Pattern>
+        struct IsTopLevelGuard : std::false_type
+        {
+        };
+
+        template <typename Pattern, typename Pred>
+        struct IsTopLevelGuard<PostCheck<Pattern, Pred>> : std::true_type
+        {
+        };
+
+        template <typename RetOverride, typename Value,
+                  typename... PatternPairs>
+        constexpr void reportDispatch()
+        {
+            constexpr bool deduced = std::is_same_v<RetOverride, Deduce>;
+            constexpr auto armCount = sizeof...(PatternPairs);
+            if constexpr (useAppHoistV<PatternPairs...>)
+            {
+                DispatchReport<dispatchreport::AppHoistThenNested, armCount,
+                               false, false, false, false>::emit();
+            }
+            else if constexpr (deduced &&
+                               useEqDispatchV<Value, PatternPairs...>)
+            {
+                DispatchReport<dispatchreport::FlatEqCompare, armCount, false,
+                               false, false, false>::emit();
+            }
+            else if constexpr (deduced &&
+                               useStrEqDispatchV<Value, PatternPairs...>)
+            {
+                DispatchReport<dispatchreport::FlatStrEqCompare, armCount,
+                               false, false, false, false>::emit();
+            }
+            else if constexpr (deduced &&
+                               useDsEqDispatchV<Value, PatternPairs...>)
+            {
+                DispatchReport<dispatchreport::FlatDsEqCompare, armCount,
+                               false, false, false, false>::emit();
+            }
+            else
+            {
+#if MATCHIT_COMPACT && !MATCHIT_PROFILE && !MATCHIT_TRACE
+                using Strategy = dispatchreport::CompactErasedLoop;
+#else
+                using Strategy = dispatchreport::SequentialTrial;
+#endif
+                constexpr bool armsBindIds =
+                    ((PatternTraits<typename PatternPairs::PatternT>::nbIdV +
+                      ...) > 0);
+                constexpr bool armsHaveGuards =
+                    (IsTopLevelGuard<typename PatternPairs::PatternT>::value ||
+                     ...);
+                // shape reason is reported only when the arm set would miss
+                // the flat paths even with a deduced result type.
+                constexpr bool armShapesNotFlatLiterals =
+                    !(useEqDispatchV<Value, PatternPairs...> ||
+                      useStrEqDispatchV<Value, PatternPairs...> ||
+                      useDsEqDispatchV<Value, PatternPairs...>);
+                DispatchReport<Strategy, armCount, !deduced, armsBindIds,
+                               armsHaveGuards,
+                               armShapesNotFlatLiterals>::emit();
+            }
+        }
+
+        template <bool exhaustive, typename RetOverride, typename Value,
+                  typename... PatternPairs>
+        MATCHIT_HOT constexpr decltype(auto)
+        matchPatterns(Value &&value, PatternPairs const &...patterns)
+        {
+            static_assert(
+                !exhaustive ||
+                    CoversAllAlternatives<std::decay_t<Value>,
+                                          PatternPairs...>::value,
+                "matchExhaustive over a std::variant must cover every "
+                "alternative or include a catch-all arm!");
+            using RetType =
+                typename RetTypeSelect<RetOverride, PatternPairs...>::type;
+            using TypeTuple = decltype(std::tuple_cat(
+                std::declval<typename PatternTraits<typename PatternPairs::PatternT>::
+                                 template AppResultTuple<Value>>()...));
+
+#if MATCHIT_PROFILE
+            SiteStats *profileStats = nullptr;
+            std::size_t profileArm = 0;
+            static_cast<void>(profileArm);
+#if defined(__GNUC__) || defined(__clang__)
+            if (!__builtin_is_constant_evaluated())
+#endif
+            {
+                profileStats = &siteStatsFor<PatternPairs...>();
+                profileStats->recordInvocation();
+            }
+#endif // MATCHIT_PROFILE
+#if MATCHIT_TRACE
+            char const *traceSite = nullptr;
+            std::size_t traceArm = 0;
+            static_cast<void>(traceArm);
+#if defined(__GNUC__) || defined(__clang__)
+            if (!__builtin_is_constant_evaluated())
+#endif
+            {
+                traceSite = traceSiteName<PatternPairs...>();
+                traceMatchEnter(traceSite, sizeof...(PatternPairs));
+            }
+#endif // MATCHIT_TRACE
+
+// profiling and tracing route every site through the standard arm loops
+// so per-arm counters and arm-selected events stay exact; the erased
+// compact loop is skipped.
+#if MATCHIT_COMPACT && !MATCHIT_PROFILE && !MATCHIT_TRACE
+            // Arm sets served by the app-hoist or flat-dispatch paths stay
+            // on them: those expand to a comparison per arm already and
+            // erasing them would change string/projection semantics for
+            // no size win. Everything else goes through the erased loop.
+            if constexpr (!useAppHoistV<PatternPairs...> &&
+                          !(std::is_same_v<RetOverride, Deduce> &&
+                            (useEqDispatchV<Value, PatternPairs...> ||
+                             useStrEqDispatchV<Value, PatternPairs...> ||
+                             useDsEqDispatchV<Value, PatternPairs...>)))
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                // constant evaluation cannot go through the erased thunks;
+                // keep the inlined fold for it. At runtime codegen the
+                // builtin folds to false, so only the compact path is
+                // emitted in optimized builds.
+                if (!__builtin_is_constant_evaluated())
+#endif
+                {
+                    return runCompactMatch<RetType, exhaustive, TypeTuple>(
+                        std::forward<Value>(value), patterns...);
+                }
+            }
+#endif // MATCHIT_COMPACT
+
+            if constexpr (useAppHoistV<PatternPairs...>)
+            {
+                auto const &unary = firstAppUnary(patterns...);
+                if (hoistUnariesAgree(unary, patterns...))
+                {
+                    // every arm projects through the same unary: compute the
+                    // projection once and match the inner patterns against
+                    // it. The projection outlives the handlers, so ids that
+                    // bind by pointer stay valid through execute().
+                    decltype(auto) projected = invoke_(unary, value);
+                    return matchPatterns<exhaustive, RetOverride>(
+                        projected, hoistAppArm(patterns)...);
+                }
+            }
+
+            if constexpr (std::is_same_v<RetOverride, Deduce> &&
+                          useEqDispatchV<Value, PatternPairs...>)
+            {
+                return runFlatArms<RetType, exhaustive>(
+                    [&value](auto const &arm)
+                    { return eqDispatchMatch(value, arm); },
+                    patterns...);
+            }
+            else if constexpr (std::is_same_v<RetOverride, Deduce> &&
+                               useStrEqDispatchV<Value, PatternPairs...>)
+            {
+                auto const sv = std::string_view{value};
+                return runFlatArms<RetType, exhaustive>(
+                    [sv](auto const &arm)
+                    { return strEqDispatchMatch(sv, arm); },
+                    patterns...);
+            }
+            else if constexpr (std::is_same_v<RetOverride, Deduce> &&
+                               useDsEqDispatchV<Value, PatternPairs...>)
+            {
+                using ColumnSeq =
+                    typename DsColumnOrder<Value, PatternPairs...>::seq;
+                return runFlatArms<RetType, exhaustive>(
+                    [&value](auto const &arm)
+                    { return dsEqDispatchMatch(value, arm, ColumnSeq{}); },
+                    patterns...);
+            }
+            // expression returning a preserved reference: every arm returns
+            // an lvalue reference, so the result is carried as a pointer and
+            // no referee is copied.
+            else if constexpr (std::is_lvalue_reference_v<RetType>)
+            {
+                constexpr auto const func =
+                    [](auto const &pattern, auto &&value,
+                       std::remove_reference_t<RetType> *&result) constexpr->bool
+                {
+                    if (!armPossiblyMatches(value, pattern))
+                    {
+                        return false;
+                    }
+                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                    if (pattern.matchValue(std::forward<Value>(value), context))
+                    {
+                        result = std::addressof(pattern.execute());
+                        processId(pattern, 0, IdProcess::kCANCEL);
+                        return true;
+                    }
+                    return false;
+                };
+                std::remove_reference_t<RetType> *result = nullptr;
+                bool const matched =
+                    (MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(func(patterns, value, result))) || ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                    else
+                    {
+                        throwNoMatch();
+                    }
+                }
+                static_cast<void>(matched);
+                return static_cast<RetType>(*result);
+            }
+            // expression with a pinned result type: construct RetType in
+            // place from the matching arm's expression, no common_type
+            // conversion and no default-construct-then-assign.
+            else if constexpr (!std::is_same_v<RetOverride, Deduce> &&
+                               !std::is_same_v<RetType, void>)
+            {
+                std::optional<RetType> result;
+                auto const func = [&result](auto const &pattern,
+                                            auto &&value) -> bool
+                {
+                    if (!armPossiblyMatches(value, pattern))
+                    {
+                        return false;
+                    }
+                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                    if (pattern.matchValue(std::forward<Value>(value), context))
+                    {
+                        result.emplace(pattern.execute());
+                        processId(pattern, 0, IdProcess::kCANCEL);
+                        return true;
+                    }
+                    return false;
+                };
+                bool const matched =
+                    (MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(func(patterns, value))) || ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                    else
+                    {
+                        throwNoMatch();
+                    }
+                }
+                static_cast<void>(matched);
+                return RetType{std::move(*result)};
+            }
+            // expression, has return value.
+            else if constexpr (!std::is_same_v<RetType, void>)
+            {
+                constexpr auto const func =
+                    [](auto const &pattern, auto &&value, RetType &result) constexpr->bool
+                {
+                    if (!armPossiblyMatches(value, pattern))
+                    {
+                        return false;
+                    }
+                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                    if (pattern.matchValue(std::forward<Value>(value), context))
+                    {
+                        result = pattern.execute();
+                        processId(pattern, 0, IdProcess::kCANCEL);
+                        return true;
+                    }
+                    return false;
+                };
+                RetType result{};
+                bool const matched =
+                    (MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(func(patterns, value, result))) || ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                    else
+                    {
+                        throwNoMatch();
+                    }
+                }
+                static_cast<void>(matched);
+                return result;
+            }
+            else
+            // statement, no return value, mismatching all patterns is not an error.
+            {
+                auto const func = [](auto const &pattern, auto &&value) -> bool
+                {
+                    if (!armPossiblyMatches(value, pattern))
+                    {
+                        return false;
+                    }
+                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                    if (pattern.matchValue(std::forward<Value>(value), context))
                     {
                         pattern.execute();
                         processId(pattern, 0, IdProcess::kCANCEL);
@@ -1703,11 +4924,506 @@ namespace matchit
                     }
                     return false;
                 };
-                bool const matched = (func(patterns, value) || ...);
+                bool const matched =
+                    (MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(func(patterns, value))) || ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                }
                 static_cast<void>(matched);
             }
         }
 
+#undef MATCHIT_PROFILED_TRY
+#undef MATCHIT_PROFILED_MISS
+#undef MATCHIT_TRACED_TRY
+
+        // matchPatterns variant for probing: a miss is not an error but an
+        // empty optional, so callers trying several pattern sets in
+        // sequence need neither a sentinel wildcard arm (which widens the
+        // arms' common type) nor a try/catch. There is no exceptional path
+        // at all — the miss branch is just the optional staying empty.
+        template <typename RetOverride, typename Value, typename... PatternPairs>
+        constexpr auto tryMatchPatterns(Value &&value,
+                                        PatternPairs const &...patterns)
+        {
+            using RetType =
+                typename RetTypeSelect<RetOverride, PatternPairs...>::type;
+            static_assert(!std::is_same_v<RetType, void>,
+                          "tryMatch needs value-returning arms: with void "
+                          "handlers a plain match() statement already treats "
+                          "a miss as a no-op.");
+            static_assert(!std::is_lvalue_reference_v<RetType>,
+                          "tryMatch carries the result inside std::optional; "
+                          "use match() for reference-returning arms.");
+            using TypeTuple = decltype(std::tuple_cat(
+                std::declval<typename PatternTraits<typename PatternPairs::PatternT>::
+                                 template AppResultTuple<Value>>()...));
+            std::optional<RetType> result;
+            auto const func = [&result](auto const &pattern,
+                                        auto &&value) -> bool
+            {
+                if (!armPossiblyMatches(value, pattern))
+                {
+                    return false;
+                }
+                auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                if (pattern.matchValue(std::forward<Value>(value), context))
+                {
+                    result.emplace(pattern.execute());
+                    processId(pattern, 0, IdProcess::kCANCEL);
+                    return true;
+                }
+                return false;
+            };
+            static_cast<void>((func(patterns, value) || ...));
+            return result;
+        }
+
+        // matchPatterns with the per-arm binding context placed in a
+        // caller-owned arena instead of the stack frame. Each arm allocates
+        // at the arena's current mark and releases back to it when done, so
+        // nested matches inside handlers stack within the same buffer.
+        // Matches whose arms need no context at all fall through to the
+        // plain runner untouched.
+        template <typename Value, typename... PatternPairs>
+        decltype(auto) matchPatternsArena(Arena &arena, Value &&value,
+                                          PatternPairs const &...patterns)
+        {
+            using RetType = typename PatternPairsRetType<PatternPairs...>::RetType;
+            using TypeTuple = decltype(std::tuple_cat(
+                std::declval<typename PatternTraits<typename PatternPairs::PatternT>::
+                                 template AppResultTuple<Value>>()...));
+            using ContextT = typename ContextTrait<TypeTuple>::ContextT;
+
+            if constexpr (std::is_empty_v<ContextT>)
+            {
+                static_cast<void>(arena);
+                return matchPatterns<false>(std::forward<Value>(value), patterns...);
+            }
+            else
+            {
+                auto const runArm = [&arena](auto const &pattern, auto &&value,
+                                             auto const &onMatch) -> bool
+                {
+                    if (!armPossiblyMatches(value, pattern))
+                    {
+                        return false;
+                    }
+                    auto const marked = arena.mark();
+                    auto *context = ::new (
+                        arena.allocate(sizeof(ContextT), alignof(ContextT)))
+                        ContextT{};
+                    bool matched = false;
+                    if (pattern.matchValue(std::forward<Value>(value), *context))
+                    {
+                        onMatch(pattern);
+                        processId(pattern, 0, IdProcess::kCANCEL);
+                        matched = true;
+                    }
+                    context->~ContextT();
+                    arena.release(marked);
+                    return matched;
+                };
+                if constexpr (std::is_lvalue_reference_v<RetType>)
+                {
+                    std::remove_reference_t<RetType> *result = nullptr;
+                    bool const matched =
+                        (runArm(patterns, value,
+                                [&result](auto const &pattern) {
+                                    result = std::addressof(pattern.execute());
+                                }) ||
+                         ...);
+                    if (!matched)
+                    {
+                        throwNoMatch();
+                    }
+                    return static_cast<RetType>(*result);
+                }
+                else if constexpr (!std::is_same_v<RetType, void>)
+                {
+                    RetType result{};
+                    bool const matched =
+                        (runArm(patterns, value,
+                                [&result](auto const &pattern)
+                                { result = pattern.execute(); }) ||
+                         ...);
+                    if (!matched)
+                    {
+                        throwNoMatch();
+                    }
+                    return result;
+                }
+                else
+                {
+                    bool const matched =
+                        (runArm(patterns, value,
+                                [](auto const &pattern) { pattern.execute(); }) ||
+                         ...);
+                    static_cast<void>(matched);
+                }
+            }
+        }
+
+        // Reusable matcher for loop-style dispatch: the arms (and every
+        // nested pattern object inside them) are built once and the object
+        // is invoked per value, so draining a queue through one pattern set
+        // does the setup a single time. Ids referenced by the arms live
+        // outside the matcher and keep their usual per-iteration semantics.
+        template <typename... PatternPairs>
+        class Matcher
+        {
+            std::tuple<PatternPairs...> mPatterns;
+
+        public:
+            constexpr explicit Matcher(PatternPairs const &...patterns)
+                : mPatterns{patterns...}
+            {
+            }
+            template <typename Value>
+            constexpr decltype(auto) operator()(Value &&value) const
+            {
+                return std::apply(
+                    [&value](auto const &...patterns) -> decltype(auto)
+                    {
+                        // bindings survive a successful match (see the
+                        // resetAfterFailure tests), so a reused arm set must
+                        // cancel them up front or a bound Id would turn into
+                        // an equality check on the next invocation.
+                        (processId(patterns.pattern(), 0, IdProcess::kCANCEL),
+                         ...);
+                        return matchPatterns<false, Deduce>(
+                            std::forward<Value>(value), patterns...);
+                    },
+                    mPatterns);
+            }
+        };
+
+        template <typename... PatternPairs>
+        constexpr auto matcher(PatternPairs const &...patterns)
+        {
+            return Matcher<PatternPairs...>{patterns...};
+        }
+
+        // matcher() whose arm set is proven Id-free. Without bindings the
+        // arms are immutable, so the result is constexpr-constructible and a
+        // single (even static) instance can be invoked from many threads
+        // concurrently. Arm sets that bind Ids carry their binding state in
+        // the pattern objects and need one matcher() per thread instead.
+        template <typename... PatternPairs>
+        constexpr auto compileMatch(PatternPairs const &...patterns)
+        {
+            static_assert(
+                (0 + ... +
+                 PatternTraits<typename PatternPairs::PatternT>::nbIdV) == 0,
+                "compileMatch requires Id-free arms: Id binding state lives "
+                "inside the pattern, so sharing it across threads would race. "
+                "Use matcher() per thread when arms bind Ids.");
+            return Matcher<PatternPairs...>{patterns...};
+        }
+
+        // matcher() that learns the trial order: per-arm hit counts are
+        // collected and every kReorderInterval invocations the arms are
+        // re-sorted so the hottest ones are tried first. Only valid when
+        // the arms (except a trailing catch-all, which stays pinned last)
+        // are mutually disjoint — reordering overlapping arms would change
+        // which one wins. Hit counting mutates the object, so share one
+        // instance per thread, as with any matcher() whose arms bind Ids.
+        template <typename... PatternPairs>
+        class AdaptiveMatcher
+        {
+            static constexpr std::size_t nbArms = sizeof...(PatternPairs);
+            static constexpr std::uint32_t kReorderInterval = 1024;
+            std::tuple<PatternPairs...> mPatterns;
+            mutable std::array<std::size_t, nbArms> mOrder{};
+            mutable std::array<std::uint64_t, nbArms> mHits{};
+            mutable std::uint32_t mSinceReorder{};
+
+            // runtime trial index -> compile-time arm: attempt the arm and
+            // feed the matching one to sink before its ids are cancelled.
+            template <std::size_t I, typename Value, typename Sink>
+            bool tryArmAt(std::size_t idx, Value &&value, Sink const &sink) const
+            {
+                using TypeTuple = decltype(std::tuple_cat(
+                    std::declval<
+                        typename PatternTraits<typename PatternPairs::PatternT>::
+                            template AppResultTuple<Value>>()...));
+                if (I == idx)
+                {
+                    auto const &arm = std::get<I>(mPatterns);
+                    if (!armPossiblyMatches(value, arm))
+                    {
+                        return false;
+                    }
+                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                    if (arm.matchValue(std::forward<Value>(value), context))
+                    {
+                        sink(arm);
+                        processId(arm, 0, IdProcess::kCANCEL);
+                        return true;
+                    }
+                    return false;
+                }
+                if constexpr (I + 1 < nbArms)
+                {
+                    return tryArmAt<I + 1>(idx, std::forward<Value>(value),
+                                           sink);
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            void recordHit(std::size_t trial) const
+            {
+                ++mHits[mOrder[trial]];
+                if (++mSinceReorder != kReorderInterval)
+                {
+                    return;
+                }
+                mSinceReorder = 0;
+                // stable insertion sort by descending hits over all but the
+                // last slot: ties and the trailing catch-all keep their
+                // source order.
+                for (std::size_t i = 1; i + 1 < nbArms; ++i)
+                {
+                    auto const idx = mOrder[i];
+                    std::size_t j = i;
+                    for (; j != 0 && mHits[mOrder[j - 1]] < mHits[idx]; --j)
+                    {
+                        mOrder[j] = mOrder[j - 1];
+                    }
+                    mOrder[j] = idx;
+                }
+            }
+
+        public:
+            explicit AdaptiveMatcher(PatternPairs const &...patterns)
+                : mPatterns{patterns...}
+            {
+                for (std::size_t i = 0; i != nbArms; ++i)
+                {
+                    mOrder[i] = i;
+                }
+            }
+            template <typename Value>
+            decltype(auto) operator()(Value &&value) const
+            {
+                using RetType =
+                    typename PatternPairsRetType<PatternPairs...>::RetType;
+                std::apply([](auto const &...patterns)
+                           { (processId(patterns.pattern(), 0,
+                                        IdProcess::kCANCEL),
+                              ...); },
+                           mPatterns);
+                if constexpr (std::is_same_v<RetType, void>)
+                {
+                    for (std::size_t i = 0; i != nbArms; ++i)
+                    {
+                        if (tryArmAt<0>(mOrder[i], std::forward<Value>(value),
+                                        [](auto const &arm)
+                                        { arm.execute(); }))
+                        {
+                            recordHit(i);
+                            return;
+                        }
+                    }
+                }
+                else
+                {
+                    static_assert(!std::is_lvalue_reference_v<RetType>,
+                                  "adaptiveMatcher carries the result by "
+                                  "value; use matcher() for reference-"
+                                  "returning arms.");
+                    std::optional<RetType> result;
+                    auto const sink = [&result](auto const &arm)
+                    { result.emplace(arm.execute()); };
+                    for (std::size_t i = 0; i != nbArms; ++i)
+                    {
+                        if (tryArmAt<0>(mOrder[i], std::forward<Value>(value),
+                                        sink))
+                        {
+                            recordHit(i);
+                            return RetType{std::move(*result)};
+                        }
+                    }
+                    throwNoMatch();
+                }
+            }
+            // the trial order currently in effect, hottest first; exposed
+            // so callers (and tests) can observe what the counters learned.
+            constexpr std::array<std::size_t, nbArms> const &trialOrder() const
+            {
+                return mOrder;
+            }
+        };
+
+        template <typename... PatternPairs>
+        auto adaptiveMatcher(PatternPairs const &...patterns)
+        {
+            return AdaptiveMatcher<PatternPairs...>{patterns...};
+        }
+
+        // State-machine table compilation. An arm matrix over
+        // match(state, event) whose arms are all ds(literal, literal) —
+        // wildcards allowed per column and as a catch-all — is dense over
+        // two small enum domains, so instead of trying up to N tuple
+        // compares per event the whole decision lowers to one 2D table
+        // lookup of the winning arm's index. The table is filled at
+        // construction with first-match-wins semantics and the object is
+        // constexpr-constructible, so a static instance bakes the table
+        // into rodata.
+        template <typename Cell>
+        constexpr auto isTableCellV = std::is_integral_v<Cell> ||
+                                      std::is_enum_v<Cell> ||
+                                      std::is_same_v<Cell, Wildcard>;
+
+        template <typename Pattern>
+        constexpr auto isTableArmV = std::is_same_v<Pattern, Wildcard>;
+
+        template <typename A, typename B>
+        constexpr auto isTableArmV<Ds<A, B>> =
+            isTableCellV<A> && isTableCellV<B>;
+
+        template <typename Cell>
+        constexpr bool tableCellMatches(Cell const &cell, std::size_t index)
+        {
+            if constexpr (std::is_same_v<Cell, Wildcard>)
+            {
+                static_cast<void>(cell);
+                static_cast<void>(index);
+                return true;
+            }
+            else
+            {
+                return static_cast<std::size_t>(cell) == index;
+            }
+        }
+
+        template <std::size_t nbStates, std::size_t nbEvents,
+                  typename... PatternPairs>
+        class TableMatcher
+        {
+            static constexpr std::size_t nbArms = sizeof...(PatternPairs);
+            static constexpr std::size_t kMiss = nbArms;
+            static_assert(
+                (isTableArmV<typename PatternPairs::PatternT> && ...),
+                "tableMatcher arms must be ds(literal, literal) over "
+                "integrals/enums (wildcards allowed) or a catch-all _.");
+            static_assert(
+                (0 + ... +
+                 PatternTraits<typename PatternPairs::PatternT>::nbIdV) == 0,
+                "tableMatcher arms cannot bind Ids: the table records only "
+                "which arm wins.");
+
+            std::tuple<PatternPairs...> mPatterns;
+            std::array<std::array<std::size_t, nbEvents>, nbStates> mTable{};
+
+            template <typename PatternPair>
+            constexpr static bool armMatchesCell(PatternPair const &arm,
+                                                 std::size_t state,
+                                                 std::size_t event)
+            {
+                using Pattern = typename PatternPair::PatternT;
+                if constexpr (std::is_same_v<Pattern, Wildcard>)
+                {
+                    static_cast<void>(arm);
+                    static_cast<void>(state);
+                    static_cast<void>(event);
+                    return true;
+                }
+                else
+                {
+                    return tableCellMatches(std::get<0>(arm.pattern().patterns()),
+                                            state) &&
+                           tableCellMatches(std::get<1>(arm.pattern().patterns()),
+                                            event);
+                }
+            }
+
+            constexpr std::size_t armIndexFor(std::size_t state,
+                                              std::size_t event) const
+            {
+                return std::apply(
+                    [state, event](auto const &...arms)
+                    {
+                        std::size_t winner = kMiss;
+                        std::size_t index = 0;
+                        // first match wins, as in source order.
+                        ((winner == kMiss && armMatchesCell(arms, state, event)
+                              ? winner = index++
+                              : index++),
+                         ...);
+                        return winner;
+                    },
+                    mPatterns);
+            }
+
+            using RetType =
+                typename PatternPairsRetType<PatternPairs...>::RetType;
+
+            template <std::size_t I>
+            constexpr RetType invokeArm(std::size_t idx) const
+            {
+                if (I == idx)
+                {
+                    return static_cast<RetType>(std::get<I>(mPatterns).execute());
+                }
+                if constexpr (I + 1 < nbArms)
+                {
+                    return invokeArm<I + 1>(idx);
+                }
+                else if constexpr (std::is_same_v<RetType, void>)
+                {
+                    // statement semantics: a miss with void handlers is not
+                    // an error, as in match().
+                    return;
+                }
+                else
+                {
+                    throwNoMatch();
+                }
+            }
+
+        public:
+            constexpr explicit TableMatcher(PatternPairs const &...patterns)
+                : mPatterns{patterns...}
+            {
+                for (std::size_t s = 0; s != nbStates; ++s)
+                {
+                    for (std::size_t e = 0; e != nbEvents; ++e)
+                    {
+                        mTable[s][e] = armIndexFor(s, e);
+                    }
+                }
+            }
+            template <typename State, typename Event>
+            constexpr RetType operator()(State state, Event event) const
+            {
+                auto const s = static_cast<std::size_t>(state);
+                auto const e = static_cast<std::size_t>(event);
+                // out-of-domain values miss the table; a linear scan still
+                // gives wildcard arms their shot.
+                auto const idx = (s < nbStates && e < nbEvents)
+                                     ? mTable[s][e]
+                                     : armIndexFor(s, e);
+                return invokeArm<0>(idx);
+            }
+        };
+
+        template <std::size_t nbStates, std::size_t nbEvents,
+                  typename... PatternPairs>
+        constexpr auto tableMatcher(PatternPairs const &...patterns)
+        {
+            return TableMatcher<nbStates, nbEvents, PatternPairs...>{
+                patterns...};
+        }
+
     } // namespace impl
 
     // export symbols
@@ -1715,15 +5431,38 @@ namespace matchit
     using impl::and_;
     using impl::app;
     using impl::ds;
+    using impl::glob;
     using impl::Id;
+    using impl::adaptiveMatcher;
+    using impl::AdaptiveMatcher;
+    using impl::compileMatch;
+    using impl::likely;
+    using impl::matcher;
+    using impl::Matcher;
     using impl::meet;
     using impl::not_;
     using impl::ooo;
     using impl::or_;
     using impl::pattern;
+#if MATCHIT_PROFILE
+    using impl::dumpProfile;
+    using impl::profileSnapshot;
+    using impl::SiteProfileSnapshot;
+#endif // MATCHIT_PROFILE
+#if MATCHIT_TRACE
+    using impl::setTraceHooks;
+    using impl::TraceHook;
+#endif // MATCHIT_TRACE
+    using impl::SharedId;
+    using impl::streamed;
+    using impl::Streamed;
     using impl::Subrange;
     using impl::SubrangeT;
+    using impl::tableMatcher;
+    using impl::TableMatcher;
+    using impl::unlikely;
     using impl::when;
+    using impl::within;
 } // namespace matchit
 
 #endif // MATCHIT_PATTERNS_H
@@ -2,7 +2,24 @@
 #define MATCHIT_UTILITY_H
 
 #include <any>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <typeinfo>
 #include <variant>
+#include <vector>
+
+// std::execution policy overloads light up when the caller includes
+// <execution> before this header. It is not pulled in here: merely
+// including it can add a link-time dependency on the parallel backend
+// (TBB with libstdc++), which a header-only library must not impose.
+#if defined(_GLIBCXX_EXECUTION) || defined(_LIBCPP_EXECUTION) || \
+    defined(_EXECUTION_) || defined(_PSTL_EXECUTION_POLICIES_DEFINED)
+#define MATCHIT_HAS_EXECUTION 1
+#else
+#define MATCHIT_HAS_EXECUTION 0
+#endif
 
 namespace matchit
 {
@@ -14,12 +31,13 @@ namespace matchit
     { return static_cast<T>(input); };
 
     constexpr auto deref = [](auto &&x) -> decltype(*x) & { return *x; };
+
+    // fused nodes (Some/None in patterns.h): one emptiness test, the
+    // contained value bound by reference, no And/App machinery.
     constexpr auto some = [](auto const pat)
-    {
-      return and_(app(cast<bool>, true), app(deref, pat));
-    };
+    { return Some<std::decay_t<decltype(pat)>>{pat}; };
 
-    constexpr auto none = app(cast<bool>, false);
+    constexpr auto none = None{};
 
     template <typename Value, typename Variant, typename = std::void_t<>>
     struct ViaGetIf : std::false_type
@@ -41,6 +59,78 @@ namespace matchit
 
     static_assert(viaGetIfV<int, std::variant<int, bool>>);
 
+    // Sealed-hierarchy downcasts. Hierarchies following the kind-tag
+    // convention (a `kind` member or `kind()` accessor on the base plus a
+    // static `k` on each derived class, as in the Closed-Class-Hierarchy
+    // sample) get as<Derived> lowered to a tag compare plus static_cast, with
+    // no dynamic_cast and no user-written get_if. A user-provided get_if
+    // still takes precedence.
+    template <typename T, typename B, typename = std::void_t<>>
+    struct ViaKindMember : std::false_type
+    {
+    };
+
+    template <typename T, typename B>
+    struct ViaKindMember<
+        T, B, std::void_t<decltype(std::declval<B const &>().kind == T::k)>>
+        : std::true_type
+    {
+    };
+
+    template <typename T, typename B, typename = std::void_t<>>
+    struct ViaKindFunc : std::false_type
+    {
+    };
+
+    template <typename T, typename B>
+    struct ViaKindFunc<
+        T, B, std::void_t<decltype(std::declval<B const &>().kind() == T::k)>>
+        : std::true_type
+    {
+    };
+
+    template <typename T, typename B>
+    constexpr auto viaKindTagV =
+        (ViaKindMember<T, B>::value || ViaKindFunc<T, B>::value) &&
+        !viaGetIfV<T, B>;
+
+    template <typename B, typename = std::void_t<>>
+    struct HasKindFunc : std::false_type
+    {
+    };
+
+    template <typename B>
+    struct HasKindFunc<B,
+                       std::void_t<decltype(std::declval<B const &>().kind())>>
+        : std::true_type
+    {
+    };
+
+    template <typename B>
+    constexpr decltype(auto) kindOf(B const &b)
+    {
+      if constexpr (HasKindFunc<B>::value)
+      {
+        return b.kind();
+      }
+      else
+      {
+        return b.kind;
+      }
+    }
+
+    template <typename T, typename B, typename = std::void_t<>>
+    struct CanStaticDowncast : std::false_type
+    {
+    };
+
+    template <typename T, typename B>
+    struct CanStaticDowncast<
+        T, B, std::void_t<decltype(static_cast<T *>(std::declval<B *>()))>>
+        : std::true_type
+    {
+    };
+
     template <typename T>
     class AsPointer
     {
@@ -77,20 +167,54 @@ namespace matchit
         return static_cast<T*>(std::addressof(d));
       }
 
-      // cast to derived class
-      template <typename B, typename std::enable_if<!viaGetIfV<T, B> && std::is_base_of_v<B, T>>::type * = nullptr>
+      // cast to derived class. The exact-type test compiles down to a
+      // vtable-pointer comparison and handles the common case of matching a
+      // leaf class; dynamic_cast only runs when T is an intermediate base of
+      // the dynamic type. Hierarchies with virtual bases (where the
+      // static_cast is ill-formed) keep the plain dynamic_cast.
+      template <typename B, typename std::enable_if<!viaGetIfV<T, B> && std::is_base_of_v<B, T> && !viaKindTagV<T, B>>::type * = nullptr>
       constexpr auto operator()(B const& b) const
           -> decltype(dynamic_cast<T const *>(std::addressof(b)))
       {
+        if constexpr (CanStaticDowncast<T, B>::value)
+        {
+          if (typeid(b) == typeid(T))
+          {
+            return static_cast<T const *>(std::addressof(b));
+          }
+        }
         return dynamic_cast<T const *>(std::addressof(b));
       }
 
       // cast to derived class
-      template <typename B, typename std::enable_if<!viaGetIfV<T, B> && std::is_base_of_v<B, T>>::type * = nullptr>
+      template <typename B, typename std::enable_if<!viaGetIfV<T, B> && std::is_base_of_v<B, T> && !viaKindTagV<T, B>>::type * = nullptr>
       constexpr auto operator()(B& b) const
           -> decltype(dynamic_cast<T*>(std::addressof(b)))
       {
-        return dynamic_cast<T*>(std::addressof(b));
+        if constexpr (CanStaticDowncast<T, B>::value)
+        {
+          if (typeid(b) == typeid(T))
+          {
+            return static_cast<T *>(std::addressof(b));
+          }
+        }
+        return dynamic_cast<T *>(std::addressof(b));
+      }
+
+      // cast to derived class within a sealed, kind-tagged hierarchy
+      template <typename B, typename std::enable_if<std::is_base_of_v<B, T> && viaKindTagV<T, B>>::type * = nullptr>
+      constexpr T const *operator()(B const& b) const
+      {
+        return kindOf(b) == T::k ? static_cast<T const *>(std::addressof(b))
+                                 : nullptr;
+      }
+
+      // cast to derived class within a sealed, kind-tagged hierarchy
+      template <typename B, typename std::enable_if<std::is_base_of_v<B, T> && viaKindTagV<T, B>>::type * = nullptr>
+      constexpr T *operator()(B& b) const
+      {
+        return kindOf(b) == T::k ? static_cast<T *>(std::addressof(b))
+                                 : nullptr;
       }
 
       constexpr auto operator()(T const& b) const
@@ -124,6 +248,636 @@ namespace matchit
           { return false; });
     }
 
+    // Single-arm conditional: ifLet(pat, value, onMatch[, onMiss]) probes
+    // one pattern without assembling an arm set — no PatternPairsRetType
+    // computation, no per-arm fold, just the pattern's own context and one
+    // matchPattern walk; the moral equivalent of a hand-written
+    // `if (auto *p = get_if<T>(&v))`. Handlers follow the arm rules:
+    // nullary callables reading bound ids through their captures, or
+    // expression values. With onMatch alone the result is a bool (did it
+    // match) for a void handler, otherwise an optional of the handler's
+    // result, empty on a miss; with onMiss the handlers' common type is
+    // returned.
+    template <typename Pattern, typename Value, typename OnMatch>
+    constexpr auto ifLet(Pattern const &pat, Value &&value, OnMatch &&onMatch)
+    {
+      auto const onMatchFn = toNullary(onMatch);
+      auto const p = canonicalize(pat);
+      using TypeTuple = typename PatternTraits<std::decay_t<decltype(p)>>::
+          template AppResultTuple<Value>;
+      using RetT = std::invoke_result_t<decltype(onMatchFn)>;
+      auto context = typename ContextTrait<TypeTuple>::ContextT{};
+      if constexpr (std::is_void_v<RetT>)
+      {
+        if (matchPattern(std::forward<Value>(value), p, 0, context))
+        {
+          onMatchFn();
+          processId(p, 0, IdProcess::kCANCEL);
+          return true;
+        }
+        return false;
+      }
+      else
+      {
+        if (matchPattern(std::forward<Value>(value), p, 0, context))
+        {
+          auto result = std::optional<std::decay_t<RetT>>{onMatchFn()};
+          processId(p, 0, IdProcess::kCANCEL);
+          return result;
+        }
+        return std::optional<std::decay_t<RetT>>{};
+      }
+    }
+
+    template <typename Pattern, typename Value, typename OnMatch,
+              typename OnMiss>
+    constexpr auto ifLet(Pattern const &pat, Value &&value, OnMatch &&onMatch,
+                         OnMiss &&onMiss)
+    {
+      auto const onMatchFn = toNullary(onMatch);
+      auto const onMissFn = toNullary(onMiss);
+      auto const p = canonicalize(pat);
+      using TypeTuple = typename PatternTraits<std::decay_t<decltype(p)>>::
+          template AppResultTuple<Value>;
+      using MatchRetT = std::invoke_result_t<decltype(onMatchFn)>;
+      using MissRetT = std::invoke_result_t<decltype(onMissFn)>;
+      auto context = typename ContextTrait<TypeTuple>::ContextT{};
+      if constexpr (std::is_void_v<MatchRetT> && std::is_void_v<MissRetT>)
+      {
+        if (matchPattern(std::forward<Value>(value), p, 0, context))
+        {
+          onMatchFn();
+          processId(p, 0, IdProcess::kCANCEL);
+        }
+        else
+        {
+          onMissFn();
+        }
+      }
+      else
+      {
+        using RetT = std::common_type_t<MatchRetT, MissRetT>;
+        if (matchPattern(std::forward<Value>(value), p, 0, context))
+        {
+          RetT result = onMatchFn();
+          processId(p, 0, IdProcess::kCANCEL);
+          return result;
+        }
+        return static_cast<RetT>(onMissFn());
+      }
+    }
+
+    // Multi-substring search automaton backing containsAny. The literal
+    // set is compiled once into an Aho-Corasick automaton with completed
+    // goto transitions, so scanning is a single table walk per character —
+    // O(text) however many literals there are — where composing meet
+    // predicates would cost one find() per literal.
+    class AhoCorasick
+    {
+      struct Node
+      {
+        std::array<int32_t, 256> next{};
+        int32_t fail = 0;
+        int32_t out = -1;
+      };
+      std::vector<Node> mNodes;
+      std::vector<std::string> mLiterals;
+
+      static constexpr int32_t kUnset = -1;
+
+      int32_t &slot(int32_t node, unsigned char c)
+      {
+        return mNodes[static_cast<std::size_t>(node)].next[c];
+      }
+
+    public:
+      explicit AhoCorasick(std::vector<std::string> literals)
+          : mLiterals{std::move(literals)}
+      {
+        mNodes.emplace_back();
+        mNodes.front().next.fill(kUnset);
+        for (std::size_t i = 0; i != mLiterals.size(); ++i)
+        {
+          int32_t state = 0;
+          for (char const ch : mLiterals[i])
+          {
+            // read by value: growing mNodes below invalidates references.
+            auto next = slot(state, static_cast<unsigned char>(ch));
+            if (next == kUnset)
+            {
+              next = static_cast<int32_t>(mNodes.size());
+              slot(state, static_cast<unsigned char>(ch)) = next;
+              mNodes.emplace_back();
+              mNodes.back().next.fill(kUnset);
+            }
+            state = next;
+          }
+          auto &out = mNodes[static_cast<std::size_t>(state)].out;
+          if (out == kUnset) // first literal listed wins duplicates
+          {
+            out = static_cast<int32_t>(i);
+          }
+        }
+        // breadth-first completion of goto and fail links: unset edges
+        // point where the failure state would go, so the scan never
+        // chases fail links.
+        std::vector<int32_t> queue;
+        for (std::size_t c = 0; c != 256; ++c)
+        {
+          auto &next = slot(0, static_cast<unsigned char>(c));
+          if (next == kUnset)
+          {
+            next = 0;
+          }
+          else
+          {
+            queue.push_back(next);
+          }
+        }
+        for (std::size_t head = 0; head != queue.size(); ++head)
+        {
+          auto const u = queue[head];
+          auto const fail = mNodes[static_cast<std::size_t>(u)].fail;
+          auto &node = mNodes[static_cast<std::size_t>(u)];
+          if (node.out == kUnset) // a proper suffix may be a literal
+          {
+            node.out = mNodes[static_cast<std::size_t>(fail)].out;
+          }
+          for (std::size_t c = 0; c != 256; ++c)
+          {
+            auto const viaFail =
+                mNodes[static_cast<std::size_t>(fail)]
+                    .next[static_cast<unsigned char>(c)];
+            auto &next = slot(u, static_cast<unsigned char>(c));
+            if (next == kUnset)
+            {
+              next = viaFail;
+            }
+            else
+            {
+              mNodes[static_cast<std::size_t>(next)].fail = viaFail;
+              queue.push_back(next);
+            }
+          }
+        }
+      }
+
+      // the literal whose occurrence ends first in text; ties at the same
+      // end position go to the longer occurrence, then to listing order.
+      std::optional<std::string_view> find(std::string_view text) const
+      {
+        int32_t state = 0;
+        for (char const ch : text)
+        {
+          state = mNodes[static_cast<std::size_t>(state)]
+                      .next[static_cast<unsigned char>(ch)];
+          auto const out = mNodes[static_cast<std::size_t>(state)].out;
+          if (out != kUnset)
+          {
+            return std::string_view{mLiterals[static_cast<std::size_t>(out)]};
+          }
+        }
+        return std::nullopt;
+      }
+    };
+
+    // Pattern factory for classifying a string by which of many substrings
+    // it contains: containsAny("timeout", "refused")(which) matches any
+    // string-like scrutinee containing one of the literals and exposes the
+    // hit through the inner pattern (an Id<std::string_view>, or _ for a
+    // plain containment test). The automaton is built when the factory is
+    // called, so hoist the result (static, or inside a matcher()) to pay
+    // construction once; arms sharing one factory result also share the
+    // automaton.
+    template <typename... Literals>
+    auto containsAny(Literals const &...literals)
+    {
+      static_assert(sizeof...(Literals) > 0,
+                    "containsAny needs at least one literal!");
+      auto const automaton = std::make_shared<AhoCorasick const>(
+          std::vector<std::string>{std::string{literals}...});
+      return [automaton](auto const &pat)
+      {
+        return app(
+            [automaton](auto const &text) -> std::optional<std::string_view>
+            { return automaton->find(std::string_view{text}); },
+            some(pat));
+      };
+    }
+
+    // Bulk classification: run one arm set over every element. The arm set
+    // is built once up front (matcher() hoists the pattern setup) instead of
+    // being re-assembled per element as match() in a loop would. Handlers
+    // follow the usual statement/expression rules, so for pure side effects
+    // give void handlers or add a catch-all arm — with non-void handlers an
+    // element no arm matches throws.
+    template <typename Iter, typename... PatternPairs>
+    auto matchAllIter(Iter first, Iter last, PatternPairs const &...patterns)
+    {
+      auto const arms = matcher(patterns...);
+      for (; first != last; ++first)
+      {
+        arms(*first);
+      }
+    }
+
+    template <typename Iter, typename... PatternPairs>
+    auto matchAllParIter(Iter first, Iter last, PatternPairs const &...patterns)
+    {
+      static_assert(
+          (0 + ... +
+           PatternTraits<typename PatternPairs::PatternT>::nbIdV) == 0,
+          "parallel matchAll needs id-free arms: id bindings live in the "
+          "pattern objects and would race across workers.");
+      auto const len = static_cast<std::size_t>(std::distance(first, last));
+      auto const hw = std::thread::hardware_concurrency();
+      auto const nbWorkers = std::min<std::size_t>(hw == 0 ? 1 : hw, len);
+      if (nbWorkers <= 1)
+      {
+        matchAllIter(first, last, patterns...);
+        return;
+      }
+      auto const chunk = len / nbWorkers;
+      auto const rem = len % nbWorkers;
+      std::vector<std::thread> workers;
+      workers.reserve(nbWorkers);
+      auto cursor = first;
+      for (std::size_t w = 0; w != nbWorkers; ++w)
+      {
+        auto const take = chunk + (w < rem ? 1U : 0U);
+        auto const chunkFirst = cursor;
+        std::advance(cursor, static_cast<std::ptrdiff_t>(take));
+        // each worker owns its own copy of the arm set, so no pattern state
+        // is shared across threads.
+        workers.emplace_back(
+            [chunkFirst, take, patterns...]
+            {
+              auto const arms = matcher(patterns...);
+              auto it = chunkFirst;
+              for (std::size_t i = 0; i != take; ++i, ++it)
+              {
+                arms(*it);
+              }
+            });
+      }
+      for (auto &worker : workers)
+      {
+        worker.join();
+      }
+    }
+
+    template <typename Iter, typename... PatternPairs,
+              typename std::enable_if<!isRangeV<Iter>>::type * = nullptr>
+    auto matchAll(Iter first, Iter last, PatternPairs const &...patterns)
+    {
+      matchAllIter(first, last, patterns...);
+    }
+
+    template <typename Range, typename... PatternPairs,
+              typename std::enable_if<isRangeV<Range>>::type * = nullptr>
+    auto matchAll(Range &&range, PatternPairs const &...patterns)
+    {
+      matchAllIter(std::begin(range), std::end(range), patterns...);
+    }
+
+#if MATCHIT_HAS_EXECUTION
+    template <typename Policy>
+    constexpr auto isParallelPolicyV =
+        std::is_same<Policy, std::execution::parallel_policy>::value ||
+        std::is_same<Policy, std::execution::parallel_unsequenced_policy>::value;
+
+    template <typename Iter, typename... PatternPairs,
+              typename std::enable_if<!isRangeV<Iter>>::type * = nullptr>
+    auto matchAll(std::execution::sequenced_policy, Iter first, Iter last,
+                  PatternPairs const &...patterns)
+    {
+      matchAllIter(first, last, patterns...);
+    }
+
+    template <typename Range, typename... PatternPairs,
+              typename std::enable_if<isRangeV<Range>>::type * = nullptr>
+    auto matchAll(std::execution::sequenced_policy, Range &&range,
+                  PatternPairs const &...patterns)
+    {
+      matchAllIter(std::begin(range), std::end(range), patterns...);
+    }
+
+    template <typename Policy, typename Iter, typename... PatternPairs,
+              typename std::enable_if<isParallelPolicyV<Policy> &&
+                                      !isRangeV<Iter>>::type * = nullptr>
+    auto matchAll(Policy, Iter first, Iter last,
+                  PatternPairs const &...patterns)
+    {
+      matchAllParIter(first, last, patterns...);
+    }
+
+    template <typename Policy, typename Range, typename... PatternPairs,
+              typename std::enable_if<isParallelPolicyV<Policy> &&
+                                      isRangeV<Range>>::type * = nullptr>
+    auto matchAll(Policy, Range &&range, PatternPairs const &...patterns)
+    {
+      matchAllParIter(std::begin(range), std::end(range), patterns...);
+    }
+#endif // MATCHIT_HAS_EXECUTION
+
+    // Bulk mapping: match every element and write each result through an
+    // output iterator — the clip/relu idiom applied to a whole array.
+    //
+    // Arms that bind no ids and materialize nothing in the binding context
+    // (range/literal/meet patterns over arithmetic elements) take a kernel
+    // that reduces each element to a chain of selects with no stores, no
+    // cancel walks and no early exits, which the optimizer turns into
+    // branchless code and vectorizes across lanes. Arms with ids or
+    // context-backed patterns keep the full per-element match.
+    template <typename RetT, typename Value>
+    constexpr RetT mapOne(Value const &)
+    {
+      throwNoMatch();
+    }
+
+    template <typename RetT, typename Value, typename First,
+              typename... Rest>
+    constexpr RetT mapOne(Value const &value, First const &first,
+                          Rest const &...rest)
+    {
+      Context<> dummy{};
+      return matchPattern(value, first.pattern(), 0, dummy)
+                 ? static_cast<RetT>(first.execute())
+                 : mapOne<RetT>(value, rest...);
+    }
+
+    template <typename Elem, typename... PatternPairs>
+    constexpr auto useSelectKernelV =
+        ((PatternTraits<typename PatternPairs::PatternT>::nbIdV == 0) &&
+         ...) &&
+        (std::is_same_v<typename PatternTraits<
+                            typename PatternPairs::PatternT>::
+                            template AppResultTuple<Elem &>,
+                        std::tuple<>> &&
+         ...);
+
+    template <typename Iter, typename OutIter, typename... PatternPairs,
+              typename std::enable_if<!isRangeV<Iter>>::type * = nullptr>
+    constexpr auto mapAll(Iter first, Iter last, OutIter out,
+                          PatternPairs const &...patterns)
+    {
+      using Elem = std::decay_t<decltype(*first)>;
+      using RetT =
+          typename PatternPairsRetType<PatternPairs...>::RetType;
+      if constexpr (useSelectKernelV<Elem, PatternPairs...>)
+      {
+        for (; first != last; ++first, ++out)
+        {
+          *out = mapOne<RetT>(*first, patterns...);
+        }
+      }
+      else
+      {
+        auto const arms = matcher(patterns...);
+        for (; first != last; ++first, ++out)
+        {
+          *out = arms(*first);
+        }
+      }
+      return out;
+    }
+
+    template <typename Range, typename OutIter, typename... PatternPairs,
+              typename std::enable_if<isRangeV<Range>>::type * = nullptr>
+    constexpr auto mapAll(Range &&range, OutIter out,
+                          PatternPairs const &...patterns)
+    {
+      return mapAll(std::begin(range), std::end(range), out, patterns...);
+    }
+
+    // Fork-join for recursive tree matches: evaluate two independent
+    // subcomputations — typically the two operands an arm bound with
+    // ds(l, r) — concurrently while the recursion is above a depth cutoff,
+    // serially below it. The cutoff bounds the task count to 2^cutoff, so
+    // the splits near the root fan out across cores and the vast majority
+    // of nodes run in the caller's thread with zero scheduling overhead.
+    // The caller's thread always takes the left side and only the right
+    // side is spawned, so a fork costs one task per split, not two.
+    //
+    // Handlers may share bound ids freely across the two sides: the match
+    // that bound them has completed, so both sides only read. Recursive
+    // matches inside the sides must declare their own local Ids, as the
+    // recursive samples already do.
+    template <typename Left, typename Right>
+    auto forkJoin(int32_t depth, int32_t cutoff, Left &&left, Right &&right)
+    {
+      if (depth < cutoff)
+      {
+        auto rightResult =
+            std::async(std::launch::async, std::forward<Right>(right));
+        auto leftResult = std::forward<Left>(left)();
+        return std::make_pair(std::move(leftResult), rightResult.get());
+      }
+      auto leftResult = std::forward<Left>(left)();
+      auto rightResult = std::forward<Right>(right)();
+      return std::make_pair(std::move(leftResult), std::move(rightResult));
+    }
+
+    // Lazy pipeline stage: range | matchEach(arms...) yields each element's
+    // match result on demand, so matchit dispatch composes with other view
+    // adaptors without materializing a vector between them. The arm set is
+    // compiled once (matcher()) and shared by every element; dereferencing
+    // an iterator runs the match. Input-iterator semantics: each deref
+    // recomputes, single pass is the intended use. The typedefs below also
+    // satisfy the C++20 input_range concepts, so the view drops into
+    // std::ranges pipelines when built as C++20.
+    template <typename Iter, typename MatcherT>
+    class MatchEachIterator
+    {
+      Iter mIter{};
+      MatcherT const *mMatcher = nullptr;
+
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using reference = decltype((*std::declval<MatcherT const *>())(
+          *std::declval<Iter const &>()));
+      using value_type = std::decay_t<reference>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+
+      // default constructible so it models semiregular, which C++20
+      // ranges::end demands of a sentinel.
+      constexpr MatchEachIterator() = default;
+      constexpr MatchEachIterator(Iter iter, MatcherT const &matcher)
+          : mIter{iter}, mMatcher{&matcher}
+      {
+      }
+      constexpr decltype(auto) operator*() const { return (*mMatcher)(*mIter); }
+      constexpr MatchEachIterator &operator++()
+      {
+        ++mIter;
+        return *this;
+      }
+      constexpr MatchEachIterator operator++(int)
+      {
+        auto old = *this;
+        ++mIter;
+        return old;
+      }
+      friend constexpr bool operator==(MatchEachIterator const &lhs,
+                                       MatchEachIterator const &rhs)
+      {
+        return lhs.mIter == rhs.mIter;
+      }
+      friend constexpr bool operator!=(MatchEachIterator const &lhs,
+                                       MatchEachIterator const &rhs)
+      {
+        return !(lhs == rhs);
+      }
+    };
+
+    template <typename Range, typename MatcherT>
+    class MatchEachView
+    {
+      // Range is a reference type when the adaptor was applied to an
+      // lvalue (view semantics) and an object type for rvalues, which are
+      // moved in so the view owns them.
+      Range mRange;
+      MatcherT const mMatcher;
+
+    public:
+      template <typename R>
+      constexpr MatchEachView(R &&range, MatcherT matcher)
+          : mRange{std::forward<R>(range)}, mMatcher{std::move(matcher)}
+      {
+      }
+      constexpr auto begin()
+      {
+        return MatchEachIterator<decltype(std::begin(mRange)), MatcherT>{
+            std::begin(mRange), mMatcher};
+      }
+      constexpr auto end()
+      {
+        return MatchEachIterator<decltype(std::begin(mRange)), MatcherT>{
+            std::end(mRange), mMatcher};
+      }
+      // SFINAE'd so owning a C++20 view that is not const-iterable (e.g.
+      // filter_view) only removes the const overloads instead of erroring.
+      template <typename R = Range const>
+      constexpr auto begin() const
+          -> MatchEachIterator<decltype(std::begin(std::declval<R &>())),
+                               MatcherT>
+      {
+        return {std::begin(mRange), mMatcher};
+      }
+      template <typename R = Range const>
+      constexpr auto end() const
+          -> MatchEachIterator<decltype(std::begin(std::declval<R &>())),
+                               MatcherT>
+      {
+        return {std::end(mRange), mMatcher};
+      }
+    };
+
+    template <typename MatcherT>
+    class MatchEachAdaptor
+    {
+    public:
+      MatcherT mMatcher;
+    };
+
+    template <typename... PatternPairs>
+    constexpr auto matchEach(PatternPairs const &...patterns)
+    {
+      auto arms = matcher(patterns...);
+      return MatchEachAdaptor<decltype(arms)>{std::move(arms)};
+    }
+
+    // isRangeV demands const iteration, which C++20 views like filter_view
+    // do not offer; the pipe only needs begin/end on a mutable lvalue.
+    template <typename Range, typename = std::void_t<>>
+    struct IsLvalueIterable : std::false_type
+    {
+    };
+    template <typename Range>
+    struct IsLvalueIterable<
+        Range,
+        std::void_t<
+            decltype(std::begin(
+                std::declval<std::remove_reference_t<Range> &>())),
+            decltype(std::end(std::declval<std::remove_reference_t<Range> &>()))>>
+        : std::true_type
+    {
+    };
+    template <typename Range>
+    constexpr auto isLvalueIterableV = IsLvalueIterable<Range>::value;
+
+    template <typename Range, typename MatcherT,
+              typename std::enable_if<isLvalueIterableV<Range>>::type * = nullptr>
+    constexpr auto operator|(Range &&range, MatchEachAdaptor<MatcherT> adaptor)
+    {
+      return MatchEachView<Range, MatcherT>{std::forward<Range>(range),
+                                            std::move(adaptor.mMatcher)};
+    }
+
+    // Trampoline for tail-recursive matches. A handler that would recurse
+    // in tail position returns recur(next) to continue the walk with a new
+    // scrutinee, or done(result) to stop; tailRec drives the loop. The walk
+    // then runs in constant stack instead of one matchPatterns + handler
+    // frame — plus its binding Context — per level. Arms of one match mix
+    // the two, so the step is written as match<TailRec<Value, Result>>(v).
+    template <typename Value>
+    struct Recur
+    {
+      Value value;
+    };
+
+    template <typename Result>
+    struct Done
+    {
+      Result result;
+    };
+
+    template <typename Value>
+    constexpr auto recur(Value value)
+    {
+      return Recur<Value>{std::move(value)};
+    }
+
+    template <typename Result>
+    constexpr auto done(Result result)
+    {
+      return Done<Result>{std::move(result)};
+    }
+
+    template <typename Value, typename Result>
+    class TailRec
+    {
+    public:
+      template <typename V>
+      constexpr TailRec(Recur<V> next)
+          : mState{Recur<Value>{std::move(next.value)}}
+      {
+      }
+      template <typename R>
+      constexpr TailRec(Done<R> result)
+          : mState{Done<Result>{std::move(result.result)}}
+      {
+      }
+      constexpr bool isDone() const { return mState.index() == 1; }
+      constexpr Value &next() { return std::get<0>(mState).value; }
+      constexpr Result &result() { return std::get<1>(mState).result; }
+
+    private:
+      std::variant<Recur<Value>, Done<Result>> mState;
+    };
+
+    template <typename Value, typename Step>
+    constexpr auto tailRec(Value init, Step &&step)
+    {
+      auto token = step(std::move(init));
+      while (!token.isDone())
+      {
+        token = step(std::move(token.next()));
+      }
+      return std::move(token.result());
+    }
+
     constexpr auto dsVia = [](auto ...members)
     {
       return [members...](auto ...pats)
@@ -135,19 +889,321 @@ namespace matchit
     {
       return [members...](auto ...pats)
       {
-        // FIXME, why the following line will cause segfault in at-Bindings.cpp
-        // return as<T>(dsVia(members...)(pats...));
-        return as<T>(and_(app(members, pats)...));
+        // fused path: one downcast, then every member accessor applied at
+        // once into a tuple of references matched as a flat ds — a single
+        // matchPattern re-entry instead of one and_/app node per member.
+        // Only valid when all accessors yield lvalues; by-value accessors
+        // need their own context slots and keep the composed form. The
+        // unary must be passed as a prvalue: app() deduces Unary& for
+        // lvalues and App then stores a reference, which is also why the
+        // dsVia-composed spelling below segfaulted — it referenced the
+        // captures of the temporary closure dsVia(members...) returns.
+        if constexpr (allLvalueRefTupleV<std::tuple<decltype(invoke_(
+                          members, std::declval<T const &>()))...>>)
+        {
+          return as<T>(app(
+              [members...](auto const &obj)
+              { return std::forward_as_tuple(invoke_(members, obj)...); },
+              ds(pats...)));
+        }
+        else
+        {
+          // not: as<T>(dsVia(members...)(pats...)) — see above, the app
+          // nodes would dangle into the temporary closure's captures.
+          return as<T>(and_(app(members, pats)...));
+        }
       };
     };
 
+    // Automatic aggregate destructuring, pfr-style: the field count is
+    // detected at compile time and the aggregate is torn into a tuple of
+    // references via structured bindings, so all members match in one pass
+    // as a flat ds through a single App node — no member-pointer list and
+    // no per-member app context. Members that are C arrays fall outside the
+    // detection (brace elision counts their elements); list accessors with
+    // dsVia for those.
+    struct Universal
+    {
+      template <typename T>
+      operator T() const;
+    };
+
+    template <typename T, typename Seq, typename = std::void_t<>>
+    struct BraceInitN : std::false_type
+    {
+    };
+
+    template <typename T, std::size_t... I>
+    struct BraceInitN<
+        T, std::index_sequence<I...>,
+        std::void_t<decltype(T{(static_cast<void>(I), Universal{})...})>>
+        : std::true_type
+    {
+    };
+
+    constexpr std::size_t maxDetectedFields = 16;
+
+    template <typename T, std::size_t N = maxDetectedFields>
+    constexpr std::size_t fieldCount()
+    {
+      if constexpr (BraceInitN<T, std::make_index_sequence<N>>::value)
+      {
+        return N;
+      }
+      else
+      {
+        static_assert(N > 0, "not an aggregate initializable type");
+        return fieldCount<T, N - 1>();
+      }
+    }
+
+    template <typename T>
+    constexpr auto fieldsTie(T const &obj)
+    {
+      constexpr auto n = fieldCount<T>();
+      static_assert(std::is_aggregate_v<T>);
+      if constexpr (n == 0)
+      {
+        return std::tuple<>{};
+      }
+      else if constexpr (n == 1)
+      {
+        auto const &[m0] = obj;
+        return std::tie(m0);
+      }
+      else if constexpr (n == 2)
+      {
+        auto const &[m0, m1] = obj;
+        return std::tie(m0, m1);
+      }
+      else if constexpr (n == 3)
+      {
+        auto const &[m0, m1, m2] = obj;
+        return std::tie(m0, m1, m2);
+      }
+      else if constexpr (n == 4)
+      {
+        auto const &[m0, m1, m2, m3] = obj;
+        return std::tie(m0, m1, m2, m3);
+      }
+      else if constexpr (n == 5)
+      {
+        auto const &[m0, m1, m2, m3, m4] = obj;
+        return std::tie(m0, m1, m2, m3, m4);
+      }
+      else if constexpr (n == 6)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5);
+      }
+      else if constexpr (n == 7)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6);
+      }
+      else if constexpr (n == 8)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7);
+      }
+      else if constexpr (n == 9)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8);
+      }
+      else if constexpr (n == 10)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9);
+      }
+      else if constexpr (n == 11)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10);
+      }
+      else if constexpr (n == 12)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11);
+      }
+      else if constexpr (n == 13)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12] =
+            obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12);
+      }
+      else if constexpr (n == 14)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                     m13] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                        m13);
+      }
+      else if constexpr (n == 15)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                     m13, m14] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                        m13, m14);
+      }
+      else
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                     m13, m14, m15] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                        m13, m14, m15);
+      }
+    }
+
+    constexpr auto fields = [](auto const &obj)
+    { return fieldsTie(obj); };
+
+    constexpr auto dsFields = [](auto const ...pats)
+    { return app(fields, ds(pats...)); };
+
+    // Zero-copy binary decoding over contiguous byte buffers. A frame is
+    // viewed as a ByteSpan (a contiguous Subrange, convertible to std::span
+    // under C++20); field patterns are App extractors that read a typed
+    // value at a fixed offset or re-slice the buffer, so a header match
+    // binds integers and payload slices without copying any bytes.
+    using ByteSpan = Subrange<unsigned char const *>;
+
+    template <typename Buffer>
+    auto bytesOf(Buffer const &buffer)
+    {
+      auto const *data =
+          reinterpret_cast<unsigned char const *>(buffer.data());
+      return ByteSpan{data, data + buffer.size()};
+    }
+
+    enum class ByteOrder
+    {
+      kLE,
+      kBE
+    };
+
+    template <typename T, ByteOrder order, std::size_t offset>
+    class ReadFixed
+    {
+    public:
+      std::optional<T> operator()(ByteSpan const s) const
+      {
+        if (s.size() < offset + sizeof(T))
+        {
+          return std::nullopt;
+        }
+        auto const *p = s.data() + offset;
+        std::uintmax_t acc = 0;
+        if constexpr (order == ByteOrder::kBE)
+        {
+          for (std::size_t i = 0; i < sizeof(T); ++i)
+          {
+            acc = (acc << 8U) | static_cast<std::uintmax_t>(p[i]);
+          }
+        }
+        else
+        {
+          for (std::size_t i = sizeof(T); i > 0; --i)
+          {
+            acc = (acc << 8U) | static_cast<std::uintmax_t>(p[i - 1]);
+          }
+        }
+        return static_cast<T>(acc);
+      }
+    };
+
+    // reads a LenT length field at `offset` and yields the following
+    // `length` bytes as a slice of the original buffer.
+    template <typename LenT, std::size_t offset, ByteOrder order>
+    class ReadLenPrefixed
+    {
+    public:
+      std::optional<ByteSpan> operator()(ByteSpan const s) const
+      {
+        auto const length = ReadFixed<LenT, order, offset>{}(s);
+        if (!length ||
+            s.size() < offset + sizeof(LenT) + static_cast<std::size_t>(*length))
+        {
+          return std::nullopt;
+        }
+        auto const *begin = s.data() + offset + sizeof(LenT);
+        return ByteSpan{begin, begin + *length};
+      }
+    };
+
+    template <std::size_t offset>
+    class ReadSlice
+    {
+    public:
+      std::optional<ByteSpan> operator()(ByteSpan const s) const
+      {
+        if (s.size() < offset)
+        {
+          return std::nullopt;
+        }
+        return ByteSpan{s.data() + offset, s.data() + s.size()};
+      }
+    };
+
+    template <typename T, ByteOrder order, std::size_t offset>
+    constexpr auto fixedAt = [](auto const pat)
+    { return app(ReadFixed<T, order, offset>{}, some(pat)); };
+
+    template <std::size_t offset = 0>
+    constexpr auto u8At = fixedAt<uint8_t, ByteOrder::kBE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u16beAt = fixedAt<uint16_t, ByteOrder::kBE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u16leAt = fixedAt<uint16_t, ByteOrder::kLE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u32beAt = fixedAt<uint32_t, ByteOrder::kBE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u32leAt = fixedAt<uint32_t, ByteOrder::kLE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u64beAt = fixedAt<uint64_t, ByteOrder::kBE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u64leAt = fixedAt<uint64_t, ByteOrder::kLE, offset>;
+
+    template <typename LenT, std::size_t offset,
+              ByteOrder order = ByteOrder::kBE>
+    constexpr auto lenPrefixedAt = [](auto const pat)
+    { return app(ReadLenPrefixed<LenT, offset, order>{}, some(pat)); };
+
+    template <std::size_t offset>
+    constexpr auto sliceAt = [](auto const pat)
+    { return app(ReadSlice<offset>{}, some(pat)); };
+
   } // namespace impl
   using impl::as;
   using impl::asDsVia;
+  using impl::ByteOrder;
+  using impl::ByteSpan;
+  using impl::bytesOf;
+  using impl::containsAny;
+  using impl::done;
+  using impl::dsFields;
   using impl::dsVia;
+  using impl::fixedAt;
+  using impl::forkJoin;
+  using impl::ifLet;
+  using impl::lenPrefixedAt;
+  using impl::mapAll;
+  using impl::matchAll;
+  using impl::matchEach;
   using impl::matched;
   using impl::none;
+  using impl::recur;
+  using impl::sliceAt;
   using impl::some;
+  using impl::tailRec;
+  using impl::TailRec;
+  using impl::u16beAt;
+  using impl::u16leAt;
+  using impl::u32beAt;
+  using impl::u32leAt;
+  using impl::u64beAt;
+  using impl::u64leAt;
+  using impl::u8At;
 } // namespace matchit
 
 #endif // MATCHIT_UTILITY_H
@@ -10,8 +10,33 @@
 #define MATCHIT_CORE_H
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <new>
 #include <tuple>
+#include <type_traits>
+
+// MATCHIT_FORCE_INLINE collapses the hot matching chain (matchPattern ->
+// PatternTraits::matchPatternImpl -> evaluate_ plus the id walks) into
+// its callers even in -O0/-Og builds, where every hop is otherwise a
+// real call and match-heavy debug binaries crawl. Off by default:
+// optimized builds inline the chain anyway and forced inlining only
+// slows compilation there.
+#if !defined(MATCHIT_FORCE_INLINE)
+#define MATCHIT_FORCE_INLINE 0
+#endif // !defined(MATCHIT_FORCE_INLINE)
+
+#if MATCHIT_FORCE_INLINE
+#if defined(__GNUC__) || defined(__clang__)
+#define MATCHIT_HOT __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define MATCHIT_HOT __forceinline
+#else
+#define MATCHIT_HOT
+#endif
+#else
+#define MATCHIT_HOT
+#endif // MATCHIT_FORCE_INLINE
 
 namespace matchit
 {
@@ -31,10 +56,65 @@ namespace matchit
             using ValueT = Value &&;
         };
 
+        // sentinel for "deduce the result type from the arms".
+        class Deduce;
+
+        template <bool exhaustive, typename RetOverride, typename Value,
+                  typename... Patterns>
+        constexpr decltype(auto) matchPatterns(Value &&value,
+                                               Patterns const &...patterns);
+
+        // Caller-owned bump allocator for binding contexts. Contexts that
+        // materialize large intermediates (ooo subranges over big tuples)
+        // land here instead of on the stack of every call, so a loop reuses
+        // one buffer and deep recursion does not grow its frames by the
+        // context size. Allocation is a pointer bump; each arm releases back
+        // to its mark on completion, so nested matches inside handlers stack
+        // naturally within the same arena.
+        class Arena
+        {
+            unsigned char *mBuffer;
+            std::size_t mCapacity;
+            std::size_t mOffset = 0;
+
+        public:
+            template <std::size_t N>
+            explicit Arena(unsigned char (&buffer)[N]) : mBuffer{buffer}, mCapacity{N}
+            {
+            }
+            Arena(unsigned char *buffer, std::size_t capacity)
+                : mBuffer{buffer}, mCapacity{capacity}
+            {
+            }
+
+            void *allocate(std::size_t size, std::size_t align)
+            {
+                auto const aligned = (mOffset + align - 1) & ~(align - 1);
+                if (aligned + size > mCapacity)
+                {
+                    throw std::bad_alloc{};
+                }
+                mOffset = aligned + size;
+                return mBuffer + aligned;
+            }
+            std::size_t mark() const { return mOffset; }
+            void release(std::size_t marked) { mOffset = marked; }
+        };
+
         template <typename Value, typename... Patterns>
-        constexpr auto matchPatterns(Value &&value, Patterns const &...patterns);
+        decltype(auto) matchPatternsArena(Arena &arena, Value &&value,
+                                          Patterns const &...patterns);
 
-        template <typename Value, bool byRef>
+        template <typename RetOverride, typename Value, typename... Patterns>
+        constexpr auto tryMatchPatterns(Value &&value,
+                                        Patterns const &...patterns);
+
+        // defined alongside the dispatch-selection traits in patterns.h.
+        template <typename RetOverride, typename Value, typename... Patterns>
+        constexpr void reportDispatch();
+
+        template <typename Value, bool byRef, bool exhaustive = false,
+                  typename RetT = Deduce, bool reporting = false>
         class MatchHelper
         {
         private:
@@ -46,30 +126,214 @@ namespace matchit
             template <typename V>
             constexpr explicit MatchHelper(V &&value) : mValue{std::forward<V>(value)} {}
             template <typename... PatternPair>
-            constexpr auto operator()(PatternPair const &...patterns)
+            MATCHIT_HOT constexpr decltype(auto)
+            operator()(PatternPair const &...patterns)
+            {
+                if constexpr (reporting)
+                {
+                    reportDispatch<RetT, ValueT, PatternPair...>();
+                }
+                return matchPatterns<exhaustive, RetT>(
+                    std::forward<ValueRefT>(mValue), patterns...);
+            }
+            // dispatch audit: match(v).report()(arms...) matches as usual
+            // but also emits the compile-time DispatchReport warning naming
+            // the strategy this site is given and why the flat paths were
+            // not taken. See reportDispatch in patterns.h.
+            constexpr auto report() &&
             {
-                return matchPatterns(std::forward<ValueRefT>(mValue), patterns...);
+                return MatchHelper<Value, byRef, exhaustive, RetT, true>{
+                    std::forward<ValueRefT>(mValue)};
             }
         };
 
-        template <typename Value>
+        template <typename Value, bool byRef>
+        class ArenaMatchHelper
+        {
+        private:
+            using ValueT = typename ValueType<Value, byRef>::ValueT;
+            Arena &mArena;
+            ValueT mValue;
+            using ValueRefT = ValueT &&;
+
+        public:
+            template <typename V>
+            explicit ArenaMatchHelper(Arena &arena, V &&value)
+                : mArena{arena}, mValue{std::forward<V>(value)}
+            {
+            }
+            template <typename... PatternPair>
+            decltype(auto) operator()(PatternPair const &...patterns)
+            {
+                return matchPatternsArena(mArena, std::forward<ValueRefT>(mValue),
+                                          patterns...);
+            }
+        };
+
+        // match<Ret>(value) pins the result type: each arm's expression
+        // constructs Ret directly instead of being converted through
+        // std::common_type_t of all the arms.
+        template <typename RetT = Deduce, typename Value>
         constexpr auto match(Value &&value)
         {
-            return MatchHelper<Value, true>{std::forward<Value>(value)};
+            return MatchHelper<Value, true, false, RetT>{
+                std::forward<Value>(value)};
+        }
+
+        template <typename Value>
+        auto match(Arena &arena, Value &&value)
+        {
+            return ArenaMatchHelper<Value, true>{arena, std::forward<Value>(value)};
         }
 
         template <typename First, typename... Values>
+        auto match(Arena &arena, First &&first, Values &&...values)
+        {
+            auto result = std::forward_as_tuple(std::forward<First>(first),
+                                                std::forward<Values>(values)...);
+            return ArenaMatchHelper<decltype(result), false>{
+                arena, std::forward<decltype(result)>(result)};
+        }
+
+        template <typename RetT = Deduce, typename First, typename... Values,
+                  typename std::enable_if<!std::is_same<std::decay_t<First>,
+                                                        Arena>::value>::type * =
+                      nullptr>
         constexpr auto match(First &&first, Values &&...values)
         {
             auto result = std::forward_as_tuple(std::forward<First>(first),
                                                 std::forward<Values>(values)...);
-            return MatchHelper<decltype(result), false>{
+            return MatchHelper<decltype(result), false, false, RetT>{
+                std::forward<decltype(result)>(result)};
+        }
+
+        template <typename Value, bool byRef, typename RetT = Deduce>
+        class TryMatchHelper
+        {
+        private:
+            using ValueT = typename ValueType<Value, byRef>::ValueT;
+            ValueT mValue;
+            using ValueRefT = ValueT &&;
+
+        public:
+            template <typename V>
+            constexpr explicit TryMatchHelper(V &&value)
+                : mValue{std::forward<V>(value)}
+            {
+            }
+            template <typename... PatternPair>
+            constexpr auto operator()(PatternPair const &...patterns)
+            {
+                return tryMatchPatterns<RetT>(std::forward<ValueRefT>(mValue),
+                                              patterns...);
+            }
+        };
+
+        // match that reports a miss as an empty std::optional instead of
+        // throwing, for callers that probe several pattern sets in
+        // sequence. The sentinel-wildcard workaround this replaces both
+        // widens the arms' common type and keeps a live branch the
+        // optimizer cannot discard; here the miss is simply an empty
+        // optional and no exceptional path is emitted at all.
+        template <typename RetT = Deduce, typename Value>
+        constexpr auto tryMatch(Value &&value)
+        {
+            return TryMatchHelper<Value, true, RetT>{std::forward<Value>(value)};
+        }
+
+        template <typename RetT = Deduce, typename First, typename... Values,
+                  typename std::enable_if<!std::is_same<std::decay_t<First>,
+                                                        Arena>::value>::type * =
+                      nullptr>
+        constexpr auto tryMatch(First &&first, Values &&...values)
+        {
+            auto result = std::forward_as_tuple(std::forward<First>(first),
+                                                std::forward<Values>(values)...);
+            return TryMatchHelper<decltype(result), false, RetT>{
+                std::forward<decltype(result)>(result)};
+        }
+
+        // match whose arms are declared to cover every possible value. The
+        // no-arm-matched path becomes unreachable instead of a throw (or a
+        // silent no-op in statement form), so the optimizer can drop the cold
+        // tail and codegen the arms like an exhaustive switch. Coverage is
+        // checked statically for std::variant scrutinees; for everything else
+        // the declaration is trusted and a miss is undefined behavior.
+        template <typename Value>
+        constexpr auto matchExhaustive(Value &&value)
+        {
+            return MatchHelper<Value, true, true>{std::forward<Value>(value)};
+        }
+
+        template <typename First, typename... Values>
+        constexpr auto matchExhaustive(First &&first, Values &&...values)
+        {
+            auto result = std::forward_as_tuple(std::forward<First>(first),
+                                                std::forward<Values>(values)...);
+            return MatchHelper<decltype(result), false, true>{
+                std::forward<decltype(result)>(result)};
+        }
+
+#if defined(__cpp_consteval)
+        // match that must fold at compile time. Applying the arms is an
+        // immediate (consteval) call, so a use whose scrutinee or arms
+        // are not constant expressions is a compile error at the call
+        // site instead of silently emitted runtime code, and the result
+        // is a constant expression callers can static_assert on. The
+        // builder stays constexpr: only the full match expression needs
+        // to fold, and a consteval builder would forbid the helper from
+        // carrying its reference to the scrutinee.
+        template <typename Value, bool byRef, typename RetT = Deduce>
+        class ConstevalMatchHelper
+        {
+        private:
+            using ValueT = typename ValueType<Value, byRef>::ValueT;
+            ValueT mValue;
+            using ValueRefT = ValueT &&;
+
+        public:
+            template <typename V>
+            constexpr explicit ConstevalMatchHelper(V &&value)
+                : mValue{std::forward<V>(value)}
+            {
+            }
+            template <typename... PatternPair>
+            consteval decltype(auto) operator()(PatternPair const &...patterns)
+            {
+                return matchPatterns<false, RetT>(
+                    std::forward<ValueRefT>(mValue), patterns...);
+            }
+        };
+
+        template <typename RetT = Deduce, typename Value>
+        constexpr auto matchConsteval(Value &&value)
+        {
+            return ConstevalMatchHelper<Value, true, RetT>{
+                std::forward<Value>(value)};
+        }
+
+        template <typename RetT = Deduce, typename First, typename... Values,
+                  typename std::enable_if<!std::is_same<std::decay_t<First>,
+                                                        Arena>::value>::type * =
+                      nullptr>
+        constexpr auto matchConsteval(First &&first, Values &&...values)
+        {
+            auto result = std::forward_as_tuple(std::forward<First>(first),
+                                                std::forward<Values>(values)...);
+            return ConstevalMatchHelper<decltype(result), false, RetT>{
                 std::forward<decltype(result)>(result)};
         }
+#endif // defined(__cpp_consteval)
     } // namespace impl
 
     // export symbols
+    using impl::Arena;
     using impl::match;
+#if defined(__cpp_consteval)
+    using impl::matchConsteval;
+#endif // defined(__cpp_consteval)
+    using impl::matchExhaustive;
+    using impl::tryMatch;
 
 } // namespace matchit
 #endif // MATCHIT_CORE_H
@@ -77,6 +341,7 @@ namespace matchit
 #define MATCHIT_EXPRESSION_H
 
 #include <type_traits>
+#include <utility>
 
 namespace matchit
 {
@@ -98,17 +363,37 @@ namespace matchit
         template <typename T>
         class Id;
         template <typename T>
+        class SharedId;
+        // Expression nodes capture their operands by value so the resulting
+        // callables own their state and can outlive the statement that built
+        // them (stored in a reusable Matcher, for instance). An Id copy
+        // shares the original's binding block, so evaluation still reads the
+        // current binding.
+        template <typename T>
         constexpr auto expr(Id<T> &id)
         {
-            return nullary([&]
-                           { return *id; });
+            return nullary([id]
+                           { return *const_cast<Id<T> &>(id); });
+        }
+
+        // SharedId copies share the slot, so the same holds for them.
+        template <typename T>
+        constexpr auto expr(SharedId<T> &id)
+        {
+            return nullary([id]
+                           { return *const_cast<SharedId<T> &>(id); });
         }
 
         template <typename T>
         constexpr auto expr(T const &v)
         {
-            return nullary([&]
-                           { return v; });
+            // decay so array operands (string literals) are held as the
+            // pointer they would have evaluated to, not a copied array.
+            std::decay_t<T const &> const value = v;
+            return nullary(
+                [value]() noexcept(
+                    std::is_nothrow_copy_constructible_v<std::decay_t<T const &>>)
+                { return value; });
         }
 
         template <typename T>
@@ -154,6 +439,16 @@ namespace matchit
             }
         };
 
+        template <typename T>
+        class EvalTraits<SharedId<T>>
+        {
+        public:
+            constexpr static decltype(auto) evalImpl(SharedId<T> const &id)
+            {
+                return *const_cast<SharedId<T> &>(id);
+            }
+        };
+
         template <typename Pred>
         class Meet;
 
@@ -185,11 +480,130 @@ namespace matchit
         };
 
         template <typename T, typename... Args>
-        constexpr decltype(auto) evaluate_(T const &t, Args const &...args)
+        MATCHIT_HOT constexpr decltype(auto) evaluate_(T const &t,
+                                                       Args const &...args)
         {
             return EvalTraits<T>::evalImpl(t, args...);
         }
 
+        // Flat expression nodes. Each operator application is one struct —
+        // an operator tag plus operands stored by value — instead of
+        // another capturing-lambda layer, so a chain like x * scale + bias
+        // is a small tree of plain members: evaluation is a single
+        // constexpr recursion the compiler flattens even in lightly
+        // optimized builds, and the nodes own their operands outright, so
+        // a guard expression can safely outlive the statement that built
+        // it. Id operands are copies sharing the original's binding block,
+        // exactly as expr() documents.
+#define MATCHIT_OP_TAG(name, op)                                \
+    struct name                                                 \
+    {                                                           \
+        template <typename L, typename R>                       \
+        constexpr decltype(auto) operator()(L &&l, R &&r) const \
+        {                                                       \
+            return std::forward<L>(l) op std::forward<R>(r);    \
+        }                                                       \
+    };
+
+#define MATCHIT_UN_OP_TAG(name, op)                  \
+    struct name                                      \
+    {                                                \
+        template <typename T>                        \
+        constexpr decltype(auto) operator()(T &&t) const \
+        {                                            \
+            return op std::forward<T>(t);            \
+        }                                            \
+    };
+
+        MATCHIT_UN_OP_TAG(LogicalNot, !)
+        MATCHIT_UN_OP_TAG(Negate, -)
+        MATCHIT_OP_TAG(Plus, +)
+        MATCHIT_OP_TAG(Minus, -)
+        MATCHIT_OP_TAG(Mul, *)
+        MATCHIT_OP_TAG(Div, /)
+        MATCHIT_OP_TAG(Mod, %)
+        MATCHIT_OP_TAG(Less, <)
+        MATCHIT_OP_TAG(LessEqual, <=)
+        MATCHIT_OP_TAG(Equal, ==)
+        MATCHIT_OP_TAG(NotEqual, !=)
+        MATCHIT_OP_TAG(GreaterEqual, >=)
+        MATCHIT_OP_TAG(Greater, >)
+        MATCHIT_OP_TAG(BitXor, ^)
+        class LogicalOr;
+        class LogicalAnd;
+
+#undef MATCHIT_OP_TAG
+#undef MATCHIT_UN_OP_TAG
+
+        template <typename Op, typename T>
+        class UnaryExpr
+        {
+        public:
+            constexpr explicit UnaryExpr(T const &operand) : mOperand{operand} {}
+            template <typename... Args>
+            constexpr decltype(auto) operator()(Args const &...args) const
+            {
+                return Op{}(evaluate_(mOperand, args...));
+            }
+
+        private:
+            T const mOperand;
+        };
+
+        template <typename Op, typename L, typename R>
+        class BinaryExpr
+        {
+        public:
+            constexpr BinaryExpr(L const &lhs, R const &rhs)
+                : mLhs{lhs}, mRhs{rhs} {}
+            template <typename... Args>
+            constexpr decltype(auto) operator()(Args const &...args) const
+            {
+                return Op{}(evaluate_(mLhs, args...), evaluate_(mRhs, args...));
+            }
+
+        private:
+            L const mLhs;
+            R const mRhs;
+        };
+
+        // || and && keep their short-circuit: the right operand is only
+        // evaluated when the left does not decide, so they cannot go
+        // through an operator tag that takes both results.
+        template <typename L, typename R>
+        class BinaryExpr<LogicalOr, L, R>
+        {
+        public:
+            constexpr BinaryExpr(L const &lhs, R const &rhs)
+                : mLhs{lhs}, mRhs{rhs} {}
+            template <typename... Args>
+            constexpr decltype(auto) operator()(Args const &...args) const
+            {
+                return evaluate_(mLhs, args...) || evaluate_(mRhs, args...);
+            }
+
+        private:
+            L const mLhs;
+            R const mRhs;
+        };
+
+        template <typename L, typename R>
+        class BinaryExpr<LogicalAnd, L, R>
+        {
+        public:
+            constexpr BinaryExpr(L const &lhs, R const &rhs)
+                : mLhs{lhs}, mRhs{rhs} {}
+            template <typename... Args>
+            constexpr decltype(auto) operator()(Args const &...args) const
+            {
+                return evaluate_(mLhs, args...) && evaluate_(mRhs, args...);
+            }
+
+        private:
+            L const mLhs;
+            R const mRhs;
+        };
+
         template <typename T>
         class IsNullaryOrId : public std::false_type
         {
@@ -200,6 +614,11 @@ namespace matchit
         {
         };
 
+        template <typename T>
+        class IsNullaryOrId<SharedId<T>> : public std::true_type
+        {
+        };
+
         template <typename T>
         class IsNullaryOrId<Nullary<T>> : public std::true_type
         {
@@ -208,42 +627,68 @@ namespace matchit
         template <typename T>
         constexpr auto isNullaryOrIdV = IsNullaryOrId<std::decay_t<T>>::value;
 
-#define UN_OP_FOR_NULLARY(op)                                               \
+// Under C++20 the expression operators are constrained with concepts
+// instead of enable_if: candidates are discarded before any template
+// instantiation, and a misuse diagnostic names the unsatisfied concept
+// rather than unrolling the SFINAE machinery.
+#if defined(__cpp_concepts)
+        template <typename T>
+        concept NullaryOrIdExpr = isNullaryOrIdV<T>;
+
+#define UN_OP_FOR_NULLARY(op, tag)                 \
+    template <NullaryOrIdExpr T>                   \
+    constexpr auto operator op(T const &t)         \
+    {                                              \
+        return nullary(UnaryExpr<tag, T>{t});      \
+    }
+
+#define BIN_OP_FOR_NULLARY(op, tag)                                           \
+    template <typename T, typename U>                                         \
+        requires(NullaryOrIdExpr<T> || NullaryOrIdExpr<U>)                    \
+    constexpr auto operator op(T const &t, U const &u)                        \
+    {                                                                         \
+        return nullary(                                                       \
+            BinaryExpr<tag, std::decay_t<T>, std::decay_t<U>>{t, u});         \
+    }
+#else
+#define UN_OP_FOR_NULLARY(op, tag)                                          \
     template <typename T, std::enable_if_t<isNullaryOrIdV<T>, bool> = true> \
     constexpr auto operator op(T const &t)                                  \
     {                                                                       \
-        return nullary([&] { return op evaluate_(t); });                         \
+        return nullary(UnaryExpr<tag, T>{t});                               \
     }
 
-#define BIN_OP_FOR_NULLARY(op)                                                 \
+#define BIN_OP_FOR_NULLARY(op, tag)                                            \
     template <typename T, typename U,                                          \
               std::enable_if_t<isNullaryOrIdV<T> || isNullaryOrIdV<U>, bool> = \
                   true>                                                        \
     constexpr auto operator op(T const &t, U const &u)                         \
     {                                                                          \
-        return nullary([&] { return evaluate_(t) op evaluate_(u); });                    \
+        return nullary(                                                        \
+            BinaryExpr<tag, std::decay_t<T>, std::decay_t<U>>{t, u});          \
     }
+#endif // defined(__cpp_concepts)
 
         // ADL will find these operators.
-        UN_OP_FOR_NULLARY(!)
-        UN_OP_FOR_NULLARY(-)
+        UN_OP_FOR_NULLARY(!, LogicalNot)
+        UN_OP_FOR_NULLARY(-, Negate)
 
 #undef UN_OP_FOR_NULLARY
 
-        BIN_OP_FOR_NULLARY(+)
-        BIN_OP_FOR_NULLARY(-)
-        BIN_OP_FOR_NULLARY(*)
-        BIN_OP_FOR_NULLARY(/)
-        BIN_OP_FOR_NULLARY(%)
-        BIN_OP_FOR_NULLARY(<)
-        BIN_OP_FOR_NULLARY(<=)
-        BIN_OP_FOR_NULLARY(==)
-        BIN_OP_FOR_NULLARY(!=)
-        BIN_OP_FOR_NULLARY(>=)
-        BIN_OP_FOR_NULLARY(>)
-        BIN_OP_FOR_NULLARY(||)
-        BIN_OP_FOR_NULLARY(&&)
-        BIN_OP_FOR_NULLARY(^)
+        BIN_OP_FOR_NULLARY(+, Plus)
+        BIN_OP_FOR_NULLARY(-, Minus)
+        BIN_OP_FOR_NULLARY(*, Mul)
+        BIN_OP_FOR_NULLARY(/, Div)
+        BIN_OP_FOR_NULLARY(%, Mod)
+        BIN_OP_FOR_NULLARY(<, Less)
+        BIN_OP_FOR_NULLARY(<=, LessEqual)
+        BIN_OP_FOR_NULLARY(==, Equal)
+        BIN_OP_FOR_NULLARY(!=, NotEqual)
+        BIN_OP_FOR_NULLARY(>=, GreaterEqual)
+        BIN_OP_FOR_NULLARY(>, Greater)
+        BIN_OP_FOR_NULLARY(||, LogicalOr)
+        BIN_OP_FOR_NULLARY(&&, LogicalAnd)
+        BIN_OP_FOR_NULLARY(^, BitXor)
 
 #undef BIN_OP_FOR_NULLARY
 
@@ -273,43 +718,63 @@ namespace matchit
             return meet(std::forward<T>(t));
         }
 
-#define UN_OP_FOR_UNARY(op)                                                     \
+#if defined(__cpp_concepts)
+        template <typename T>
+        concept UnaryOrWildcardExpr = isUnaryOrWildcardV<T>;
+
+#define UN_OP_FOR_UNARY(op, tag)                   \
+    template <UnaryOrWildcardExpr T>               \
+    constexpr auto operator op(T const &t)         \
+    {                                              \
+        return unary(UnaryExpr<tag, T>{t});        \
+    }
+
+#define BIN_OP_FOR_UNARY(op, tag)                                          \
+    template <typename T, typename U>                                      \
+        requires(UnaryOrWildcardExpr<T> || UnaryOrWildcardExpr<U>)         \
+    constexpr auto operator op(T const &t, U const &u)                     \
+    {                                                                      \
+        return unary(                                                      \
+            BinaryExpr<tag, std::decay_t<T>, std::decay_t<U>>{t, u});      \
+    }
+#else
+#define UN_OP_FOR_UNARY(op, tag)                                                \
     template <typename T, std::enable_if_t<isUnaryOrWildcardV<T>, bool> = true> \
     constexpr auto operator op(T const &t)                                      \
     {                                                                           \
-        return unary([&](auto &&arg) constexpr { return op evaluate_(t, arg); });    \
+        return unary(UnaryExpr<tag, T>{t});                                     \
     }
 
-#define BIN_OP_FOR_UNARY(op)                                                   \
+#define BIN_OP_FOR_UNARY(op, tag)                                              \
     template <typename T, typename U,                                          \
               std::enable_if_t<isUnaryOrWildcardV<T> || isUnaryOrWildcardV<U>, \
                                bool> = true>                                   \
     constexpr auto operator op(T const &t, U const &u)                         \
     {                                                                          \
-        return unary([&](auto &&arg) constexpr {                               \
-            return evaluate_(t, arg) op evaluate_(u, arg);                               \
-        });                                                                    \
+        return unary(                                                          \
+            BinaryExpr<tag, std::decay_t<T>, std::decay_t<U>>{t, u});          \
     }
+#endif // defined(__cpp_concepts)
 
-        UN_OP_FOR_UNARY(!)
-        UN_OP_FOR_UNARY(-)
+        UN_OP_FOR_UNARY(!, LogicalNot)
+        UN_OP_FOR_UNARY(-, Negate)
 
 #undef UN_OP_FOR_UNARY
 
-        BIN_OP_FOR_UNARY(+)
-        BIN_OP_FOR_UNARY(-)
-        BIN_OP_FOR_UNARY(*)
-        BIN_OP_FOR_UNARY(/)
-        BIN_OP_FOR_UNARY(%)
-        BIN_OP_FOR_UNARY(<)
-        BIN_OP_FOR_UNARY(<=)
-        BIN_OP_FOR_UNARY(==)
-        BIN_OP_FOR_UNARY(!=)
-        BIN_OP_FOR_UNARY(>=)
-        BIN_OP_FOR_UNARY(>)
-        BIN_OP_FOR_UNARY(||)
-        BIN_OP_FOR_UNARY(&&)
-        BIN_OP_FOR_UNARY(^)
+        BIN_OP_FOR_UNARY(+, Plus)
+        BIN_OP_FOR_UNARY(-, Minus)
+        BIN_OP_FOR_UNARY(*, Mul)
+        BIN_OP_FOR_UNARY(/, Div)
+        BIN_OP_FOR_UNARY(%, Mod)
+        BIN_OP_FOR_UNARY(<, Less)
+        BIN_OP_FOR_UNARY(<=, LessEqual)
+        BIN_OP_FOR_UNARY(==, Equal)
+        BIN_OP_FOR_UNARY(!=, NotEqual)
+        BIN_OP_FOR_UNARY(>=, GreaterEqual)
+        BIN_OP_FOR_UNARY(>, Greater)
+        BIN_OP_FOR_UNARY(||, LogicalOr)
+        BIN_OP_FOR_UNARY(&&, LogicalAnd)
+        BIN_OP_FOR_UNARY(^, BitXor)
 
 #undef BIN_OP_FOR_UNARY
 
@@ -321,93 +786,565 @@ namespace matchit
 #ifndef MATCHIT_PATTERNS_H
 #define MATCHIT_PATTERNS_H
 
+#include <any>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <variant>
+#include <vector>
 
 #if !defined(NO_SCALAR_REFERENCES_USED_IN_PATTERNS)
 #define NO_SCALAR_REFERENCES_USED_IN_PATTERNS 0
 #endif // !defined(NO_SCALAR_REFERENCES_USED_IN_PATTERNS)
 
+#if defined(__has_include)
+#if __has_include(<span>) && __cplusplus > 201703L
+#include <span>
+#define MATCHIT_HAS_SPAN 1
+#endif
+#endif
+#if !defined(MATCHIT_HAS_SPAN)
+#define MATCHIT_HAS_SPAN 0
+#endif // !defined(MATCHIT_HAS_SPAN)
+
+// branch-weight hint for likely()/unlikely() arm annotations; expands to
+// a plain test where the builtin is unavailable.
+#if defined(__GNUC__) || defined(__clang__)
+#define MATCHIT_EXPECT(cond, expected) __builtin_expect(!!(cond), (expected))
+#else
+#define MATCHIT_EXPECT(cond, expected) (!!(cond))
+#endif
+
+// MATCHIT_COMPACT trades peak match speed for code size: each call site
+// drives its arms through a shared type-erased loop instead of an
+// inlined per-arm fold, skipping the flat-dispatch fast paths. For
+// flash-constrained targets where the inlined expansion of a wide match
+// costs kilobytes per call site.
+#if !defined(MATCHIT_COMPACT)
+#define MATCHIT_COMPACT 0
+#endif // !defined(MATCHIT_COMPACT)
+
+// MATCHIT_PROFILE maintains per-call-site counters — invocations,
+// per-arm tries and hits, fall-through misses — in a global registry
+// with a snapshot/dump API (profileSnapshot()/dumpProfile()), telling
+// you which match sites are hot and which arms are tried-and-rejected
+// without attaching a profiler. Counters are relaxed atomics; with the
+// default of 0 everything is compiled out. Sites are keyed by their arm
+// type signature, so two sites with byte-identical arm types share one
+// entry.
+#if !defined(MATCHIT_PROFILE)
+#define MATCHIT_PROFILE 0
+#endif // !defined(MATCHIT_PROFILE)
+
+// MATCHIT_TRACE embeds static tracepoints for live diagnosis: every
+// match fires an event on entry (call-site id, arm count) and another
+// when an arm is selected (call-site id, arm index). Where <sys/sdt.h>
+// is present the events are USDT probes (provider "matchit", probes
+// "match_enter"/"arm_selected") visible to perf and bpftrace without
+// recompiling; a process-wide hook installed via setTraceHooks() fires
+// as well, covering targets without SDT. With the default of 0
+// everything is compiled out.
+#if !defined(MATCHIT_TRACE)
+#define MATCHIT_TRACE 0
+#endif // !defined(MATCHIT_TRACE)
+
+#if MATCHIT_TRACE
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define MATCHIT_HAS_SDT 1
+#endif
+#endif
+#if !defined(MATCHIT_HAS_SDT)
+#define MATCHIT_HAS_SDT 0
+#endif // !defined(MATCHIT_HAS_SDT)
+#endif // MATCHIT_TRACE
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MATCHIT_COLD __attribute__((cold, noinline))
+#else
+#define MATCHIT_COLD
+#endif
+
 namespace matchit
 {
     namespace impl
     {
-        template <typename I, typename S = I>
-        class Subrange
+        // single cold stub for the no-arm-matched error: every call site
+        // shares one outlined throw (and its terminate tail) instead of
+        // emitting its own.
+        [[noreturn]] MATCHIT_COLD inline void throwNoMatch()
         {
-            I mBegin;
-            S mEnd;
+            throw std::logic_error{"Error: no patterns got matched!"};
+        }
 
+#if MATCHIT_PROFILE
+        // Profile-mode counters for one match call site. The counter
+        // storage lives in function-local statics of siteStatsFor, so a
+        // site registers itself on first execution: registration is a CAS
+        // push onto an intrusive lock-free list — sites have static
+        // storage and are never unregistered, so no lock and no ownership
+        // bookkeeping are needed. All counting is relaxed: the numbers are
+        // diagnostics, not synchronization.
+        class SiteStats
+        {
         public:
-            constexpr Subrange(I const begin, S const end) : mBegin{begin}, mEnd{end} {}
+            SiteStats(char const *site, std::size_t armCount,
+                      std::atomic<std::uint64_t> *tries,
+                      std::atomic<std::uint64_t> *hits)
+                : mSite{site}, mArmCount{armCount}, mTries{tries}, mHits{hits}
+            {
+                auto &head = registryHead();
+                mNext = head.load(std::memory_order_relaxed);
+                while (!head.compare_exchange_weak(mNext, this,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed))
+                {
+                }
+            }
 
-            constexpr Subrange(Subrange const &other)
-                : mBegin{other.begin()}, mEnd{other.end()} {}
+            void recordInvocation()
+            {
+                mInvocations.fetch_add(1, std::memory_order_relaxed);
+            }
+            void recordTry(std::size_t arm, bool hit)
+            {
+                mTries[arm].fetch_add(1, std::memory_order_relaxed);
+                if (hit)
+                {
+                    mHits[arm].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            void recordMiss()
+            {
+                mMisses.fetch_add(1, std::memory_order_relaxed);
+            }
 
-            Subrange &operator=(Subrange const &other)
+            char const *site() const { return mSite; }
+            std::size_t armCount() const { return mArmCount; }
+            std::uint64_t invocations() const
             {
-                mBegin = other.begin();
-                mEnd = other.end();
-                return *this;
+                return mInvocations.load(std::memory_order_relaxed);
+            }
+            std::uint64_t misses() const
+            {
+                return mMisses.load(std::memory_order_relaxed);
+            }
+            std::uint64_t tries(std::size_t arm) const
+            {
+                return mTries[arm].load(std::memory_order_relaxed);
             }
+            std::uint64_t hits(std::size_t arm) const
+            {
+                return mHits[arm].load(std::memory_order_relaxed);
+            }
+            SiteStats const *next() const { return mNext; }
 
-            size_t size() const
+            static std::atomic<SiteStats *> &registryHead()
             {
-                return static_cast<size_t>(std::distance(mBegin, mEnd));
+                static std::atomic<SiteStats *> head{nullptr};
+                return head;
             }
-            auto begin() const { return mBegin; }
-            auto end() const { return mEnd; }
+
+        private:
+            char const *mSite;
+            std::size_t mArmCount;
+            std::atomic<std::uint64_t> *mTries;
+            std::atomic<std::uint64_t> *mHits;
+            std::atomic<std::uint64_t> mInvocations{};
+            std::atomic<std::uint64_t> mMisses{};
+            SiteStats *mNext{};
         };
 
-        template <typename I, typename S>
-        constexpr auto makeSubrange(I begin, S end)
+        template <typename... PatternPairs>
+        inline SiteStats &siteStatsFor()
         {
-            return Subrange<I, S>{begin, end};
+            static std::array<std::atomic<std::uint64_t>,
+                              sizeof...(PatternPairs)>
+                tries{};
+            static std::array<std::atomic<std::uint64_t>,
+                              sizeof...(PatternPairs)>
+                hits{};
+#if defined(__GNUC__) || defined(__clang__)
+            static SiteStats stats{__PRETTY_FUNCTION__,
+                                   sizeof...(PatternPairs), tries.data(),
+                                   hits.data()};
+#elif defined(_MSC_VER)
+            static SiteStats stats{__FUNCSIG__, sizeof...(PatternPairs),
+                                   tries.data(), hits.data()};
+#else
+            static SiteStats stats{"match site", sizeof...(PatternPairs),
+                                   tries.data(), hits.data()};
+#endif
+            return stats;
         }
 
-        template <typename RangeType>
-        class IterUnderlyingType
+        // constexpr-safe wrappers: during constant evaluation stats is
+        // null and no counter is touched.
+        template <typename Try>
+        constexpr bool profiledArmTry(SiteStats *stats, std::size_t &arm,
+                                      Try const &tryArm)
         {
-        public:
-            using beginT = decltype(std::begin(std::declval<RangeType &>()));
-            using endT = decltype(std::end(std::declval<RangeType &>()));
-        };
+            auto const index = arm++;
+            bool const hit = tryArm();
+            if (stats != nullptr)
+            {
+                stats->recordTry(index, hit);
+            }
+            return hit;
+        }
 
-        // force array iterators fallback to pointers.
-        template <typename ElemT, size_t size>
-        class IterUnderlyingType<std::array<ElemT, size>>
+        constexpr void profiledMiss(SiteStats *stats)
         {
-        public:
-            using beginT =
-                decltype(&*std::begin(std::declval<std::array<ElemT, size> &>()));
-            using endT = beginT;
-        };
+            if (stats != nullptr)
+            {
+                stats->recordMiss();
+            }
+        }
 
-        // force array iterators fallback to pointers.
-        template <typename ElemT, size_t size>
-        class IterUnderlyingType<std::array<ElemT, size> const>
+        struct SiteProfileSnapshot
         {
-        public:
-            using beginT =
-                decltype(&*std::begin(std::declval<std::array<ElemT, size> const &>()));
-            using endT = beginT;
+            char const *site;
+            std::uint64_t invocations;
+            std::uint64_t misses;
+            std::vector<std::uint64_t> tries;
+            std::vector<std::uint64_t> hits;
+        };
+
+        inline std::vector<SiteProfileSnapshot> profileSnapshot()
+        {
+            auto result = std::vector<SiteProfileSnapshot>{};
+            for (auto const *s = SiteStats::registryHead().load(
+                     std::memory_order_acquire);
+                 s != nullptr; s = s->next())
+            {
+                auto snapshot = SiteProfileSnapshot{
+                    s->site(), s->invocations(), s->misses(), {}, {}};
+                for (std::size_t arm = 0; arm < s->armCount(); ++arm)
+                {
+                    snapshot.tries.push_back(s->tries(arm));
+                    snapshot.hits.push_back(s->hits(arm));
+                }
+                result.push_back(std::move(snapshot));
+            }
+            return result;
+        }
+
+        template <typename Stream>
+        void dumpProfile(Stream &os)
+        {
+            for (auto const &site : profileSnapshot())
+            {
+                os << site.site << "\n  invocations " << site.invocations
+                   << ", misses " << site.misses << "\n";
+                for (std::size_t arm = 0; arm < site.tries.size(); ++arm)
+                {
+                    os << "  arm " << arm << ": tries " << site.tries[arm]
+                       << ", hits " << site.hits[arm] << "\n";
+                }
+            }
+        }
+#endif // MATCHIT_PROFILE
+
+#if MATCHIT_TRACE
+        // Trace-mode hooks: process-wide function pointers fired on match
+        // entry and on the selected arm, alongside the USDT probes when
+        // <sys/sdt.h> is present. Stored as relaxed atomics so installing
+        // from one thread is safe against concurrent matches; null hooks
+        // cost one load and a predictable branch per event.
+        using TraceHook = void (*)(char const *site, std::size_t);
+
+        inline std::atomic<TraceHook> &matchEnterHook()
+        {
+            static std::atomic<TraceHook> hook{nullptr};
+            return hook;
+        }
+
+        inline std::atomic<TraceHook> &armSelectedHook()
+        {
+            static std::atomic<TraceHook> hook{nullptr};
+            return hook;
+        }
+
+        // Install the hooks; either may be nullptr. matchEnter receives
+        // the call-site id and the arm count, armSelected the call-site id
+        // and the zero-based index of the arm that matched.
+        inline void setTraceHooks(TraceHook matchEnter, TraceHook armSelected)
+        {
+            matchEnterHook().store(matchEnter, std::memory_order_relaxed);
+            armSelectedHook().store(armSelected, std::memory_order_relaxed);
+        }
+
+        // Call-site id for trace events: the instantiated signature names
+        // the site by its arm types, the same keying as the profile
+        // registry, so trace and profile output correlate directly.
+        template <typename... PatternPairs>
+        inline char const *traceSiteName()
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __PRETTY_FUNCTION__;
+#elif defined(_MSC_VER)
+            return __FUNCSIG__;
+#else
+            return "match site";
+#endif
+        }
+
+        inline void traceMatchEnter(char const *site, std::size_t armCount)
+        {
+#if MATCHIT_HAS_SDT
+            DTRACE_PROBE2(matchit, match_enter, site, armCount);
+#endif
+            if (auto const hook =
+                    matchEnterHook().load(std::memory_order_relaxed))
+            {
+                hook(site, armCount);
+            }
+        }
+
+        inline void traceArmSelected(char const *site, std::size_t armIndex)
+        {
+#if MATCHIT_HAS_SDT
+            DTRACE_PROBE2(matchit, arm_selected, site, armIndex);
+#endif
+            if (auto const hook =
+                    armSelectedHook().load(std::memory_order_relaxed))
+            {
+                hook(site, armIndex);
+            }
+        }
+
+        // constexpr-safe wrapper: during constant evaluation site is null
+        // and no event fires.
+        template <typename Try>
+        constexpr bool tracedArmTry(char const *site, std::size_t &arm,
+                                    Try const &tryArm)
+        {
+            auto const index = arm++;
+            bool const hit = tryArm();
+            if (hit && site != nullptr)
+            {
+                traceArmSelected(site, index);
+            }
+            return hit;
+        }
+#endif // MATCHIT_TRACE
+
+        template <typename I, typename S = I>
+        class Subrange
+        {
+            I mBegin{};
+            S mEnd{};
+
+        public:
+            constexpr Subrange() = default;
+
+            constexpr Subrange(I const begin, S const end) : mBegin{begin}, mEnd{end} {}
+
+            constexpr Subrange(Subrange const &other)
+                : mBegin{other.begin()}, mEnd{other.end()} {}
+
+            Subrange &operator=(Subrange const &other)
+            {
+                mBegin = other.begin();
+                mEnd = other.end();
+                return *this;
+            }
+
+            size_t size() const
+            {
+                return static_cast<size_t>(std::distance(mBegin, mEnd));
+            }
+            auto begin() const { return mBegin; }
+            auto end() const { return mEnd; }
+
+            // contiguous slices (pointer iterators) additionally model a
+            // span: direct element access and a raw pointer for bulk
+            // operations on the underlying buffer.
+            template <typename P = I,
+                      typename = std::enable_if_t<std::is_pointer_v<P>>>
+            constexpr auto data() const
+            {
+                return mBegin;
+            }
+            template <typename P = I,
+                      typename = std::enable_if_t<std::is_pointer_v<P>>>
+            constexpr decltype(auto) operator[](size_t const index) const
+            {
+                return mBegin[index];
+            }
+#if MATCHIT_HAS_SPAN
+            template <typename P = I,
+                      typename = std::enable_if_t<std::is_pointer_v<P>>>
+            constexpr operator std::span<std::remove_pointer_t<P>>() const
+            {
+                return {mBegin, size()};
+            }
+#endif
+        };
+
+        template <typename I, typename S>
+        constexpr auto makeSubrange(I begin, S end)
+        {
+            return Subrange<I, S>{begin, end};
+        }
+
+        // Single-pass adapter: wraps an input iterator/sentinel pair so ds
+        // patterns can destructure a stream (socket reader, decompressor,
+        // istream_iterator, ...) without materializing it first. Matching
+        // consumes the stream as it proceeds, so only one ds arm can inspect
+        // a given stream; follow it with a wildcard arm for the miss case.
+        template <typename I, typename S = I>
+        class Streamed
+        {
+            I mBegin;
+            S mEnd;
+
+        public:
+            using value_type =
+                std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<I &>())>>;
+
+            Streamed(I begin, S end) : mBegin{std::move(begin)}, mEnd{std::move(end)} {}
+
+            bool done() const { return !(mBegin != mEnd); }
+            value_type next()
+            {
+                value_type v = *mBegin;
+                ++mBegin;
+                return v;
+            }
+        };
+
+        template <typename I, typename S>
+        auto streamed(I begin, S end)
+        {
+            return Streamed<I, S>{std::move(begin), std::move(end)};
+        }
+
+        template <typename Range>
+        auto streamed(Range &&range)
+        {
+            return streamed(std::begin(range), std::end(range));
+        }
+
+        template <typename T>
+        struct IsStreamed : std::false_type
+        {
+        };
+
+        template <typename I, typename S>
+        struct IsStreamed<Streamed<I, S>> : std::true_type
+        {
+        };
+
+        template <typename T>
+        constexpr auto isStreamedV = IsStreamed<std::decay_t<T>>::value;
+
+        template <typename RangeType>
+        class IterUnderlyingType
+        {
+        public:
+            using beginT = decltype(std::begin(std::declval<RangeType &>()));
+            using endT = decltype(std::end(std::declval<RangeType &>()));
+        };
+
+        // force array iterators fallback to pointers.
+        template <typename ElemT, size_t size>
+        class IterUnderlyingType<std::array<ElemT, size>>
+        {
+        public:
+            using beginT =
+                decltype(&*std::begin(std::declval<std::array<ElemT, size> &>()));
+            using endT = beginT;
+        };
+
+        // force array iterators fallback to pointers.
+        template <typename ElemT, size_t size>
+        class IterUnderlyingType<std::array<ElemT, size> const>
+        {
+        public:
+            using beginT =
+                decltype(&*std::begin(std::declval<std::array<ElemT, size> const &>()));
+            using endT = beginT;
         };
 
         template <typename RangeType>
         using SubrangeT = Subrange<typename IterUnderlyingType<RangeType>::beginT,
                                    typename IterUnderlyingType<RangeType>::endT>;
 
+        // element types whose value equality is representation equality, so
+        // comparing slices of them can be a single memcmp. Floating point is
+        // excluded (NaN, signed zero); padded types are excluded by the
+        // unique-object-representations check.
+        template <typename T>
+        constexpr auto bitwiseEqualityV =
+            (std::is_integral_v<T> || std::is_enum_v<T>)&&std::
+                has_unique_object_representations_v<T>;
+
         template <typename I, typename S>
         bool operator==(Subrange<I, S> const &lhs, Subrange<I, S> const &rhs)
         {
             using std::operator==;
-            return lhs.size() == rhs.size() &&
-                   std::equal(lhs.begin(), lhs.end(), rhs.begin());
+            if constexpr (std::is_pointer_v<I> &&
+                          bitwiseEqualityV<std::remove_cv_t<
+                              std::remove_pointer_t<I>>>)
+            {
+                using Elem = std::remove_pointer_t<I>;
+                return lhs.size() == rhs.size() &&
+                       std::memcmp(lhs.data(), rhs.data(),
+                                   lhs.size() * sizeof(Elem)) == 0;
+            }
+            else
+            {
+                return lhs.size() == rhs.size() &&
+                       std::equal(lhs.begin(), lhs.end(), rhs.begin());
+            }
+        }
+
+        template <typename T>
+        struct IsSubrange : std::false_type
+        {
+        };
+
+        template <typename I, typename S>
+        struct IsSubrange<Subrange<I, S>> : std::true_type
+        {
+        };
+
+        // equality against any other contiguous range of the same
+        // byte-comparable element type (vector, array, span, ...), again as
+        // one bulk compare.
+        template <typename I, typename S, typename Range,
+                  typename = std::enable_if_t<
+                      std::is_pointer_v<I> && !IsSubrange<Range>::value &&
+                      std::is_same_v<std::remove_cv_t<std::remove_pointer_t<
+                                         decltype(std::declval<Range const &>()
+                                                      .data())>>,
+                                     std::remove_cv_t<std::remove_pointer_t<I>>>>>
+        bool operator==(Subrange<I, S> const &lhs, Range const &rhs)
+        {
+            using Elem = std::remove_cv_t<std::remove_pointer_t<I>>;
+            if constexpr (bitwiseEqualityV<Elem>)
+            {
+                return lhs.size() == rhs.size() &&
+                       std::memcmp(lhs.data(), rhs.data(),
+                                   lhs.size() * sizeof(Elem)) == 0;
+            }
+            else
+            {
+                return lhs.size() == rhs.size() &&
+                       std::equal(lhs.begin(), lhs.end(), rhs.begin());
+            }
         }
 
         template <typename K1, typename V1, typename K2, typename V2>
@@ -416,48 +1353,65 @@ namespace matchit
             return t.first == u.first && t.second == u.second;
         }
 
+        // Deduplication keeps the last occurrence of each type, computed
+        // without the old per-element recursion (which instantiated a fresh
+        // class per suffix and went quadratic on wide ds patterns): one row
+        // of is_same comparisons per element feeds a constexpr mask, and a
+        // single tuple_cat assembles the survivors.
         template <typename T, typename... Ts>
-        class WithinTypes
+        constexpr std::array<bool, sizeof...(Ts)> sameTypeRow()
         {
-        public:
-            constexpr static auto value = (std::is_same_v<T, Ts> || ...);
-        };
+            return {{std::is_same_v<T, Ts>...}};
+        }
+
+        template <typename... Ts>
+        constexpr auto lastOccurrenceMask()
+        {
+            constexpr auto size = sizeof...(Ts);
+            std::array<std::array<bool, size>, size> const same{
+                {sameTypeRow<Ts, Ts...>()...}};
+            std::array<bool, size> keep{};
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                keep[i] = true;
+                for (std::size_t j = i + 1; j < size; ++j)
+                {
+                    if (same[i][j])
+                    {
+                        keep[i] = false;
+                    }
+                }
+            }
+            return keep;
+        }
 
-        template <typename T, typename Tuple>
-        class PrependUnique;
+        template <typename Tuple, typename Indices>
+        class UniqueImpl;
 
-        template <typename T, typename... Ts>
-        class PrependUnique<T, std::tuple<Ts...>>
+        template <typename... Ts, std::size_t... I>
+        class UniqueImpl<std::tuple<Ts...>, std::index_sequence<I...>>
         {
-            constexpr static auto unique = !WithinTypes<T, Ts...>::value;
+            constexpr static auto kept = lastOccurrenceMask<Ts...>();
 
         public:
-            using type =
-                std::conditional_t<unique, std::tuple<T, Ts...>, std::tuple<Ts...>>;
+            using type = decltype(std::tuple_cat(
+                std::declval<
+                    std::conditional_t<kept[I], std::tuple<Ts>, std::tuple<>>>()...));
         };
 
-        template <typename T, typename Tuple>
-        using PrependUniqueT = typename PrependUnique<T, Tuple>::type;
-
         template <typename Tuple>
         class Unique;
 
         template <typename... Ts>
-        using UniqueT = typename Unique<std::tuple<Ts...>>::type;
-
-        template <>
-        class Unique<std::tuple<>>
+        class Unique<std::tuple<Ts...>>
         {
         public:
-            using type = std::tuple<>;
+            using type = typename UniqueImpl<std::tuple<Ts...>,
+                                             std::index_sequence_for<Ts...>>::type;
         };
 
-        template <typename T, typename... Ts>
-        class Unique<std::tuple<T, Ts...>>
-        {
-        public:
-            using type = PrependUniqueT<T, UniqueT<Ts...>>;
-        };
+        template <typename... Ts>
+        using UniqueT = typename Unique<std::tuple<Ts...>>::type;
 
         static_assert(
             std::is_same_v<std::tuple<int32_t>, UniqueT<int32_t, int32_t>>);
@@ -511,7 +1465,7 @@ namespace matchit
 
         // as constexpr
         template <class F, class... Args>
-        constexpr std::invoke_result_t<F, Args...>
+        MATCHIT_HOT constexpr std::invoke_result_t<F, Args...>
         invoke_(F &&f,
                 Args &&...args) noexcept(std::is_nothrow_invocable_v<F, Args...>)
         {
@@ -557,11 +1511,48 @@ namespace matchit
         template <typename Pattern>
         class PatternTraits;
 
+        // When every arm returns an lvalue reference to the same type the
+        // match preserves the reference instead of copying the referee out;
+        // mixing T& and T const& arms yields T const&. Everything else keeps
+        // the decaying common-type result.
+        template <typename T, typename... Ts>
+        class RefRetType
+        {
+        public:
+            constexpr static bool applicable =
+                std::is_lvalue_reference_v<T> &&
+                ((std::is_lvalue_reference_v<Ts> &&
+                  std::is_same_v<std::decay_t<T>, std::decay_t<Ts>>)&&...);
+            constexpr static bool anyConst =
+                std::is_const_v<std::remove_reference_t<T>> ||
+                (std::is_const_v<std::remove_reference_t<Ts>> || ... || false);
+        };
+
         template <typename... PatternPairs>
         class PatternPairsRetType
         {
+            using RefInfo = RefRetType<typename PatternPairs::RetType...>;
+            // two-step select so the reference type is only formed when the
+            // arms actually all return references (RetType may be void).
+            template <bool preserveRef, typename = void>
+            struct Select
+            {
+                using type =
+                    std::common_type_t<typename PatternPairs::RetType...>;
+            };
+            template <typename Dummy>
+            struct Select<true, Dummy>
+            {
+                using First = std::tuple_element_t<
+                    0, std::tuple<typename PatternPairs::RetType...>>;
+                using type =
+                    std::conditional_t<RefInfo::anyConst,
+                                       std::decay_t<First> const &,
+                                       std::decay_t<First> &>;
+            };
+
         public:
-            using RetType = std::common_type_t<typename PatternPairs::RetType...>;
+            using RetType = typename Select<RefInfo::applicable>::type;
         };
 
         enum class IdProcess : int32_t
@@ -570,11 +1561,28 @@ namespace matchit
             kCONFIRM
         };
 
+        // Confirm/cancel walks only exist to update Id bindings, so subtrees
+        // whose static Id count is zero are pruned here instead of being
+        // walked to run no-op processIdImpl leaves. An arm without any Id
+        // does no cancel work at all on failure.
         template <typename Pattern>
-        constexpr void processId(Pattern const &pattern, int32_t depth,
-                                 IdProcess idProcess)
+        MATCHIT_HOT constexpr void processId(Pattern const &pattern,
+                                             int32_t depth,
+                                             IdProcess idProcess)
+            noexcept(PatternTraits<Pattern>::nbIdV == 0 ||
+                     noexcept(PatternTraits<Pattern>::processIdImpl(
+                         pattern, depth, idProcess)))
         {
-            PatternTraits<Pattern>::processIdImpl(pattern, depth, idProcess);
+            if constexpr (PatternTraits<Pattern>::nbIdV != 0)
+            {
+                PatternTraits<Pattern>::processIdImpl(pattern, depth, idProcess);
+            }
+            else
+            {
+                static_cast<void>(pattern);
+                static_cast<void>(depth);
+                static_cast<void>(idProcess);
+            }
         }
 
         template <typename Tuple>
@@ -605,12 +1613,52 @@ namespace matchit
                 mMemHolder[mSize] = std::forward<T>(t);
                 ++mSize;
             }
-            constexpr auto back() -> ElementT & { return mMemHolder[mSize - 1]; }
+            template <typename T>
+            constexpr auto backAs() -> T &
+            {
+                return std::get<T>(mMemHolder[mSize - 1]);
+            }
+            // rewind protocol for paths that retry matching within one
+            // pass (the subsequence sliding window): the slots are sized
+            // for a single pass, so a failed try releases back to its
+            // mark and the next try reuses them.
+            constexpr auto mark() const { return mSize; }
+            constexpr void release(size_t marked) { mSize = marked; }
         };
 
         template <>
         class Context<>
         {
+        public:
+            constexpr std::size_t mark() const { return 0; }
+            constexpr void release(std::size_t) {}
+        };
+
+        // Context for matches whose materialized intermediates all share one
+        // type (a single ooo subrange type, or repeated applications of the
+        // same unary): a plain array of that type, with no variant
+        // discriminant written on every store and none checked on access.
+        template <typename T, std::size_t N>
+        class MonoContext
+        {
+            std::array<T, N> mMemHolder{};
+            size_t mSize = 0;
+
+        public:
+            template <typename U>
+            constexpr void emplace_back(U &&u)
+            {
+                mMemHolder[mSize] = std::forward<U>(u);
+                ++mSize;
+            }
+            template <typename U>
+            constexpr auto backAs() -> T &
+            {
+                static_assert(std::is_same_v<U, T>);
+                return mMemHolder[mSize - 1];
+            }
+            constexpr auto mark() const { return mSize; }
+            constexpr void release(size_t marked) { mSize = marked; }
         };
 
         template <typename T>
@@ -618,14 +1666,42 @@ namespace matchit
 
         template <typename... Ts>
         class ContextTrait<std::tuple<Ts...>>
+        {
+            template <typename Uniq>
+            struct Select
+            {
+                using type = Context<Ts...>;
+            };
+            template <typename T>
+            struct Select<std::tuple<T>>
+            {
+                using type =
+                    std::conditional_t<std::is_default_constructible_v<T> &&
+                                           std::is_move_assignable_v<T>,
+                                       MonoContext<T, sizeof...(Ts)>,
+                                       Context<Ts...>>;
+            };
+
+        public:
+            using ContextT = typename Select<UniqueT<Ts...>>::type;
+        };
+
+        template <>
+        class ContextTrait<std::tuple<>>
         {
         public:
-            using ContextT = Context<Ts...>;
+            using ContextT = Context<>;
         };
 
         template <typename Value, typename Pattern, typename ConctextT>
-        constexpr auto matchPattern(Value &&value, Pattern const &pattern,
-                                    int32_t depth, ConctextT &context)
+        MATCHIT_HOT constexpr auto matchPattern(Value &&value,
+                                                Pattern const &pattern,
+                                                int32_t depth,
+                                                ConctextT &context)
+            noexcept(noexcept(PatternTraits<Pattern>::matchPatternImpl(
+                         std::forward<Value>(value), pattern, depth,
+                         context)) &&
+                     noexcept(processId(pattern, depth, IdProcess::kCONFIRM)))
         {
             auto const result = PatternTraits<Pattern>::matchPatternImpl(
                 std::forward<Value>(value), pattern, depth, context);
@@ -634,6 +1710,14 @@ namespace matchit
             return result;
         }
 
+        // true when matching Pattern against Value — including the id
+        // bookkeeping walk — is declared nothrow, so composite traits can
+        // fold the property over their subpatterns.
+        template <typename Pattern, typename Value, typename ContextT>
+        constexpr auto isNothrowMatchV = noexcept(
+            matchPattern(std::declval<Value>(), std::declval<Pattern const &>(),
+                         0, std::declval<ContextT &>()));
+
         template <typename Pattern, typename Func>
         class PatternPair
         {
@@ -644,12 +1728,28 @@ namespace matchit
             constexpr PatternPair(Pattern const &pattern, Func const &func)
                 : mPattern{pattern}, mHandler{func} {}
             template <typename Value, typename ContextT>
-            constexpr bool matchValue(Value &&value, ContextT &context) const
+            MATCHIT_HOT constexpr bool matchValue(Value &&value,
+                                                  ContextT &context) const
+                noexcept(noexcept(matchPattern(std::forward<Value>(value),
+                                               mPattern, 0, context)))
             {
                 return matchPattern(std::forward<Value>(value), mPattern, /*depth*/ 0,
                                     context);
             }
-            constexpr auto execute() const { return mHandler(); }
+            MATCHIT_HOT constexpr decltype(auto) execute() const
+                noexcept(noexcept(mHandler()))
+            {
+                return mHandler();
+            }
+            constexpr auto const &pattern() const { return mPattern; }
+            // rebuild this arm around a different pattern, keeping the
+            // handler; used when a projection shared by every arm is hoisted
+            // out of the arms.
+            template <typename NewPattern>
+            constexpr auto withPattern(NewPattern const &newPattern) const
+            {
+                return PatternPair<NewPattern, Func>{newPattern, mHandler};
+            }
 
         private:
             Pattern const mPattern;
@@ -672,25 +1772,72 @@ namespace matchit
             auto p = toNullary(pred);
             return When<decltype(p)>{p};
         }
-        
-        template <typename Pattern>
-        class PatternHelper
+
+        // Branch-weight annotation: pattern | p | likely() tells the
+        // compiler the arm's test is expected to succeed (unlikely() the
+        // opposite), so the hot handler is laid out on the fall-through
+        // path. Purely a codegen hint — match semantics are untouched.
+        template <typename Pattern, bool expected>
+        class Expected
         {
         public:
-            constexpr explicit PatternHelper(Pattern const &pattern)
+            constexpr explicit Expected(Pattern const &pattern)
                 : mPattern{pattern} {}
-            template <typename Func>
-            constexpr auto operator=(Func &&func)
-            {
-                auto f = toNullary(func);
-                return PatternPair<Pattern, decltype(f)>{mPattern, f};
-            }
-            template <typename Pred>
-            constexpr auto operator|(When<Pred> const &w)
-            {
-                return PatternHelper<PostCheck<Pattern, Pred>>(
-                    PostCheck(mPattern, w.mPred));
-            }
+            constexpr auto const &pattern() const { return mPattern; }
+
+        private:
+            Pattern const mPattern;
+        };
+
+        class LikelyTag
+        {
+        };
+        class UnlikelyTag
+        {
+        };
+
+        constexpr auto likely() { return LikelyTag{}; }
+        constexpr auto unlikely() { return UnlikelyTag{}; }
+
+        // Structural canonicalization applied once per arm, when
+        // `pattern | p = handler` assembles the PatternPair. Defined after
+        // the composite patterns below; declared here so arm assembly can
+        // name it.
+        template <typename Pattern, typename = void>
+        class CanonicalTraits;
+
+        template <typename Pattern>
+        constexpr decltype(auto) canonicalize(Pattern const &pattern);
+
+        template <typename Pattern>
+        class PatternHelper
+        {
+        public:
+            constexpr explicit PatternHelper(Pattern const &pattern)
+                : mPattern{pattern} {}
+            template <typename Func>
+            constexpr auto operator=(Func &&func)
+            {
+                auto f = toNullary(func);
+                auto const p = canonicalize(mPattern);
+                return PatternPair<std::decay_t<decltype(p)>, decltype(f)>{p, f};
+            }
+            template <typename Pred>
+            constexpr auto operator|(When<Pred> const &w)
+            {
+                return PatternHelper<PostCheck<Pattern, Pred>>(
+                    PostCheck(mPattern, w.mPred));
+            }
+            constexpr auto operator|(LikelyTag)
+            {
+                return PatternHelper<Expected<Pattern, true>>(
+                    Expected<Pattern, true>(mPattern));
+            }
+            constexpr auto operator|(UnlikelyTag)
+            {
+                return PatternHelper<Expected<Pattern, false>>(
+                    Expected<Pattern, false>(mPattern));
+            }
 
         private:
             Pattern const mPattern;
@@ -739,14 +1886,15 @@ namespace matchit
             constexpr static auto nbIdV = 0;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value, Pattern const &pattern,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value, Pattern const &pattern,
                                                    int32_t /* depth */,
                                                    ContextT & /*context*/)
+                noexcept(noexcept(pattern == std::forward<Value>(value)))
             {
                 return pattern == std::forward<Value>(value);
             }
-            constexpr static void processIdImpl(Pattern const &, int32_t /*depth*/,
-                                                IdProcess) {}
+            MATCHIT_HOT constexpr static void processIdImpl(Pattern const &, int32_t /*depth*/,
+                                                IdProcess) noexcept {}
         };
 
         class Wildcard
@@ -767,13 +1915,13 @@ namespace matchit
             constexpr static auto nbIdV = 0;
 
             template <typename Value, typename ContextT>
-            constexpr static bool matchPatternImpl(Value &&, Pattern const &, int32_t,
-                                                   ContextT &)
+            MATCHIT_HOT constexpr static bool matchPatternImpl(Value &&, Pattern const &, int32_t,
+                                                   ContextT &) noexcept
             {
                 return true;
             }
-            constexpr static void processIdImpl(Pattern const &, int32_t /*depth*/,
-                                                IdProcess) {}
+            MATCHIT_HOT constexpr static void processIdImpl(Pattern const &, int32_t /*depth*/,
+                                                IdProcess) noexcept {}
         };
 
         template <typename... Patterns>
@@ -804,22 +1952,50 @@ namespace matchit
             constexpr static auto nbIdV = (PatternTraits<Patterns>::nbIdV + ... + 0);
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    Or<Patterns...> const &orPat,
                                                    int32_t depth, ContextT &context)
+                noexcept((isNothrowMatchV<InternalPatternT<Patterns>, Value,
+                                          ContextT> &&
+                          ...))
             {
-                constexpr auto patSize = sizeof...(Patterns);
-                return std::apply(
-                           [&value, depth, &context](auto const &...patterns)
-                           {
-                               return (matchPattern(value, patterns, depth + 1, context) ||
-                                       ...);
-                           },
-                           take<patSize - 1>(orPat.patterns())) ||
-                       matchPattern(std::forward<Value>(value),
-                                    get<patSize - 1>(orPat.patterns()), depth + 1, context);
-            }
-            constexpr static void processIdImpl(Or<Patterns...> const &orPat,
+                // Rollback across alternatives is already delta-scoped by the
+                // depth protocol: alternatives run at depth + 1, so a failing
+                // alternative only resets blocks bound at that depth or
+                // deeper, and bindings made before the or_ (outer at()/ds
+                // bindings the alternatives agree with) are compared against,
+                // not re-bound. No separate undo log is needed.
+                // or_ over plain literals is a membership test: compare
+                // against the stored alternatives directly instead of going
+                // through matchPattern/processId per alternative (both no-ops
+                // for literals). The flat fold over the contiguous tuple is
+                // what compilers turn into bit tests or vectorized compares;
+                // a sorted array buys nothing at these alternative counts.
+                if constexpr (((std::is_arithmetic_v<Patterns> ||
+                                std::is_enum_v<Patterns>)&&...))
+                {
+                    static_cast<void>(depth);
+                    static_cast<void>(context);
+                    return std::apply(
+                        [&value](auto const &...patterns)
+                        { return ((patterns == value) || ...); },
+                        orPat.patterns());
+                }
+                else
+                {
+                    constexpr auto patSize = sizeof...(Patterns);
+                    return std::apply(
+                               [&value, depth, &context](auto const &...patterns)
+                               {
+                                   return (matchPattern(value, patterns, depth + 1, context) ||
+                                           ...);
+                               },
+                               take<patSize - 1>(orPat.patterns())) ||
+                           matchPattern(std::forward<Value>(value),
+                                        get<patSize - 1>(orPat.patterns()), depth + 1, context);
+                }
+            }
+            MATCHIT_HOT constexpr static void processIdImpl(Or<Patterns...> const &orPat,
                                                 int32_t depth, IdProcess idProcess)
             {
                 return std::apply(
@@ -844,6 +2020,37 @@ namespace matchit
             return Meet<Pred>{pred};
         }
 
+        // Interval pattern, both bounds included. Bounds are stored by value
+        // (the Matcher-within sample captures by reference and must outlive
+        // the pattern; this one has no such constraint). When the bounds and
+        // the scrutinee share an integral type the test compiles to the
+        // single-branch unsigned-subtraction form
+        //     (U)(v - first) <= (U)(last - first)
+        // instead of a pair of comparisons.
+        template <typename First, typename Last>
+        constexpr auto within(First const &first, Last const &last)
+        {
+            return meet(
+                [first, last](auto &&v)
+                {
+                    using V = std::decay_t<decltype(v)>;
+                    if constexpr (std::is_integral_v<V> &&
+                                  std::is_same_v<First, V> &&
+                                  std::is_same_v<Last, V>)
+                    {
+                        using U = std::make_unsigned_t<V>;
+                        return static_cast<U>(static_cast<U>(v) -
+                                              static_cast<U>(first)) <=
+                               static_cast<U>(static_cast<U>(last) -
+                                              static_cast<U>(first));
+                    }
+                    else
+                    {
+                        return first <= v && v <= last;
+                    }
+                });
+        }
+
         template <typename Pred>
         class PatternTraits<Meet<Pred>>
         {
@@ -854,16 +2061,24 @@ namespace matchit
             constexpr static auto nbIdV = 0;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    Meet<Pred> const &meetPat,
                                                    int32_t /* depth */, ContextT &)
+                noexcept(noexcept(meetPat(std::forward<Value>(value))))
             {
                 return meetPat(std::forward<Value>(value));
             }
-            constexpr static void processIdImpl(Meet<Pred> const &, int32_t /*depth*/,
-                                                IdProcess) {}
+            MATCHIT_HOT constexpr static void processIdImpl(Meet<Pred> const &, int32_t /*depth*/,
+                                                IdProcess) noexcept {}
         };
 
+        // nothrow propagation spot-checks: trivial comparisons and their
+        // id-free walks carry noexcept end to end.
+        static_assert(isNothrowMatchV<int32_t, int32_t &&, Context<>>);
+        static_assert(isNothrowMatchV<Wildcard, int32_t &&, Context<>>);
+        static_assert(
+            isNothrowMatchV<Or<int32_t, int32_t>, int32_t &&, Context<>>);
+
         template <typename Unary, typename Pattern>
         class App
         {
@@ -888,6 +2103,46 @@ namespace matchit
         static_assert(std::holds_alternative<int32_t const *>(
             std::variant<std::monostate, const int32_t *>{&y}));
 
+        // a freshly built tuple of lvalue references (an aggregate torn into
+        // its fields, a tie over existing objects) needs no context slot: the
+        // referenced objects outlive the match and the tuple itself is
+        // re-derivable at will.
+        template <typename T>
+        struct AllLvalueRefTuple : std::false_type
+        {
+        };
+
+        template <typename... Ts>
+        struct AllLvalueRefTuple<std::tuple<Ts...>>
+            : std::conjunction<std::is_lvalue_reference<Ts>...>
+        {
+        };
+
+        template <typename T>
+        constexpr auto allLvalueRefTupleV =
+            AllLvalueRefTuple<std::remove_reference_t<T>>::value;
+
+        template <typename Type>
+        class Id;
+
+        template <typename Type>
+        class SharedId;
+
+        // a prvalue projection result also needs no context slot when nothing
+        // below the projection can keep a reference into it: a pure test (no
+        // ids under the pattern) only inspects the result while it is alive as
+        // the call's temporary, and a lone Id over the whole result moves it
+        // straight into its own block, since rvalue bindings are always owned
+        // and never by-pointer. Any other shape may hand lvalue references to
+        // sub-patterns (at(), ds over the result), so those still materialize
+        // into the context, where ids pointing into the result stay valid for
+        // the handler.
+        template <typename Pattern, typename AppResult>
+        constexpr auto consumesPrvalueDirectlyV =
+            PatternTraits<Pattern>::nbIdV == 0 ||
+            std::is_same_v<Pattern, Id<std::decay_t<AppResult>>> ||
+            std::is_same_v<Pattern, SharedId<std::decay_t<AppResult>>>;
+
         template <typename Unary, typename Pattern>
         class PatternTraits<App<Unary, Pattern>>
         {
@@ -898,11 +2153,13 @@ namespace matchit
             // support constexpr.
             template <typename Value>
             using AppResultCurTuple =
-                std::conditional_t<std::is_lvalue_reference_v<AppResult<Value>>
+                std::conditional_t<std::is_lvalue_reference_v<AppResult<Value>> ||
+                                       allLvalueRefTupleV<AppResult<Value>>
 #if NO_SCALAR_REFERENCES_USED_IN_PATTERNS
                                     || std::is_scalar_v<AppResult<Value>>
 #endif // NO_SCALAR_REFERENCES_USED_IN_PATTERNS
-                                    ,
+                                    || consumesPrvalueDirectlyV<
+                                           Pattern, AppResult<Value>>,
                                    std::tuple<>,
                                    std::tuple<std::decay_t<AppResult<Value>>>>;
 
@@ -915,7 +2172,7 @@ namespace matchit
             constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    App<Unary, Pattern> const &appPat,
                                                    int32_t depth, ContextT &context)
             {
@@ -929,18 +2186,308 @@ namespace matchit
                 {
                     context.emplace_back(invoke_(appPat.unary(), value));
                     decltype(auto) result =
-                        get<std::decay_t<AppResult<Value>>>(context.back());
+                        context.template backAs<std::decay_t<AppResult<Value>>>();
                     return matchPattern(std::forward<AppResult<Value>>(result),
                                         appPat.pattern(), depth + 1, context);
                 }
             }
-            constexpr static void processIdImpl(App<Unary, Pattern> const &appPat,
+            MATCHIT_HOT constexpr static void processIdImpl(App<Unary, Pattern> const &appPat,
                                                 int32_t depth, IdProcess idProcess)
             {
                 return processId(appPat.pattern(), depth, idProcess);
             }
         };
 
+        // Fused optional/pointer patterns. some(p) used to compose
+        // and_(app(cast<bool>, true), app(deref, p)) — two App traversals
+        // with their context and processId bookkeeping for what is one
+        // emptiness test plus a dereference. Some runs that directly: a
+        // single static_cast<bool> check, then p is matched (and any ids
+        // bound) through the reference the dereference yields. None is the
+        // emptiness test alone. Works for anything contextually
+        // bool-convertible and dereferenceable: std::optional, raw
+        // pointers, smart pointers.
+        template <typename Pattern>
+        class Some
+        {
+        public:
+            constexpr explicit Some(Pattern const &pattern)
+                : mPattern{pattern}
+            {
+            }
+            constexpr auto const &pattern() const { return mPattern; }
+
+        private:
+            InternalPatternT<Pattern> mPattern;
+        };
+
+        template <typename Pattern>
+        class PatternTraits<Some<Pattern>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = typename PatternTraits<Pattern>::
+                template AppResultTuple<decltype(*std::declval<Value>())>;
+
+            constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
+
+            template <typename Value, typename ContextT>
+            MATCHIT_HOT constexpr static auto matchPatternImpl(
+                Value &&value, Some<Pattern> const &somePat, int32_t depth,
+                ContextT &context)
+            {
+                return static_cast<bool>(value) &&
+                       matchPattern(*std::forward<Value>(value),
+                                    somePat.pattern(), depth + 1, context);
+            }
+            MATCHIT_HOT constexpr static void processIdImpl(
+                Some<Pattern> const &somePat, int32_t depth,
+                IdProcess idProcess)
+            {
+                return processId(somePat.pattern(), depth, idProcess);
+            }
+        };
+
+        class None
+        {
+        };
+
+        template <>
+        class PatternTraits<None>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = std::tuple<>;
+
+            constexpr static auto nbIdV = 0;
+
+            template <typename Value, typename ContextT>
+            constexpr static auto matchPatternImpl(Value &&value, None const &,
+                                                   int32_t /* depth */,
+                                                   ContextT &)
+            {
+                return !static_cast<bool>(value);
+            }
+            constexpr static void processIdImpl(None const &, int32_t,
+                                                IdProcess)
+            {
+            }
+        };
+
+        // Compiled string-shape pattern. Prefix, suffix and segment tests
+        // against strings are routinely written as meet lambdas stacking
+        // substr and find calls — several passes over the value and a
+        // lambda per shape. glob("GET /api/*/status") compiles the spec
+        // once at construction (constexpr when the pattern is) into a
+        // table of star-free literal segments and matches in a single
+        // forward walk with no allocation: the first segment anchors as a
+        // prefix, the last as a suffix, and the segments between are
+        // located greedily left to right. '*' matches any run of
+        // characters (consecutive stars collapse), '?' matches exactly
+        // one. Each star's run can be captured by passing one sub-pattern
+        // per star — glob("*.cpp", stem) — matched against a
+        // std::string_view of the run, so Id<std::string_view> binds it
+        // without copying the characters (see Id below for the aliasing
+        // rules).
+        template <std::size_t N, typename... Patterns>
+        class Glob
+        {
+        public:
+            constexpr explicit Glob(char const (&spec)[N],
+                                    Patterns const &...patterns)
+                : mSpec{}, mBegin{}, mEnd{}, mSegCount{1}, mPatterns{patterns...}
+            {
+                constexpr auto len = N - 1;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    mSpec[i] = spec[i];
+                }
+                std::size_t seg = 0;
+                std::size_t i = 0;
+                while (i < len)
+                {
+                    if (mSpec[i] == '*')
+                    {
+                        mEnd[seg] = i;
+                        while (i < len && mSpec[i] == '*')
+                        {
+                            ++i;
+                        }
+                        ++seg;
+                        mBegin[seg] = i;
+                    }
+                    else
+                    {
+                        ++i;
+                    }
+                }
+                mEnd[seg] = len;
+                mSegCount = seg + 1;
+                // one capture sub-pattern per star, or none for a pure test.
+                assert(sizeof...(Patterns) == 0 || sizeof...(Patterns) == seg);
+            }
+
+            constexpr auto const &patterns() const { return mPatterns; }
+
+            template <typename ContextT>
+            constexpr bool matchView(std::string_view value, int32_t depth,
+                                     ContextT &context) const
+            {
+                auto const stars = mSegCount - 1;
+                if (stars == 0)
+                {
+                    return value.size() == segLen(0) &&
+                           segMatchesAt(0, value, 0);
+                }
+                if (value.size() < segLen(0) + segLen(stars) ||
+                    !segMatchesAt(0, value, 0))
+                {
+                    return false;
+                }
+                auto const suffixStart = value.size() - segLen(stars);
+                if (suffixStart < segLen(0) ||
+                    !segMatchesAt(stars, value, suffixStart))
+                {
+                    return false;
+                }
+                if constexpr (sizeof...(Patterns) == 0)
+                {
+                    static_cast<void>(depth);
+                    static_cast<void>(context);
+                    auto pos = segLen(0);
+                    for (std::size_t seg = 1; seg != stars; ++seg)
+                    {
+                        pos = findSeg(seg, value, pos, suffixStart);
+                        if (pos == std::string_view::npos)
+                        {
+                            return false;
+                        }
+                        pos += segLen(seg);
+                    }
+                    return true;
+                }
+                else
+                {
+                    return matchCaptures(
+                        value, segLen(0), suffixStart, depth, context,
+                        std::make_index_sequence<sizeof...(Patterns)>{});
+                }
+            }
+
+        private:
+            constexpr std::size_t segLen(std::size_t seg) const
+            {
+                return mEnd[seg] - mBegin[seg];
+            }
+            constexpr bool segMatchesAt(std::size_t seg, std::string_view value,
+                                        std::size_t pos) const
+            {
+                for (auto k = mBegin[seg]; k != mEnd[seg]; ++k, ++pos)
+                {
+                    if (mSpec[k] != '?' && mSpec[k] != value[pos])
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            // first start in [from, limit - segLen] where seg matches, or
+            // npos.
+            constexpr std::size_t findSeg(std::size_t seg,
+                                          std::string_view value,
+                                          std::size_t from,
+                                          std::size_t limit) const
+            {
+                for (auto pos = from; pos + segLen(seg) <= limit; ++pos)
+                {
+                    if (segMatchesAt(seg, value, pos))
+                    {
+                        return pos;
+                    }
+                }
+                return std::string_view::npos;
+            }
+            template <typename ContextT, std::size_t... I>
+            constexpr bool matchCaptures(std::string_view value,
+                                         std::size_t pos,
+                                         std::size_t suffixStart, int32_t depth,
+                                         ContextT &context,
+                                         std::index_sequence<I...>) const
+            {
+                auto result = true;
+                auto const step = [&](auto idxC, auto const &pat)
+                {
+                    constexpr auto idx = decltype(idxC)::value;
+                    if (!result)
+                    {
+                        return;
+                    }
+                    auto capEnd = suffixStart;
+                    if constexpr (idx + 1 < sizeof...(Patterns))
+                    {
+                        capEnd = findSeg(idx + 1, value, pos, suffixStart);
+                        if (capEnd == std::string_view::npos)
+                        {
+                            result = false;
+                            return;
+                        }
+                    }
+                    result = matchPattern(value.substr(pos, capEnd - pos), pat,
+                                          depth + 1, context);
+                    pos = capEnd + segLen(idx + 1);
+                };
+                (step(std::integral_constant<std::size_t, I>{},
+                      std::get<I>(mPatterns)),
+                 ...);
+                return result;
+            }
+
+            char mSpec[N];
+            // star-free [begin, end) ranges into mSpec; mSegCount - 1 stars.
+            std::size_t mBegin[N];
+            std::size_t mEnd[N];
+            std::size_t mSegCount;
+            std::tuple<InternalPatternT<Patterns>...> mPatterns;
+        };
+
+        template <std::size_t N, typename... Patterns>
+        constexpr auto glob(char const (&spec)[N], Patterns const &...patterns)
+        {
+            return Glob<N, Patterns...>{spec, patterns...};
+        }
+
+        template <std::size_t N, typename... Patterns>
+        class PatternTraits<Glob<N, Patterns...>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = decltype(std::tuple_cat(
+                std::declval<typename PatternTraits<Patterns>::
+                                 template AppResultTuple<std::string_view>>()...));
+
+            constexpr static auto nbIdV =
+                (PatternTraits<Patterns>::nbIdV + ... + 0);
+
+            template <typename Value, typename ContextT>
+            MATCHIT_HOT constexpr static auto matchPatternImpl(
+                Value &&value, Glob<N, Patterns...> const &globPat,
+                int32_t depth, ContextT &context)
+            {
+                return globPat.matchView(
+                    std::string_view{std::forward<Value>(value)}, depth,
+                    context);
+            }
+            MATCHIT_HOT constexpr static void processIdImpl(
+                Glob<N, Patterns...> const &globPat, int32_t depth,
+                IdProcess idProcess)
+            {
+                std::apply(
+                    [depth, idProcess](auto const &...pats)
+                    { (processId(pats, depth, idProcess), ...); },
+                    globPat.patterns());
+            }
+        };
+
         template <typename... Patterns>
         class And
         {
@@ -982,9 +2529,12 @@ namespace matchit
             constexpr static auto nbIdV = (PatternTraits<Patterns>::nbIdV + ... + 0);
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    And<Patterns...> const &andPat,
                                                    int32_t depth, ContextT &context)
+                noexcept((isNothrowMatchV<InternalPatternT<Patterns>, Value &,
+                                          ContextT> &&
+                          ...))
             {
                 constexpr auto patSize = sizeof...(Patterns);
                 auto const exceptLast = std::apply(
@@ -1009,7 +2559,7 @@ namespace matchit
                                         context);
                 }
             }
-            constexpr static void processIdImpl(And<Patterns...> const &andPat,
+            MATCHIT_HOT constexpr static void processIdImpl(And<Patterns...> const &andPat,
                                                 int32_t depth, IdProcess idProcess)
             {
                 return std::apply(
@@ -1025,8 +2575,8 @@ namespace matchit
         class Not
         {
         public:
-            explicit Not(Pattern const &pattern) : mPattern{pattern} {}
-            auto const &pattern() const { return mPattern; }
+            constexpr explicit Not(Pattern const &pattern) : mPattern{pattern} {}
+            constexpr auto const &pattern() const { return mPattern; }
 
         private:
             InternalPatternT<Pattern> mPattern;
@@ -1049,76 +2599,316 @@ namespace matchit
             constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    Not<Pattern> const &notPat,
                                                    int32_t depth, ContextT &context)
+                noexcept(isNothrowMatchV<InternalPatternT<Pattern>, Value,
+                                         ContextT>)
             {
                 return !matchPattern(std::forward<Value>(value), notPat.pattern(),
                                      depth + 1, context);
             }
-            constexpr static void processIdImpl(Not<Pattern> const &notPat, int32_t depth,
+            MATCHIT_HOT constexpr static void processIdImpl(Not<Pattern> const &notPat, int32_t depth,
                                                 IdProcess idProcess)
             {
                 processId(notPat.pattern(), depth, idProcess);
             }
         };
 
-        template <typename Ptr, typename Value, typename = std::void_t<>>
-        struct StorePointer : std::false_type
-        {
-        };
-
-        template <typename Type>
-        using ValueVariant =
-                std::conditional_t<std::is_lvalue_reference_v<Type>,
-                            UniqVariant<std::remove_reference_t<Type>*>,
-                            std::conditional_t<std::is_rvalue_reference_v<Type>,
-                                        UniqVariant<std::remove_reference_t<Type>, std::remove_reference_t<Type> *>,
-                                        std::conditional_t<std::is_abstract_v<std::remove_reference_t<Type>>,
-                                                UniqVariant<std::remove_reference_t<Type>*, std::remove_reference_t<Type> const *>,
-                                                UniqVariant<std::remove_reference_t<Type>, std::remove_reference_t<Type>*, std::remove_reference_t<Type> const *>
-                                                >
-                                            >>;
-
-        template <typename Type, typename Value>
-        struct StorePointer<Type, Value,
-                            std::void_t<decltype(std::declval<ValueVariant<Type> &>() =
-                                                     &std::declval<Value>())>>
-            : std::is_reference<Value> // need to double check this condition. to loosen it.
-        {
-        };
-
-        static_assert(!StorePointer<char, char>::value);
-        // static_assert(StorePointer<std::tuple<char, int>, std::tuple<char, int>>::value);
-        static_assert(StorePointer<char, char &>::value);
-        static_assert(StorePointer<const char, const char &>::value);
-        static_assert(StorePointer<const char, char &>::value);
-        static_assert(StorePointer<std::tuple<int32_t &, int32_t &> const,
-                                   std::tuple<int32_t &, int32_t &> const &>::value);
-
-        template <typename... Ts>
-        class Overload : public Ts...
+        // Canonicalization rewrites pattern trees into cheaper equivalent
+        // shapes before any value is matched: double negation is dropped,
+        // not_(or_(...)) is De-Morganed into and_ of negations (each
+        // alternative is tested at most once instead of the whole
+        // disjunction running to completion under the negation), nested
+        // and_ is flattened into one conjunction, and stateless duplicate
+        // subpatterns (the same meet reused, repeated wildcards — the
+        // shapes rule engines produce when composing fragments
+        // programmatically) collapse to their first occurrence. Only
+        // id-free subtrees are rewritten: composites run their children
+        // one depth deeper, so moving a pattern across a composite
+        // boundary would change the depth its ids confirm and cancel at.
+        // Duplicate literals inside or_ are left alone — they are equal
+        // values of one type, not redundant types, and the fold-based
+        // membership test already handles them for the price of a
+        // compare.
+        template <typename Pattern, typename>
+        class CanonicalTraits
         {
         public:
-            using Ts::operator()...;
+            constexpr static Pattern const &canonical(Pattern const &pattern)
+            {
+                return pattern;
+            }
         };
 
-        template <typename... Ts>
-        constexpr auto overload(Ts &&...ts)
+        template <typename Pattern>
+        constexpr decltype(auto) canonicalize(Pattern const &pattern)
         {
-            return Overload<Ts...>{ts...};
+            return CanonicalTraits<Pattern>::canonical(pattern);
         }
 
-        template <typename Pattern>
-        class OooBinder;
-
-        class Ooo;
-
-        template <typename Type>
-        class IdTraits
+        // Keep-first mask over the subpattern types: a stateless (empty)
+        // subpattern that already occurred earlier carries no information
+        // the first occurrence does not, for conjunction and disjunction
+        // alike.
+        template <typename... Patterns>
+        constexpr std::array<bool, sizeof...(Patterns)> keepFirstStatelessMask()
         {
-        public:
-            constexpr static auto
+            constexpr auto size = sizeof...(Patterns);
+            std::array<std::array<bool, size>, size> const same = {
+                {sameTypeRow<Patterns, Patterns...>()...}};
+            std::array<bool, size> const stateless = {
+                {std::is_empty_v<Patterns>...}};
+            std::array<bool, size> kept{};
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                kept[i] = true;
+                if (stateless[i])
+                {
+                    for (std::size_t j = 0; j < i; ++j)
+                    {
+                        if (same[i][j])
+                        {
+                            kept[i] = false;
+                        }
+                    }
+                }
+            }
+            return kept;
+        }
+
+        template <std::size_t N>
+        constexpr std::size_t countKept(std::array<bool, N> const &kept)
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                count += kept[i] ? std::size_t{1} : std::size_t{0};
+            }
+            return count;
+        }
+
+        template <std::size_t Count, std::size_t N>
+        constexpr std::array<std::size_t, Count>
+        keptIndices(std::array<bool, N> const &kept)
+        {
+            std::array<std::size_t, Count> indices{};
+            std::size_t out = 0;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (kept[i])
+                {
+                    indices[out++] = i;
+                }
+            }
+            return indices;
+        }
+
+        template <typename Rebuild, std::size_t... I, typename... Patterns>
+        constexpr auto selectKept(Rebuild rebuild, std::index_sequence<I...>,
+                                  std::tuple<Patterns...> const &children)
+        {
+            constexpr auto indices =
+                keptIndices<sizeof...(I)>(keepFirstStatelessMask<Patterns...>());
+            return rebuild(std::get<indices[I]>(children)...);
+        }
+
+        template <typename Rebuild, typename... Patterns>
+        constexpr auto dedupStateless(Rebuild rebuild,
+                                      std::tuple<Patterns...> const &children)
+        {
+            return selectKept(
+                rebuild,
+                std::make_index_sequence<countKept(
+                    keepFirstStatelessMask<Patterns...>())>{},
+                children);
+        }
+
+        template <typename Pattern>
+        class IsAnd : public std::false_type
+        {
+        };
+
+        template <typename... Patterns>
+        class IsAnd<And<Patterns...>> : public std::true_type
+        {
+        };
+
+        // Splice an already-canonical subpattern into an enclosing
+        // conjunction: canonical And children are themselves flat, so this
+        // recurses at most one level.
+        template <typename Pattern>
+        constexpr auto flattenAnd(Pattern const &pattern)
+        {
+            if constexpr (IsAnd<Pattern>::value)
+            {
+                return std::apply(
+                    [](auto const &...patterns)
+                    { return std::tuple_cat(flattenAnd(patterns)...); },
+                    pattern.patterns());
+            }
+            else
+            {
+                return std::make_tuple(pattern);
+            }
+        }
+
+        // not_(not_(p)) -> p.
+        template <typename Pattern>
+        class CanonicalTraits<
+            Not<Not<Pattern>>,
+            std::enable_if_t<PatternTraits<Not<Not<Pattern>>>::nbIdV == 0>>
+        {
+        public:
+            constexpr static decltype(auto) canonical(Not<Not<Pattern>> const &p)
+            {
+                return canonicalize(p.pattern().pattern());
+            }
+        };
+
+        // De Morgan: not_(or_(p...)) -> and_(not_(p)...). Re-canonicalizing
+        // the rebuilt conjunction flattens it and resolves negations the
+        // rewrite itself introduced (a negated alternative that was an or_
+        // De-Morgans in turn; a negated negation drops).
+        template <typename... Patterns>
+        class CanonicalTraits<
+            Not<Or<Patterns...>>,
+            std::enable_if_t<PatternTraits<Not<Or<Patterns...>>>::nbIdV == 0>>
+        {
+        public:
+            constexpr static auto canonical(Not<Or<Patterns...>> const &p)
+            {
+                return std::apply(
+                    [](auto const &...patterns)
+                    { return canonicalize(and_(not_(canonicalize(patterns))...)); },
+                    p.pattern().patterns());
+            }
+        };
+
+        template <typename... Patterns>
+        class CanonicalTraits<
+            And<Patterns...>,
+            std::enable_if_t<PatternTraits<And<Patterns...>>::nbIdV == 0>>
+        {
+        public:
+            constexpr static auto canonical(And<Patterns...> const &p)
+            {
+                auto const flat = std::apply(
+                    [](auto const &...patterns)
+                    { return std::tuple_cat(flattenAnd(canonicalize(patterns))...); },
+                    p.patterns());
+                return dedupStateless(
+                    [](auto const &...patterns) { return and_(patterns...); },
+                    flat);
+            }
+        };
+
+        template <typename... Patterns>
+        class CanonicalTraits<
+            Or<Patterns...>,
+            std::enable_if_t<PatternTraits<Or<Patterns...>>::nbIdV == 0>>
+        {
+        public:
+            constexpr static auto canonical(Or<Patterns...> const &p)
+            {
+                auto const children = std::apply(
+                    [](auto const &...patterns)
+                    { return std::make_tuple(canonicalize(patterns)...); },
+                    p.patterns());
+                return dedupStateless(
+                    [](auto const &...patterns) { return or_(patterns...); },
+                    children);
+            }
+        };
+
+        static_assert(
+            std::is_same_v<std::decay_t<decltype(canonicalize(
+                               not_(not_(std::declval<int32_t &>()))))>,
+                           int32_t>);
+        static_assert(
+            std::is_same_v<std::decay_t<decltype(canonicalize(not_(or_(1, 2))))>,
+                           And<Not<int32_t>, Not<int32_t>>>);
+        static_assert(std::is_same_v<
+                      std::decay_t<decltype(canonicalize(
+                          and_(and_(std::declval<Wildcard &>(), 1), 2)))>,
+                      And<Wildcard, int32_t, int32_t>>);
+        static_assert(std::is_same_v<std::decay_t<decltype(canonicalize(or_(
+                          std::declval<Wildcard &>(), 1,
+                          std::declval<Wildcard &>())))>,
+                      Or<Wildcard, int32_t>>);
+
+        template <typename Ptr, typename Value, typename = std::void_t<>>
+        struct StorePointer : std::false_type
+        {
+        };
+
+        template <typename Type>
+        using ValueVariant =
+                std::conditional_t<std::is_lvalue_reference_v<Type>,
+                            UniqVariant<std::remove_reference_t<Type>*>,
+                            std::conditional_t<std::is_rvalue_reference_v<Type>,
+                                        UniqVariant<std::remove_reference_t<Type>, std::remove_reference_t<Type> *>,
+                                        std::conditional_t<std::is_abstract_v<std::remove_reference_t<Type>>,
+                                                UniqVariant<std::remove_reference_t<Type>*, std::remove_reference_t<Type> const *>,
+                                                UniqVariant<std::remove_reference_t<Type>, std::remove_reference_t<Type>*, std::remove_reference_t<Type> const *>
+                                                >
+                                            >>;
+
+        // Binding policy: lvalue scrutinees whose address fits one of the
+        // block's pointer alternatives are bound by pointer — no copy, no
+        // allocation, whatever the size of the type. Rvalues are moved into
+        // the block (they may not outlive the match), which also serves as
+        // the per-use opt-out: pass std::move(x) or a copy to force an owned
+        // binding. Small trivially copyable types bypass this entirely and
+        // copy through TrivialIdBlock below.
+        template <typename Type, typename Value>
+        struct StorePointer<Type, Value,
+                            std::void_t<decltype(std::declval<ValueVariant<Type> &>() =
+                                                     &std::declval<Value>())>>
+            : std::is_reference<Value>
+        {
+        };
+
+        static_assert(!StorePointer<char, char>::value);
+        // static_assert(StorePointer<std::tuple<char, int>, std::tuple<char, int>>::value);
+        static_assert(StorePointer<char, char &>::value);
+        static_assert(StorePointer<const char, const char &>::value);
+        static_assert(StorePointer<const char, char &>::value);
+        static_assert(StorePointer<std::tuple<int32_t &, int32_t &> const,
+                                   std::tuple<int32_t &, int32_t &> const &>::value);
+
+        template <typename... Ts>
+        class Overload : public Ts...
+        {
+        public:
+            using Ts::operator()...;
+        };
+
+        template <typename... Ts>
+        constexpr auto overload(Ts &&...ts)
+        {
+            return Overload<Ts...>{ts...};
+        }
+
+        template <typename Pattern>
+        class OooBinder;
+
+        class Ooo;
+
+        // Equality for a repeated Id occurrence: when the same Id appears
+        // more than once in a pattern (ds(x, x), x reused across or_
+        // branches), occurrences after the first are checked against the
+        // bound value through this trait. Specialize it for types whose
+        // operator== is a deep walk to make the re-check cheap — compare a
+        // precomputed hash or a length field first and fall back to full
+        // equality only on agreement. An occurrence that sees the very
+        // same object as a by-pointer binding short-circuits on address
+        // identity before this trait is consulted.
+        template <typename Type>
+        class IdTraits
+        {
+        public:
+            constexpr static auto
 #if defined(__has_feature)
 #if __has_feature(address_sanitizer)
                 __attribute__((no_sanitize_address))
@@ -1148,7 +2938,14 @@ namespace matchit
             {
                 if (mDepth - depth >= 0)
                 {
-                    mVariant = {};
+                    // cancel walks mostly hit never-bound blocks (failed or_
+                    // alternatives that did not reach this Id); skip the
+                    // assignment, and its destroy for non-trivial types, when
+                    // the block is already empty.
+                    if (!std::holds_alternative<std::monostate>(mVariant))
+                    {
+                        mVariant = {};
+                    }
                     mDepth = depth;
                 }
             }
@@ -1191,6 +2988,28 @@ namespace matchit
                                 }),
                     IdBlockBase<Type>::mVariant);
             }
+            // move-out access: only legal when the match bound an owned
+            // value; by-pointer bindings alias the scrutinee and must not be
+            // stolen from.
+            constexpr decltype(auto) move()
+            {
+                return std::visit(
+                    overload([](Type &v) -> Type && { return std::move(v); },
+                                [](Type const *) -> Type && {
+                                    throw std::logic_error(
+                                        "Cannot move out of a by-reference "
+                                        "binding!");
+                                },
+                                [](Type *) -> Type && {
+                                    throw std::logic_error(
+                                        "Cannot move out of a by-reference "
+                                        "binding!");
+                                },
+                                [](std::monostate &) -> Type && {
+                                    throw std::logic_error("invalid state!");
+                                }),
+                    IdBlockBase<Type>::mVariant);
+            }
         };
 
         template <typename Type>
@@ -1271,6 +3090,75 @@ namespace matchit
             }
         };
 
+        // Storage fast path for trivially copyable bound types (ints, enums,
+        // small PODs — the common case). Binding is a store plus a flag set
+        // and reading is a flag-guarded load; there is no discriminant to tag
+        // and no pointer alternative, since copying such a value costs no
+        // more than storing its address.
+        template <typename Type>
+        class TrivialIdBlock
+        {
+            int32_t mDepth{};
+            Type mValue{};
+            bool mHasValue{};
+
+        public:
+            constexpr void reset(int32_t depth)
+            {
+                if (mDepth - depth >= 0)
+                {
+                    mHasValue = false;
+                    mDepth = depth;
+                }
+            }
+            constexpr void confirm(int32_t depth)
+            {
+                if (mDepth > depth || mDepth == 0)
+                {
+                    assert(depth == mDepth - 1 || depth == mDepth || mDepth == 0);
+                    mDepth = depth;
+                }
+            }
+            constexpr auto hasValue() const { return mHasValue; }
+            constexpr Type const &get() const
+            {
+                if (!mHasValue)
+                {
+                    throw std::logic_error("invalid state!");
+                }
+                return mValue;
+            }
+            template <typename Value>
+            constexpr void bind(Value &&value)
+            {
+                mValue = std::forward<Value>(value);
+                mHasValue = true;
+            }
+            constexpr Type &&move()
+            {
+                if (!mHasValue)
+                {
+                    throw std::logic_error("invalid state!");
+                }
+                return std::move(mValue);
+            }
+        };
+
+        // The plain block copies on bind, so it is reserved for types where
+        // the copy is no dearer than storing a pointer. Larger trivially
+        // copyable types (multi-kilobyte PODs matched by lvalue) keep the
+        // variant block, whose StorePointer path binds them by pointer
+        // without any copy.
+        template <typename Type>
+        constexpr auto useTrivialIdBlockV =
+            !std::is_reference_v<Type> && std::is_trivially_copyable_v<Type> &&
+            std::is_default_constructible_v<Type> &&
+            sizeof(Type) <= 2 * sizeof(void *);
+
+        template <typename Type>
+        using IdBlockT = std::conditional_t<useTrivialIdBlockV<Type>,
+                                            TrivialIdBlock<Type>, IdBlock<Type>>;
+
         template <typename Type>
         class IdUtil
         {
@@ -1288,13 +3176,37 @@ namespace matchit
             {
                 v = ValueVariant<Type>{&value};
             }
+            // address of a by-pointer binding, or nullptr for owned and
+            // empty blocks; lets a repeated occurrence over the very same
+            // object settle equality by identity.
+            constexpr static void const *boundAddress(ValueVariant<Type> const &v)
+            {
+                using P = std::remove_const_t<std::remove_reference_t<Type>>;
+                return std::visit(
+                    overload([](P const *p) -> void const * { return p; },
+                             [](P *p) -> void const * { return p; },
+                             [](auto const &) -> void const *
+                             { return nullptr; }),
+                    v);
+            }
         };
 
+        // Binding string data without allocating: Id<std::string_view> is
+        // the supported way to capture a piece of a string scrutinee.
+        // string_view rides the trivial block, so binding copies the
+        // 16-byte view — never the characters — whether it comes from the
+        // scrutinee itself, a substr/tokenize projection, or a
+        // std::string lvalue (bound as a view of its buffer). The view
+        // aliases the scrutinee (or the arm's context for materialized
+        // projections), both of which outlive the handler, so reading it
+        // inside the handler is always safe; like any binding it must not
+        // escape the match expression. A repeated occurrence compares
+        // content, as string_view equality does.
         template <typename Type>
         class Id
         {
         private:
-            using BlockT = IdBlock<Type>;
+            using BlockT = IdBlockT<Type>;
             using BlockVT = std::variant<BlockT, BlockT *>;
             BlockVT mBlock = BlockT{};
 
@@ -1325,15 +3237,37 @@ namespace matchit
             }
 
             template <typename Value>
-            constexpr auto
+            MATCHIT_HOT constexpr auto
                 matchValue(Value &&v) const
             {
                 if (hasValue())
                 {
+                    // repeated occurrence: a prior by-pointer binding of
+                    // this very object is equal by identity — skip the
+                    // deep compare.
+                    if constexpr (!useTrivialIdBlockV<Type> &&
+                                  std::is_lvalue_reference_v<Value> &&
+                                  std::is_same_v<std::decay_t<Value>,
+                                                 std::decay_t<Type>>)
+                    {
+                        if (IdUtil<Type>::boundAddress(block().variant()) ==
+                            static_cast<void const *>(std::addressof(v)))
+                        {
+                            return true;
+                        }
+                    }
                     return IdTraits<std::decay_t<Type>>::equal(internalValue(), v);
                 }
-                IdUtil<Type>::bindValue(block().variant(), std::forward<Value>(v),
-                                   StorePointer<Type, Value>{});
+                if constexpr (useTrivialIdBlockV<Type>)
+                {
+                    block().bind(std::forward<Value>(v));
+                }
+                else
+                {
+                    IdUtil<Type>::bindValue(block().variant(),
+                                            std::forward<Value>(v),
+                                            StorePointer<Type, Value>{});
+                }
                 return true;
             }
             constexpr void reset(int32_t depth) const { return block().reset(depth); }
@@ -1343,6 +3277,11 @@ namespace matchit
             constexpr decltype(auto) get() { return block().get(); }
             // non-const to inform users not to mark Id as const.
             constexpr decltype(auto) operator*() { return get(); }
+            // steal the bound value out of the block instead of copying it.
+            // Only legal when the match bound an owned value (an rvalue
+            // scrutinee or a materialized intermediate); by-pointer bindings
+            // throw. Non-const to inform users not to mark Id as const.
+            constexpr decltype(auto) move() { return block().move(); }
         };
 
         template <typename Type>
@@ -1355,12 +3294,12 @@ namespace matchit
             constexpr static auto nbIdV = true;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value, Id<Type> const &idPat,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value, Id<Type> const &idPat,
                                                    int32_t /* depth */, ContextT &)
             {
                 return idPat.matchValue(std::forward<Value>(value));
             }
-            constexpr static void processIdImpl(Id<Type> const &idPat, int32_t depth,
+            MATCHIT_HOT constexpr static void processIdImpl(Id<Type> const &idPat, int32_t depth,
                                                 IdProcess idProcess)
             {
                 switch (idProcess)
@@ -1376,6 +3315,120 @@ namespace matchit
             }
         };
 
+        // Thread-shareable Id. A plain Id carries its binding inside the
+        // pattern object, so an arm set that binds Ids cannot be shared
+        // across threads and ends up rebuilt per call. A SharedId stores
+        // only an immutable slot index; the binding block lives in
+        // thread-local storage, one block per (slot, thread). A static
+        // pattern expression (or static matcher()) containing SharedIds can
+        // therefore serve any number of threads concurrently, each seeing
+        // its own bindings. Every access costs one thread-local vector
+        // lookup, so prefer plain Id when the pattern is built per call
+        // anyway. ooo binding is not supported; use Id for subranges.
+        template <typename Type>
+        class SharedId
+        {
+            using BlockT = IdBlockT<Type>;
+            std::size_t mSlot;
+
+            static std::size_t allocateSlot()
+            {
+                static std::atomic<std::size_t> counter{0};
+                return counter.fetch_add(1, std::memory_order_relaxed);
+            }
+            BlockT &block() const
+            {
+                static thread_local std::vector<BlockT> blocks;
+                if (blocks.size() <= mSlot)
+                {
+                    blocks.resize(mSlot + 1);
+                }
+                return blocks[mSlot];
+            }
+
+        public:
+            SharedId() : mSlot{allocateSlot()} {}
+            // copies share the slot, as Id copies share the block.
+            SharedId(SharedId const &) = default;
+
+            // non-const to inform users not to mark SharedId as const.
+            template <typename Pattern>
+            auto at(Pattern &&pattern)
+            {
+                return and_(pattern, *this);
+            }
+
+            template <typename Value>
+            auto matchValue(Value &&v) const
+            {
+                auto &b = block();
+                if (b.hasValue())
+                {
+                    if constexpr (!useTrivialIdBlockV<Type> &&
+                                  std::is_lvalue_reference_v<Value> &&
+                                  std::is_same_v<std::decay_t<Value>,
+                                                 std::decay_t<Type>>)
+                    {
+                        if (IdUtil<Type>::boundAddress(b.variant()) ==
+                            static_cast<void const *>(std::addressof(v)))
+                        {
+                            return true;
+                        }
+                    }
+                    return IdTraits<std::decay_t<Type>>::equal(b.get(), v);
+                }
+                if constexpr (useTrivialIdBlockV<Type>)
+                {
+                    b.bind(std::forward<Value>(v));
+                }
+                else
+                {
+                    IdUtil<Type>::bindValue(b.variant(), std::forward<Value>(v),
+                                            StorePointer<Type, Value>{});
+                }
+                return true;
+            }
+            void reset(int32_t depth) const { block().reset(depth); }
+            void confirm(int32_t depth) const { block().confirm(depth); }
+            bool hasValue() const { return block().hasValue(); }
+            // non-const to inform users not to mark SharedId as const.
+            decltype(auto) get() { return block().get(); }
+            decltype(auto) operator*() { return get(); }
+            decltype(auto) move() { return block().move(); }
+        };
+
+        template <typename Type>
+        class PatternTraits<SharedId<Type>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple = std::tuple<>;
+
+            constexpr static auto nbIdV = true;
+
+            template <typename Value, typename ContextT>
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
+                                                   SharedId<Type> const &idPat,
+                                                   int32_t /* depth */, ContextT &)
+            {
+                return idPat.matchValue(std::forward<Value>(value));
+            }
+            MATCHIT_HOT constexpr static void processIdImpl(SharedId<Type> const &idPat,
+                                                int32_t depth, IdProcess idProcess)
+            {
+                switch (idProcess)
+                {
+                case IdProcess::kCANCEL:
+                    idPat.reset(depth);
+                    break;
+
+                case IdProcess::kCONFIRM:
+                    idPat.confirm(depth);
+                    break;
+                }
+            }
+        };
+
         template <typename... Patterns>
         class Ds
         {
@@ -1427,12 +3480,12 @@ namespace matchit
             constexpr static auto nbIdV = false;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&, Ooo, int32_t /*depth*/,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&, Ooo, int32_t /*depth*/,
                                                    ContextT &)
             {
                 return true;
             }
-            constexpr static void processIdImpl(Ooo, int32_t /*depth*/, IdProcess) {}
+            MATCHIT_HOT constexpr static void processIdImpl(Ooo, int32_t /*depth*/, IdProcess) {}
         };
 
         template <typename Pattern>
@@ -1443,17 +3496,20 @@ namespace matchit
             using AppResultTuple =
                 typename PatternTraits<Pattern>::template AppResultTuple<Value>;
 
-            constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
+            // the binder's template argument is the bound type, not a
+            // sub-pattern; what the confirm/cancel walk reaches is the one
+            // Id the binder wraps.
+            constexpr static auto nbIdV = PatternTraits<Id<Pattern>>::nbIdV;
 
             template <typename Value, typename ContextT>
-            constexpr static auto matchPatternImpl(Value &&value,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(Value &&value,
                                                    OooBinder<Pattern> const &oooBinderPat,
                                                    int32_t depth, ContextT &context)
             {
                 return matchPattern(std::forward<Value>(value), oooBinderPat.binder(),
                                     depth + 1, context);
             }
-            constexpr static void processIdImpl(OooBinder<Pattern> const &oooBinderPat,
+            MATCHIT_HOT constexpr static void processIdImpl(OooBinder<Pattern> const &oooBinderPat,
                                                 int32_t depth, IdProcess idProcess)
             {
                 processId(oooBinderPat.binder(), depth, idProcess);
@@ -1560,10 +3616,33 @@ namespace matchit
                                     depth + 1, context);
             };
             static_cast<void>(func);
-            // Fix Me, avoid call next from begin every time.
-            return (func(*std::next(rangeBegin, static_cast<long>(I)),
-                         std::get<I + patternStartIdx>(patternTuple)) &&
-                    ...);
+            using Iter = std::decay_t<RangeBegin>;
+            if constexpr (std::is_convertible_v<
+                              typename std::iterator_traits<Iter>::iterator_category,
+                              std::random_access_iterator_tag>)
+            {
+                return (func(rangeBegin[static_cast<std::ptrdiff_t>(I)],
+                             std::get<I + patternStartIdx>(patternTuple)) &&
+                        ...);
+            }
+            else
+            {
+                // forward iterators: advance one shared iterator through the
+                // fold instead of std::next from begin per position, which
+                // would walk the range quadratically.
+                auto iter = rangeBegin;
+                static_cast<void>(iter);
+                auto const step = [&](auto &&pattern)
+                {
+                    auto &&value = *iter;
+                    auto const matched =
+                        func(std::forward<decltype(value)>(value), pattern);
+                    ++iter;
+                    return matched;
+                };
+                static_cast<void>(step);
+                return (step(std::get<I + patternStartIdx>(patternTuple)) && ...);
+            }
         }
 
         template <std::size_t patternStartIdx, std::size_t size,
@@ -1577,6 +3656,67 @@ namespace matchit
                 std::make_index_sequence<size>{});
         }
 
+        template <std::size_t patternStartIdx, typename Stream,
+                  typename PatternTuple, typename ContextT, std::size_t... I>
+        bool matchStreamPrefixImpl(Stream &stream, PatternTuple const &patternTuple,
+                                   int32_t depth, ContextT &context,
+                                   std::index_sequence<I...>)
+        {
+            using Elem = typename Stream::value_type;
+            // consumed elements land in the binding context so that ids bound
+            // inside the element patterns outlive this call.
+            auto const step = [&](auto const &pattern)
+            {
+                if (stream.done())
+                {
+                    return false;
+                }
+                context.emplace_back(stream.next());
+                return matchPattern(context.template backAs<Elem>(), pattern,
+                                    depth + 1, context);
+            };
+            static_cast<void>(step);
+            return (step(std::get<I + patternStartIdx>(patternTuple)) && ...);
+        }
+
+        template <std::size_t patternStartIdx, std::size_t size, typename Stream,
+                  typename PatternTuple, typename ContextT>
+        bool matchStreamPrefix(Stream &stream, PatternTuple const &patternTuple,
+                               int32_t depth, ContextT &context)
+        {
+            return matchStreamPrefixImpl<patternStartIdx>(
+                stream, patternTuple, depth, context,
+                std::make_index_sequence<size>{});
+        }
+
+        // O(1) type-at-index lookup: one multiply-inherited indexer per
+        // pack, and overload resolution against its bases picks out the
+        // element. Each std::get/tuple_element query walks the tuple
+        // recursively, which summed over every element of a wide ds
+        // pattern went quadratic.
+        template <std::size_t I, typename T>
+        class IndexedType
+        {
+        public:
+            using type = T;
+        };
+
+        template <typename Indices, typename... Ts>
+        class TypeIndexer;
+
+        template <std::size_t... I, typename... Ts>
+        class TypeIndexer<std::index_sequence<I...>, Ts...>
+            : public IndexedType<I, Ts>...
+        {
+        };
+
+        template <std::size_t I, typename T>
+        constexpr IndexedType<I, T> selectIndexed(IndexedType<I, T> const &);
+
+        template <std::size_t I, typename... Ts>
+        using TypeAtT = typename decltype(selectIndexed<I>(
+            std::declval<TypeIndexer<std::index_sequence_for<Ts...>, Ts...>>()))::type;
+
         template <std::size_t start, typename Indices, typename Tuple>
         class IndexedTypes;
 
@@ -1588,6 +3728,13 @@ namespace matchit
                 std::decay_t<decltype(std::get<start + I>(std::declval<Tuple>()))>...>;
         };
 
+        template <typename... Ts, std::size_t start, std::size_t... I>
+        class IndexedTypes<start, std::index_sequence<I...>, std::tuple<Ts...>>
+        {
+        public:
+            using type = std::tuple<std::decay_t<TypeAtT<start + I, Ts...>>...>;
+        };
+
         template <std::size_t start, std::size_t end, class Tuple>
         class SubTypes
         {
@@ -1605,6 +3752,23 @@ namespace matchit
         template <std::size_t start, std::size_t end, class Tuple>
         using SubTypesT = typename SubTypes<start, end, Tuple>::type;
 
+        template <typename Elem, typename Seq>
+        class RepeatTuple;
+
+        template <typename Elem, std::size_t... I>
+        class RepeatTuple<Elem, std::index_sequence<I...>>
+        {
+            template <std::size_t>
+            using E = Elem;
+
+        public:
+            using type = std::tuple<E<I>...>;
+        };
+
+        template <typename Elem, std::size_t n>
+        using RepeatTupleT =
+            typename RepeatTuple<Elem, std::make_index_sequence<n>>::type;
+
         static_assert(
             std::is_same_v<
                 std::tuple<std::nullptr_t>,
@@ -1670,11 +3834,63 @@ namespace matchit
         static_assert(!isRangeV<std::pair<int32_t, char>>);
         static_assert(isRangeV<const std::array<int32_t, 5>>);
 
+        // contiguous storage reachable through std::data: memchr/memcmp can
+        // scan it directly instead of walking iterators.
+        template <typename Range, typename = std::void_t<>>
+        struct HasContiguousData : std::false_type
+        {
+        };
+
+        template <typename Range>
+        struct HasContiguousData<
+            Range, std::void_t<decltype(std::data(std::declval<Range const &>()))>>
+            : std::is_pointer<decltype(std::data(std::declval<Range const &>()))>
+        {
+        };
+
+        template <typename Range>
+        constexpr auto hasContiguousDataV =
+            HasContiguousData<std::decay_t<Range>>::value;
+
+        template <typename Tuple>
+        struct AllIntegralElems : std::false_type
+        {
+        };
+
+        template <typename... Ts>
+        struct AllIntegralElems<std::tuple<Ts...>>
+            : std::bool_constant<(std::is_integral_v<std::decay_t<Ts>> && ...)>
+        {
+        };
+
         template <typename... Patterns>
         class PatternTraits<Ds<Patterns...>>
         {
             constexpr static auto nbOooOrBinder = nbOooOrBinderV<Patterns...>;
-            static_assert(nbOooOrBinder == 0 || nbOooOrBinder == 1);
+
+            // ds(ooo, needle..., ooo) is a subsequence search: the needle may
+            // sit at any offset of the scrutinee. Only this double-ooo shape
+            // is accepted beyond the usual single ooo, and the outer ooos
+            // must be plain (binders would be ambiguous: which side owns the
+            // unmatched elements around the first hit?).
+            constexpr static bool computeSubseqShape()
+            {
+                if constexpr (sizeof...(Patterns) >= 3 &&
+                              nbOooOrBinderV<Patterns...> == 2)
+                {
+                    using Pats = std::tuple<Patterns...>;
+                    return IsOoo<std::decay_t<
+                               std::tuple_element_t<0, Pats>>>::value &&
+                           IsOoo<std::decay_t<std::tuple_element_t<
+                               sizeof...(Patterns) - 1, Pats>>>::value;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            constexpr static auto isSubseqShape = computeSubseqShape();
+            static_assert(nbOooOrBinder <= 1 || isSubseqShape);
 
         public:
             template <typename PsTuple, typename VsTuple>
@@ -1733,6 +3949,20 @@ namespace matchit
                                                      std::declval<SecondHalfTuple>()));
             };
 
+            template <typename... Values>
+            class AppResultForTupleHelper<2, std::tuple<Values...>>
+            {
+                // subsequence shape (arrays only): the needle patterns see
+                // elements one at a time and the plain ooos bind nothing.
+                using ElemT = std::tuple_element_t<
+                    0, std::tuple<std::remove_reference_t<Values>..., int32_t>>;
+
+            public:
+                using type = decltype(std::tuple_cat(
+                    std::declval<typename PatternTraits<Patterns>::
+                                     template AppResultTuple<ElemT &>>()...));
+            };
+
             template <typename Tuple>
             using AppResultForTuple = typename AppResultForTupleHelper<
                 nbOooOrBinder, decltype(drop<0>(std::declval<Tuple>()))>::type;
@@ -1766,13 +3996,29 @@ namespace matchit
                 using type = AppResultForRangeType<RangeType>;
             };
 
+            // streams buffer every element a non-ooo pattern inspects in the
+            // binding context: one value slot per such pattern, plus whatever
+            // the element patterns themselves materialize.
+            template <typename Stream>
+            class AppResultHelper<Stream, std::enable_if_t<isStreamedV<Stream>>>
+            {
+                using Elem = typename std::decay_t<Stream>::value_type;
+
+            public:
+                using type = decltype(std::tuple_cat(
+                    std::declval<
+                        RepeatTupleT<Elem, sizeof...(Patterns) - nbOooOrBinder>>(),
+                    std::declval<typename PatternTraits<Patterns>::
+                                     template AppResultTuple<Elem &>>()...));
+            };
+
             template <typename Value>
             using AppResultTuple = typename AppResultHelper<Value>::type;
 
             constexpr static auto nbIdV = (PatternTraits<Patterns>::nbIdV + ... + 0);
 
             template <typename ValueTuple, typename ContextT>
-            constexpr static auto matchPatternImpl(ValueTuple &&valueTuple,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(ValueTuple &&valueTuple,
                                                    Ds<Patterns...> const &dsPat,
                                                    int32_t depth, ContextT &context)
                 -> std::enable_if_t<isTupleLikeV<ValueTuple>, bool>
@@ -1809,12 +4055,16 @@ namespace matchit
                     {
                         if constexpr (isBinder)
                         {
-                            auto const rangeSize = static_cast<long>(valLen - (patLen - 1));
+                            // extent and arity are both compile-time here, so
+                            // the ooo span length is too: the whole split
+                            // unrolls with constant offsets.
+                            constexpr auto rangeSize =
+                                static_cast<long>(valLen - (patLen - 1));
                             context.emplace_back(makeSubrange(&valueTuple[idxOoo],
                                                               &valueTuple[idxOoo] + rangeSize));
                             using type = decltype(makeSubrange(&valueTuple[idxOoo],
                                                                &valueTuple[idxOoo] + rangeSize));
-                            result = result && matchPattern(std::get<type>(context.back()),
+                            result = result && matchPattern(context.template backAs<type>(),
                                                             std::get<idxOoo>(dsPat.patterns()),
                                                             depth, context);
                         }
@@ -1828,16 +4078,38 @@ namespace matchit
                                          std::forward<ValueTuple>(valueTuple),
                                          dsPat.patterns(), depth, context);
                 }
+                else
+                {
+                    static_assert(isArrayV<ValueTuple>,
+                                  "the ds(ooo, needle..., ooo) subsequence "
+                                  "shape needs elements of one type: a range "
+                                  "or an array scrutinee.");
+                    constexpr auto valLen =
+                        std::tuple_size_v<std::decay_t<ValueTuple>>;
+                    constexpr auto runLen = sizeof...(Patterns) - 2;
+                    if constexpr (valLen < runLen)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        // delegate to the range implementation over the
+                        // array's contiguous storage.
+                        return matchPatternImpl(
+                            makeSubrange(&valueTuple[0], &valueTuple[0] + valLen),
+                            dsPat, depth, context);
+                    }
+                }
             }
 
             template <typename ValueRange, typename ContextT>
-            constexpr static auto matchPatternImpl(ValueRange &&valueRange,
+            MATCHIT_HOT constexpr static auto matchPatternImpl(ValueRange &&valueRange,
                                                    Ds<Patterns...> const &dsPat,
                                                    int32_t depth, ContextT &context)
                 -> std::enable_if_t<!isTupleLikeV<ValueRange> && isRangeV<ValueRange>,
                                     bool>
             {
-                static_assert(nbOooOrBinder == 0 || nbOooOrBinder == 1);
+                static_assert(nbOooOrBinder <= 1 || isSubseqShape);
                 constexpr auto nbPat = sizeof...(Patterns);
 
                 if constexpr (nbOooOrBinder == 0)
@@ -1870,7 +4142,7 @@ namespace matchit
                         auto const end = std::next(beginOoo, rangeSize);
                         context.emplace_back(makeSubrange(beginOoo, end));
                         using type = decltype(makeSubrange(beginOoo, end));
-                        result = result && matchPattern(std::get<type>(context.back()),
+                        result = result && matchPattern(context.template backAs<type>(),
                                                         std::get<idxOoo>(dsPat.patterns()),
                                                         depth, context);
                     }
@@ -1879,9 +4151,177 @@ namespace matchit
                     return result && matchPatternRange<idxOoo + 1, patLen - idxOoo - 1>(
                                          beginAfterOoo, dsPat.patterns(), depth, context);
                 }
+                else
+                {
+                    // subsequence search: the first window matching the
+                    // needle wins. Contiguous byte ranges with an all-literal
+                    // needle scan in bulk — memchr skips to each candidate
+                    // first byte and memcmp verifies the run — instead of
+                    // advancing the pattern machinery per element.
+                    constexpr auto runLen = nbPat - 2;
+                    auto const valLen = valueRange.size();
+                    if (valLen < runLen)
+                    {
+                        return false;
+                    }
+                    using Elem = std::decay_t<decltype(*std::begin(valueRange))>;
+                    using NeedlePats =
+                        SubTypesT<1, nbPat - 1, std::tuple<Patterns...>>;
+                    if constexpr (hasContiguousDataV<ValueRange> &&
+                                  sizeof(Elem) == 1 && bitwiseEqualityV<Elem> &&
+                                  AllIntegralElems<NeedlePats>::value)
+                    {
+                        std::array<Elem, runLen> needle{};
+                        auto const representable = std::apply(
+                            [&needle](auto const &...lits)
+                            {
+                                std::size_t i = 0;
+                                static_cast<void>(i);
+                                // a literal outside Elem's range can equal no
+                                // element: the arm cannot match.
+                                return (((needle[i++] = static_cast<Elem>(lits)),
+                                         static_cast<Elem>(lits) == lits) &&
+                                        ...);
+                            },
+                            subtuple<1, nbPat - 1>(dsPat.patterns()));
+                        if (!representable)
+                        {
+                            return false;
+                        }
+                        auto const *cursor = std::data(valueRange);
+                        auto const *lastStart = cursor + (valLen - runLen);
+                        while (cursor <= lastStart)
+                        {
+                            auto const *hit =
+                                static_cast<Elem const *>(std::memchr(
+                                    cursor,
+                                    static_cast<int32_t>(
+                                        static_cast<unsigned char>(needle[0])),
+                                    static_cast<std::size_t>(lastStart - cursor) +
+                                        1));
+                            if (hit == nullptr)
+                            {
+                                return false;
+                            }
+                            if (runLen == 1 ||
+                                std::memcmp(hit, needle.data(), runLen) == 0)
+                            {
+                                return true;
+                            }
+                            cursor = hit + 1;
+                        }
+                        return false;
+                    }
+                    else
+                    {
+                        auto iter = std::begin(valueRange);
+                        for (std::size_t start = 0; start + runLen <= valLen;
+                             ++start, ++iter)
+                        {
+                            auto const marked = context.mark();
+                            if (matchPatternRange<1, runLen>(
+                                    iter, dsPat.patterns(), depth, context))
+                            {
+                                return true;
+                            }
+                            // a partially matched window may have confirmed
+                            // needle ids and materialized intermediates;
+                            // drop both before sliding — the context is
+                            // sized for a single pass over the needle.
+                            std::apply(
+                                [depth](auto const &...ps)
+                                {
+                                    (processId(ps, depth + 1,
+                                               IdProcess::kCANCEL),
+                                     ...);
+                                },
+                                dsPat.patterns());
+                            context.release(marked);
+                        }
+                        return false;
+                    }
+                }
+            }
+
+            template <typename Stream, typename ContextT>
+            MATCHIT_HOT static auto matchPatternImpl(Stream &&stream,
+                                         Ds<Patterns...> const &dsPat,
+                                         int32_t depth, ContextT &context)
+                -> std::enable_if_t<isStreamedV<Stream>, bool>
+            {
+                static_assert(nbOooOrBinder == 0 || nbOooOrBinder == 1);
+                constexpr auto patLen = sizeof...(Patterns);
+                using Elem = typename std::decay_t<Stream>::value_type;
+
+                if constexpr (nbOooOrBinder == 0)
+                {
+                    // exact arity: k elements must match and the stream must
+                    // then be exhausted, mirroring the sized-range check.
+                    return matchStreamPrefix<0, patLen>(stream, dsPat.patterns(),
+                                                        depth, context) &&
+                           stream.done();
+                }
+                else
+                {
+                    constexpr auto idxOoo =
+                        findOooIdx<typename Ds<Patterns...>::Type>();
+                    static_assert(
+                        !isOooBinderV<
+                            std::tuple_element_t<idxOoo, std::tuple<Patterns...>>>,
+                        "an ooo binder needs a multi-pass range: a stream "
+                        "cannot be re-read into a subrange.");
+                    if (!matchStreamPrefix<0, idxOoo>(stream, dsPat.patterns(),
+                                                      depth, context))
+                    {
+                        return false;
+                    }
+                    // drain the rest through a ring of the last m elements:
+                    // the patterns after ooo only ever need that many, so the
+                    // skipped middle is never buffered.
+                    constexpr auto m = patLen - idxOoo - 1;
+                    std::array<std::optional<Elem>, m == 0 ? 1 : m> ring{};
+                    std::size_t count = 0;
+                    while (!stream.done())
+                    {
+                        if constexpr (m > 0)
+                        {
+                            ring[count % m] = stream.next();
+                        }
+                        else
+                        {
+                            static_cast<void>(stream.next());
+                        }
+                        ++count;
+                    }
+                    if (count < m)
+                    {
+                        return false;
+                    }
+                    if constexpr (m > 0)
+                    {
+                        auto const step = [&](auto const &pattern,
+                                              std::size_t const i)
+                        {
+                            context.emplace_back(std::move(*ring[(count + i) % m]));
+                            return matchPattern(context.template backAs<Elem>(),
+                                                pattern, depth + 1, context);
+                        };
+                        return std::apply(
+                            [&](auto const &...patterns)
+                            {
+                                std::size_t i = 0;
+                                return (step(patterns, i++) && ...);
+                            },
+                            subtuple<idxOoo + 1, patLen>(dsPat.patterns()));
+                    }
+                    else
+                    {
+                        return true;
+                    }
+                }
             }
 
-            constexpr static void processIdImpl(Ds<Patterns...> const &dsPat,
+            MATCHIT_HOT constexpr static void processIdImpl(Ds<Patterns...> const &dsPat,
                                                 int32_t depth, IdProcess idProcess)
             {
                 return std::apply(
@@ -1936,22 +4376,70 @@ namespace matchit
             using AppResultTuple =
                 typename PatternTraits<Pattern>::template AppResultTuple<Value>;
 
+            constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
+
             template <typename Value, typename ContextT>
-            constexpr static auto
+            MATCHIT_HOT constexpr static auto
             matchPatternImpl(Value &&value, PostCheck<Pattern, Pred> const &postCheck,
                              int32_t depth, ContextT &context)
             {
-                return matchPattern(std::forward<Value>(value), postCheck.pattern(),
-                                    depth + 1, context) &&
+                // The guard runs on tentative bindings: ids bound by the
+                // structural impl are readable before any confirm walk, so
+                // the inner pattern is matched without its own
+                // confirm/cancel pass and the enclosing matchPattern issues
+                // the one walk for the whole arm afterwards. A failing
+                // guard — the common case for filtering guards — thus costs
+                // a single cancel walk instead of a confirm pass over the
+                // freshly bound ids followed by the cancel.
+                return PatternTraits<Pattern>::matchPatternImpl(
+                           std::forward<Value>(value), postCheck.pattern(),
+                           depth + 1, context) &&
                        postCheck.check();
             }
-            constexpr static void processIdImpl(PostCheck<Pattern, Pred> const &postCheck,
+            MATCHIT_HOT constexpr static void processIdImpl(PostCheck<Pattern, Pred> const &postCheck,
                                                 int32_t depth, IdProcess idProcess)
             {
+                // matchPatternImpl skipped the inner level's own confirm, so
+                // replay it here on success to keep the stepwise depth
+                // protocol the id blocks assert; a cancel resets every
+                // deeper level in one walk and needs no replay.
+                if (idProcess == IdProcess::kCONFIRM)
+                {
+                    processId(postCheck.pattern(), depth + 1, idProcess);
+                }
                 processId(postCheck.pattern(), depth, idProcess);
             }
         };
 
+        template <typename Pattern, bool expected>
+        class PatternTraits<Expected<Pattern, expected>>
+        {
+        public:
+            template <typename Value>
+            using AppResultTuple =
+                typename PatternTraits<Pattern>::template AppResultTuple<Value>;
+
+            constexpr static auto nbIdV = PatternTraits<Pattern>::nbIdV;
+
+            template <typename Value, typename ContextT>
+            constexpr static bool
+            matchPatternImpl(Value &&value, Expected<Pattern, expected> const &e,
+                             int32_t depth, ContextT &context)
+            {
+                // same depth: the annotation is invisible to id bookkeeping.
+                return MATCHIT_EXPECT(
+                    matchPattern(std::forward<Value>(value), e.pattern(), depth,
+                                 context),
+                    expected);
+            }
+            constexpr static void
+            processIdImpl(Expected<Pattern, expected> const &e, int32_t depth,
+                          IdProcess idProcess)
+            {
+                processId(e.pattern(), depth, idProcess);
+            }
+        };
+
         static_assert(
             std::is_same_v<PatternTraits<Wildcard>::template AppResultTuple<int32_t>,
                            std::tuple<>>);
@@ -1963,10 +4451,24 @@ namespace matchit
         // static_assert(std::is_same_v<PatternTraits<App<decltype(x), Wildcard>>::
         //                                  template AppResultTuple<int32_t>,
         //                              std::tuple<>>);
+        // pure tests and a lone Id consume the projection result without a
+        // context slot; a composite that can reference into the result keeps
+        // one.
         static_assert(
             std::is_same_v<PatternTraits<App<decltype(x), Wildcard>>::
                                template AppResultTuple<std::array<int32_t, 3>>,
-                           std::tuple<std::array<int32_t, 3>>>);
+                           std::tuple<>>);
+        static_assert(
+            std::is_same_v<PatternTraits<App<decltype(x),
+                                             Id<std::array<int32_t, 3>>>>::
+                               template AppResultTuple<std::array<int32_t, 3>>,
+                           std::tuple<>>);
+        static_assert(
+            std::is_same_v<
+                PatternTraits<App<decltype(x),
+                                  And<Id<std::array<int32_t, 3>>, Wildcard>>>::
+                    template AppResultTuple<std::array<int32_t, 3>>,
+                std::tuple<std::array<int32_t, 3>>>);
         // static_assert(std::is_same_v<PatternTraits<And<App<decltype(x), Wildcard>>>::
         //                                  template AppResultTuple<int32_t>,
         //                              std::tuple<>>);
@@ -1977,200 +4479,2656 @@ namespace matchit
         static_assert(PatternTraits<Or<Id<int32_t>, Id<float>>>::nbIdV == 2);
         static_assert(PatternTraits<Or<Wildcard, float>>::nbIdV == 0);
 
-        template <typename Value, typename... PatternPairs>
-        constexpr auto matchPatterns(Value &&value, PatternPairs const &...patterns)
+        // Fast dispatch for arm sets made of plain integral literals (plus the
+        // wildcard). Such arms bind no Ids and capture nothing into the
+        // context, so the whole match lowers to a flat run of comparisons
+        // without per-arm context construction or processId bookkeeping.
+        // Arm values live in the pattern objects at runtime, so the jump
+        // table itself is emitted by the optimizer, the same way it lowers a
+        // hand-written switch over the same comparisons.
+        template <typename T>
+        struct IsMeet : std::false_type
         {
-            using RetType = typename PatternPairsRetType<PatternPairs...>::RetType;
-            using TypeTuple = decltype(std::tuple_cat(
-                std::declval<typename PatternTraits<typename PatternPairs::PatternT>::
-                                 template AppResultTuple<Value>>()...));
+        };
 
-            // expression, has return value.
-            if constexpr (!std::is_same_v<RetType, void>)
+        template <typename Pred>
+        struct IsMeet<Meet<Pred>> : std::true_type
+        {
+        };
+
+        template <typename Value, typename Pattern>
+        constexpr auto isEqDispatchArmV =
+            (std::is_same_v<std::decay_t<Value>, Pattern> &&
+             (std::is_integral_v<Pattern> || std::is_enum_v<Pattern>)) ||
+            (IsMeet<Pattern>::value &&
+             std::is_invocable_r_v<bool, Pattern const &, Value const &>) ||
+            std::is_same_v<Pattern, Wildcard>;
+
+        // likely()/unlikely() is transparent to the flat dispatch: an
+        // annotated literal arm keeps the fast path and carries its hint
+        // into the flattened comparison.
+        template <typename Value, typename Pattern, bool expected>
+        constexpr auto isEqDispatchArmV<Value, Expected<Pattern, expected>> =
+            isEqDispatchArmV<Value, Pattern>;
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto useEqDispatchV =
+            (isEqDispatchArmV<Value, typename PatternPairs::PatternT> && ...);
+
+        template <typename Value, typename Pattern>
+        constexpr bool eqDispatchPattern(Value const &value, Pattern const &p)
+        {
+            if constexpr (std::is_same_v<Pattern, Wildcard>)
             {
-                constexpr auto const func =
-                    [](auto const &pattern, auto &&value, RetType &result) constexpr->bool
-                {
-                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
-                    if (pattern.matchValue(std::forward<Value>(value), context))
-                    {
-                        result = pattern.execute();
-                        processId(pattern, 0, IdProcess::kCANCEL);
-                        return true;
-                    }
-                    return false;
-                };
-                RetType result{};
-                bool const matched = (func(patterns, value, result) || ...);
-                if (!matched)
-                {
-                    throw std::logic_error{"Error: no patterns got matched!"};
-                }
-                static_cast<void>(matched);
-                return result;
+                static_cast<void>(value);
+                static_cast<void>(p);
+                return true;
+            }
+            else if constexpr (IsMeet<Pattern>::value)
+            {
+                return static_cast<bool>(p(value));
             }
             else
-            // statement, no return value, mismatching all patterns is not an error.
             {
-                auto const func = [](auto const &pattern, auto &&value) -> bool
-                {
-                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
-                    if (pattern.matchValue(std::forward<Value>(value), context))
-                    {
-                        pattern.execute();
-                        processId(pattern, 0, IdProcess::kCANCEL);
-                        return true;
-                    }
-                    return false;
-                };
-                bool const matched = (func(patterns, value) || ...);
-                static_cast<void>(matched);
+                return p == value;
             }
         }
 
-    } // namespace impl
+        template <typename Value, typename Pattern, bool expected>
+        constexpr bool eqDispatchPattern(Value const &value,
+                                         Expected<Pattern, expected> const &p)
+        {
+            return MATCHIT_EXPECT(eqDispatchPattern(value, p.pattern()),
+                                  expected);
+        }
 
-    // export symbols
-    using impl::_;
-    using impl::and_;
-    using impl::app;
-    using impl::ds;
-    using impl::Id;
-    using impl::meet;
-    using impl::not_;
-    using impl::ooo;
-    using impl::or_;
-    using impl::pattern;
-    using impl::Subrange;
-    using impl::SubrangeT;
-    using impl::when;
-} // namespace matchit
+        template <typename Value, typename PatternPair>
+        constexpr bool eqDispatchMatch(Value const &value, PatternPair const &arm)
+        {
+            return eqDispatchPattern(value, arm.pattern());
+        }
 
-#endif // MATCHIT_PATTERNS_H
-#ifndef MATCHIT_UTILITY_H
-#define MATCHIT_UTILITY_H
+        // Fast dispatch for arm sets made of string literals — char const *
+        // and std::string_view arms, in any mix. The scrutinee is converted
+        // to a string_view once (a single strlen for raw char pointers),
+        // then every arm compares length-first before touching the
+        // characters, so arms of the wrong length cost one integer compare
+        // instead of a character-wise strcmp. No arm allocates: string_view
+        // arms and the converted scrutinee are views all the way through.
+        template <typename Value, typename Pattern>
+        constexpr auto isStrEqDispatchArmV =
+            ((std::is_same_v<Pattern, char const *> ||
+              std::is_same_v<Pattern, std::string_view>) &&
+             std::is_convertible_v<Value, std::string_view>) ||
+            std::is_same_v<Pattern, Wildcard>;
 
-#include <any>
-#include <variant>
+        template <typename Value, typename... PatternPairs>
+        constexpr auto useStrEqDispatchV =
+            (isStrEqDispatchArmV<Value, typename PatternPairs::PatternT> && ...);
 
-namespace matchit
+        template <typename PatternPair>
+        constexpr bool strEqDispatchMatch(std::string_view const value,
+                                          PatternPair const &arm)
+        {
+            if constexpr (std::is_same_v<typename PatternPair::PatternT, Wildcard>)
+            {
+                static_cast<void>(value);
+                return true;
+            }
+            else
+            {
+                return std::string_view{arm.pattern()} == value;
+            }
+        }
+
+        // Literal destructuring arms: a ds(...) whose elements are all
+        // integral literals or wildcards over a tuple-like scrutinee needs no
+        // binding machinery either, so such arm sets join the flat dispatch
+        // and compile to fused element-wise compares. This is the
+        // decision-tree shape a pattern-matrix compiler would emit for
+        // literal rows; the sharing of column tests between arms is left to
+        // the optimizer, which sees them as plain comparisons of the same
+        // loads.
+        template <typename V, typename P>
+        constexpr bool eqDispatchElem(V const &v, P const &p)
+        {
+            if constexpr (std::is_same_v<P, Wildcard>)
+            {
+                static_cast<void>(v);
+                return true;
+            }
+            else
+            {
+                return p == v;
+            }
+        }
+
+        template <typename Value, typename Pattern, typename = std::void_t<>>
+        struct IsFlatDsArm : std::false_type
+        {
+        };
+
+        template <typename Value, typename... Ps>
+        struct IsFlatDsArm<
+            Value, Ds<Ps...>,
+            std::enable_if_t<std::tuple_size_v<std::decay_t<Value>> ==
+                                 sizeof...(Ps),
+                             std::void_t<>>>
+        {
+            // element types come from get<I> rather than std::tuple_element:
+            // tuple-like protocols in this library only require tuple_size
+            // plus an ADL get.
+            template <std::size_t... I>
+            constexpr static bool compute(std::index_sequence<I...>)
+            {
+                using std::get;
+                return (isEqDispatchArmV<
+                            std::decay_t<decltype(get<I>(
+                                std::declval<std::decay_t<Value> const &>()))>,
+                            std::tuple_element_t<I, std::tuple<Ps...>>> &&
+                        ...);
+            }
+            constexpr static bool value =
+                compute(std::make_index_sequence<sizeof...(Ps)>{});
+        };
+
+        template <typename Value, typename Pattern>
+        constexpr auto isDsEqDispatchArmV =
+            IsFlatDsArm<Value, Pattern>::value ||
+            std::is_same_v<Pattern, Wildcard>;
+
+        // Value-independent arm shape check. It runs first so that the
+        // tuple-like probe below is only ever instantiated for arm sets that
+        // can actually take this path; scrutinee types unrelated to literal
+        // destructuring never have their tuple-likeness inspected here.
+        template <typename Pattern>
+        struct IsLiteralDs : std::false_type
+        {
+        };
+
+        template <typename... Ps>
+        struct IsLiteralDs<Ds<Ps...>>
+        {
+            constexpr static bool value =
+                ((std::is_integral_v<Ps> || std::is_same_v<Ps, Wildcard>)&&...);
+        };
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto computeUseDsEqDispatch()
+        {
+            if constexpr (((IsLiteralDs<typename PatternPairs::PatternT>::value ||
+                            std::is_same_v<typename PatternPairs::PatternT,
+                                           Wildcard>)&&...) &&
+                          (IsLiteralDs<typename PatternPairs::PatternT>::value ||
+                           ...))
+            {
+                if constexpr (isTupleLikeV<Value>)
+                {
+                    return (isDsEqDispatchArmV<
+                                Value, typename PatternPairs::PatternT> &&
+                            ...);
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        template <typename Value, typename... PatternPairs>
+        constexpr auto useDsEqDispatchV =
+            computeUseDsEqDispatch<Value, PatternPairs...>();
+
+        // Cost-ordered column testing for the flat ds path. Literal values
+        // are runtime data, but how discriminating a column *can* be is
+        // visible in the types: a column where many arms hold a Wildcard
+        // rejects nothing in those arms. Columns are therefore tested in
+        // ascending order of wildcard count across the arm set (stable, so
+        // equal columns keep source order) — in a (state, event) dispatch
+        // where most arms wildcard the state, the event column is compared
+        // first and rejects most arms on the first compare.
+        template <typename Value, typename... PatternPairs>
+        struct DsColumnOrder
+        {
+            constexpr static auto patLen =
+                std::tuple_size_v<std::decay_t<Value>>;
+
+            template <typename... Ps>
+            constexpr static void countDs(std::array<std::size_t, patLen> &wildcards,
+                                          Ds<Ps...> const *)
+            {
+                if constexpr (sizeof...(Ps) > 0)
+                {
+                    constexpr bool isWild[] = {std::is_same_v<Ps, Wildcard>...};
+                    for (std::size_t i = 0; i < patLen; ++i)
+                    {
+                        wildcards[i] += isWild[i] ? 1U : 0U;
+                    }
+                }
+                else
+                {
+                    static_cast<void>(wildcards);
+                }
+            }
+
+            template <typename PatternPair>
+            constexpr static void countArm(std::array<std::size_t, patLen> &wildcards)
+            {
+                using Pattern = typename PatternPair::PatternT;
+                if constexpr (!std::is_same_v<Pattern, Wildcard>)
+                {
+                    countDs(wildcards, static_cast<Pattern const *>(nullptr));
+                }
+            }
+
+            constexpr static std::array<std::size_t, patLen> compute()
+            {
+                std::array<std::size_t, patLen> wildcards{};
+                (countArm<PatternPairs>(wildcards), ...);
+                std::array<std::size_t, patLen> order{};
+                for (std::size_t i = 0; i < patLen; ++i)
+                {
+                    order[i] = i;
+                }
+                // stable insertion sort by ascending wildcard count.
+                for (std::size_t i = 1; i < patLen; ++i)
+                {
+                    auto const col = order[i];
+                    std::size_t j = i;
+                    while (j > 0 && wildcards[order[j - 1]] > wildcards[col])
+                    {
+                        order[j] = order[j - 1];
+                        --j;
+                    }
+                    order[j] = col;
+                }
+                return order;
+            }
+
+            constexpr static auto value = compute();
+
+            template <std::size_t... I>
+            constexpr static auto toSeq(std::index_sequence<I...>)
+                -> std::index_sequence<value[I]...>;
+
+            using seq =
+                decltype(toSeq(std::make_index_sequence<patLen>{}));
+        };
+
+        template <typename Value, typename DsPat, std::size_t... I>
+        constexpr bool dsEqDispatchMatchImpl(Value const &value,
+                                             DsPat const &dsPat,
+                                             std::index_sequence<I...>)
+        {
+            using std::get;
+            return (eqDispatchElem(get<I>(value), get<I>(dsPat.patterns())) &&
+                    ...);
+        }
+
+        template <typename Value, typename PatternPair, typename ColumnSeq>
+        constexpr bool dsEqDispatchMatch(Value const &value,
+                                         PatternPair const &arm, ColumnSeq)
+        {
+            using Pattern = typename PatternPair::PatternT;
+            if constexpr (std::is_same_v<Pattern, Wildcard>)
+            {
+                static_cast<void>(value);
+                return true;
+            }
+            else
+            {
+                return dsEqDispatchMatchImpl(value, arm.pattern(), ColumnSeq{});
+            }
+        }
+
+        template <typename T>
+        class AsPointer;
+
+        // Index-based pre-dispatch for as<T> arms over a std::variant. Every
+        // such arm knows the alternative index it can possibly match at
+        // compile time, so a mismatching arm is rejected with one integer
+        // compare against variant::index() instead of running the whole
+        // get_if-based pattern machinery. Arms whose index matches still go
+        // through the full match to run inner patterns and bindings.
+        template <typename Pattern>
+        struct AsDispatchTarget
+        {
+            using type = void;
+        };
+
+        template <typename T, typename P>
+        struct AsDispatchTarget<App<AsPointer<T>, P>>
+        {
+            using type = T;
+        };
+
+        template <typename T, typename P>
+        struct AsDispatchTarget<App<AsPointer<T> const &, P>>
+        {
+            using type = T;
+        };
+
+        template <typename P, typename Pred>
+        struct AsDispatchTarget<PostCheck<P, Pred>> : AsDispatchTarget<P>
+        {
+        };
+
+        template <typename P, bool expected>
+        struct AsDispatchTarget<Expected<P, expected>> : AsDispatchTarget<P>
+        {
+        };
+
+        template <typename Pattern>
+        using AsDispatchTargetT = typename AsDispatchTarget<Pattern>::type;
+
+        template <typename T>
+        struct IsVariant : std::false_type
+        {
+        };
+
+        template <typename... Alts>
+        struct IsVariant<std::variant<Alts...>> : std::true_type
+        {
+        };
+
+        template <typename T, typename Variant>
+        struct VariantAltIndex;
+
+        template <typename T, typename... Alts>
+        struct VariantAltIndex<T, std::variant<Alts...>>
+        {
+            constexpr static std::size_t compute()
+            {
+                constexpr bool found[] = {std::is_same_v<T, Alts>...};
+                std::size_t index = sizeof...(Alts);
+                for (std::size_t i = 0; i < sizeof...(Alts); ++i)
+                {
+                    if (found[i])
+                    {
+                        index = i;
+                        break;
+                    }
+                }
+                return index;
+            }
+            constexpr static auto value = compute();
+        };
+        static_assert(VariantAltIndex<bool, std::variant<int32_t, bool>>::value ==
+                      1);
+
+        // Fixed-arity ds arms over a sized range can only match one length,
+        // so comparing size() against the arity rejects wrong-length arms
+        // before any element is visited. Several ds arms of different
+        // arities thus degrade to a run of integer compares — effectively a
+        // length dispatch over the arm list.
+        template <typename Pattern>
+        struct DsArity
+        {
+            constexpr static bool fixed = false;
+            constexpr static std::size_t value = 0;
+        };
+
+        template <typename... Ps>
+        struct DsArity<Ds<Ps...>>
+        {
+            constexpr static bool fixed = nbOooOrBinderV<Ps...> == 0;
+            constexpr static std::size_t value = sizeof...(Ps);
+        };
+
+        template <typename P, typename Pred>
+        struct DsArity<PostCheck<P, Pred>> : DsArity<P>
+        {
+        };
+
+        template <typename P, bool expected>
+        struct DsArity<Expected<P, expected>> : DsArity<P>
+        {
+        };
+
+        template <typename Value, typename PatternPair>
+        MATCHIT_HOT constexpr bool armPossiblyMatches(Value const &value,
+                                                      PatternPair const &)
+        {
+            using Target = AsDispatchTargetT<typename PatternPair::PatternT>;
+            // as<T> arms over std::any: compare the stored type_info against
+            // typeid(T) directly. This is the same test any_cast performs,
+            // but done once up front it spares mismatching arms the whole
+            // any_cast call and the binding context that surrounds it.
+            if constexpr (!std::is_void_v<Target> &&
+                          std::is_same_v<std::decay_t<Value>, std::any>)
+            {
+                return value.type() == typeid(Target);
+            }
+            else if constexpr (!std::is_void_v<Target> &&
+                          IsVariant<std::decay_t<Value>>::value)
+            {
+                constexpr auto altIndex =
+                    VariantAltIndex<Target, std::decay_t<Value>>::value;
+                if constexpr (altIndex !=
+                              std::variant_size_v<std::decay_t<Value>>)
+                {
+                    return value.index() == altIndex;
+                }
+                else
+                {
+                    return true;
+                }
+            }
+            // the tuple-like/range probe is nested so it is only
+            // instantiated for fixed-arity ds arms: naming isTupleLikeV
+            // here for every arm would cache IsTupleLike<Value> for
+            // scrutinees whose std::tuple_size specialization appears
+            // later in the translation unit and make their ds matches
+            // ill-formed.
+            else if constexpr (DsArity<typename PatternPair::PatternT>::fixed)
+            {
+                if constexpr (!isTupleLikeV<Value> && isRangeV<Value>)
+                {
+                    return value.size() ==
+                           DsArity<typename PatternPair::PatternT>::value;
+                }
+                else
+                {
+                    static_cast<void>(value);
+                    return true;
+                }
+            }
+            else
+            {
+                static_cast<void>(value);
+                return true;
+            }
+        }
+
+        // Miss path for matchExhaustive: the caller declared the arms cover
+        // every value, so tell the optimizer the tail cannot run.
+        [[noreturn]] inline void unreachableMiss()
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            __assume(false);
+#else
+            __builtin_unreachable();
+#endif
+        }
+
+        template <typename T>
+        struct IsId : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct IsId<Id<T>> : std::true_type
+        {
+        };
+
+        template <typename Pattern>
+        constexpr auto isCatchAllPatternV =
+            std::is_same_v<Pattern, Wildcard> || IsId<Pattern>::value;
+
+        // Static coverage check backing matchExhaustive. Only variant
+        // scrutinees can be checked structurally: every alternative must be
+        // targeted by an as<Alt> arm, unless a wildcard/Id arm catches the
+        // rest. Guards cannot be seen through, so arms carrying `when` still
+        // count as covering their alternative — the declaration remains the
+        // caller's responsibility there.
+        template <typename Value, typename... PatternPairs>
+        struct CoversAllAlternatives : std::true_type
+        {
+        };
+
+        template <typename... Alts, typename... PatternPairs>
+        struct CoversAllAlternatives<std::variant<Alts...>, PatternPairs...>
+        {
+            constexpr static bool hasCatchAll =
+                (isCatchAllPatternV<typename PatternPairs::PatternT> || ...);
+            template <typename Alt>
+            constexpr static bool altCovered =
+                (std::is_same_v<Alt, AsDispatchTargetT<
+                                         typename PatternPairs::PatternT>> ||
+                 ...);
+            constexpr static bool value = hasCatchAll || (altCovered<Alts> && ...);
+        };
+
+// Profile-mode arm wrappers: MATCHIT_PROFILED_TRY counts a try (and a
+// hit on success) for the next arm index, MATCHIT_PROFILED_MISS a
+// fall-through. With profiling off both expand to the bare expression.
+// Used by runFlatArms and matchPatterns below; undefined after them.
+#if MATCHIT_PROFILE
+#define MATCHIT_PROFILED_TRY(expr) \
+    profiledArmTry(profileStats, profileArm, [&] { return (expr); })
+#define MATCHIT_PROFILED_MISS() profiledMiss(profileStats)
+#else
+#define MATCHIT_PROFILED_TRY(expr) (expr)
+#define MATCHIT_PROFILED_MISS() static_cast<void>(0)
+#endif // MATCHIT_PROFILE
+
+// Trace-mode arm wrapper: MATCHIT_TRACED_TRY fires the arm-selected
+// event when its arm matches. Nested inside MATCHIT_PROFILED_TRY so
+// both modes see the same arm indices.
+#if MATCHIT_TRACE
+#define MATCHIT_TRACED_TRY(expr) \
+    tracedArmTry(traceSite, traceArm, [&] { return (expr); })
+#else
+#define MATCHIT_TRACED_TRY(expr) (expr)
+#endif // MATCHIT_TRACE
+
+        // Run a flattened arm sequence where matching an arm needs no binding
+        // context and no processId bookkeeping.
+        template <typename RetType, bool exhaustive, typename ArmMatch,
+                  typename... PatternPairs>
+        constexpr decltype(auto) runFlatArms(ArmMatch const &armMatch,
+                                             PatternPairs const &...patterns)
+        {
+#if MATCHIT_PROFILE
+            // tries/hits/misses for flat-dispatch sites; the invocation
+            // itself is counted by matchPatterns before dispatching here.
+            SiteStats *profileStats = nullptr;
+            std::size_t profileArm = 0;
+#if defined(__GNUC__) || defined(__clang__)
+            if (!__builtin_is_constant_evaluated())
+#endif
+            {
+                profileStats = &siteStatsFor<PatternPairs...>();
+            }
+#endif // MATCHIT_PROFILE
+#if MATCHIT_TRACE
+            // arm-selected events for flat-dispatch sites; match entry is
+            // traced by matchPatterns before dispatching here.
+            char const *traceSite = nullptr;
+            std::size_t traceArm = 0;
+#if defined(__GNUC__) || defined(__clang__)
+            if (!__builtin_is_constant_evaluated())
+#endif
+            {
+                traceSite = traceSiteName<PatternPairs...>();
+            }
+#endif // MATCHIT_TRACE
+            if constexpr (std::is_lvalue_reference_v<RetType>)
+            {
+                std::remove_reference_t<RetType> *result = nullptr;
+                bool const matched =
+                    ((MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(armMatch(patterns)))
+                          ? (result = std::addressof(patterns.execute()), true)
+                          : false) ||
+                     ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                    else
+                    {
+                        throwNoMatch();
+                    }
+                }
+                return static_cast<RetType>(*result);
+            }
+            else if constexpr (!std::is_same_v<RetType, void>)
+            {
+                RetType result{};
+                bool const matched =
+                    ((MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(armMatch(patterns)))
+                          ? (result = patterns.execute(), true)
+                          : false) ||
+                     ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                    else
+                    {
+                        throwNoMatch();
+                    }
+                }
+                return result;
+            }
+            else
+            {
+                bool const matched =
+                    ((MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(armMatch(patterns)))
+                          ? (patterns.execute(), true)
+                          : false) ||
+                     ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                }
+                static_cast<void>(matched);
+            }
+        }
+
+        // Cross-arm hoisting of a shared App projection. Arms routinely
+        // apply the same unary — every some(p) arm casts and dereferences,
+        // hand-written arms repeat app(&T::size, p) — and each arm re-invokes
+        // it on the same scrutinee. When every arm is app(u, ...) with one
+        // unary (a trailing wildcard fallback is allowed), the projection is
+        // computed once and the inner patterns are matched against that.
+        template <typename Pattern>
+        struct AppUnaryType
+        {
+            using type = void;
+        };
+
+        template <typename Unary, typename Pattern>
+        struct AppUnaryType<App<Unary, Pattern>>
+        {
+            using type = Unary;
+        };
+
+        template <typename T, typename = std::void_t<>>
+        struct IsEqComparable : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct IsEqComparable<T, std::void_t<decltype(std::declval<T const &>() ==
+                                                      std::declval<T const &>())>>
+            : std::true_type
+        {
+        };
+
+        template <typename... PatternPairs>
+        constexpr bool computeUseAppHoist()
+        {
+            if constexpr (sizeof...(PatternPairs) < 2)
+            {
+                return false;
+            }
+            else
+            {
+                using First = std::tuple_element_t<
+                    0, std::tuple<typename PatternPairs::PatternT...>>;
+                using U = typename AppUnaryType<First>::type;
+                if constexpr (std::is_same_v<U, void>)
+                {
+                    return false;
+                }
+                // an empty unary is structurally identical across arms by
+                // type alone; stateful ones (member / function pointers) need
+                // an equality check of the instances at match time.
+                else if constexpr (!std::is_empty_v<U> &&
+                                   !IsEqComparable<U>::value)
+                {
+                    return false;
+                }
+                else
+                {
+                    constexpr bool allFit =
+                        ((std::is_same_v<typename PatternPairs::PatternT,
+                                         Wildcard> ||
+                          std::is_same_v<typename AppUnaryType<
+                                             typename PatternPairs::PatternT>::type,
+                                         U>) &&
+                         ...);
+                    constexpr auto nbApps =
+                        ((std::is_same_v<typename AppUnaryType<
+                                             typename PatternPairs::PatternT>::type,
+                                         U>
+                              ? 1
+                              : 0) +
+                         ...);
+                    return allFit && nbApps >= 2;
+                }
+            }
+        }
+
+        template <typename... PatternPairs>
+        constexpr auto useAppHoistV = computeUseAppHoist<PatternPairs...>();
+
+        template <typename First, typename... Rest>
+        constexpr auto const &firstAppUnary(First const &first, Rest const &...)
+        {
+            return first.pattern().unary();
+        }
+
+        template <typename Unary, typename... PatternPairs>
+        constexpr bool hoistUnariesAgree(Unary const &first,
+                                         PatternPairs const &...patterns)
+        {
+            if constexpr (std::is_empty_v<Unary>)
+            {
+                static_cast<void>(first);
+                return true;
+            }
+            else
+            {
+                auto const agree = [&first](auto const &arm)
+                {
+                    using Pattern =
+                        typename std::decay_t<decltype(arm)>::PatternT;
+                    if constexpr (std::is_same_v<
+                                      typename AppUnaryType<Pattern>::type,
+                                      Unary>)
+                    {
+                        return arm.pattern().unary() == first;
+                    }
+                    else
+                    {
+                        return true;
+                    }
+                };
+                return (agree(patterns) && ...);
+            }
+        }
+
+        template <typename PatternPair>
+        constexpr decltype(auto) hoistAppArm(PatternPair const &arm)
+        {
+            if constexpr (std::is_same_v<typename AppUnaryType<
+                                             typename PatternPair::PatternT>::type,
+                                         void>)
+            {
+                return (arm);
+            }
+            else
+            {
+                return arm.withPattern(arm.pattern().pattern());
+            }
+        }
+
+        // Lazily pick the match result type so the common-type computation
+        // is never instantiated when the caller pinned the type with
+        // match<Ret> (the arms may have no common type at all).
+        template <typename RetOverride, typename... PatternPairs>
+        class RetTypeSelect
+        {
+        public:
+            using type = RetOverride;
+        };
+
+        template <typename... PatternPairs>
+        class RetTypeSelect<Deduce, PatternPairs...>
+        {
+        public:
+            using type = typename PatternPairsRetType<PatternPairs...>::RetType;
+        };
+
+        // MATCHIT_COMPACT machinery: the non-template loop below is the
+        // only code shared match call sites expand to — everything
+        // arm-specific lives behind a type-erased thunk pointer.
+        using CompactArmThunk = bool (*)(void const *arm, void *value,
+                                         void *result);
+
+        inline bool compactArmLoop(CompactArmThunk const *thunks,
+                                   void const *const *arms, std::size_t count,
+                                   void *value, void *result)
+        {
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                if (thunks[i](arms[i], value, result))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Compact body of matchPatterns: each arm becomes a thunk over
+        // erased pointers and a call site shrinks to two constant arrays
+        // plus one compactArmLoop call. Every arm costs an indirect call
+        // and the flat-dispatch fast paths are skipped — peak speed is
+        // the price of the footprint.
+        template <typename RetType, bool exhaustive, typename TypeTuple,
+                  typename Value, typename... PatternPairs>
+        RetType runCompactMatch(Value &&value, PatternPairs const &...patterns)
+        {
+            // one result slot shape per match form: presence flag for
+            // statements, pointer for preserved references, optional
+            // otherwise.
+            using Slot = std::conditional_t<
+                std::is_void_v<RetType>, bool,
+                std::conditional_t<
+                    std::is_lvalue_reference_v<RetType>,
+                    std::remove_reference_t<RetType> *,
+                    std::optional<std::remove_const_t<RetType>>>>;
+            constexpr std::array<CompactArmThunk, sizeof...(PatternPairs)>
+                thunks{{+[](void const *arm, void *v, void *r) -> bool
+                        {
+                            auto const &pattern =
+                                *static_cast<PatternPairs const *>(arm);
+                            auto &valueRef =
+                                *static_cast<std::remove_reference_t<Value> *>(
+                                    v);
+                            if (!armPossiblyMatches(valueRef, pattern))
+                            {
+                                return false;
+                            }
+                            auto context =
+                                typename ContextTrait<TypeTuple>::ContextT{};
+                            if (!pattern.matchValue(
+                                    std::forward<Value>(valueRef), context))
+                            {
+                                return false;
+                            }
+                            auto &slot = *static_cast<Slot *>(r);
+                            if constexpr (std::is_void_v<RetType>)
+                            {
+                                pattern.execute();
+                                slot = true;
+                            }
+                            else if constexpr (
+                                std::is_lvalue_reference_v<RetType>)
+                            {
+                                slot = std::addressof(pattern.execute());
+                            }
+                            else
+                            {
+                                slot.emplace(pattern.execute());
+                            }
+                            processId(pattern, 0, IdProcess::kCANCEL);
+                            return true;
+                        }...}};
+            std::array<void const *, sizeof...(PatternPairs)> const arms{
+                {static_cast<void const *>(std::addressof(patterns))...}};
+            Slot slot{};
+            // the thunk restores the exact (possibly const) value type, so
+            // no write ever goes through the shed qualifier.
+            auto *const valuePtr = const_cast<void *>(
+                static_cast<void const *>(std::addressof(value)));
+            bool const matched =
+                compactArmLoop(thunks.data(), arms.data(),
+                               sizeof...(PatternPairs), valuePtr, &slot);
+            if (!matched)
+            {
+                if constexpr (exhaustive)
+                {
+                    unreachableMiss();
+                }
+                else if constexpr (!std::is_void_v<RetType>)
+                {
+                    throwNoMatch();
+                }
+            }
+            if constexpr (std::is_lvalue_reference_v<RetType>)
+            {
+                return static_cast<RetType>(*slot);
+            }
+            else if constexpr (!std::is_void_v<RetType>)
+            {
+                return static_cast<RetType>(std::move(*slot));
+            }
+        }
+
+        // Compile-time dispatch audit, triggered per site with
+        // match(v).report()(arms...). The call behaves exactly like
+        // match(v)(arms...) but additionally instantiates a [[deprecated]]
+        // stub whose -Wdeprecated-declarations warning spells out, in the
+        // instantiated template arguments, the strategy matchPatterns gives
+        // the site, its arm count, and — when the strategy is the
+        // sequential trial — which properties kept it off the flat fast
+        // paths. Auditing a code base is grepping one build log for
+        // DispatchReport; nothing reaches the binary and the match result
+        // is unchanged. AppHoist is reported as the static selection; the
+        // projection-agreement check it performs at runtime is not visible
+        // here.
+        namespace dispatchreport
+        {
+            struct FlatEqCompare;      // flattened literal/meet comparisons
+            struct FlatStrEqCompare;   // flattened length-first string compares
+            struct FlatDsEqCompare;    // fused element-wise literal ds compares
+            struct AppHoistThenNested; // shared projection hoisted, inner match
+            struct SequentialTrial;    // per-arm context + full pattern walk
+            struct CompactErasedLoop;  // MATCHIT_COMPACT shared type-erased loop
+        } // namespace dispatchreport
+
+        template <typename Strategy, std::size_t armCount,
+                  bool resultTypePinned, bool armsBindIds, bool armsHaveGuards,
+                  bool armShapesNotFlatLiterals>
+        struct DispatchReport
+        {
+            [[deprecated(
+                "matchit dispatch report - strategy, arm count and fallback "
+                "reasons are the template arguments of the DispatchReport "
+                "instantiation above")]] constexpr static void
+            emit()
+            {
+            }
+        };
+
+        template <typename Pattern>
+        struct IsTopLevelGuard : std::false_type
+        {
+        };
+
+        template <typename Pattern, typename Pred>
+        struct IsTopLevelGuard<PostCheck<Pattern, Pred>> : std::true_type
+        {
+        };
+
+        template <typename RetOverride, typename Value,
+                  typename... PatternPairs>
+        constexpr void reportDispatch()
+        {
+            constexpr bool deduced = std::is_same_v<RetOverride, Deduce>;
+            constexpr auto armCount = sizeof...(PatternPairs);
+            if constexpr (useAppHoistV<PatternPairs...>)
+            {
+                DispatchReport<dispatchreport::AppHoistThenNested, armCount,
+                               false, false, false, false>::emit();
+            }
+            else if constexpr (deduced &&
+                               useEqDispatchV<Value, PatternPairs...>)
+            {
+                DispatchReport<dispatchreport::FlatEqCompare, armCount, false,
+                               false, false, false>::emit();
+            }
+            else if constexpr (deduced &&
+                               useStrEqDispatchV<Value, PatternPairs...>)
+            {
+                DispatchReport<dispatchreport::FlatStrEqCompare, armCount,
+                               false, false, false, false>::emit();
+            }
+            else if constexpr (deduced &&
+                               useDsEqDispatchV<Value, PatternPairs...>)
+            {
+                DispatchReport<dispatchreport::FlatDsEqCompare, armCount,
+                               false, false, false, false>::emit();
+            }
+            else
+            {
+#if MATCHIT_COMPACT && !MATCHIT_PROFILE && !MATCHIT_TRACE
+                using Strategy = dispatchreport::CompactErasedLoop;
+#else
+                using Strategy = dispatchreport::SequentialTrial;
+#endif
+                constexpr bool armsBindIds =
+                    ((PatternTraits<typename PatternPairs::PatternT>::nbIdV +
+                      ...) > 0);
+                constexpr bool armsHaveGuards =
+                    (IsTopLevelGuard<typename PatternPairs::PatternT>::value ||
+                     ...);
+                // shape reason is reported only when the arm set would miss
+                // the flat paths even with a deduced result type.
+                constexpr bool armShapesNotFlatLiterals =
+                    !(useEqDispatchV<Value, PatternPairs...> ||
+                      useStrEqDispatchV<Value, PatternPairs...> ||
+                      useDsEqDispatchV<Value, PatternPairs...>);
+                DispatchReport<Strategy, armCount, !deduced, armsBindIds,
+                               armsHaveGuards,
+                               armShapesNotFlatLiterals>::emit();
+            }
+        }
+
+        template <bool exhaustive, typename RetOverride, typename Value,
+                  typename... PatternPairs>
+        MATCHIT_HOT constexpr decltype(auto)
+        matchPatterns(Value &&value, PatternPairs const &...patterns)
+        {
+            static_assert(
+                !exhaustive ||
+                    CoversAllAlternatives<std::decay_t<Value>,
+                                          PatternPairs...>::value,
+                "matchExhaustive over a std::variant must cover every "
+                "alternative or include a catch-all arm!");
+            using RetType =
+                typename RetTypeSelect<RetOverride, PatternPairs...>::type;
+            using TypeTuple = decltype(std::tuple_cat(
+                std::declval<typename PatternTraits<typename PatternPairs::PatternT>::
+                                 template AppResultTuple<Value>>()...));
+
+#if MATCHIT_PROFILE
+            SiteStats *profileStats = nullptr;
+            std::size_t profileArm = 0;
+            static_cast<void>(profileArm);
+#if defined(__GNUC__) || defined(__clang__)
+            if (!__builtin_is_constant_evaluated())
+#endif
+            {
+                profileStats = &siteStatsFor<PatternPairs...>();
+                profileStats->recordInvocation();
+            }
+#endif // MATCHIT_PROFILE
+#if MATCHIT_TRACE
+            char const *traceSite = nullptr;
+            std::size_t traceArm = 0;
+            static_cast<void>(traceArm);
+#if defined(__GNUC__) || defined(__clang__)
+            if (!__builtin_is_constant_evaluated())
+#endif
+            {
+                traceSite = traceSiteName<PatternPairs...>();
+                traceMatchEnter(traceSite, sizeof...(PatternPairs));
+            }
+#endif // MATCHIT_TRACE
+
+// profiling and tracing route every site through the standard arm loops
+// so per-arm counters and arm-selected events stay exact; the erased
+// compact loop is skipped.
+#if MATCHIT_COMPACT && !MATCHIT_PROFILE && !MATCHIT_TRACE
+            // Arm sets served by the app-hoist or flat-dispatch paths stay
+            // on them: those expand to a comparison per arm already and
+            // erasing them would change string/projection semantics for
+            // no size win. Everything else goes through the erased loop.
+            if constexpr (!useAppHoistV<PatternPairs...> &&
+                          !(std::is_same_v<RetOverride, Deduce> &&
+                            (useEqDispatchV<Value, PatternPairs...> ||
+                             useStrEqDispatchV<Value, PatternPairs...> ||
+                             useDsEqDispatchV<Value, PatternPairs...>)))
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                // constant evaluation cannot go through the erased thunks;
+                // keep the inlined fold for it. At runtime codegen the
+                // builtin folds to false, so only the compact path is
+                // emitted in optimized builds.
+                if (!__builtin_is_constant_evaluated())
+#endif
+                {
+                    return runCompactMatch<RetType, exhaustive, TypeTuple>(
+                        std::forward<Value>(value), patterns...);
+                }
+            }
+#endif // MATCHIT_COMPACT
+
+            if constexpr (useAppHoistV<PatternPairs...>)
+            {
+                auto const &unary = firstAppUnary(patterns...);
+                if (hoistUnariesAgree(unary, patterns...))
+                {
+                    // every arm projects through the same unary: compute the
+                    // projection once and match the inner patterns against
+                    // it. The projection outlives the handlers, so ids that
+                    // bind by pointer stay valid through execute().
+                    decltype(auto) projected = invoke_(unary, value);
+                    return matchPatterns<exhaustive, RetOverride>(
+                        projected, hoistAppArm(patterns)...);
+                }
+            }
+
+            if constexpr (std::is_same_v<RetOverride, Deduce> &&
+                          useEqDispatchV<Value, PatternPairs...>)
+            {
+                return runFlatArms<RetType, exhaustive>(
+                    [&value](auto const &arm)
+                    { return eqDispatchMatch(value, arm); },
+                    patterns...);
+            }
+            else if constexpr (std::is_same_v<RetOverride, Deduce> &&
+                               useStrEqDispatchV<Value, PatternPairs...>)
+            {
+                auto const sv = std::string_view{value};
+                return runFlatArms<RetType, exhaustive>(
+                    [sv](auto const &arm)
+                    { return strEqDispatchMatch(sv, arm); },
+                    patterns...);
+            }
+            else if constexpr (std::is_same_v<RetOverride, Deduce> &&
+                               useDsEqDispatchV<Value, PatternPairs...>)
+            {
+                using ColumnSeq =
+                    typename DsColumnOrder<Value, PatternPairs...>::seq;
+                return runFlatArms<RetType, exhaustive>(
+                    [&value](auto const &arm)
+                    { return dsEqDispatchMatch(value, arm, ColumnSeq{}); },
+                    patterns...);
+            }
+            // expression returning a preserved reference: every arm returns
+            // an lvalue reference, so the result is carried as a pointer and
+            // no referee is copied.
+            else if constexpr (std::is_lvalue_reference_v<RetType>)
+            {
+                constexpr auto const func =
+                    [](auto const &pattern, auto &&value,
+                       std::remove_reference_t<RetType> *&result) constexpr->bool
+                {
+                    if (!armPossiblyMatches(value, pattern))
+                    {
+                        return false;
+                    }
+                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                    if (pattern.matchValue(std::forward<Value>(value), context))
+                    {
+                        result = std::addressof(pattern.execute());
+                        processId(pattern, 0, IdProcess::kCANCEL);
+                        return true;
+                    }
+                    return false;
+                };
+                std::remove_reference_t<RetType> *result = nullptr;
+                bool const matched =
+                    (MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(func(patterns, value, result))) || ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                    else
+                    {
+                        throwNoMatch();
+                    }
+                }
+                static_cast<void>(matched);
+                return static_cast<RetType>(*result);
+            }
+            // expression with a pinned result type: construct RetType in
+            // place from the matching arm's expression, no common_type
+            // conversion and no default-construct-then-assign.
+            else if constexpr (!std::is_same_v<RetOverride, Deduce> &&
+                               !std::is_same_v<RetType, void>)
+            {
+                std::optional<RetType> result;
+                auto const func = [&result](auto const &pattern,
+                                            auto &&value) -> bool
+                {
+                    if (!armPossiblyMatches(value, pattern))
+                    {
+                        return false;
+                    }
+                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                    if (pattern.matchValue(std::forward<Value>(value), context))
+                    {
+                        result.emplace(pattern.execute());
+                        processId(pattern, 0, IdProcess::kCANCEL);
+                        return true;
+                    }
+                    return false;
+                };
+                bool const matched =
+                    (MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(func(patterns, value))) || ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                    else
+                    {
+                        throwNoMatch();
+                    }
+                }
+                static_cast<void>(matched);
+                return RetType{std::move(*result)};
+            }
+            // expression, has return value.
+            else if constexpr (!std::is_same_v<RetType, void>)
+            {
+                constexpr auto const func =
+                    [](auto const &pattern, auto &&value, RetType &result) constexpr->bool
+                {
+                    if (!armPossiblyMatches(value, pattern))
+                    {
+                        return false;
+                    }
+                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                    if (pattern.matchValue(std::forward<Value>(value), context))
+                    {
+                        result = pattern.execute();
+                        processId(pattern, 0, IdProcess::kCANCEL);
+                        return true;
+                    }
+                    return false;
+                };
+                RetType result{};
+                bool const matched =
+                    (MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(func(patterns, value, result))) || ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                    else
+                    {
+                        throwNoMatch();
+                    }
+                }
+                static_cast<void>(matched);
+                return result;
+            }
+            else
+            // statement, no return value, mismatching all patterns is not an error.
+            {
+                auto const func = [](auto const &pattern, auto &&value) -> bool
+                {
+                    if (!armPossiblyMatches(value, pattern))
+                    {
+                        return false;
+                    }
+                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                    if (pattern.matchValue(std::forward<Value>(value), context))
+                    {
+                        pattern.execute();
+                        processId(pattern, 0, IdProcess::kCANCEL);
+                        return true;
+                    }
+                    return false;
+                };
+                bool const matched =
+                    (MATCHIT_PROFILED_TRY(MATCHIT_TRACED_TRY(func(patterns, value))) || ...);
+                if (!matched)
+                {
+                    MATCHIT_PROFILED_MISS();
+                    if constexpr (exhaustive)
+                    {
+                        unreachableMiss();
+                    }
+                }
+                static_cast<void>(matched);
+            }
+        }
+
+#undef MATCHIT_PROFILED_TRY
+#undef MATCHIT_PROFILED_MISS
+#undef MATCHIT_TRACED_TRY
+
+        // matchPatterns variant for probing: a miss is not an error but an
+        // empty optional, so callers trying several pattern sets in
+        // sequence need neither a sentinel wildcard arm (which widens the
+        // arms' common type) nor a try/catch. There is no exceptional path
+        // at all — the miss branch is just the optional staying empty.
+        template <typename RetOverride, typename Value, typename... PatternPairs>
+        constexpr auto tryMatchPatterns(Value &&value,
+                                        PatternPairs const &...patterns)
+        {
+            using RetType =
+                typename RetTypeSelect<RetOverride, PatternPairs...>::type;
+            static_assert(!std::is_same_v<RetType, void>,
+                          "tryMatch needs value-returning arms: with void "
+                          "handlers a plain match() statement already treats "
+                          "a miss as a no-op.");
+            static_assert(!std::is_lvalue_reference_v<RetType>,
+                          "tryMatch carries the result inside std::optional; "
+                          "use match() for reference-returning arms.");
+            using TypeTuple = decltype(std::tuple_cat(
+                std::declval<typename PatternTraits<typename PatternPairs::PatternT>::
+                                 template AppResultTuple<Value>>()...));
+            std::optional<RetType> result;
+            auto const func = [&result](auto const &pattern,
+                                        auto &&value) -> bool
+            {
+                if (!armPossiblyMatches(value, pattern))
+                {
+                    return false;
+                }
+                auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                if (pattern.matchValue(std::forward<Value>(value), context))
+                {
+                    result.emplace(pattern.execute());
+                    processId(pattern, 0, IdProcess::kCANCEL);
+                    return true;
+                }
+                return false;
+            };
+            static_cast<void>((func(patterns, value) || ...));
+            return result;
+        }
+
+        // matchPatterns with the per-arm binding context placed in a
+        // caller-owned arena instead of the stack frame. Each arm allocates
+        // at the arena's current mark and releases back to it when done, so
+        // nested matches inside handlers stack within the same buffer.
+        // Matches whose arms need no context at all fall through to the
+        // plain runner untouched.
+        template <typename Value, typename... PatternPairs>
+        decltype(auto) matchPatternsArena(Arena &arena, Value &&value,
+                                          PatternPairs const &...patterns)
+        {
+            using RetType = typename PatternPairsRetType<PatternPairs...>::RetType;
+            using TypeTuple = decltype(std::tuple_cat(
+                std::declval<typename PatternTraits<typename PatternPairs::PatternT>::
+                                 template AppResultTuple<Value>>()...));
+            using ContextT = typename ContextTrait<TypeTuple>::ContextT;
+
+            if constexpr (std::is_empty_v<ContextT>)
+            {
+                static_cast<void>(arena);
+                return matchPatterns<false>(std::forward<Value>(value), patterns...);
+            }
+            else
+            {
+                auto const runArm = [&arena](auto const &pattern, auto &&value,
+                                             auto const &onMatch) -> bool
+                {
+                    if (!armPossiblyMatches(value, pattern))
+                    {
+                        return false;
+                    }
+                    auto const marked = arena.mark();
+                    auto *context = ::new (
+                        arena.allocate(sizeof(ContextT), alignof(ContextT)))
+                        ContextT{};
+                    bool matched = false;
+                    if (pattern.matchValue(std::forward<Value>(value), *context))
+                    {
+                        onMatch(pattern);
+                        processId(pattern, 0, IdProcess::kCANCEL);
+                        matched = true;
+                    }
+                    context->~ContextT();
+                    arena.release(marked);
+                    return matched;
+                };
+                if constexpr (std::is_lvalue_reference_v<RetType>)
+                {
+                    std::remove_reference_t<RetType> *result = nullptr;
+                    bool const matched =
+                        (runArm(patterns, value,
+                                [&result](auto const &pattern) {
+                                    result = std::addressof(pattern.execute());
+                                }) ||
+                         ...);
+                    if (!matched)
+                    {
+                        throwNoMatch();
+                    }
+                    return static_cast<RetType>(*result);
+                }
+                else if constexpr (!std::is_same_v<RetType, void>)
+                {
+                    RetType result{};
+                    bool const matched =
+                        (runArm(patterns, value,
+                                [&result](auto const &pattern)
+                                { result = pattern.execute(); }) ||
+                         ...);
+                    if (!matched)
+                    {
+                        throwNoMatch();
+                    }
+                    return result;
+                }
+                else
+                {
+                    bool const matched =
+                        (runArm(patterns, value,
+                                [](auto const &pattern) { pattern.execute(); }) ||
+                         ...);
+                    static_cast<void>(matched);
+                }
+            }
+        }
+
+        // Reusable matcher for loop-style dispatch: the arms (and every
+        // nested pattern object inside them) are built once and the object
+        // is invoked per value, so draining a queue through one pattern set
+        // does the setup a single time. Ids referenced by the arms live
+        // outside the matcher and keep their usual per-iteration semantics.
+        template <typename... PatternPairs>
+        class Matcher
+        {
+            std::tuple<PatternPairs...> mPatterns;
+
+        public:
+            constexpr explicit Matcher(PatternPairs const &...patterns)
+                : mPatterns{patterns...}
+            {
+            }
+            template <typename Value>
+            constexpr decltype(auto) operator()(Value &&value) const
+            {
+                return std::apply(
+                    [&value](auto const &...patterns) -> decltype(auto)
+                    {
+                        // bindings survive a successful match (see the
+                        // resetAfterFailure tests), so a reused arm set must
+                        // cancel them up front or a bound Id would turn into
+                        // an equality check on the next invocation.
+                        (processId(patterns.pattern(), 0, IdProcess::kCANCEL),
+                         ...);
+                        return matchPatterns<false, Deduce>(
+                            std::forward<Value>(value), patterns...);
+                    },
+                    mPatterns);
+            }
+        };
+
+        template <typename... PatternPairs>
+        constexpr auto matcher(PatternPairs const &...patterns)
+        {
+            return Matcher<PatternPairs...>{patterns...};
+        }
+
+        // matcher() whose arm set is proven Id-free. Without bindings the
+        // arms are immutable, so the result is constexpr-constructible and a
+        // single (even static) instance can be invoked from many threads
+        // concurrently. Arm sets that bind Ids carry their binding state in
+        // the pattern objects and need one matcher() per thread instead.
+        template <typename... PatternPairs>
+        constexpr auto compileMatch(PatternPairs const &...patterns)
+        {
+            static_assert(
+                (0 + ... +
+                 PatternTraits<typename PatternPairs::PatternT>::nbIdV) == 0,
+                "compileMatch requires Id-free arms: Id binding state lives "
+                "inside the pattern, so sharing it across threads would race. "
+                "Use matcher() per thread when arms bind Ids.");
+            return Matcher<PatternPairs...>{patterns...};
+        }
+
+        // matcher() that learns the trial order: per-arm hit counts are
+        // collected and every kReorderInterval invocations the arms are
+        // re-sorted so the hottest ones are tried first. Only valid when
+        // the arms (except a trailing catch-all, which stays pinned last)
+        // are mutually disjoint — reordering overlapping arms would change
+        // which one wins. Hit counting mutates the object, so share one
+        // instance per thread, as with any matcher() whose arms bind Ids.
+        template <typename... PatternPairs>
+        class AdaptiveMatcher
+        {
+            static constexpr std::size_t nbArms = sizeof...(PatternPairs);
+            static constexpr std::uint32_t kReorderInterval = 1024;
+            std::tuple<PatternPairs...> mPatterns;
+            mutable std::array<std::size_t, nbArms> mOrder{};
+            mutable std::array<std::uint64_t, nbArms> mHits{};
+            mutable std::uint32_t mSinceReorder{};
+
+            // runtime trial index -> compile-time arm: attempt the arm and
+            // feed the matching one to sink before its ids are cancelled.
+            template <std::size_t I, typename Value, typename Sink>
+            bool tryArmAt(std::size_t idx, Value &&value, Sink const &sink) const
+            {
+                using TypeTuple = decltype(std::tuple_cat(
+                    std::declval<
+                        typename PatternTraits<typename PatternPairs::PatternT>::
+                            template AppResultTuple<Value>>()...));
+                if (I == idx)
+                {
+                    auto const &arm = std::get<I>(mPatterns);
+                    if (!armPossiblyMatches(value, arm))
+                    {
+                        return false;
+                    }
+                    auto context = typename ContextTrait<TypeTuple>::ContextT{};
+                    if (arm.matchValue(std::forward<Value>(value), context))
+                    {
+                        sink(arm);
+                        processId(arm, 0, IdProcess::kCANCEL);
+                        return true;
+                    }
+                    return false;
+                }
+                if constexpr (I + 1 < nbArms)
+                {
+                    return tryArmAt<I + 1>(idx, std::forward<Value>(value),
+                                           sink);
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            void recordHit(std::size_t trial) const
+            {
+                ++mHits[mOrder[trial]];
+                if (++mSinceReorder != kReorderInterval)
+                {
+                    return;
+                }
+                mSinceReorder = 0;
+                // stable insertion sort by descending hits over all but the
+                // last slot: ties and the trailing catch-all keep their
+                // source order.
+                for (std::size_t i = 1; i + 1 < nbArms; ++i)
+                {
+                    auto const idx = mOrder[i];
+                    std::size_t j = i;
+                    for (; j != 0 && mHits[mOrder[j - 1]] < mHits[idx]; --j)
+                    {
+                        mOrder[j] = mOrder[j - 1];
+                    }
+                    mOrder[j] = idx;
+                }
+            }
+
+        public:
+            explicit AdaptiveMatcher(PatternPairs const &...patterns)
+                : mPatterns{patterns...}
+            {
+                for (std::size_t i = 0; i != nbArms; ++i)
+                {
+                    mOrder[i] = i;
+                }
+            }
+            template <typename Value>
+            decltype(auto) operator()(Value &&value) const
+            {
+                using RetType =
+                    typename PatternPairsRetType<PatternPairs...>::RetType;
+                std::apply([](auto const &...patterns)
+                           { (processId(patterns.pattern(), 0,
+                                        IdProcess::kCANCEL),
+                              ...); },
+                           mPatterns);
+                if constexpr (std::is_same_v<RetType, void>)
+                {
+                    for (std::size_t i = 0; i != nbArms; ++i)
+                    {
+                        if (tryArmAt<0>(mOrder[i], std::forward<Value>(value),
+                                        [](auto const &arm)
+                                        { arm.execute(); }))
+                        {
+                            recordHit(i);
+                            return;
+                        }
+                    }
+                }
+                else
+                {
+                    static_assert(!std::is_lvalue_reference_v<RetType>,
+                                  "adaptiveMatcher carries the result by "
+                                  "value; use matcher() for reference-"
+                                  "returning arms.");
+                    std::optional<RetType> result;
+                    auto const sink = [&result](auto const &arm)
+                    { result.emplace(arm.execute()); };
+                    for (std::size_t i = 0; i != nbArms; ++i)
+                    {
+                        if (tryArmAt<0>(mOrder[i], std::forward<Value>(value),
+                                        sink))
+                        {
+                            recordHit(i);
+                            return RetType{std::move(*result)};
+                        }
+                    }
+                    throwNoMatch();
+                }
+            }
+            // the trial order currently in effect, hottest first; exposed
+            // so callers (and tests) can observe what the counters learned.
+            constexpr std::array<std::size_t, nbArms> const &trialOrder() const
+            {
+                return mOrder;
+            }
+        };
+
+        template <typename... PatternPairs>
+        auto adaptiveMatcher(PatternPairs const &...patterns)
+        {
+            return AdaptiveMatcher<PatternPairs...>{patterns...};
+        }
+
+        // State-machine table compilation. An arm matrix over
+        // match(state, event) whose arms are all ds(literal, literal) —
+        // wildcards allowed per column and as a catch-all — is dense over
+        // two small enum domains, so instead of trying up to N tuple
+        // compares per event the whole decision lowers to one 2D table
+        // lookup of the winning arm's index. The table is filled at
+        // construction with first-match-wins semantics and the object is
+        // constexpr-constructible, so a static instance bakes the table
+        // into rodata.
+        template <typename Cell>
+        constexpr auto isTableCellV = std::is_integral_v<Cell> ||
+                                      std::is_enum_v<Cell> ||
+                                      std::is_same_v<Cell, Wildcard>;
+
+        template <typename Pattern>
+        constexpr auto isTableArmV = std::is_same_v<Pattern, Wildcard>;
+
+        template <typename A, typename B>
+        constexpr auto isTableArmV<Ds<A, B>> =
+            isTableCellV<A> && isTableCellV<B>;
+
+        template <typename Cell>
+        constexpr bool tableCellMatches(Cell const &cell, std::size_t index)
+        {
+            if constexpr (std::is_same_v<Cell, Wildcard>)
+            {
+                static_cast<void>(cell);
+                static_cast<void>(index);
+                return true;
+            }
+            else
+            {
+                return static_cast<std::size_t>(cell) == index;
+            }
+        }
+
+        template <std::size_t nbStates, std::size_t nbEvents,
+                  typename... PatternPairs>
+        class TableMatcher
+        {
+            static constexpr std::size_t nbArms = sizeof...(PatternPairs);
+            static constexpr std::size_t kMiss = nbArms;
+            static_assert(
+                (isTableArmV<typename PatternPairs::PatternT> && ...),
+                "tableMatcher arms must be ds(literal, literal) over "
+                "integrals/enums (wildcards allowed) or a catch-all _.");
+            static_assert(
+                (0 + ... +
+                 PatternTraits<typename PatternPairs::PatternT>::nbIdV) == 0,
+                "tableMatcher arms cannot bind Ids: the table records only "
+                "which arm wins.");
+
+            std::tuple<PatternPairs...> mPatterns;
+            std::array<std::array<std::size_t, nbEvents>, nbStates> mTable{};
+
+            template <typename PatternPair>
+            constexpr static bool armMatchesCell(PatternPair const &arm,
+                                                 std::size_t state,
+                                                 std::size_t event)
+            {
+                using Pattern = typename PatternPair::PatternT;
+                if constexpr (std::is_same_v<Pattern, Wildcard>)
+                {
+                    static_cast<void>(arm);
+                    static_cast<void>(state);
+                    static_cast<void>(event);
+                    return true;
+                }
+                else
+                {
+                    return tableCellMatches(std::get<0>(arm.pattern().patterns()),
+                                            state) &&
+                           tableCellMatches(std::get<1>(arm.pattern().patterns()),
+                                            event);
+                }
+            }
+
+            constexpr std::size_t armIndexFor(std::size_t state,
+                                              std::size_t event) const
+            {
+                return std::apply(
+                    [state, event](auto const &...arms)
+                    {
+                        std::size_t winner = kMiss;
+                        std::size_t index = 0;
+                        // first match wins, as in source order.
+                        ((winner == kMiss && armMatchesCell(arms, state, event)
+                              ? winner = index++
+                              : index++),
+                         ...);
+                        return winner;
+                    },
+                    mPatterns);
+            }
+
+            using RetType =
+                typename PatternPairsRetType<PatternPairs...>::RetType;
+
+            template <std::size_t I>
+            constexpr RetType invokeArm(std::size_t idx) const
+            {
+                if (I == idx)
+                {
+                    return static_cast<RetType>(std::get<I>(mPatterns).execute());
+                }
+                if constexpr (I + 1 < nbArms)
+                {
+                    return invokeArm<I + 1>(idx);
+                }
+                else if constexpr (std::is_same_v<RetType, void>)
+                {
+                    // statement semantics: a miss with void handlers is not
+                    // an error, as in match().
+                    return;
+                }
+                else
+                {
+                    throwNoMatch();
+                }
+            }
+
+        public:
+            constexpr explicit TableMatcher(PatternPairs const &...patterns)
+                : mPatterns{patterns...}
+            {
+                for (std::size_t s = 0; s != nbStates; ++s)
+                {
+                    for (std::size_t e = 0; e != nbEvents; ++e)
+                    {
+                        mTable[s][e] = armIndexFor(s, e);
+                    }
+                }
+            }
+            template <typename State, typename Event>
+            constexpr RetType operator()(State state, Event event) const
+            {
+                auto const s = static_cast<std::size_t>(state);
+                auto const e = static_cast<std::size_t>(event);
+                // out-of-domain values miss the table; a linear scan still
+                // gives wildcard arms their shot.
+                auto const idx = (s < nbStates && e < nbEvents)
+                                     ? mTable[s][e]
+                                     : armIndexFor(s, e);
+                return invokeArm<0>(idx);
+            }
+        };
+
+        template <std::size_t nbStates, std::size_t nbEvents,
+                  typename... PatternPairs>
+        constexpr auto tableMatcher(PatternPairs const &...patterns)
+        {
+            return TableMatcher<nbStates, nbEvents, PatternPairs...>{
+                patterns...};
+        }
+
+    } // namespace impl
+
+    // export symbols
+    using impl::_;
+    using impl::and_;
+    using impl::app;
+    using impl::ds;
+    using impl::glob;
+    using impl::Id;
+    using impl::adaptiveMatcher;
+    using impl::AdaptiveMatcher;
+    using impl::compileMatch;
+    using impl::likely;
+    using impl::matcher;
+    using impl::Matcher;
+    using impl::meet;
+    using impl::not_;
+    using impl::ooo;
+    using impl::or_;
+    using impl::pattern;
+#if MATCHIT_PROFILE
+    using impl::dumpProfile;
+    using impl::profileSnapshot;
+    using impl::SiteProfileSnapshot;
+#endif // MATCHIT_PROFILE
+#if MATCHIT_TRACE
+    using impl::setTraceHooks;
+    using impl::TraceHook;
+#endif // MATCHIT_TRACE
+    using impl::SharedId;
+    using impl::streamed;
+    using impl::Streamed;
+    using impl::Subrange;
+    using impl::SubrangeT;
+    using impl::tableMatcher;
+    using impl::TableMatcher;
+    using impl::unlikely;
+    using impl::when;
+    using impl::within;
+} // namespace matchit
+
+#endif // MATCHIT_PATTERNS_H
+#ifndef MATCHIT_UTILITY_H
+#define MATCHIT_UTILITY_H
+
+#include <any>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <variant>
+#include <vector>
+
+// std::execution policy overloads light up when the caller includes
+// <execution> before this header. It is not pulled in here: merely
+// including it can add a link-time dependency on the parallel backend
+// (TBB with libstdc++), which a header-only library must not impose.
+#if defined(_GLIBCXX_EXECUTION) || defined(_LIBCPP_EXECUTION) || \
+    defined(_EXECUTION_) || defined(_PSTL_EXECUTION_POLICIES_DEFINED)
+#define MATCHIT_HAS_EXECUTION 1
+#else
+#define MATCHIT_HAS_EXECUTION 0
+#endif
+
+namespace matchit
 {
   namespace impl
   {
 
-    template <typename T>
-    constexpr auto cast = [](auto &&input)
-    { return static_cast<T>(input); };
+    template <typename T>
+    constexpr auto cast = [](auto &&input)
+    { return static_cast<T>(input); };
+
+    constexpr auto deref = [](auto &&x) -> decltype(*x) & { return *x; };
+
+    // fused nodes (Some/None in patterns.h): one emptiness test, the
+    // contained value bound by reference, no And/App machinery.
+    constexpr auto some = [](auto const pat)
+    { return Some<std::decay_t<decltype(pat)>>{pat}; };
+
+    constexpr auto none = None{};
+
+    template <typename Value, typename Variant, typename = std::void_t<>>
+    struct ViaGetIf : std::false_type
+    {
+    };
+
+    using std::get_if;
+
+    template <typename T, typename Variant>
+    struct ViaGetIf<
+        T, Variant,
+        std::void_t<decltype(get_if<T>(std::declval<Variant const *>()))>>
+        : std::true_type
+    {
+    };
+
+    template <typename T, typename Variant>
+    constexpr auto viaGetIfV = ViaGetIf<T, Variant>::value;
+
+    static_assert(viaGetIfV<int, std::variant<int, bool>>);
+
+    // Sealed-hierarchy downcasts. Hierarchies following the kind-tag
+    // convention (a `kind` member or `kind()` accessor on the base plus a
+    // static `k` on each derived class, as in the Closed-Class-Hierarchy
+    // sample) get as<Derived> lowered to a tag compare plus static_cast, with
+    // no dynamic_cast and no user-written get_if. A user-provided get_if
+    // still takes precedence.
+    template <typename T, typename B, typename = std::void_t<>>
+    struct ViaKindMember : std::false_type
+    {
+    };
+
+    template <typename T, typename B>
+    struct ViaKindMember<
+        T, B, std::void_t<decltype(std::declval<B const &>().kind == T::k)>>
+        : std::true_type
+    {
+    };
+
+    template <typename T, typename B, typename = std::void_t<>>
+    struct ViaKindFunc : std::false_type
+    {
+    };
+
+    template <typename T, typename B>
+    struct ViaKindFunc<
+        T, B, std::void_t<decltype(std::declval<B const &>().kind() == T::k)>>
+        : std::true_type
+    {
+    };
+
+    template <typename T, typename B>
+    constexpr auto viaKindTagV =
+        (ViaKindMember<T, B>::value || ViaKindFunc<T, B>::value) &&
+        !viaGetIfV<T, B>;
+
+    template <typename B, typename = std::void_t<>>
+    struct HasKindFunc : std::false_type
+    {
+    };
+
+    template <typename B>
+    struct HasKindFunc<B,
+                       std::void_t<decltype(std::declval<B const &>().kind())>>
+        : std::true_type
+    {
+    };
+
+    template <typename B>
+    constexpr decltype(auto) kindOf(B const &b)
+    {
+      if constexpr (HasKindFunc<B>::value)
+      {
+        return b.kind();
+      }
+      else
+      {
+        return b.kind;
+      }
+    }
+
+    template <typename T, typename B, typename = std::void_t<>>
+    struct CanStaticDowncast : std::false_type
+    {
+    };
+
+    template <typename T, typename B>
+    struct CanStaticDowncast<
+        T, B, std::void_t<decltype(static_cast<T *>(std::declval<B *>()))>>
+        : std::true_type
+    {
+    };
+
+    template <typename T>
+    class AsPointer
+    {
+      static_assert(!std::is_reference_v<T>);
+    public:
+      template <typename Variant,
+                typename std::enable_if<viaGetIfV<T, std::decay_t<Variant>>>::type * = nullptr>
+      constexpr auto operator()(Variant&& v) const
+      {
+        return get_if<T>(std::addressof(v));
+      }
+
+      // template to disable implicit cast to std::any
+      template <typename A, typename std::enable_if<std::is_same<std::decay_t<A>, std::any>::value>::type * = nullptr>
+      constexpr auto operator()(A&& a) const
+      {
+        return std::any_cast<T>(std::addressof(a));
+      }
+
+      // cast to base class
+      template <typename D, typename std::enable_if<!viaGetIfV<T, D> && std::is_base_of_v<T, D>>::type * = nullptr>
+      constexpr auto operator()(D const& d) const
+          -> decltype(static_cast<T const *>(std::addressof(d)))
+      {
+        return static_cast<T const *>(std::addressof(d));
+      }
+
+      // No way to handle rvalue to save copy in this class. Need to define some in another way to handle this.
+      // cast to base class
+      template <typename D, typename std::enable_if<!viaGetIfV<T, D> && std::is_base_of_v<T, D>>::type * = nullptr>
+      constexpr auto operator()(D& d) const
+          -> decltype(static_cast<T*>(std::addressof(d)))
+      {
+        return static_cast<T*>(std::addressof(d));
+      }
+
+      // cast to derived class. The exact-type test compiles down to a
+      // vtable-pointer comparison and handles the common case of matching a
+      // leaf class; dynamic_cast only runs when T is an intermediate base of
+      // the dynamic type. Hierarchies with virtual bases (where the
+      // static_cast is ill-formed) keep the plain dynamic_cast.
+      template <typename B, typename std::enable_if<!viaGetIfV<T, B> && std::is_base_of_v<B, T> && !viaKindTagV<T, B>>::type * = nullptr>
+      constexpr auto operator()(B const& b) const
+          -> decltype(dynamic_cast<T const *>(std::addressof(b)))
+      {
+        if constexpr (CanStaticDowncast<T, B>::value)
+        {
+          if (typeid(b) == typeid(T))
+          {
+            return static_cast<T const *>(std::addressof(b));
+          }
+        }
+        return dynamic_cast<T const *>(std::addressof(b));
+      }
+
+      // cast to derived class
+      template <typename B, typename std::enable_if<!viaGetIfV<T, B> && std::is_base_of_v<B, T> && !viaKindTagV<T, B>>::type * = nullptr>
+      constexpr auto operator()(B& b) const
+          -> decltype(dynamic_cast<T*>(std::addressof(b)))
+      {
+        if constexpr (CanStaticDowncast<T, B>::value)
+        {
+          if (typeid(b) == typeid(T))
+          {
+            return static_cast<T *>(std::addressof(b));
+          }
+        }
+        return dynamic_cast<T *>(std::addressof(b));
+      }
+
+      // cast to derived class within a sealed, kind-tagged hierarchy
+      template <typename B, typename std::enable_if<std::is_base_of_v<B, T> && viaKindTagV<T, B>>::type * = nullptr>
+      constexpr T const *operator()(B const& b) const
+      {
+        return kindOf(b) == T::k ? static_cast<T const *>(std::addressof(b))
+                                 : nullptr;
+      }
+
+      // cast to derived class within a sealed, kind-tagged hierarchy
+      template <typename B, typename std::enable_if<std::is_base_of_v<B, T> && viaKindTagV<T, B>>::type * = nullptr>
+      constexpr T *operator()(B& b) const
+      {
+        return kindOf(b) == T::k ? static_cast<T *>(std::addressof(b))
+                                 : nullptr;
+      }
+
+      constexpr auto operator()(T const& b) const
+      {
+        return std::addressof(b);
+      }
+
+      constexpr auto operator()(T& b) const
+      {
+        return std::addressof(b);
+      }
+    };
+
+    static_assert(std::is_invocable_v<AsPointer<int>, int>);
+    static_assert(std::is_invocable_v<AsPointer<std::tuple<int>>, std::tuple<int>>);
+
+    template <typename T>
+    constexpr AsPointer<T> asPointer;
+
+    template <typename T>
+    constexpr auto as = [](auto const pat)
+    { return app(asPointer<T>, some(pat)); };
+
+    template <typename Value, typename Pattern>
+    constexpr auto matched(Value &&v, Pattern &&p)
+    {
+      return match(std::forward<Value>(v))(
+          pattern | std::forward<Pattern>(p) = []
+          { return true; },
+          pattern | _ = []
+          { return false; });
+    }
+
+    // Single-arm conditional: ifLet(pat, value, onMatch[, onMiss]) probes
+    // one pattern without assembling an arm set — no PatternPairsRetType
+    // computation, no per-arm fold, just the pattern's own context and one
+    // matchPattern walk; the moral equivalent of a hand-written
+    // `if (auto *p = get_if<T>(&v))`. Handlers follow the arm rules:
+    // nullary callables reading bound ids through their captures, or
+    // expression values. With onMatch alone the result is a bool (did it
+    // match) for a void handler, otherwise an optional of the handler's
+    // result, empty on a miss; with onMiss the handlers' common type is
+    // returned.
+    template <typename Pattern, typename Value, typename OnMatch>
+    constexpr auto ifLet(Pattern const &pat, Value &&value, OnMatch &&onMatch)
+    {
+      auto const onMatchFn = toNullary(onMatch);
+      auto const p = canonicalize(pat);
+      using TypeTuple = typename PatternTraits<std::decay_t<decltype(p)>>::
+          template AppResultTuple<Value>;
+      using RetT = std::invoke_result_t<decltype(onMatchFn)>;
+      auto context = typename ContextTrait<TypeTuple>::ContextT{};
+      if constexpr (std::is_void_v<RetT>)
+      {
+        if (matchPattern(std::forward<Value>(value), p, 0, context))
+        {
+          onMatchFn();
+          processId(p, 0, IdProcess::kCANCEL);
+          return true;
+        }
+        return false;
+      }
+      else
+      {
+        if (matchPattern(std::forward<Value>(value), p, 0, context))
+        {
+          auto result = std::optional<std::decay_t<RetT>>{onMatchFn()};
+          processId(p, 0, IdProcess::kCANCEL);
+          return result;
+        }
+        return std::optional<std::decay_t<RetT>>{};
+      }
+    }
+
+    template <typename Pattern, typename Value, typename OnMatch,
+              typename OnMiss>
+    constexpr auto ifLet(Pattern const &pat, Value &&value, OnMatch &&onMatch,
+                         OnMiss &&onMiss)
+    {
+      auto const onMatchFn = toNullary(onMatch);
+      auto const onMissFn = toNullary(onMiss);
+      auto const p = canonicalize(pat);
+      using TypeTuple = typename PatternTraits<std::decay_t<decltype(p)>>::
+          template AppResultTuple<Value>;
+      using MatchRetT = std::invoke_result_t<decltype(onMatchFn)>;
+      using MissRetT = std::invoke_result_t<decltype(onMissFn)>;
+      auto context = typename ContextTrait<TypeTuple>::ContextT{};
+      if constexpr (std::is_void_v<MatchRetT> && std::is_void_v<MissRetT>)
+      {
+        if (matchPattern(std::forward<Value>(value), p, 0, context))
+        {
+          onMatchFn();
+          processId(p, 0, IdProcess::kCANCEL);
+        }
+        else
+        {
+          onMissFn();
+        }
+      }
+      else
+      {
+        using RetT = std::common_type_t<MatchRetT, MissRetT>;
+        if (matchPattern(std::forward<Value>(value), p, 0, context))
+        {
+          RetT result = onMatchFn();
+          processId(p, 0, IdProcess::kCANCEL);
+          return result;
+        }
+        return static_cast<RetT>(onMissFn());
+      }
+    }
+
+    // Multi-substring search automaton backing containsAny. The literal
+    // set is compiled once into an Aho-Corasick automaton with completed
+    // goto transitions, so scanning is a single table walk per character —
+    // O(text) however many literals there are — where composing meet
+    // predicates would cost one find() per literal.
+    class AhoCorasick
+    {
+      struct Node
+      {
+        std::array<int32_t, 256> next{};
+        int32_t fail = 0;
+        int32_t out = -1;
+      };
+      std::vector<Node> mNodes;
+      std::vector<std::string> mLiterals;
+
+      static constexpr int32_t kUnset = -1;
+
+      int32_t &slot(int32_t node, unsigned char c)
+      {
+        return mNodes[static_cast<std::size_t>(node)].next[c];
+      }
+
+    public:
+      explicit AhoCorasick(std::vector<std::string> literals)
+          : mLiterals{std::move(literals)}
+      {
+        mNodes.emplace_back();
+        mNodes.front().next.fill(kUnset);
+        for (std::size_t i = 0; i != mLiterals.size(); ++i)
+        {
+          int32_t state = 0;
+          for (char const ch : mLiterals[i])
+          {
+            // read by value: growing mNodes below invalidates references.
+            auto next = slot(state, static_cast<unsigned char>(ch));
+            if (next == kUnset)
+            {
+              next = static_cast<int32_t>(mNodes.size());
+              slot(state, static_cast<unsigned char>(ch)) = next;
+              mNodes.emplace_back();
+              mNodes.back().next.fill(kUnset);
+            }
+            state = next;
+          }
+          auto &out = mNodes[static_cast<std::size_t>(state)].out;
+          if (out == kUnset) // first literal listed wins duplicates
+          {
+            out = static_cast<int32_t>(i);
+          }
+        }
+        // breadth-first completion of goto and fail links: unset edges
+        // point where the failure state would go, so the scan never
+        // chases fail links.
+        std::vector<int32_t> queue;
+        for (std::size_t c = 0; c != 256; ++c)
+        {
+          auto &next = slot(0, static_cast<unsigned char>(c));
+          if (next == kUnset)
+          {
+            next = 0;
+          }
+          else
+          {
+            queue.push_back(next);
+          }
+        }
+        for (std::size_t head = 0; head != queue.size(); ++head)
+        {
+          auto const u = queue[head];
+          auto const fail = mNodes[static_cast<std::size_t>(u)].fail;
+          auto &node = mNodes[static_cast<std::size_t>(u)];
+          if (node.out == kUnset) // a proper suffix may be a literal
+          {
+            node.out = mNodes[static_cast<std::size_t>(fail)].out;
+          }
+          for (std::size_t c = 0; c != 256; ++c)
+          {
+            auto const viaFail =
+                mNodes[static_cast<std::size_t>(fail)]
+                    .next[static_cast<unsigned char>(c)];
+            auto &next = slot(u, static_cast<unsigned char>(c));
+            if (next == kUnset)
+            {
+              next = viaFail;
+            }
+            else
+            {
+              mNodes[static_cast<std::size_t>(next)].fail = viaFail;
+              queue.push_back(next);
+            }
+          }
+        }
+      }
+
+      // the literal whose occurrence ends first in text; ties at the same
+      // end position go to the longer occurrence, then to listing order.
+      std::optional<std::string_view> find(std::string_view text) const
+      {
+        int32_t state = 0;
+        for (char const ch : text)
+        {
+          state = mNodes[static_cast<std::size_t>(state)]
+                      .next[static_cast<unsigned char>(ch)];
+          auto const out = mNodes[static_cast<std::size_t>(state)].out;
+          if (out != kUnset)
+          {
+            return std::string_view{mLiterals[static_cast<std::size_t>(out)]};
+          }
+        }
+        return std::nullopt;
+      }
+    };
+
+    // Pattern factory for classifying a string by which of many substrings
+    // it contains: containsAny("timeout", "refused")(which) matches any
+    // string-like scrutinee containing one of the literals and exposes the
+    // hit through the inner pattern (an Id<std::string_view>, or _ for a
+    // plain containment test). The automaton is built when the factory is
+    // called, so hoist the result (static, or inside a matcher()) to pay
+    // construction once; arms sharing one factory result also share the
+    // automaton.
+    template <typename... Literals>
+    auto containsAny(Literals const &...literals)
+    {
+      static_assert(sizeof...(Literals) > 0,
+                    "containsAny needs at least one literal!");
+      auto const automaton = std::make_shared<AhoCorasick const>(
+          std::vector<std::string>{std::string{literals}...});
+      return [automaton](auto const &pat)
+      {
+        return app(
+            [automaton](auto const &text) -> std::optional<std::string_view>
+            { return automaton->find(std::string_view{text}); },
+            some(pat));
+      };
+    }
+
+    // Bulk classification: run one arm set over every element. The arm set
+    // is built once up front (matcher() hoists the pattern setup) instead of
+    // being re-assembled per element as match() in a loop would. Handlers
+    // follow the usual statement/expression rules, so for pure side effects
+    // give void handlers or add a catch-all arm — with non-void handlers an
+    // element no arm matches throws.
+    template <typename Iter, typename... PatternPairs>
+    auto matchAllIter(Iter first, Iter last, PatternPairs const &...patterns)
+    {
+      auto const arms = matcher(patterns...);
+      for (; first != last; ++first)
+      {
+        arms(*first);
+      }
+    }
+
+    template <typename Iter, typename... PatternPairs>
+    auto matchAllParIter(Iter first, Iter last, PatternPairs const &...patterns)
+    {
+      static_assert(
+          (0 + ... +
+           PatternTraits<typename PatternPairs::PatternT>::nbIdV) == 0,
+          "parallel matchAll needs id-free arms: id bindings live in the "
+          "pattern objects and would race across workers.");
+      auto const len = static_cast<std::size_t>(std::distance(first, last));
+      auto const hw = std::thread::hardware_concurrency();
+      auto const nbWorkers = std::min<std::size_t>(hw == 0 ? 1 : hw, len);
+      if (nbWorkers <= 1)
+      {
+        matchAllIter(first, last, patterns...);
+        return;
+      }
+      auto const chunk = len / nbWorkers;
+      auto const rem = len % nbWorkers;
+      std::vector<std::thread> workers;
+      workers.reserve(nbWorkers);
+      auto cursor = first;
+      for (std::size_t w = 0; w != nbWorkers; ++w)
+      {
+        auto const take = chunk + (w < rem ? 1U : 0U);
+        auto const chunkFirst = cursor;
+        std::advance(cursor, static_cast<std::ptrdiff_t>(take));
+        // each worker owns its own copy of the arm set, so no pattern state
+        // is shared across threads.
+        workers.emplace_back(
+            [chunkFirst, take, patterns...]
+            {
+              auto const arms = matcher(patterns...);
+              auto it = chunkFirst;
+              for (std::size_t i = 0; i != take; ++i, ++it)
+              {
+                arms(*it);
+              }
+            });
+      }
+      for (auto &worker : workers)
+      {
+        worker.join();
+      }
+    }
 
-    constexpr auto deref = [](auto &&x) -> decltype(*x) & { return *x; };
-    constexpr auto some = [](auto const pat)
+    template <typename Iter, typename... PatternPairs,
+              typename std::enable_if<!isRangeV<Iter>>::type * = nullptr>
+    auto matchAll(Iter first, Iter last, PatternPairs const &...patterns)
     {
-      return and_(app(cast<bool>, true), app(deref, pat));
-    };
+      matchAllIter(first, last, patterns...);
+    }
 
-    constexpr auto none = app(cast<bool>, false);
+    template <typename Range, typename... PatternPairs,
+              typename std::enable_if<isRangeV<Range>>::type * = nullptr>
+    auto matchAll(Range &&range, PatternPairs const &...patterns)
+    {
+      matchAllIter(std::begin(range), std::end(range), patterns...);
+    }
 
-    template <typename Value, typename Variant, typename = std::void_t<>>
-    struct ViaGetIf : std::false_type
+#if MATCHIT_HAS_EXECUTION
+    template <typename Policy>
+    constexpr auto isParallelPolicyV =
+        std::is_same<Policy, std::execution::parallel_policy>::value ||
+        std::is_same<Policy, std::execution::parallel_unsequenced_policy>::value;
+
+    template <typename Iter, typename... PatternPairs,
+              typename std::enable_if<!isRangeV<Iter>>::type * = nullptr>
+    auto matchAll(std::execution::sequenced_policy, Iter first, Iter last,
+                  PatternPairs const &...patterns)
     {
-    };
+      matchAllIter(first, last, patterns...);
+    }
 
-    using std::get_if;
+    template <typename Range, typename... PatternPairs,
+              typename std::enable_if<isRangeV<Range>>::type * = nullptr>
+    auto matchAll(std::execution::sequenced_policy, Range &&range,
+                  PatternPairs const &...patterns)
+    {
+      matchAllIter(std::begin(range), std::end(range), patterns...);
+    }
 
-    template <typename T, typename Variant>
-    struct ViaGetIf<
-        T, Variant,
-        std::void_t<decltype(get_if<T>(std::declval<Variant const *>()))>>
-        : std::true_type
+    template <typename Policy, typename Iter, typename... PatternPairs,
+              typename std::enable_if<isParallelPolicyV<Policy> &&
+                                      !isRangeV<Iter>>::type * = nullptr>
+    auto matchAll(Policy, Iter first, Iter last,
+                  PatternPairs const &...patterns)
     {
-    };
+      matchAllParIter(first, last, patterns...);
+    }
 
-    template <typename T, typename Variant>
-    constexpr auto viaGetIfV = ViaGetIf<T, Variant>::value;
+    template <typename Policy, typename Range, typename... PatternPairs,
+              typename std::enable_if<isParallelPolicyV<Policy> &&
+                                      isRangeV<Range>>::type * = nullptr>
+    auto matchAll(Policy, Range &&range, PatternPairs const &...patterns)
+    {
+      matchAllParIter(std::begin(range), std::end(range), patterns...);
+    }
+#endif // MATCHIT_HAS_EXECUTION
+
+    // Bulk mapping: match every element and write each result through an
+    // output iterator — the clip/relu idiom applied to a whole array.
+    //
+    // Arms that bind no ids and materialize nothing in the binding context
+    // (range/literal/meet patterns over arithmetic elements) take a kernel
+    // that reduces each element to a chain of selects with no stores, no
+    // cancel walks and no early exits, which the optimizer turns into
+    // branchless code and vectorizes across lanes. Arms with ids or
+    // context-backed patterns keep the full per-element match.
+    template <typename RetT, typename Value>
+    constexpr RetT mapOne(Value const &)
+    {
+      throwNoMatch();
+    }
 
-    static_assert(viaGetIfV<int, std::variant<int, bool>>);
+    template <typename RetT, typename Value, typename First,
+              typename... Rest>
+    constexpr RetT mapOne(Value const &value, First const &first,
+                          Rest const &...rest)
+    {
+      Context<> dummy{};
+      return matchPattern(value, first.pattern(), 0, dummy)
+                 ? static_cast<RetT>(first.execute())
+                 : mapOne<RetT>(value, rest...);
+    }
 
-    template <typename T>
-    class AsPointer
+    template <typename Elem, typename... PatternPairs>
+    constexpr auto useSelectKernelV =
+        ((PatternTraits<typename PatternPairs::PatternT>::nbIdV == 0) &&
+         ...) &&
+        (std::is_same_v<typename PatternTraits<
+                            typename PatternPairs::PatternT>::
+                            template AppResultTuple<Elem &>,
+                        std::tuple<>> &&
+         ...);
+
+    template <typename Iter, typename OutIter, typename... PatternPairs,
+              typename std::enable_if<!isRangeV<Iter>>::type * = nullptr>
+    constexpr auto mapAll(Iter first, Iter last, OutIter out,
+                          PatternPairs const &...patterns)
     {
-      static_assert(!std::is_reference_v<T>);
-    public:
-      template <typename Variant,
-                typename std::enable_if<viaGetIfV<T, std::decay_t<Variant>>>::type * = nullptr>
-      constexpr auto operator()(Variant&& v) const
+      using Elem = std::decay_t<decltype(*first)>;
+      using RetT =
+          typename PatternPairsRetType<PatternPairs...>::RetType;
+      if constexpr (useSelectKernelV<Elem, PatternPairs...>)
       {
-        return get_if<T>(std::addressof(v));
+        for (; first != last; ++first, ++out)
+        {
+          *out = mapOne<RetT>(*first, patterns...);
+        }
       }
-
-      // template to disable implicit cast to std::any
-      template <typename A, typename std::enable_if<std::is_same<std::decay_t<A>, std::any>::value>::type * = nullptr>
-      constexpr auto operator()(A&& a) const
+      else
       {
-        return std::any_cast<T>(std::addressof(a));
+        auto const arms = matcher(patterns...);
+        for (; first != last; ++first, ++out)
+        {
+          *out = arms(*first);
+        }
       }
+      return out;
+    }
 
-      // cast to base class
-      template <typename D, typename std::enable_if<!viaGetIfV<T, D> && std::is_base_of_v<T, D>>::type * = nullptr>
-      constexpr auto operator()(D const& d) const
-          -> decltype(static_cast<T const *>(std::addressof(d)))
+    template <typename Range, typename OutIter, typename... PatternPairs,
+              typename std::enable_if<isRangeV<Range>>::type * = nullptr>
+    constexpr auto mapAll(Range &&range, OutIter out,
+                          PatternPairs const &...patterns)
+    {
+      return mapAll(std::begin(range), std::end(range), out, patterns...);
+    }
+
+    // Fork-join for recursive tree matches: evaluate two independent
+    // subcomputations — typically the two operands an arm bound with
+    // ds(l, r) — concurrently while the recursion is above a depth cutoff,
+    // serially below it. The cutoff bounds the task count to 2^cutoff, so
+    // the splits near the root fan out across cores and the vast majority
+    // of nodes run in the caller's thread with zero scheduling overhead.
+    // The caller's thread always takes the left side and only the right
+    // side is spawned, so a fork costs one task per split, not two.
+    //
+    // Handlers may share bound ids freely across the two sides: the match
+    // that bound them has completed, so both sides only read. Recursive
+    // matches inside the sides must declare their own local Ids, as the
+    // recursive samples already do.
+    template <typename Left, typename Right>
+    auto forkJoin(int32_t depth, int32_t cutoff, Left &&left, Right &&right)
+    {
+      if (depth < cutoff)
       {
-        return static_cast<T const *>(std::addressof(d));
+        auto rightResult =
+            std::async(std::launch::async, std::forward<Right>(right));
+        auto leftResult = std::forward<Left>(left)();
+        return std::make_pair(std::move(leftResult), rightResult.get());
       }
+      auto leftResult = std::forward<Left>(left)();
+      auto rightResult = std::forward<Right>(right)();
+      return std::make_pair(std::move(leftResult), std::move(rightResult));
+    }
 
-      // No way to handle rvalue to save copy in this class. Need to define some in another way to handle this.
-      // cast to base class
-      template <typename D, typename std::enable_if<!viaGetIfV<T, D> && std::is_base_of_v<T, D>>::type * = nullptr>
-      constexpr auto operator()(D& d) const
-          -> decltype(static_cast<T*>(std::addressof(d)))
+    // Lazy pipeline stage: range | matchEach(arms...) yields each element's
+    // match result on demand, so matchit dispatch composes with other view
+    // adaptors without materializing a vector between them. The arm set is
+    // compiled once (matcher()) and shared by every element; dereferencing
+    // an iterator runs the match. Input-iterator semantics: each deref
+    // recomputes, single pass is the intended use. The typedefs below also
+    // satisfy the C++20 input_range concepts, so the view drops into
+    // std::ranges pipelines when built as C++20.
+    template <typename Iter, typename MatcherT>
+    class MatchEachIterator
+    {
+      Iter mIter{};
+      MatcherT const *mMatcher = nullptr;
+
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using reference = decltype((*std::declval<MatcherT const *>())(
+          *std::declval<Iter const &>()));
+      using value_type = std::decay_t<reference>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+
+      // default constructible so it models semiregular, which C++20
+      // ranges::end demands of a sentinel.
+      constexpr MatchEachIterator() = default;
+      constexpr MatchEachIterator(Iter iter, MatcherT const &matcher)
+          : mIter{iter}, mMatcher{&matcher}
       {
-        return static_cast<T*>(std::addressof(d));
       }
-
-      // cast to derived class
-      template <typename B, typename std::enable_if<!viaGetIfV<T, B> && std::is_base_of_v<B, T>>::type * = nullptr>
-      constexpr auto operator()(B const& b) const
-          -> decltype(dynamic_cast<T const *>(std::addressof(b)))
+      constexpr decltype(auto) operator*() const { return (*mMatcher)(*mIter); }
+      constexpr MatchEachIterator &operator++()
       {
-        return dynamic_cast<T const *>(std::addressof(b));
+        ++mIter;
+        return *this;
       }
-
-      // cast to derived class
-      template <typename B, typename std::enable_if<!viaGetIfV<T, B> && std::is_base_of_v<B, T>>::type * = nullptr>
-      constexpr auto operator()(B& b) const
-          -> decltype(dynamic_cast<T*>(std::addressof(b)))
+      constexpr MatchEachIterator operator++(int)
       {
-        return dynamic_cast<T*>(std::addressof(b));
+        auto old = *this;
+        ++mIter;
+        return old;
       }
-
-      constexpr auto operator()(T const& b) const
+      friend constexpr bool operator==(MatchEachIterator const &lhs,
+                                       MatchEachIterator const &rhs)
       {
-        return std::addressof(b);
+        return lhs.mIter == rhs.mIter;
       }
+      friend constexpr bool operator!=(MatchEachIterator const &lhs,
+                                       MatchEachIterator const &rhs)
+      {
+        return !(lhs == rhs);
+      }
+    };
 
-      constexpr auto operator()(T& b) const
+    template <typename Range, typename MatcherT>
+    class MatchEachView
+    {
+      // Range is a reference type when the adaptor was applied to an
+      // lvalue (view semantics) and an object type for rvalues, which are
+      // moved in so the view owns them.
+      Range mRange;
+      MatcherT const mMatcher;
+
+    public:
+      template <typename R>
+      constexpr MatchEachView(R &&range, MatcherT matcher)
+          : mRange{std::forward<R>(range)}, mMatcher{std::move(matcher)}
       {
-        return std::addressof(b);
+      }
+      constexpr auto begin()
+      {
+        return MatchEachIterator<decltype(std::begin(mRange)), MatcherT>{
+            std::begin(mRange), mMatcher};
+      }
+      constexpr auto end()
+      {
+        return MatchEachIterator<decltype(std::begin(mRange)), MatcherT>{
+            std::end(mRange), mMatcher};
+      }
+      // SFINAE'd so owning a C++20 view that is not const-iterable (e.g.
+      // filter_view) only removes the const overloads instead of erroring.
+      template <typename R = Range const>
+      constexpr auto begin() const
+          -> MatchEachIterator<decltype(std::begin(std::declval<R &>())),
+                               MatcherT>
+      {
+        return {std::begin(mRange), mMatcher};
+      }
+      template <typename R = Range const>
+      constexpr auto end() const
+          -> MatchEachIterator<decltype(std::begin(std::declval<R &>())),
+                               MatcherT>
+      {
+        return {std::end(mRange), mMatcher};
       }
     };
 
-    static_assert(std::is_invocable_v<AsPointer<int>, int>);
-    static_assert(std::is_invocable_v<AsPointer<std::tuple<int>>, std::tuple<int>>);
+    template <typename MatcherT>
+    class MatchEachAdaptor
+    {
+    public:
+      MatcherT mMatcher;
+    };
 
-    template <typename T>
-    constexpr AsPointer<T> asPointer;
+    template <typename... PatternPairs>
+    constexpr auto matchEach(PatternPairs const &...patterns)
+    {
+      auto arms = matcher(patterns...);
+      return MatchEachAdaptor<decltype(arms)>{std::move(arms)};
+    }
 
-    template <typename T>
-    constexpr auto as = [](auto const pat)
-    { return app(asPointer<T>, some(pat)); };
+    // isRangeV demands const iteration, which C++20 views like filter_view
+    // do not offer; the pipe only needs begin/end on a mutable lvalue.
+    template <typename Range, typename = std::void_t<>>
+    struct IsLvalueIterable : std::false_type
+    {
+    };
+    template <typename Range>
+    struct IsLvalueIterable<
+        Range,
+        std::void_t<
+            decltype(std::begin(
+                std::declval<std::remove_reference_t<Range> &>())),
+            decltype(std::end(std::declval<std::remove_reference_t<Range> &>()))>>
+        : std::true_type
+    {
+    };
+    template <typename Range>
+    constexpr auto isLvalueIterableV = IsLvalueIterable<Range>::value;
 
-    template <typename Value, typename Pattern>
-    constexpr auto matched(Value &&v, Pattern &&p)
+    template <typename Range, typename MatcherT,
+              typename std::enable_if<isLvalueIterableV<Range>>::type * = nullptr>
+    constexpr auto operator|(Range &&range, MatchEachAdaptor<MatcherT> adaptor)
     {
-      return match(std::forward<Value>(v))(
-          pattern | std::forward<Pattern>(p) = []
-          { return true; },
-          pattern | _ = []
-          { return false; });
+      return MatchEachView<Range, MatcherT>{std::forward<Range>(range),
+                                            std::move(adaptor.mMatcher)};
+    }
+
+    // Trampoline for tail-recursive matches. A handler that would recurse
+    // in tail position returns recur(next) to continue the walk with a new
+    // scrutinee, or done(result) to stop; tailRec drives the loop. The walk
+    // then runs in constant stack instead of one matchPatterns + handler
+    // frame — plus its binding Context — per level. Arms of one match mix
+    // the two, so the step is written as match<TailRec<Value, Result>>(v).
+    template <typename Value>
+    struct Recur
+    {
+      Value value;
+    };
+
+    template <typename Result>
+    struct Done
+    {
+      Result result;
+    };
+
+    template <typename Value>
+    constexpr auto recur(Value value)
+    {
+      return Recur<Value>{std::move(value)};
+    }
+
+    template <typename Result>
+    constexpr auto done(Result result)
+    {
+      return Done<Result>{std::move(result)};
+    }
+
+    template <typename Value, typename Result>
+    class TailRec
+    {
+    public:
+      template <typename V>
+      constexpr TailRec(Recur<V> next)
+          : mState{Recur<Value>{std::move(next.value)}}
+      {
+      }
+      template <typename R>
+      constexpr TailRec(Done<R> result)
+          : mState{Done<Result>{std::move(result.result)}}
+      {
+      }
+      constexpr bool isDone() const { return mState.index() == 1; }
+      constexpr Value &next() { return std::get<0>(mState).value; }
+      constexpr Result &result() { return std::get<1>(mState).result; }
+
+    private:
+      std::variant<Recur<Value>, Done<Result>> mState;
+    };
+
+    template <typename Value, typename Step>
+    constexpr auto tailRec(Value init, Step &&step)
+    {
+      auto token = step(std::move(init));
+      while (!token.isDone())
+      {
+        token = step(std::move(token.next()));
+      }
+      return std::move(token.result());
     }
 
     constexpr auto dsVia = [](auto ...members)
@@ -2184,19 +7142,321 @@ namespace matchit
     {
       return [members...](auto ...pats)
       {
-        // FIXME, why the following line will cause segfault in at-Bindings.cpp
-        // return as<T>(dsVia(members...)(pats...));
-        return as<T>(and_(app(members, pats)...));
+        // fused path: one downcast, then every member accessor applied at
+        // once into a tuple of references matched as a flat ds — a single
+        // matchPattern re-entry instead of one and_/app node per member.
+        // Only valid when all accessors yield lvalues; by-value accessors
+        // need their own context slots and keep the composed form. The
+        // unary must be passed as a prvalue: app() deduces Unary& for
+        // lvalues and App then stores a reference, which is also why the
+        // dsVia-composed spelling below segfaulted — it referenced the
+        // captures of the temporary closure dsVia(members...) returns.
+        if constexpr (allLvalueRefTupleV<std::tuple<decltype(invoke_(
+                          members, std::declval<T const &>()))...>>)
+        {
+          return as<T>(app(
+              [members...](auto const &obj)
+              { return std::forward_as_tuple(invoke_(members, obj)...); },
+              ds(pats...)));
+        }
+        else
+        {
+          // not: as<T>(dsVia(members...)(pats...)) — see above, the app
+          // nodes would dangle into the temporary closure's captures.
+          return as<T>(and_(app(members, pats)...));
+        }
       };
     };
 
+    // Automatic aggregate destructuring, pfr-style: the field count is
+    // detected at compile time and the aggregate is torn into a tuple of
+    // references via structured bindings, so all members match in one pass
+    // as a flat ds through a single App node — no member-pointer list and
+    // no per-member app context. Members that are C arrays fall outside the
+    // detection (brace elision counts their elements); list accessors with
+    // dsVia for those.
+    struct Universal
+    {
+      template <typename T>
+      operator T() const;
+    };
+
+    template <typename T, typename Seq, typename = std::void_t<>>
+    struct BraceInitN : std::false_type
+    {
+    };
+
+    template <typename T, std::size_t... I>
+    struct BraceInitN<
+        T, std::index_sequence<I...>,
+        std::void_t<decltype(T{(static_cast<void>(I), Universal{})...})>>
+        : std::true_type
+    {
+    };
+
+    constexpr std::size_t maxDetectedFields = 16;
+
+    template <typename T, std::size_t N = maxDetectedFields>
+    constexpr std::size_t fieldCount()
+    {
+      if constexpr (BraceInitN<T, std::make_index_sequence<N>>::value)
+      {
+        return N;
+      }
+      else
+      {
+        static_assert(N > 0, "not an aggregate initializable type");
+        return fieldCount<T, N - 1>();
+      }
+    }
+
+    template <typename T>
+    constexpr auto fieldsTie(T const &obj)
+    {
+      constexpr auto n = fieldCount<T>();
+      static_assert(std::is_aggregate_v<T>);
+      if constexpr (n == 0)
+      {
+        return std::tuple<>{};
+      }
+      else if constexpr (n == 1)
+      {
+        auto const &[m0] = obj;
+        return std::tie(m0);
+      }
+      else if constexpr (n == 2)
+      {
+        auto const &[m0, m1] = obj;
+        return std::tie(m0, m1);
+      }
+      else if constexpr (n == 3)
+      {
+        auto const &[m0, m1, m2] = obj;
+        return std::tie(m0, m1, m2);
+      }
+      else if constexpr (n == 4)
+      {
+        auto const &[m0, m1, m2, m3] = obj;
+        return std::tie(m0, m1, m2, m3);
+      }
+      else if constexpr (n == 5)
+      {
+        auto const &[m0, m1, m2, m3, m4] = obj;
+        return std::tie(m0, m1, m2, m3, m4);
+      }
+      else if constexpr (n == 6)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5);
+      }
+      else if constexpr (n == 7)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6);
+      }
+      else if constexpr (n == 8)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7);
+      }
+      else if constexpr (n == 9)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8);
+      }
+      else if constexpr (n == 10)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9);
+      }
+      else if constexpr (n == 11)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10);
+      }
+      else if constexpr (n == 12)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11);
+      }
+      else if constexpr (n == 13)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12] =
+            obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12);
+      }
+      else if constexpr (n == 14)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                     m13] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                        m13);
+      }
+      else if constexpr (n == 15)
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                     m13, m14] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                        m13, m14);
+      }
+      else
+      {
+        auto const &[m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                     m13, m14, m15] = obj;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12,
+                        m13, m14, m15);
+      }
+    }
+
+    constexpr auto fields = [](auto const &obj)
+    { return fieldsTie(obj); };
+
+    constexpr auto dsFields = [](auto const ...pats)
+    { return app(fields, ds(pats...)); };
+
+    // Zero-copy binary decoding over contiguous byte buffers. A frame is
+    // viewed as a ByteSpan (a contiguous Subrange, convertible to std::span
+    // under C++20); field patterns are App extractors that read a typed
+    // value at a fixed offset or re-slice the buffer, so a header match
+    // binds integers and payload slices without copying any bytes.
+    using ByteSpan = Subrange<unsigned char const *>;
+
+    template <typename Buffer>
+    auto bytesOf(Buffer const &buffer)
+    {
+      auto const *data =
+          reinterpret_cast<unsigned char const *>(buffer.data());
+      return ByteSpan{data, data + buffer.size()};
+    }
+
+    enum class ByteOrder
+    {
+      kLE,
+      kBE
+    };
+
+    template <typename T, ByteOrder order, std::size_t offset>
+    class ReadFixed
+    {
+    public:
+      std::optional<T> operator()(ByteSpan const s) const
+      {
+        if (s.size() < offset + sizeof(T))
+        {
+          return std::nullopt;
+        }
+        auto const *p = s.data() + offset;
+        std::uintmax_t acc = 0;
+        if constexpr (order == ByteOrder::kBE)
+        {
+          for (std::size_t i = 0; i < sizeof(T); ++i)
+          {
+            acc = (acc << 8U) | static_cast<std::uintmax_t>(p[i]);
+          }
+        }
+        else
+        {
+          for (std::size_t i = sizeof(T); i > 0; --i)
+          {
+            acc = (acc << 8U) | static_cast<std::uintmax_t>(p[i - 1]);
+          }
+        }
+        return static_cast<T>(acc);
+      }
+    };
+
+    // reads a LenT length field at `offset` and yields the following
+    // `length` bytes as a slice of the original buffer.
+    template <typename LenT, std::size_t offset, ByteOrder order>
+    class ReadLenPrefixed
+    {
+    public:
+      std::optional<ByteSpan> operator()(ByteSpan const s) const
+      {
+        auto const length = ReadFixed<LenT, order, offset>{}(s);
+        if (!length ||
+            s.size() < offset + sizeof(LenT) + static_cast<std::size_t>(*length))
+        {
+          return std::nullopt;
+        }
+        auto const *begin = s.data() + offset + sizeof(LenT);
+        return ByteSpan{begin, begin + *length};
+      }
+    };
+
+    template <std::size_t offset>
+    class ReadSlice
+    {
+    public:
+      std::optional<ByteSpan> operator()(ByteSpan const s) const
+      {
+        if (s.size() < offset)
+        {
+          return std::nullopt;
+        }
+        return ByteSpan{s.data() + offset, s.data() + s.size()};
+      }
+    };
+
+    template <typename T, ByteOrder order, std::size_t offset>
+    constexpr auto fixedAt = [](auto const pat)
+    { return app(ReadFixed<T, order, offset>{}, some(pat)); };
+
+    template <std::size_t offset = 0>
+    constexpr auto u8At = fixedAt<uint8_t, ByteOrder::kBE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u16beAt = fixedAt<uint16_t, ByteOrder::kBE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u16leAt = fixedAt<uint16_t, ByteOrder::kLE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u32beAt = fixedAt<uint32_t, ByteOrder::kBE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u32leAt = fixedAt<uint32_t, ByteOrder::kLE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u64beAt = fixedAt<uint64_t, ByteOrder::kBE, offset>;
+    template <std::size_t offset = 0>
+    constexpr auto u64leAt = fixedAt<uint64_t, ByteOrder::kLE, offset>;
+
+    template <typename LenT, std::size_t offset,
+              ByteOrder order = ByteOrder::kBE>
+    constexpr auto lenPrefixedAt = [](auto const pat)
+    { return app(ReadLenPrefixed<LenT, offset, order>{}, some(pat)); };
+
+    template <std::size_t offset>
+    constexpr auto sliceAt = [](auto const pat)
+    { return app(ReadSlice<offset>{}, some(pat)); };
+
   } // namespace impl
   using impl::as;
   using impl::asDsVia;
+  using impl::ByteOrder;
+  using impl::ByteSpan;
+  using impl::bytesOf;
+  using impl::containsAny;
+  using impl::done;
+  using impl::dsFields;
   using impl::dsVia;
+  using impl::fixedAt;
+  using impl::forkJoin;
+  using impl::ifLet;
+  using impl::lenPrefixedAt;
+  using impl::mapAll;
+  using impl::matchAll;
+  using impl::matchEach;
   using impl::matched;
   using impl::none;
+  using impl::recur;
+  using impl::sliceAt;
   using impl::some;
+  using impl::tailRec;
+  using impl::TailRec;
+  using impl::u16beAt;
+  using impl::u16leAt;
+  using impl::u32beAt;
+  using impl::u32leAt;
+  using impl::u64beAt;
+  using impl::u64leAt;
+  using impl::u8At;
 } // namespace matchit
 
 #endif // MATCHIT_UTILITY_H
@@ -0,0 +1,98 @@
+module;
+#include "matchit.h"
+export module matchit;
+
+export namespace matchit
+{
+    using ::matchit::AdaptiveMatcher;
+    using ::matchit::Arena;
+    using ::matchit::ByteOrder;
+    using ::matchit::ByteSpan;
+    using ::matchit::Id;
+    using ::matchit::Matcher;
+    using ::matchit::SharedId;
+    using ::matchit::Streamed;
+    using ::matchit::Subrange;
+    using ::matchit::SubrangeT;
+    using ::matchit::TableMatcher;
+    using ::matchit::TailRec;
+    using ::matchit::_;
+    using ::matchit::adaptiveMatcher;
+    using ::matchit::and_;
+    using ::matchit::app;
+    using ::matchit::as;
+    using ::matchit::asDsVia;
+    using ::matchit::bytesOf;
+    using ::matchit::compileMatch;
+    using ::matchit::containsAny;
+    using ::matchit::done;
+    using ::matchit::ds;
+    using ::matchit::dsFields;
+    using ::matchit::dsVia;
+    using ::matchit::expr;
+    using ::matchit::fixedAt;
+    using ::matchit::forkJoin;
+    using ::matchit::glob;
+    using ::matchit::ifLet;
+    using ::matchit::lenPrefixedAt;
+    using ::matchit::likely;
+    using ::matchit::mapAll;
+    using ::matchit::match;
+    using ::matchit::matchAll;
+    using ::matchit::matchConsteval;
+    using ::matchit::matchEach;
+    using ::matchit::matchExhaustive;
+    using ::matchit::matched;
+    using ::matchit::matcher;
+    using ::matchit::meet;
+    using ::matchit::none;
+    using ::matchit::not_;
+    using ::matchit::ooo;
+    using ::matchit::or_;
+    using ::matchit::pattern;
+    using ::matchit::recur;
+    using ::matchit::sliceAt;
+    using ::matchit::some;
+    using ::matchit::streamed;
+    using ::matchit::tableMatcher;
+    using ::matchit::tailRec;
+    using ::matchit::tryMatch;
+    using ::matchit::u16beAt;
+    using ::matchit::u16leAt;
+    using ::matchit::u32beAt;
+    using ::matchit::u32leAt;
+    using ::matchit::u64beAt;
+    using ::matchit::u64leAt;
+    using ::matchit::u8At;
+    using ::matchit::unlikely;
+    using ::matchit::when;
+    using ::matchit::within;
+#if MATCHIT_PROFILE
+    using ::matchit::SiteProfileSnapshot;
+    using ::matchit::dumpProfile;
+    using ::matchit::profileSnapshot;
+#endif // MATCHIT_PROFILE
+#if MATCHIT_TRACE
+    using ::matchit::TraceHook;
+    using ::matchit::setTraceHooks;
+#endif // MATCHIT_TRACE
+    // The DSL's free operators (expression-template arithmetic, the
+    // matchEach pipe) live in impl and are found by ADL inside the
+    // header; importers see only exported names, so re-export them here.
+    using ::matchit::impl::operator+;
+    using ::matchit::impl::operator-;
+    using ::matchit::impl::operator*;
+    using ::matchit::impl::operator/;
+    using ::matchit::impl::operator%;
+    using ::matchit::impl::operator<;
+    using ::matchit::impl::operator<=;
+    using ::matchit::impl::operator==;
+    using ::matchit::impl::operator!=;
+    using ::matchit::impl::operator>=;
+    using ::matchit::impl::operator>;
+    using ::matchit::impl::operator||;
+    using ::matchit::impl::operator&&;
+    using ::matchit::impl::operator^;
+    using ::matchit::impl::operator!;
+    using ::matchit::impl::operator|;
+} // namespace matchit
@@ -1,14 +1,11 @@
 #include "matchit.h"
 #include <iostream>
 
-constexpr auto within = [](auto const &first, auto const &last)
-{
-  // the following one has memory issue since it creates temporary unarys and
-  // capture them via reference when constructing new unarys. return first <= _
-  // && _ <= last;
-  return matchit::meet([&](auto &&v)
-                       { return first <= v && v <= last; });
-};
+// `within` used to be spelled out here as a meet-based matcher:
+//   constexpr auto within = [](auto const &first, auto const &last)
+//   { return matchit::meet([&](auto &&v) { return first <= v && v <= last; }); };
+// It is now part of the library (with bounds stored by value), but any
+// predicate can still be lifted into a pattern the same way via meet.
 
 int main()
 {
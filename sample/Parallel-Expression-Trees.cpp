@@ -0,0 +1,83 @@
+#include "matchit.h"
+#include <iostream>
+#include <memory>
+using namespace matchit;
+
+struct Expr;
+struct Add
+{
+  std::shared_ptr<Expr> lhs, rhs;
+};
+struct Mul
+{
+  std::shared_ptr<Expr> lhs, rhs;
+};
+struct Expr : std::variant<int, Add, Mul>
+{
+  using variant::variant;
+};
+
+namespace std
+{
+  template <>
+  struct variant_size<Expr> : variant_size<Expr::variant>
+  {
+  };
+  template <std::size_t I>
+  struct variant_alternative<I, Expr> : variant_alternative<I, Expr::variant>
+  {
+  };
+} // namespace std
+
+bool operator==(Expr const &l, Expr const &r)
+{
+  return static_cast<std::variant<int, Add, Mul> const &>(l) ==
+         static_cast<std::variant<int, Add, Mul> const &>(r);
+}
+
+const auto asAddDs = asDsVia<Add>(&Add::lhs, &Add::rhs);
+const auto asMulDs = asDsVia<Mul>(&Mul::lhs, &Mul::rhs);
+
+// the two operands bound by an arm are independent: forkJoin evaluates them
+// concurrently near the root of the tree and serially below the cutoff.
+int eval(const Expr &ex, int32_t depth = 0)
+{
+  constexpr int32_t cutoff = 3;
+  Id<int> i;
+  Id<Expr> l, r;
+  return match(ex)(
+      // clang-format off
+        pattern | as<int>(i)                = i,
+        pattern | asAddDs(some(l), some(r)) = [&]{
+          auto const [a, b] = forkJoin(depth, cutoff,
+              [&]{ return eval(*l, depth + 1); },
+              [&]{ return eval(*r, depth + 1); });
+          return a + b;
+        },
+        pattern | asMulDs(some(l), some(r)) = [&]{
+          auto const [a, b] = forkJoin(depth, cutoff,
+              [&]{ return eval(*l, depth + 1); },
+              [&]{ return eval(*r, depth + 1); });
+          return a * b;
+        },
+        pattern | _                         = -1
+      // clang-format on
+  );
+}
+
+std::shared_ptr<Expr> balanced(int32_t levels, int leaf)
+{
+  if (levels == 0)
+  {
+    return std::make_shared<Expr>(leaf);
+  }
+  return std::make_shared<Expr>(
+      Add{balanced(levels - 1, leaf), balanced(levels - 1, leaf)});
+}
+
+int32_t main()
+{
+  // 2^10 leaves of 1, summed: the top three levels fan out across cores.
+  std::cout << eval(*balanced(10, 1)) << std::endl;
+  return 0;
+}
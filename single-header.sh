@@ -1,3 +1,58 @@
 #!/bin/sh
 
 awk 1 develop/header.txt develop/matchit/*.h develop/footer.txt > include/matchit.h
+
+# C++20 module interface unit wrapping the single header: the header is
+# pulled into the global module fragment and the public surface (the
+# `using impl::...` export lists of the develop headers) is re-exported,
+# so C++20 consumers import a precompiled BMI instead of reparsing the
+# 2000+ line header in every TU.
+{
+    printf 'module;\n'
+    printf '#include "matchit.h"\n'
+    printf 'export module matchit;\n'
+    printf '\n'
+    printf 'export namespace matchit\n'
+    printf '{\n'
+    # instrumentation exports only exist when their flag is nonzero; the
+    # header in the global module fragment is compiled with the
+    # importer's flags, so these keep their guards and everything else
+    # is exported unconditionally.
+    grep -h '^[ ]*using impl::' develop/matchit/*.h |
+        sed -e 's/^[ ]*using impl::/    using ::matchit::/' |
+        grep -v -E '::(SiteProfileSnapshot|dumpProfile|profileSnapshot|TraceHook|setTraceHooks);' |
+        sort -u
+    cat <<'GUARDED'
+#if MATCHIT_PROFILE
+    using ::matchit::SiteProfileSnapshot;
+    using ::matchit::dumpProfile;
+    using ::matchit::profileSnapshot;
+#endif // MATCHIT_PROFILE
+#if MATCHIT_TRACE
+    using ::matchit::TraceHook;
+    using ::matchit::setTraceHooks;
+#endif // MATCHIT_TRACE
+GUARDED
+    cat <<'OPS'
+    // The DSL's free operators (expression-template arithmetic, the
+    // matchEach pipe) live in impl and are found by ADL inside the
+    // header; importers see only exported names, so re-export them here.
+    using ::matchit::impl::operator+;
+    using ::matchit::impl::operator-;
+    using ::matchit::impl::operator*;
+    using ::matchit::impl::operator/;
+    using ::matchit::impl::operator%;
+    using ::matchit::impl::operator<;
+    using ::matchit::impl::operator<=;
+    using ::matchit::impl::operator==;
+    using ::matchit::impl::operator!=;
+    using ::matchit::impl::operator>=;
+    using ::matchit::impl::operator>;
+    using ::matchit::impl::operator||;
+    using ::matchit::impl::operator&&;
+    using ::matchit::impl::operator^;
+    using ::matchit::impl::operator!;
+    using ::matchit::impl::operator|;
+OPS
+    printf '} // namespace matchit\n'
+} > include/matchit.ixx
@@ -42,3 +42,32 @@ TEST(App, scalarMut)
   );
   EXPECT_EQ(*x, 20);
 }
+
+// a prvalue projection consumed by a lone Id skips the context slot and
+// is moved into the binding, so move() steals it without a copy.
+TEST(App, prvalueProjectionMovesIntoLoneId)
+{
+  auto const makeName = [](int32_t v)
+  { return std::string(static_cast<std::size_t>(v), 'x'); };
+  Id<std::string> s;
+  auto const moved = match(8)
+  (
+    pattern | app(makeName, s) = [&] { return s.move(); }
+  );
+  EXPECT_EQ(moved, std::string(8, 'x'));
+}
+
+// a composite that tears the projection result apart still gets it
+// materialized in the context, so element bindings stay valid.
+TEST(App, compositeOverProjectionStaysMaterialized)
+{
+  auto const pairUp = [](int32_t v)
+  { return std::make_pair(v, v + 1); };
+  Id<int32_t> a;
+  Id<int32_t> b;
+  auto const sum = match(3)
+  (
+    pattern | app(pairUp, ds(a, b)) = [&] { return *a + *b; }
+  );
+  EXPECT_EQ(sum, 7);
+}
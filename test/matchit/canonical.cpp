@@ -0,0 +1,85 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+using namespace matchit;
+
+// Arm assembly canonicalizes id-free patterns: check the rewritten shapes
+// at the type level, and that match results are unchanged.
+namespace
+{
+  constexpr auto deMorganArm = (pattern | not_(or_(1, 2)) = [] { return 3; });
+  static_assert(
+      std::is_same_v<decltype(deMorganArm)::PatternT,
+                     impl::And<impl::Not<int32_t>, impl::Not<int32_t>>>);
+
+  constexpr auto isEven = [](auto x) constexpr { return x % 2 == 0; };
+  constexpr auto flatArm =
+      (pattern | and_(and_(meet(isEven), within(0, 10)), 4) = [] { return true; });
+  static_assert(std::tuple_size_v<std::decay_t<
+                    decltype(std::declval<decltype(flatArm)::PatternT>()
+                                 .patterns())>> == 3);
+} // namespace
+
+TEST(Canonical, deMorganSemantics)
+{
+  auto const classify = [](int32_t v)
+  {
+    return match(v)(pattern | not_(or_(1, 2)) = 3, pattern | 2 = 2,
+                    pattern | _ = 1);
+  };
+  EXPECT_EQ(classify(1), 1);
+  EXPECT_EQ(classify(2), 2);
+  EXPECT_EQ(classify(3), 3);
+}
+
+TEST(Canonical, doubleNegation)
+{
+  auto const inRange = [](int32_t v)
+  {
+    return match(v)(pattern | not_(not_(within(1, 5))) = true,
+                    pattern | _ = false);
+  };
+  EXPECT_TRUE(inRange(3));
+  EXPECT_FALSE(inRange(7));
+}
+
+TEST(Canonical, flattenedAndSemantics)
+{
+  auto const isEven = [](auto x) { return x % 2 == 0; };
+  auto const f = [&](int32_t v)
+  {
+    return match(v)(
+        pattern | and_(and_(meet(isEven), within(0, 10)), not_(4)) = true,
+        pattern | _ = false);
+  };
+  EXPECT_TRUE(f(6));
+  EXPECT_FALSE(f(4));  // excluded by not_(4).
+  EXPECT_FALSE(f(5));  // odd.
+  EXPECT_FALSE(f(12)); // out of range.
+}
+
+TEST(Canonical, statelessDuplicatesCollapse)
+{
+  // The same captureless meet reused across alternatives is one type; the
+  // duplicate is dropped at arm assembly without changing the result.
+  auto count = 0;
+  auto const negative = meet([](auto x) { return x < 0; });
+  match(5)(pattern | or_(negative, within(10, 20), negative) = [] {},
+           pattern | _ = [&] { ++count; });
+  EXPECT_EQ(count, 1);
+  match(-7)(pattern | or_(negative, within(10, 20), negative) = [&] { ++count; },
+            pattern | _ = [] {});
+  EXPECT_EQ(count, 2);
+}
+
+TEST(Canonical, idSubtreesUntouched)
+{
+  // at() is and_(pattern, id); id-carrying conjunctions keep their shape
+  // so binding depths are unchanged.
+  Id<int32_t> x;
+  auto const r = match(42)(
+      pattern | and_(and_(within(0, 100), x), not_(or_(1, 2))) = [&]
+      { return *x; },
+      pattern | _ = [] { return -1; });
+  EXPECT_EQ(r, 42);
+}
@@ -0,0 +1,76 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+using namespace matchit;
+
+TEST(Decode, fixedWidthFields)
+{
+  // 0xBEEF big-endian at 0, 0x01020304 little-endian at 2.
+  std::vector<uint8_t> const frame = {0xBEU, 0xEFU, 0x04U, 0x03U, 0x02U, 0x01U};
+  Id<uint16_t> tag;
+  Id<uint32_t> seq;
+  auto const matched = match(bytesOf(frame))(
+      pattern | and_(u16beAt<0>(tag), u32leAt<2>(seq)) = [&]
+      { return *tag == 0xBEEFU && *seq == 0x01020304U; },
+      pattern | _ = false);
+  EXPECT_TRUE(matched);
+}
+
+TEST(Decode, shortBufferFailsCleanly)
+{
+  std::vector<uint8_t> const frame = {0xBEU};
+  auto const result = match(bytesOf(frame))(
+      pattern | u16beAt<0>(_) = 1,
+      pattern | _ = 0);
+  EXPECT_EQ(result, 0);
+}
+
+TEST(Decode, lengthPrefixedSliceIsZeroCopy)
+{
+  std::vector<uint8_t> const frame = {0x01U, 0x00U, 0x03U, 0xAAU, 0xBBU,
+                                      0xCCU, 0xFFU};
+  Id<ByteSpan> payload;
+  auto const matched = match(bytesOf(frame))(
+      pattern | and_(u8At<0>(1), lenPrefixedAt<uint16_t, 1>(payload)) = [&]
+      {
+        // the slice aliases the original buffer: no bytes were copied.
+        EXPECT_EQ((*payload).data(), frame.data() + 3);
+        return (*payload).size() == 3U;
+      },
+      pattern | _ = false);
+  EXPECT_TRUE(matched);
+}
+
+TEST(Decode, lengthPrefixTruncatedPayload)
+{
+  // declared length 5 but only 2 payload bytes follow.
+  std::vector<uint8_t> const frame = {0x05U, 0xAAU, 0xBBU};
+  auto const result = match(bytesOf(frame))(
+      pattern | lenPrefixedAt<uint8_t, 0>(_) = 1,
+      pattern | _ = 0);
+  EXPECT_EQ(result, 0);
+}
+
+TEST(Decode, dsOverByteSpan)
+{
+  std::vector<uint8_t> const frame = {0x7EU, 1U, 2U, 3U, 0x7EU};
+  Id<ByteSpan> body;
+  auto const matched = match(bytesOf(frame))(
+      pattern | ds(0x7EU, body.at(ooo), 0x7EU) = [&]
+      { return *body == std::vector<uint8_t>{1U, 2U, 3U}; },
+      pattern | _ = false);
+  EXPECT_TRUE(matched);
+}
+
+TEST(Decode, restSlice)
+{
+  std::vector<uint8_t> const frame = {9U, 8U, 7U, 6U};
+  Id<ByteSpan> rest;
+  match(bytesOf(frame))(
+      pattern | sliceAt<2>(rest) = [&]
+      {
+        EXPECT_EQ((*rest).size(), 2U);
+        EXPECT_EQ((*rest)[0], 7U);
+      });
+}
@@ -0,0 +1,806 @@
+// .report() emits its compile-time DispatchReport note as a deprecation
+// warning; silence it TU-wide (instantiation-time diagnostics ignore
+// push/pop around the call site) so the suite can assert the part that
+// must not change — the match result.
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <any>
+#include <string>
+#include <thread>
+#include <tuple>
+using namespace matchit;
+
+TEST(Dispatch, integralLiterals)
+{
+  auto const classify = [](int32_t op)
+  {
+    return match(op)(
+        pattern | 1 = "one",
+        pattern | 2 = "two",
+        pattern | 3 = "three",
+        pattern | _ = "many");
+  };
+  EXPECT_STREQ(classify(1), "one");
+  EXPECT_STREQ(classify(2), "two");
+  EXPECT_STREQ(classify(3), "three");
+  EXPECT_STREQ(classify(42), "many");
+}
+
+TEST(Dispatch, integralLiteralsFirstMatchWins)
+{
+  auto const result = match(5)(
+      pattern | 5 = 1,
+      pattern | 5 = 2,
+      pattern | _ = 3);
+  EXPECT_EQ(result, 1);
+}
+
+TEST(Dispatch, integralLiteralsNoMatchThrows)
+{
+  auto const f = []
+  {
+    return match(4)(
+        pattern | 1 = 1,
+        pattern | 2 = 2);
+  };
+  EXPECT_THROW(f(), std::logic_error);
+}
+
+TEST(Dispatch, integralLiteralsStatement)
+{
+  int32_t hit = 0;
+  match(2)(
+      pattern | 1 = [&] { hit = 1; },
+      pattern | 2 = [&] { hit = 2; });
+  EXPECT_EQ(hit, 2);
+}
+
+TEST(Dispatch, integralLiteralsConstexpr)
+{
+  constexpr auto result = match(3)(
+      pattern | 1 = 10,
+      pattern | 3 = 30,
+      pattern | _ = 0);
+  static_assert(result == 30);
+  EXPECT_EQ(result, 30);
+}
+
+TEST(Dispatch, stringLiterals)
+{
+  auto const route = [](std::string const &method)
+  {
+    return match(method)(
+        pattern | "get"    = 1,
+        pattern | "put"    = 2,
+        pattern | "delete" = 3,
+        pattern | _        = 0);
+  };
+  EXPECT_EQ(route("get"), 1);
+  EXPECT_EQ(route("put"), 2);
+  EXPECT_EQ(route("delete"), 3);
+  EXPECT_EQ(route("patch"), 0);
+}
+
+TEST(Dispatch, stringLiteralsCharPointerValue)
+{
+  // matches by content, not by pointer identity.
+  std::string const s = "bar";
+  auto const result = match(s.c_str())(
+      pattern | "foo" = 1,
+      pattern | "bar" = 2,
+      pattern | _     = 0);
+  EXPECT_EQ(result, 2);
+}
+
+TEST(Dispatch, stringLiteralsNoMatchThrows)
+{
+  auto const f = []
+  {
+    return match(std::string{"baz"})(
+        pattern | "foo" = 1,
+        pattern | "bar" = 2);
+  };
+  EXPECT_THROW(f(), std::logic_error);
+}
+
+TEST(Dispatch, tryMatchReturnsOptional)
+{
+  auto const asDigit = [](char c)
+  {
+    return tryMatch(c)(
+        pattern | within('0', '9') = [c] { return c - '0'; });
+  };
+  EXPECT_EQ(asDigit('7'), std::optional<int32_t>{7});
+  EXPECT_EQ(asDigit('x'), std::nullopt);
+}
+
+TEST(Dispatch, tryMatchProbesPatternSetsInSequence)
+{
+  // probing parser shape: fall through to the next pattern set on a miss
+  // without sentinel arms or exception handling.
+  auto const parse = [](std::string const &token)
+  {
+    Id<std::size_t> n;
+    if (auto const keyword = tryMatch(token)(
+            pattern | "if"    = 1,
+            pattern | "while" = 2))
+    {
+      return *keyword;
+    }
+    if (auto const number = tryMatch(token.size())(
+            pattern | n.at(meet([](auto len) { return len <= 3; })) = [&]
+            { return 100 + static_cast<int32_t>(*n); }))
+    {
+      return *number;
+    }
+    return -1;
+  };
+  EXPECT_EQ(parse("while"), 2);
+  EXPECT_EQ(parse("ab"), 102);
+  EXPECT_EQ(parse("abcdef"), -1);
+}
+
+TEST(Dispatch, tryMatchBindsAndPinsRetType)
+{
+  Id<int32_t> x;
+  auto const halved = tryMatch<double>(8)(
+      pattern | x.at(app(_ % 2, 0)) = x / 2);
+  EXPECT_EQ(halved, std::optional<double>{4.0});
+  Id<int32_t> y;
+  auto const odd = tryMatch<double>(9)(
+      pattern | y.at(app(_ % 2, 0)) = y / 2);
+  EXPECT_EQ(odd, std::nullopt);
+}
+
+TEST(Dispatch, containsAnyClassifiesByHitLiteral)
+{
+  // one automaton scan per line instead of a find() per literal; the Id
+  // binds whichever literal hit.
+  static auto const severity = containsAny("fatal", "error", "warn");
+  auto const route = [](std::string const &line)
+  {
+    Id<std::string_view> hit;
+    return match(line)(
+        pattern | severity(hit) = [&]
+        { return *hit == "warn" ? 1 : 2; },
+        pattern | _ = 0);
+  };
+  EXPECT_EQ(route("disk error: retrying"), 2);
+  EXPECT_EQ(route("warn: low space"), 1);
+  EXPECT_EQ(route("all good"), 0);
+}
+
+TEST(Dispatch, containsAnyLeftmostAndOverlaps)
+{
+  static auto const which = containsAny("she", "he", "hers");
+  auto const firstHit = [](char const *text)
+  {
+    Id<std::string_view> hit;
+    return match(text)(
+        pattern | which(hit) = [&]
+        { return std::string{*hit}; },
+        pattern | _ = [] { return std::string{"none"}; });
+  };
+  // "she" and "he" end at the same position; the longer occurrence wins.
+  EXPECT_EQ(firstHit("ushers"), "she");
+  EXPECT_EQ(firstHit("the end"), "he");
+  EXPECT_EQ(firstHit("nothing"), "none");
+  // plain containment test: inner pattern _ discards the hit.
+  EXPECT_TRUE(matched("hers", which(_)));
+}
+
+TEST(Dispatch, variantAsArms)
+{
+  auto const describe = [](std::variant<int32_t, float, std::string> const &v)
+  {
+    Id<int32_t> i;
+    Id<float> f;
+    Id<std::string> s;
+    return match(v)(
+        pattern | as<int32_t>(i)     = [&] { return "int"; },
+        pattern | as<float>(f)       = [&] { return "float"; },
+        pattern | as<std::string>(s) = [&] { return "string"; });
+  };
+  EXPECT_STREQ(describe(1), "int");
+  EXPECT_STREQ(describe(1.5F), "float");
+  EXPECT_STREQ(describe(std::string{"x"}), "string");
+}
+
+TEST(Dispatch, variantAsArmsFallThroughOnGuard)
+{
+  // An index hit does not commit to the arm: a failing guard must still
+  // fall through to later arms over the same alternative.
+  Id<int32_t> i;
+  auto const v = std::variant<int32_t, float>{3};
+  auto const result = match(v)(
+      pattern | as<int32_t>(i) | when(i > 10) = 1,
+      pattern | as<int32_t>(_)                = 2,
+      pattern | _                             = 3);
+  EXPECT_EQ(result, 2);
+}
+
+TEST(Dispatch, anyAsArms)
+{
+  Id<int32_t> i;
+  Id<std::string> s;
+  auto const describe = [&](std::any const &a)
+  {
+    return match(a)(
+        pattern | as<int32_t>(i)     = [&] { return "int"; },
+        pattern | as<std::string>(s) = [&] { return "string"; },
+        pattern | _                  = [&] { return "other"; });
+  };
+  EXPECT_STREQ(describe(1), "int");
+  EXPECT_STREQ(describe(std::string{"x"}), "string");
+  EXPECT_STREQ(describe(1.5), "other");
+}
+
+namespace sealed
+{
+  struct Shape
+  {
+    enum class Kind
+    {
+      kCIRCLE,
+      kSQUARE
+    } kind;
+  };
+  struct Circle : Shape
+  {
+    constexpr static Kind k = Kind::kCIRCLE;
+    int32_t radius;
+  };
+  struct Square : Shape
+  {
+    constexpr static Kind k = Kind::kSQUARE;
+    int32_t side;
+  };
+  inline bool operator==(Circle const &lhs, Circle const &rhs)
+  {
+    return lhs.radius == rhs.radius;
+  }
+  inline bool operator==(Square const &lhs, Square const &rhs)
+  {
+    return lhs.side == rhs.side;
+  }
+} // namespace sealed
+
+TEST(Dispatch, sealedKindTagAs)
+{
+  // no virtual functions and no user get_if: as<Derived> resolves through
+  // the kind tag with a static_cast.
+  using namespace sealed;
+  Id<Circle> c;
+  Id<Square> sq;
+  auto const area = [&](Shape const &s)
+  {
+    return match(s)(
+        pattern | as<Circle>(c) = [&] { return 3 * (*c).radius * (*c).radius; },
+        pattern | as<Square>(sq) = [&] { return (*sq).side * (*sq).side; });
+  };
+  Circle const circle{{Shape::Kind::kCIRCLE}, 2};
+  Square const square{{Shape::Kind::kSQUARE}, 3};
+  EXPECT_EQ(area(circle), 12);
+  EXPECT_EQ(area(square), 9);
+}
+
+namespace poly
+{
+  struct Base
+  {
+    virtual ~Base() = default;
+  };
+  struct Mid : Base
+  {
+  };
+  struct Leaf : Mid
+  {
+    bool operator==(Leaf const &) const { return true; }
+  };
+} // namespace poly
+
+TEST(Dispatch, polymorphicExactTypeFastPath)
+{
+  using namespace poly;
+  Leaf const leaf;
+  Base const &b = leaf;
+  // exact dynamic type: resolved without dynamic_cast.
+  EXPECT_TRUE(matched(b, as<Leaf>(_)));
+  // intermediate base: still found via the dynamic_cast fallback.
+  EXPECT_TRUE(matched(b, as<Mid>(_)));
+  Mid const mid;
+  Base const &bm = mid;
+  EXPECT_FALSE(matched(bm, as<Leaf>(_)));
+}
+
+TEST(Dispatch, literalDsArms)
+{
+  auto const logic = [](bool a, bool b)
+  {
+    return match(a, b)(
+        pattern | ds(true, true)   = 3,
+        pattern | ds(true, false)  = 2,
+        pattern | ds(false, true)  = 1,
+        pattern | ds(false, false) = 0);
+  };
+  EXPECT_EQ(logic(true, true), 3);
+  EXPECT_EQ(logic(true, false), 2);
+  EXPECT_EQ(logic(false, true), 1);
+  EXPECT_EQ(logic(false, false), 0);
+}
+
+TEST(Dispatch, literalDsArmsWithWildcards)
+{
+  auto const f = [](int32_t x, int32_t y)
+  {
+    return match(x, y)(
+        pattern | ds(0, 0) = 1,
+        pattern | ds(0, _) = 2,
+        pattern | ds(_, 0) = 3,
+        pattern | _        = 4);
+  };
+  EXPECT_EQ(f(0, 0), 1);
+  EXPECT_EQ(f(0, 9), 2);
+  EXPECT_EQ(f(9, 0), 3);
+  EXPECT_EQ(f(9, 9), 4);
+}
+
+TEST(Dispatch, literalDsArmsColumnOrdering)
+{
+  // the event column (right) discriminates more arms than the state
+  // column (left, mostly wildcarded); columns are reordered internally
+  // but arms still win strictly in source order.
+  auto const step = [](int32_t state, int32_t event)
+  {
+    return match(state, event)(
+        pattern | ds(_, 1) = 10,
+        pattern | ds(_, 2) = 20,
+        pattern | ds(0, 3) = 30,
+        pattern | ds(_, 3) = 31,
+        pattern | _        = 0);
+  };
+  EXPECT_EQ(step(5, 1), 10);
+  EXPECT_EQ(step(5, 2), 20);
+  EXPECT_EQ(step(0, 3), 30);
+  EXPECT_EQ(step(7, 3), 31);
+  EXPECT_EQ(step(7, 9), 0);
+}
+
+TEST(Dispatch, literalDsArmsOverTupleValue)
+{
+  auto const t = std::make_tuple(1, 2);
+  auto const result = match(t)(
+      pattern | ds(1, 1) = 11,
+      pattern | ds(1, 2) = 12,
+      pattern | _        = 0);
+  EXPECT_EQ(result, 12);
+}
+
+enum class Op
+{
+  kADD,
+  kSUB
+};
+
+TEST(Dispatch, enumLiterals)
+{
+  auto const name = [](Op op)
+  {
+    return match(op)(
+        pattern | Op::kADD = "add",
+        pattern | Op::kSUB = "sub",
+        pattern | _        = "?");
+  };
+  EXPECT_STREQ(name(Op::kADD), "add");
+  EXPECT_STREQ(name(Op::kSUB), "sub");
+  EXPECT_STREQ(name(static_cast<Op>(9)), "?");
+}
+
+TEST(Dispatch, exhaustiveEnum)
+{
+  auto const apply = [](Op op, int32_t x, int32_t y)
+  {
+    return matchExhaustive(op)(
+        pattern | Op::kADD = x + y,
+        pattern | Op::kSUB = x - y);
+  };
+  EXPECT_EQ(apply(Op::kADD, 5, 3), 8);
+  EXPECT_EQ(apply(Op::kSUB, 5, 3), 2);
+}
+
+TEST(Dispatch, exhaustiveVariant)
+{
+  // covering every alternative passes the static coverage check; dropping
+  // an arm here is a compile error.
+  Id<int32_t> i;
+  Id<float> f;
+  auto const v = std::variant<int32_t, float>{2.5F};
+  auto const result = matchExhaustive(v)(
+      pattern | as<int32_t>(i) = [&] { return *i; },
+      pattern | as<float>(f) = [&] { return static_cast<int32_t>(*f); });
+  EXPECT_EQ(result, 2);
+}
+
+TEST(Dispatch, exhaustiveConstexpr)
+{
+  constexpr auto result = matchExhaustive(2)(
+      pattern | 1 = 10,
+      pattern | 2 = 20,
+      pattern | _ = 0);
+  static_assert(result == 20);
+  EXPECT_EQ(result, 20);
+}
+
+TEST(Dispatch, withinIntervals)
+{
+  auto const bucket = [](int32_t latency)
+  {
+    return match(latency)(
+        pattern | within(0, 9)    = 0,
+        pattern | within(10, 99)  = 1,
+        pattern | within(100, 999) = 2,
+        pattern | _               = 3);
+  };
+  EXPECT_EQ(bucket(0), 0);
+  EXPECT_EQ(bucket(9), 0);
+  EXPECT_EQ(bucket(10), 1);
+  EXPECT_EQ(bucket(555), 2);
+  EXPECT_EQ(bucket(-1), 3);
+  EXPECT_EQ(bucket(1000), 3);
+}
+
+TEST(Dispatch, withinNonIntegral)
+{
+  EXPECT_TRUE(matched(2.5, within(1.0, 3.0)));
+  EXPECT_FALSE(matched(3.5, within(1.0, 3.0)));
+  constexpr auto inRange = matched(5, within(1, 10));
+  static_assert(inRange);
+  EXPECT_TRUE(inRange);
+}
+
+TEST(Dispatch, orOverLiterals)
+{
+  auto const isVowel = [](char c)
+  {
+    return match(c)(
+        pattern | or_('a', 'e', 'i', 'o', 'u') = true,
+        pattern | _                            = false);
+  };
+  EXPECT_TRUE(isVowel('e'));
+  EXPECT_FALSE(isVowel('x'));
+
+  constexpr auto inSet = match(7)(
+      pattern | or_(1, 3, 5, 7, 9) = true,
+      pattern | _                  = false);
+  static_assert(inSet);
+  EXPECT_TRUE(inSet);
+}
+
+TEST(Dispatch, reusableMatcher)
+{
+  // arms are built once and reused per value; each invocation starts with
+  // fresh bindings instead of equality checks against the previous call.
+  Id<int32_t> i;
+  auto const classify = matcher(
+      pattern | app(_ % 2, 0) = [] { return 0; },
+      pattern | i             = [&] { return *i; });
+  EXPECT_EQ(classify(4), 0);
+  EXPECT_EQ(classify(5), 5);
+  EXPECT_EQ(classify(7), 7);
+}
+
+TEST(Dispatch, matcherInLoop)
+{
+  Id<int32_t> i;
+  auto const step = matcher(
+      pattern | 0 = [] { return -1; },
+      pattern | i = [&] { return *i - 1; });
+  int32_t n = 5;
+  int32_t iterations = 0;
+  while ((n = step(n)) >= 0)
+  {
+    ++iterations;
+  }
+  EXPECT_EQ(iterations, 5);
+}
+TEST(Dispatch, compiledMatchShared)
+{
+  // Id-free arms make the compiled object immutable: one static instance
+  // serves every caller, including concurrent ones.
+  static constexpr auto classify = compileMatch(
+      pattern | within(0, 9)  = 1,
+      pattern | app(_ % 2, 0) = 2,
+      pattern | _             = 3);
+  EXPECT_EQ(classify(5), 1);
+  EXPECT_EQ(classify(14), 2);
+  EXPECT_EQ(classify(15), 3);
+  int32_t results[2] = {};
+  std::thread t1{[&] { results[0] = classify(42); }};
+  std::thread t2{[&] { results[1] = classify(7); }};
+  t1.join();
+  t2.join();
+  EXPECT_EQ(results[0], 2);
+  EXPECT_EQ(results[1], 1);
+}
+
+TEST(Dispatch, compiledMatchConstexpr)
+{
+  constexpr auto sign = compileMatch(
+      pattern | meet([](auto x) { return x > 0; }) = 1,
+      pattern | 0                                  = 0,
+      pattern | _                                  = -1);
+  constexpr auto result = sign(-3);
+  static_assert(result == -1);
+  EXPECT_EQ(sign(3), 1);
+  EXPECT_EQ(sign(0), 0);
+  EXPECT_EQ(result, -1);
+}
+
+TEST(Dispatch, likelyAnnotationKeepsSemantics)
+{
+  // the annotation is a pure codegen hint: literal arms keep the flat
+  // dispatch fast path and every arm matches exactly as without it.
+  auto const sizeClass = [](int32_t n)
+  {
+    return match(n)(
+        pattern | 16 | likely()   = 0,
+        pattern | 64              = 1,
+        pattern | 256 | unlikely()= 2,
+        pattern | _               = 3);
+  };
+  EXPECT_EQ(sizeClass(16), 0);
+  EXPECT_EQ(sizeClass(64), 1);
+  EXPECT_EQ(sizeClass(256), 2);
+  EXPECT_EQ(sizeClass(1024), 3);
+}
+
+TEST(Dispatch, likelyComposesWithBindingsAndGuards)
+{
+  Id<int32_t> i;
+  auto const result = match(std::make_pair(3, 4))(
+      pattern | ds(i, 4) | when([&] { return *i > 0; }) | likely() =
+          [&] { return *i; },
+      pattern | _ = -1);
+  EXPECT_EQ(result, 3);
+  constexpr auto sign = match(5)(
+      pattern | (_ > 0) | likely() = 1,
+      pattern | _                  = 0);
+  static_assert(sign == 1);
+  EXPECT_EQ(sign, 1);
+}
+
+TEST(Dispatch, adaptiveMatcherReordersHotArms)
+{
+  // disjoint literal arms with skewed traffic: after enough hits the hot
+  // arm moves to the front of the trial order; the catch-all stays last.
+  auto const classify = adaptiveMatcher(
+      pattern | 1 = 'a',
+      pattern | 2 = 'b',
+      pattern | 3 = 'c',
+      pattern | _ = 'z');
+  for (int32_t i = 0; i != 3000; ++i)
+  {
+    EXPECT_EQ(classify(3), 'c');
+  }
+  EXPECT_EQ(classify.trialOrder()[0], 2U);
+  EXPECT_EQ(classify.trialOrder().back(), 3U);
+  // results stay those of the source arms regardless of trial order.
+  EXPECT_EQ(classify(1), 'a');
+  EXPECT_EQ(classify(2), 'b');
+  EXPECT_EQ(classify(9), 'z');
+}
+
+TEST(Dispatch, adaptiveMatcherRebindsIds)
+{
+  Id<int32_t> i;
+  auto const next = adaptiveMatcher(
+      pattern | 0 = [] { return -1; },
+      pattern | i = [&] { return *i + 1; });
+  EXPECT_EQ(next(0), -1);
+  EXPECT_EQ(next(5), 6);
+  EXPECT_EQ(next(7), 8);
+}
+
+TEST(Dispatch, sharedIdBasics)
+{
+  // SharedId binds, guards and equality-checks like Id; only the storage
+  // location differs. Bindings survive a successful match, as with Id.
+  SharedId<int32_t> x;
+  EXPECT_EQ(match(5)(pattern | x = x * x), 25);
+  EXPECT_TRUE(x.hasValue());
+  EXPECT_EQ(*x, 5);
+  SharedId<int32_t> y;
+  auto const samePair = match(std::make_pair(3, 3))(
+      pattern | ds(y, y) = true,
+      pattern | _        = false);
+  EXPECT_TRUE(samePair);
+  SharedId<int32_t> z;
+  EXPECT_EQ(match(-4)(
+                pattern | z.at(meet([](auto v) { return v < 0; })) = -z,
+                pattern | z                                        = z),
+            4);
+}
+
+TEST(Dispatch, sharedIdStaticArmsAcrossThreads)
+{
+  // the pattern tree is immutable (SharedId holds just a slot index), so
+  // one static arm set serves concurrent threads, each with its own
+  // thread-local bindings. Plain Id here would race on the block.
+  static SharedId<int32_t> n;
+  static auto const negate = matcher(
+      pattern | 0 = 0,
+      pattern | n = -n);
+  auto const hammer = [](int32_t base, bool &ok)
+  {
+    ok = true;
+    for (int32_t v = base; v != base + 1000; ++v)
+    {
+      ok = ok && (negate(v) == -v);
+    }
+  };
+  bool ok1 = false;
+  bool ok2 = false;
+  std::thread t1{[&] { hammer(1, ok1); }};
+  std::thread t2{[&] { hammer(100000, ok2); }};
+  t1.join();
+  t2.join();
+  EXPECT_TRUE(ok1);
+  EXPECT_TRUE(ok2);
+}
+
+namespace
+{
+  enum class Conn : int32_t
+  {
+    kIdle,
+    kOpen,
+    kClosed
+  };
+  enum class Event : int32_t
+  {
+    kConnect,
+    kData,
+    kHangup
+  };
+} // namespace
+
+TEST(Dispatch, tableMatcherTransitions)
+{
+  // the (state, event) matrix is baked into a table at construction; a
+  // transition is one lookup instead of a scan over every ds arm.
+  static constexpr auto step = tableMatcher<3, 3>(
+      pattern | ds(Conn::kIdle, Event::kConnect) = Conn::kOpen,
+      pattern | ds(Conn::kOpen, Event::kData)    = Conn::kOpen,
+      pattern | ds(Conn::kOpen, Event::kHangup)  = Conn::kClosed,
+      pattern | ds(_, _)                         = Conn::kIdle);
+  static_assert(step(Conn::kIdle, Event::kConnect) == Conn::kOpen);
+  static_assert(step(Conn::kOpen, Event::kHangup) == Conn::kClosed);
+  EXPECT_EQ(step(Conn::kIdle, Event::kConnect), Conn::kOpen);
+  EXPECT_EQ(step(Conn::kOpen, Event::kData), Conn::kOpen);
+  EXPECT_EQ(step(Conn::kClosed, Event::kData), Conn::kIdle);
+}
+
+TEST(Dispatch, tableMatcherFirstMatchWinsAndMisses)
+{
+  // overlapping arms resolve in source order when the table is built; a
+  // cell no arm covers throws like a non-exhaustive match expression.
+  auto const label = tableMatcher<2, 2>(
+      pattern | ds(0, _) = 'r',
+      pattern | ds(0, 1) = 'x', // shadowed by the row wildcard above
+      pattern | ds(1, 0) = 'c');
+  EXPECT_EQ(label(0, 1), 'r');
+  EXPECT_EQ(label(1, 0), 'c');
+  EXPECT_THROW(label(1, 1), std::logic_error);
+  // out-of-domain values miss the table but still reach wildcard arms.
+  auto const wide = tableMatcher<2, 2>(
+      pattern | ds(0, 0) = 1,
+      pattern | ds(_, _) = 2);
+  EXPECT_EQ(wide(7, 9), 2);
+}
+
+namespace
+{
+  struct Header
+  {
+    int32_t size;
+  };
+  int32_t parseCalls = 0;
+  // named at namespace scope so every arm shares one closure type.
+  auto const parseSize = [](Header const &h)
+  {
+    ++parseCalls;
+    return h.size;
+  };
+} // namespace
+
+TEST(Dispatch, sharedProjectionHoisted)
+{
+  // every arm applies the same unary: the projection runs once for the
+  // whole arm set, not once per arm.
+  parseCalls = 0;
+  auto const result = match(Header{42})(
+      pattern | app(parseSize, 1)  = 1,
+      pattern | app(parseSize, 2)  = 2,
+      pattern | app(parseSize, 42) = 3,
+      pattern | _                  = 0);
+  EXPECT_EQ(result, 3);
+  EXPECT_EQ(parseCalls, 1);
+}
+
+TEST(Dispatch, sharedProjectionBindsId)
+{
+  parseCalls = 0;
+  Id<int32_t> s;
+  auto const result = match(Header{7})(
+      pattern | app(parseSize, 100) = 100,
+      pattern | app(parseSize, s)   = s);
+  EXPECT_EQ(result, 7);
+  EXPECT_EQ(parseCalls, 1);
+}
+
+namespace
+{
+  struct Edge
+  {
+    int32_t from;
+    int32_t to;
+  };
+} // namespace
+
+TEST(Dispatch, distinctMemberProjectionsNotHoisted)
+{
+  // same member-pointer type but different members: the instances disagree
+  // at match time, so each arm keeps its own projection.
+  auto const result = match(Edge{1, 2})(
+      pattern | app(&Edge::from, 9) = 9,
+      pattern | app(&Edge::to, 2)   = 2,
+      pattern | _                   = 0);
+  EXPECT_EQ(result, 2);
+}
+
+TEST(Dispatch, sameMemberProjectionHoisted)
+{
+  auto const result = match(Edge{1, 2})(
+      pattern | app(&Edge::from, 0) = 0,
+      pattern | app(&Edge::from, 1) = 1,
+      pattern | _                   = -1);
+  EXPECT_EQ(result, 1);
+}
+
+TEST(Dispatch, reportLeavesResultUnchanged)
+{
+  auto const flat = match(2).report()(
+      pattern | 1 = 10,
+      pattern | 2 = 20,
+      pattern | _ = 30);
+  EXPECT_EQ(flat, 20);
+
+  Id<int32_t> x;
+  auto const guarded = match(7).report()(
+      pattern | x | when(x > 5) = 1,
+      pattern | _               = 0);
+  EXPECT_EQ(guarded, 1);
+}
+
+TEST(Dispatch, stringViewArmsTakeFlatPath)
+{
+  using namespace std::literals;
+  // string_view and char const * arms mix on the flat length-first path.
+  static_assert(impl::isStrEqDispatchArmV<std::string_view, std::string_view>);
+  static_assert(impl::isStrEqDispatchArmV<std::string_view, char const *>);
+  auto const classify = [](std::string_view verb)
+  {
+    return match(verb)(
+        pattern | "GET"sv  = 1,
+        pattern | "PUT"sv  = 2,
+        pattern | "POST"   = 3,
+        pattern | _        = 0);
+  };
+  EXPECT_EQ(classify("GET"), 1);
+  EXPECT_EQ(classify("PUT"), 2);
+  EXPECT_EQ(classify("POST"), 3);
+  EXPECT_EQ(classify("DELETE"), 0);
+}
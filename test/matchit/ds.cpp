@@ -1,6 +1,8 @@
 #include "matchit.h"
 #include <gtest/gtest.h>
+#include <iterator>
 #include <list>
+#include <sstream>
 #include <utility>
 
 using namespace matchit;
@@ -309,4 +311,293 @@ TEST(Ds, mapOooAtBinder)
                                              auto const expected = {std::make_pair(456, "b"), std::make_pair(789, "c")};
                                              expectRange(*subrange, expected);
                                            });
-}
\ No newline at end of file
+}
+TEST(Ds, arenaOooBinder)
+{
+  unsigned char buffer[256];
+  Arena arena{buffer};
+  auto const vec = std::vector<int32_t>{123, 456, 789};
+  Id<SubrangeT<decltype(vec)>> subrange;
+  // the binding context lives in the caller's arena, and the buffer is
+  // reused across iterations instead of re-carved from each stack frame.
+  for (int32_t i = 0; i < 3; ++i)
+  {
+    auto const matched = match(arena, vec)(
+        pattern | ds(123, subrange.at(ooo)) = [&]
+        { return (*subrange).size() == 2; },
+        pattern | _ = false);
+    EXPECT_TRUE(matched);
+  }
+}
+
+TEST(Ds, arenaStatementMatch)
+{
+  unsigned char buffer[128];
+  Arena arena{buffer};
+  auto const vec = std::vector<int32_t>{1, 2, 3};
+  Id<SubrangeT<decltype(vec)>> subrange;
+  int32_t sum = 0;
+  match(arena, vec)(
+      pattern | ds(1, subrange.at(ooo)) = [&]
+      {
+        for (auto const v : *subrange)
+        {
+          sum += v;
+        }
+      });
+  EXPECT_EQ(sum, 5);
+}
+
+TEST(Ds, listElementWiseSinglePass)
+{
+  // element patterns advance one shared iterator, so matching stays linear
+  // over bidirectional iterators; bindings still land on the right nodes.
+  auto const list = std::list<int32_t>{1, 2, 3, 4, 5};
+  Id<int32_t> b, d;
+  auto const result = match(list)(
+      pattern | ds(1, b, 3, d, 5) = [&]
+      { return *b * 10 + *d; },
+      pattern | _ = -1);
+  EXPECT_EQ(result, 24);
+}
+
+TEST(Ds, lengthDispatchAcrossArms)
+{
+  // fixed-arity ds arms are pre-filtered on size(): only the arm of the
+  // right length runs its element patterns.
+  auto const frame = [](std::vector<int32_t> const &v)
+  {
+    Id<int32_t> a, b;
+    return match(v)(
+        pattern | ds(a)          = [&] { return *a; },
+        pattern | ds(a, b)       = [&] { return *a + *b; },
+        pattern | ds(a, _, b)    = [&] { return *a * *b; },
+        pattern | _              = -1);
+  };
+  EXPECT_EQ(frame({7}), 7);
+  EXPECT_EQ(frame({3, 4}), 7);
+  EXPECT_EQ(frame({3, 9, 4}), 12);
+  EXPECT_EQ(frame({}), -1);
+  EXPECT_EQ(frame({1, 2, 3, 4}), -1);
+}
+
+TEST(Ds, subrangeBulkEquality)
+{
+  // contiguous byte slices compare as one memcmp, not an element loop.
+  std::array<uint8_t, 6> const frame = {0xDEU, 0xADU, 1U, 2U, 3U, 4U};
+  Id<SubrangeT<decltype(frame)>> rest;
+  auto const magic = std::vector<uint8_t>{1U, 2U, 3U, 4U};
+  auto const matched = match(frame)(
+      pattern | ds(0xDEU, 0xADU, rest.at(ooo)) = [&]
+      { return *rest == magic; },
+      pattern | _ = false);
+  EXPECT_TRUE(matched);
+}
+
+TEST(Ds, subrangeSpanAccess)
+{
+  std::array<int32_t, 4> const arr = {10, 20, 30, 40};
+  Id<SubrangeT<decltype(arr)>> rest;
+  match(arr)(
+      pattern | ds(10, rest.at(ooo)) = [&]
+      {
+        // pointer-iterator slices model a span over the original buffer.
+        EXPECT_EQ((*rest).data(), &arr[1]);
+        EXPECT_EQ((*rest)[0], 20);
+        EXPECT_EQ((*rest)[2], 40);
+      });
+}
+
+TEST(Ds, streamExactArity)
+{
+  // single-pass source: istream_iterator can only be walked once.
+  std::istringstream in{"1 2 3"};
+  Id<int32_t> b;
+  auto const result = match(streamed(std::istream_iterator<int32_t>{in},
+                                     std::istream_iterator<int32_t>{}))(
+      pattern | ds(1, b, 3) = [&]
+      { return *b; },
+      pattern | _ = -1);
+  EXPECT_EQ(result, 2);
+}
+
+TEST(Ds, streamOooSuffix)
+{
+  // only the two-element suffix is buffered; the skipped middle streams
+  // through a fixed-size ring.
+  std::istringstream in{"7 1 2 3 4 8 9"};
+  Id<int32_t> first, last;
+  auto const result = match(streamed(std::istream_iterator<int32_t>{in},
+                                     std::istream_iterator<int32_t>{}))(
+      pattern | ds(first, ooo, 8, last) = [&]
+      { return *first * 10 + *last; },
+      pattern | _ = -1);
+  EXPECT_EQ(result, 79);
+}
+
+TEST(Ds, streamTooShort)
+{
+  std::istringstream in{"1"};
+  auto const result = match(streamed(std::istream_iterator<int32_t>{in},
+                                     std::istream_iterator<int32_t>{}))(
+      pattern | ds(1, _, ooo) = 0,
+      pattern | _ = -1);
+  EXPECT_EQ(result, -1);
+}
+
+TEST(Ds, arrayOooConstexpr)
+{
+  // fixed extent + fixed arity: the ooo split is all constant indexing, so
+  // the whole match folds at compile time.
+  constexpr std::array<int32_t, 8> lanes = {1, 2, 3, 4, 5, 6, 7, 8};
+  constexpr auto result = match(lanes)(
+      pattern | ds(1, ooo, 8) = true,
+      pattern | _ = false);
+  static_assert(result);
+  EXPECT_TRUE(result);
+}
+
+TEST(Ds, subseqByteScan)
+{
+  // ds(ooo, needle..., ooo): the needle may sit anywhere. Byte ranges with a
+  // literal needle take the memchr/memcmp bulk scan.
+  std::string const wire = "header\r\nbody";
+  auto const found = match(wire)(
+      pattern | ds(ooo, '\r', '\n', ooo) = true,
+      pattern | _ = false);
+  EXPECT_TRUE(found);
+  auto const missing = match(wire)(
+      pattern | ds(ooo, '\r', '\r', ooo) = true,
+      pattern | _ = false);
+  EXPECT_FALSE(missing);
+}
+
+TEST(Ds, subseqByteScanEdges)
+{
+  std::vector<uint8_t> const frame = {0x7EU, 1U, 2U, 0x7EU};
+  // needle at the very start and the very end.
+  EXPECT_TRUE(match(frame)(pattern | ds(ooo, 0x7EU, 1U, ooo) = true,
+                           pattern | _ = false));
+  EXPECT_TRUE(match(frame)(pattern | ds(ooo, 2U, 0x7EU, ooo) = true,
+                           pattern | _ = false));
+  // needle longer than the buffer.
+  EXPECT_FALSE(match(frame)(
+      pattern | ds(ooo, 1U, 2U, 3U, 4U, 5U, ooo) = true,
+      pattern | _ = false));
+}
+
+TEST(Ds, subseqGenericElements)
+{
+  // non-byte elements fall back to the window-by-window pattern walk.
+  auto const xs = std::vector<int32_t>{5, 6, 7, 8};
+  auto const found = match(xs)(
+      pattern | ds(ooo, 6, 7, ooo) = true,
+      pattern | _ = false);
+  EXPECT_TRUE(found);
+}
+
+TEST(Ds, subseqBindsAfterMarker)
+{
+  // a non-literal needle element also disables the bulk scan; ids bound in
+  // rejected windows are dropped before the next window is tried.
+  auto const xs = std::vector<int32_t>{9, 0, 3, 0, 7, 1};
+  Id<int32_t> x;
+  auto const result = match(xs)(
+      pattern | ds(ooo, 0, x, 1, ooo) = x,
+      pattern | _ = -1);
+  EXPECT_EQ(result, 7);
+}
+
+TEST(Ds, subseqOverArray)
+{
+  std::array<char, 6> const buf = {'a', 'b', 'c', 'd', 'e', 'f'};
+  auto const found = match(buf)(
+      pattern | ds(ooo, 'c', 'd', ooo) = true,
+      pattern | _ = false);
+  EXPECT_TRUE(found);
+}
+
+namespace
+{
+  struct Tick
+  {
+    int32_t instrument;
+    int32_t price;
+    int32_t size;
+  };
+} // namespace
+
+TEST(Ds, dsFields)
+{
+  // aggregate members bind in declaration order without listing accessors.
+  Tick const tick{7, 100, 250};
+  Id<int32_t> price;
+  auto const result = match(tick)(
+      pattern | dsFields(7, price, _) = [&]
+      { return *price; },
+      pattern | _ = -1);
+  EXPECT_EQ(result, 100);
+}
+
+TEST(Ds, dsFieldsNoMatch)
+{
+  Tick const tick{7, 100, 250};
+  auto const result = match(tick)(
+      pattern | dsFields(8, _, _) = 1,
+      pattern | _ = 0);
+  EXPECT_EQ(result, 0);
+}
+
+namespace
+{
+  struct Point
+  {
+    int32_t x;
+    int32_t y;
+  };
+  struct Line
+  {
+    Point from;
+    Point to;
+  };
+} // namespace
+
+TEST(Ds, asDsViaFused)
+{
+  // one get_if, then members matched as a flat ds through a single app.
+  std::variant<Point, Line> const v = Point{3, 4};
+  constexpr auto asPointDs = asDsVia<Point>(&Point::x, &Point::y);
+  Id<int32_t> y;
+  auto const result = match(v)(
+      pattern | asPointDs(3, y) = [&]
+      { return *y; },
+      pattern | _ = -1);
+  EXPECT_EQ(result, 4);
+}
+
+TEST(Ds, asDsViaFusedGuardFallThrough)
+{
+  std::variant<Point, Line> const v = Point{3, 4};
+  constexpr auto asPointDs = asDsVia<Point>(&Point::x, &Point::y);
+  auto const result = match(v)(
+      pattern | asPointDs(_, meet([](auto yv) { return yv > 10; })) = 1,
+      pattern | asPointDs(3, _) = 2,
+      pattern | _ = 0);
+  EXPECT_EQ(result, 2);
+}
+
+TEST(Ds, subsequenceWindowRetriesReleaseContext)
+{
+  // each failed window materializes the app projection into the arm's
+  // context, which is sized for a single matching pass; a retry must
+  // release its slots before sliding (this used to overflow the
+  // context array).
+  Id<int32_t> x;
+  auto const r = match(std::vector<int32_t>{1, 2, 3, 4})(
+      pattern | ds(ooo,
+                   app([](int32_t e) { return e * 2; },
+                       and_(x, meet([](int32_t y) { return y >= 7; }))),
+                   ooo) = [&] { return *x; },
+      pattern | _ = -1);
+  EXPECT_EQ(r, 8);
+}
@@ -1,5 +1,7 @@
 #include "matchit.h"
 #include <gtest/gtest.h>
+#include <string>
+#include <variant>
 using namespace matchit;
 
 TEST(Expr, nullary)
@@ -28,3 +30,88 @@ TEST(Expr, Unary)
   EXPECT_EQ((_ || false)(true), true);
   EXPECT_EQ((_ && false)(true), false);
 }
+
+TEST(Expr, refPreservingReturn)
+{
+  std::array<int32_t, 2> arr{1, 2};
+  // every arm returns int32_t&: the match returns the reference itself
+  // instead of a copy of the element.
+  auto &r = match(1)(
+      pattern | 0 = [&]() -> int32_t & { return arr[0]; },
+      pattern | _ = [&]() -> int32_t & { return arr[1]; });
+  EXPECT_EQ(&r, &arr[1]);
+  r = 5;
+  EXPECT_EQ(arr[1], 5);
+}
+
+TEST(Expr, refPreservingReturnConstMix)
+{
+  std::array<int32_t, 2> arr{1, 2};
+  // mixing T& and T const& arms yields T const&.
+  auto &&r = match(0)(
+      pattern | 0 = [&]() -> int32_t const & { return arr[0]; },
+      pattern | _ = [&]() -> int32_t & { return arr[1]; });
+  static_assert(std::is_same_v<decltype(r), int32_t const &>);
+  EXPECT_EQ(&r, &arr[0]);
+}
+
+TEST(Expr, refPreservingReturnWithBindings)
+{
+  std::array<int32_t, 2> arr{1, 2};
+  Id<int32_t> i;
+  auto &r = match(std::make_tuple(7))(
+      pattern | ds(i) = [&]() -> int32_t & { return arr[0]; });
+  EXPECT_EQ(&r, &arr[0]);
+}
+
+TEST(Expr, explicitResultType)
+{
+  // arms with no common type: the caller pins the result and each arm
+  // constructs it directly.
+  auto const describe = [](int32_t n)
+  {
+    return match<std::variant<int32_t, std::string>>(n)(
+        pattern | 0 = [] { return std::string{"zero"}; },
+        pattern | _ = [&] { return n; });
+  };
+  EXPECT_EQ(std::get<std::string>(describe(0)), "zero");
+  EXPECT_EQ(std::get<int32_t>(describe(3)), 3);
+}
+
+namespace
+{
+  struct Wrapped
+  {
+    explicit Wrapped(int32_t x) : v{x} {}
+    int32_t v;
+  };
+} // namespace
+
+TEST(Expr, explicitResultTypeNoDefaultCtor)
+{
+  auto const r = match<Wrapped>(5)(
+      pattern | 5 = 50,
+      pattern | _ = 0);
+  EXPECT_EQ(r.v, 50);
+}
+
+TEST(Expr, flatNodesOwnOperands)
+{
+  // expression nodes hold their operands by value, so a compound guard
+  // expression built from temporaries can be stored and evaluated later.
+  auto const scaled = [] {
+    auto const scale = 3;
+    auto const bias = 1;
+    return _ * scale + bias > 10;
+  }();
+  EXPECT_TRUE(scaled(4));  // 13 > 10.
+  EXPECT_FALSE(scaled(3)); // 10 > 10.
+}
+
+TEST(Expr, shortCircuit)
+{
+  // || and && keep their short-circuit through the flat nodes: the right
+  // operand's division never runs when the left decides.
+  EXPECT_TRUE((_ == 0 || 10 / _ > 3)(0));
+  EXPECT_FALSE((_ != 0 && 10 / _ > 100)(0));
+}
@@ -0,0 +1,61 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+using namespace matchit;
+
+TEST(Glob, literalSpecIsExactEquality)
+{
+  EXPECT_TRUE(matched("status", glob("status")));
+  EXPECT_FALSE(matched("statuses", glob("status")));
+  EXPECT_FALSE(matched("statu", glob("status")));
+}
+
+TEST(Glob, starMatchesAnyRun)
+{
+  auto const routed = [](std::string_view target)
+  {
+    return match(target)
+    (
+      pattern | glob("GET /api/*/status") = true,
+      pattern | _ = false
+    );
+  };
+  EXPECT_TRUE(routed("GET /api/v1/status"));
+  EXPECT_TRUE(routed("GET /api//status"));
+  EXPECT_FALSE(routed("GET /api/v1/health"));
+  EXPECT_FALSE(routed("PUT /api/v1/status"));
+}
+
+TEST(Glob, questionMarkMatchesExactlyOneChar)
+{
+  EXPECT_TRUE(matched("v1", glob("v?")));
+  EXPECT_FALSE(matched("v12", glob("v?")));
+  EXPECT_FALSE(matched("v", glob("v?")));
+}
+
+TEST(Glob, starCapturesItsRun)
+{
+  Id<std::string_view> version;
+  auto const got = match(std::string_view{"GET /api/v2/status"})
+  (
+    pattern | glob("GET /api/*/status", version) = [&] { return *version; },
+    pattern | _ = std::string_view{}
+  );
+  EXPECT_EQ(got, "v2");
+}
+
+TEST(Glob, multipleStarsCaptureGreedilyLeftToRight)
+{
+  Id<std::string_view> stem;
+  Id<std::string_view> ext;
+  EXPECT_TRUE(
+      matched("include/matchit.h", glob("include/*.*", stem, ext)));
+  EXPECT_EQ(*stem, "matchit");
+  EXPECT_EQ(*ext, "h");
+}
+
+TEST(Glob, constexprScan)
+{
+  constexpr auto ok = matched("GET /api/v1/status", glob("GET /api/*/status"));
+  static_assert(ok);
+  EXPECT_TRUE(ok);
+}
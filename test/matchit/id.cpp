@@ -307,3 +307,179 @@ TEST(Id, move)
   auto y = std::move(*x);
   EXPECT_TRUE((*x).empty());
 }
+
+TEST(Id, moveOutOwnedValue)
+{
+  Id<std::string> s;
+  auto const result = match(std::string{"12345"})(
+      pattern | s = [&] { return s.move(); });
+  EXPECT_EQ(result, "12345");
+}
+
+namespace
+{
+  struct BigPod
+  {
+    int32_t data[64];
+    bool operator==(BigPod const &other) const
+    {
+      return data[0] == other.data[0];
+    }
+  };
+} // namespace
+
+TEST(Id, bigPodBindsByPointer)
+{
+  // large trivially copyable lvalues bind by pointer, not by copy; the
+  // move() throw is the observable marker of a by-pointer binding.
+  BigPod big{};
+  big.data[0] = 42;
+  Id<BigPod> b;
+  match(big)(pattern | b = [] {});
+  EXPECT_EQ((*b).data[0], 42);
+  EXPECT_THROW(b.move(), std::logic_error);
+}
+
+TEST(Id, smallScalarBindsByCopy)
+{
+  int32_t v = 5;
+  Id<int32_t> i;
+  match(v)(pattern | i = [] {});
+  v = 6;
+  // a copy was taken: the binding does not alias the scrutinee.
+  EXPECT_EQ(*i, 5);
+}
+
+TEST(Id, moveOutOfReferenceBindingThrows)
+{
+  Id<std::string> s;
+  std::string str = "12345";
+  // lvalue scrutinee: bound by pointer, stealing would mutate the caller's
+  // string behind its back.
+  match(str)(pattern | s = [] {});
+  EXPECT_THROW(s.move(), std::logic_error);
+  EXPECT_EQ(str, "12345");
+}
+
+TEST(Id, orAlternativesKeepOuterBindings)
+{
+  // a failing or_ alternative only rolls back its own bindings: the outer
+  // binding of x survives and the second alternative compares against it.
+  Id<int32_t> x;
+  auto const result = match(std::make_tuple(1, 2))(
+      pattern | and_(ds(x, _), or_(ds(2, 2), ds(_, 2))) = [&]
+      { return *x; },
+      pattern | _ = -1);
+  EXPECT_EQ(result, 1);
+}
+
+TEST(Id, guardFailureReleasesTentativeBinding)
+{
+  // the guard runs on tentative bindings before any confirm walk; when it
+  // rejects, the arm's cancel must still release the binding so a later
+  // arm can rebind the same Id.
+  Id<int32_t> x;
+  auto const r = match(std::make_pair(3, 7))(
+      pattern | ds(x, 7) | when(x > 5) = [&] { return *x * 10; },
+      pattern | ds(3, x) = [&] { return *x; });
+  EXPECT_EQ(r, 7);
+}
+
+TEST(Id, stringViewBindsSliceWithoutCopy)
+{
+  // Id<string_view> captures a piece of the scrutinee as a view: the
+  // bound data() aliases the scrutinee's buffer, no characters move.
+  auto const line = std::string{"Host: example.com"};
+  auto const value = [](std::string_view s)
+  { return s.substr(s.find(':') + 2); };
+  Id<std::string_view> v;
+  match(std::string_view{line})(
+      pattern | app(value, v) = [&]
+      {
+        EXPECT_EQ(*v, "example.com");
+        EXPECT_GE((*v).data(), line.data());
+        EXPECT_LT((*v).data(), line.data() + line.size());
+      });
+}
+
+TEST(Id, stringViewRepeatedOccurrenceComparesContent)
+{
+  auto const key = std::string{"abc"};
+  auto const other = std::string{"abc"};
+  Id<std::string_view> s;
+  // two occurrences bound from distinct buffers: equal content matches.
+  auto const same = match(std::forward_as_tuple(key, other))(
+      pattern | ds(s, s) = true,
+      pattern | _ = false);
+  EXPECT_TRUE(same);
+}
+
+namespace
+{
+  // large enough for the variant block, so an lvalue binds by pointer.
+  struct Wide
+  {
+    std::array<int32_t, 16> values;
+    static int32_t eqCalls;
+  };
+  int32_t Wide::eqCalls = 0;
+  bool operator==(Wide const &lhs, Wide const &rhs)
+  {
+    ++Wide::eqCalls;
+    return lhs.values == rhs.values;
+  }
+
+  struct Tagged
+  {
+    int32_t tag;
+    std::string payload;
+  };
+  bool operator==(Tagged const &lhs, Tagged const &rhs)
+  {
+    return lhs.tag == rhs.tag && lhs.payload == rhs.payload;
+  }
+} // namespace
+
+// cheap re-check equality for Tagged: agree on the tag and skip the
+// payload walk, the way a stored hash prechecks a large record.
+template <>
+class matchit::impl::IdTraits<Tagged>
+{
+public:
+  constexpr static bool equal(Tagged const &lhs, Tagged const &rhs)
+  {
+    return lhs.tag == rhs.tag;
+  }
+};
+
+TEST(Id, repeatedOccurrenceOfSameObjectSkipsDeepCompare)
+{
+  auto const w = Wide{{{1, 2, 3}}};
+  Wide::eqCalls = 0;
+  Id<Wide> x;
+  // both occurrences see the same object: the second settles on address
+  // identity without calling operator==.
+  EXPECT_TRUE(matched(w, and_(x, x)));
+  EXPECT_EQ(Wide::eqCalls, 0);
+}
+
+TEST(Id, repeatedOccurrenceOfDistinctObjectsStillComparesDeeply)
+{
+  auto const a = Wide{{{1, 2, 3}}};
+  auto const b = Wide{{{1, 2, 3}}};
+  Wide::eqCalls = 0;
+  Id<Wide> x;
+  EXPECT_TRUE(matched(std::forward_as_tuple(a, b), ds(x, x)));
+  EXPECT_EQ(Wide::eqCalls, 1);
+}
+
+TEST(Id, customIdTraitsDecidesRepeatedOccurrenceEquality)
+{
+  auto const lhs = Tagged{1, "alpha"};
+  auto const rhs = Tagged{1, "beta"};
+  Id<Tagged> x;
+  // operator== rejects on the payloads; the specialized trait accepts
+  // on the tag alone, so it is the one consulted.
+  EXPECT_FALSE(lhs == rhs);
+  EXPECT_TRUE(matched(std::forward_as_tuple(lhs, rhs), ds(x, x)));
+}
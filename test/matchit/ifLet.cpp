@@ -0,0 +1,61 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <optional>
+#include <string>
+#include <variant>
+using namespace matchit;
+
+TEST(IfLet, voidHandlerReturnsWhetherMatched)
+{
+  auto const v = std::variant<int32_t, std::string>{42};
+  Id<int32_t> i;
+  int32_t seen = 0;
+  EXPECT_TRUE(ifLet(as<int32_t>(i), v, [&] { seen = *i; }));
+  EXPECT_EQ(seen, 42);
+  EXPECT_FALSE(ifLet(as<std::string>(_), v, [&] { seen = -1; }));
+  EXPECT_EQ(seen, 42);
+}
+
+TEST(IfLet, valueHandlerReturnsOptional)
+{
+  Id<int32_t> x;
+  auto const doubled = ifLet(some(x), std::optional<int32_t>{21},
+                             [&] { return *x * 2; });
+  EXPECT_EQ(doubled, std::optional<int32_t>{42});
+  Id<int32_t> y;
+  auto const missed =
+      ifLet(some(y), std::optional<int32_t>{}, [&] { return *y; });
+  EXPECT_EQ(missed, std::nullopt);
+}
+
+TEST(IfLet, onMissSuppliesTheAlternative)
+{
+  Id<int32_t> n;
+  auto const pick = [](std::optional<int32_t> const &o)
+  {
+    Id<int32_t> v;
+    return ifLet(some(v), o, v * 10, -1);
+  };
+  EXPECT_EQ(pick(7), 70);
+  EXPECT_EQ(pick(std::nullopt), -1);
+  static_cast<void>(n);
+}
+
+TEST(IfLet, bindingReleasedAfterHandler)
+{
+  // the cancel walk after the handler releases the binding, so one Id
+  // can drive successive probes.
+  Id<int32_t> x;
+  auto const first = ifLet(ds(x, _), std::make_pair(1, 2), x);
+  auto const second = ifLet(ds(_, x), std::make_pair(1, 2), x);
+  EXPECT_EQ(first, std::optional<int32_t>{1});
+  EXPECT_EQ(second, std::optional<int32_t>{2});
+}
+
+TEST(IfLet, constexprProbe)
+{
+  constexpr auto result =
+      ifLet(within(1, 9), 5, [] { return 1; }, [] { return 0; });
+  static_assert(result == 1);
+  EXPECT_EQ(result, 1);
+}
@@ -0,0 +1,221 @@
+#include "matchit.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <numeric>
+#include <vector>
+using namespace matchit;
+
+TEST(MatchAll, iteratorsClassify)
+{
+  auto const xs = std::vector<int32_t>{1, -2, 3, 0, -5};
+  int32_t positives = 0;
+  int32_t negatives = 0;
+  matchAll(xs.begin(), xs.end(),
+           pattern | meet([](auto x) { return x > 0; }) = [&] { ++positives; },
+           pattern | meet([](auto x) { return x < 0; }) = [&] { ++negatives; },
+           pattern | _ = [] {});
+  EXPECT_EQ(positives, 2);
+  EXPECT_EQ(negatives, 2);
+}
+
+TEST(MatchAll, rangeOverload)
+{
+  auto const xs = std::vector<int32_t>{2, 4, 6};
+  int32_t evens = 0;
+  matchAll(xs, pattern | app(_ % 2, 0) = [&] { ++evens; },
+           pattern | _ = [] {});
+  EXPECT_EQ(evens, 3);
+}
+
+TEST(MatchAll, idsBindSequentially)
+{
+  auto const xs = std::vector<int32_t>{7, 8};
+  Id<int32_t> x;
+  int32_t sum = 0;
+  matchAll(xs, pattern | x = [&] { sum += *x; });
+  EXPECT_EQ(sum, 15);
+}
+
+TEST(MatchAll, parallelPartitions)
+{
+  // the std::execution::par overload routes here; exercised directly since
+  // including <execution> requires a parallel backend at link time.
+  std::vector<int32_t> xs(10000);
+  std::iota(xs.begin(), xs.end(), 0);
+  std::atomic<int32_t> evens{0};
+  impl::matchAllParIter(xs.begin(), xs.end(),
+                        pattern | app(_ % 2, 0) = [&] { ++evens; },
+                        pattern | _ = [] {});
+  EXPECT_EQ(evens.load(), 5000);
+}
+
+TEST(MatchAll, parallelTinyInputFallsBackToSequential)
+{
+  auto const xs = std::vector<int32_t>{41};
+  std::atomic<int32_t> seen{0};
+  impl::matchAllParIter(xs.begin(), xs.end(),
+                        pattern | _ = [&] { ++seen; });
+  EXPECT_EQ(seen.load(), 1);
+}
+
+TEST(MapAll, clipKernel)
+{
+  // id-free range arms: the branchless select kernel.
+  auto const lo = 0.0F;
+  auto const hi = 1.0F;
+  auto const xs = std::vector<float>{-0.5F, 0.25F, 2.0F, 1.0F};
+  std::vector<float> out(xs.size());
+  mapAll(xs, out.begin(),
+         pattern | (_ > hi) = hi,
+         pattern | (_ < lo) = lo,
+         pattern | _        = [] { return 0.5F; });
+  EXPECT_EQ(out, (std::vector<float>{0.0F, 0.5F, 1.0F, 0.5F}));
+}
+
+TEST(MapAll, bucketWithin)
+{
+  auto const xs = std::vector<int32_t>{3, 17, 42, 99};
+  std::vector<int32_t> out(xs.size());
+  auto const end = mapAll(xs.begin(), xs.end(), out.begin(),
+                          pattern | within(0, 9)   = 0,
+                          pattern | within(10, 49) = 1,
+                          pattern | _              = 2);
+  EXPECT_EQ(end, out.end());
+  EXPECT_EQ(out, (std::vector<int32_t>{0, 1, 1, 2}));
+}
+
+TEST(MapAll, idArmsUseFullMatch)
+{
+  // an id in an arm disables the select kernel but keeps the semantics.
+  auto const xs = std::vector<int32_t>{-3, 4};
+  std::vector<int32_t> out(xs.size());
+  Id<int32_t> x;
+  mapAll(xs, out.begin(),
+         pattern | x.at(meet([](auto v) { return v >= 0; })) = x,
+         pattern | x = [&] { return -*x; });
+  EXPECT_EQ(out, (std::vector<int32_t>{3, 4}));
+}
+
+namespace
+{
+  int32_t sumLeaves(int32_t depth, int32_t leaf, int32_t levels)
+  {
+    if (levels == 0)
+    {
+      return leaf;
+    }
+    auto const [a, b] = forkJoin(
+        depth, /*cutoff*/ 2,
+        [&] { return sumLeaves(depth + 1, leaf, levels - 1); },
+        [&] { return sumLeaves(depth + 1, leaf, levels - 1); });
+    return a + b;
+  }
+} // namespace
+
+TEST(ForkJoin, parallelMatchesSerial)
+{
+  // 2^6 leaves; the top two levels fork, the rest run inline.
+  EXPECT_EQ(sumLeaves(0, 1, 6), 64);
+}
+
+TEST(ForkJoin, cutoffZeroIsSerial)
+{
+  auto const [a, b] = forkJoin(0, 0, [] { return 2; }, [] { return 3; });
+  EXPECT_EQ(a, 2);
+  EXPECT_EQ(b, 3);
+}
+
+namespace
+{
+  struct Node
+  {
+    Node const *next;
+  };
+} // namespace
+
+TEST(TailRec, deepListWalkConstantStack)
+{
+  // 200k links: a recursive match would push a fat frame per level; the
+  // trampoline walks them in a loop.
+  auto const n = 200000;
+  std::vector<Node> nodes(n);
+  for (int32_t i = 0; i + 1 < n; ++i)
+  {
+    nodes[static_cast<std::size_t>(i)].next =
+        &nodes[static_cast<std::size_t>(i) + 1];
+  }
+  nodes.back().next = nullptr;
+  using State = std::pair<Node const *, int32_t>;
+  auto const length = tailRec(
+      State{&nodes.front(), 0},
+      [](State state)
+      {
+        Id<Node const *> rest;
+        return match<TailRec<State, int32_t>>(state.first)(
+            pattern | nullptr = [&] { return done(state.second); },
+            pattern | some(app(&Node::next, rest)) = [&]
+            { return recur(State{*rest, state.second + 1}); });
+      });
+  EXPECT_EQ(length, n);
+}
+
+TEST(TailRec, accumulatingFactorial)
+{
+  using State = std::pair<int64_t, int64_t>; // (n, acc)
+  auto const factorial = [](int64_t n)
+  {
+    return tailRec(
+        State{n, 1},
+        [](State state)
+        {
+          return match<TailRec<State, int64_t>>(state.first)(
+              pattern | 0 = [&] { return done(state.second); },
+              pattern | _ = [&]
+              {
+                return recur(
+                    State{state.first - 1, state.second * state.first});
+              });
+        });
+  };
+  EXPECT_EQ(factorial(0), 1);
+  EXPECT_EQ(factorial(10), 3628800);
+}
+
+TEST(MatchEach, lazyPipeline)
+{
+  auto const xs = std::vector<int32_t>{1, 2, 3, 4};
+  auto const view = xs | matchEach(pattern | app(_ % 2, 0) = 0,
+                                   pattern | _             = 1);
+  std::vector<int32_t> out;
+  for (auto const parity : view)
+  {
+    out.push_back(parity);
+  }
+  EXPECT_EQ(out, (std::vector<int32_t>{1, 0, 1, 0}));
+}
+
+TEST(MatchEach, ownsRvalueRange)
+{
+  // an rvalue range is moved into the view, so the pipeline stays valid
+  // after the full expression.
+  auto const view = std::vector<int32_t>{10, 25} |
+                    matchEach(pattern | within(0, 20) = true,
+                              pattern | _             = false);
+  auto it = view.begin();
+  EXPECT_TRUE(*it);
+  ++it;
+  EXPECT_FALSE(*it);
+  ++it;
+  EXPECT_EQ(it, view.end());
+}
+
+TEST(MatchEach, idsRebindPerElement)
+{
+  auto const xs = std::vector<int32_t>{5, 7};
+  Id<int32_t> x;
+  auto const view = xs | matchEach(pattern | x = x * x);
+  auto it = view.begin();
+  EXPECT_EQ(*it, 25);
+  ++it;
+  EXPECT_EQ(*it, 49);
+}